@@ -38,6 +38,10 @@
 #include "kis_selection.h"
 #include <kis_iterator_ng.h>
 
+#include <kis_convolution_painter.h>
+#include <kis_convolution_kernel.h>
+#include <kis_gaussian_kernel.h>
+
 void KisBlurBenchmark::initTestCase()
 {
     m_colorSpace = KoColorSpaceRegistry::instance()->rgb8();    
@@ -86,6 +90,46 @@ void KisBlurBenchmark::benchmarkFilter()
     }
 }
 
+void KisBlurBenchmark::benchmarkConvolution_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<bool>("useLargeKernel");
+
+    for (int threads = 1; threads <= 8; threads *= 2) {
+        QTest::newRow(QString("spatial, %1 threads").arg(threads).toLatin1()) << threads << false;
+        QTest::newRow(QString("fft, %1 threads").arg(threads).toLatin1()) << threads << true;
+    }
+}
+
+void KisBlurBenchmark::benchmarkConvolution()
+{
+    QFETCH(int, threadCount);
+    QFETCH(bool, useLargeKernel);
+
+    /**
+     * The small kernel is processed by the spatial worker, the
+     * large one goes to the FFT worker (if FFTW is available)
+     */
+    KisConvolutionKernelSP kernel;
 
+    if (useLargeKernel) {
+        kernel = KisGaussianKernel::createVerticalKernel(10);
+    } else {
+        Matrix<qreal, Dynamic, Dynamic> matrix(3, 3);
+        matrix << 1, 2, 1,
+                  2, 4, 2,
+                  1, 2, 1;
+        kernel = KisConvolutionKernel::fromMatrix(matrix, 0, 16);
+    }
+
+    const QRect rc(0, 0, GMP_IMAGE_WIDTH, GMP_IMAGE_HEIGHT);
+    KisPaintDeviceSP dst = new KisPaintDevice(m_colorSpace);
+
+    QBENCHMARK{
+        KisConvolutionPainter gc(dst);
+        gc.setThreadCount(threadCount);
+        gc.applyMatrix(kernel, m_device, rc.topLeft(), rc.topLeft(), rc.size(), BORDER_REPEAT);
+    }
+}
 
 QTEST_KDEMAIN(KisBlurBenchmark, GUI)
@@ -28,6 +28,9 @@
 #include <KoColorSpaceTraits.h>
 #include <KoCompositeOpAlphaDarken.h>
 #include <KoCompositeOpOver.h>
+#include <KoCompositeOpGeneric.h>
+#include <KoCompositeOpFunctions.h>
+#include <KoCompositeOpRegistry.h>
 #include "KoOptimizedCompositeOpFactory.h"
 
 
@@ -308,7 +311,8 @@ bool compareTwoOpsPixels(QVector<Tile> &tiles, channel_type prec) {
     return true;
 }
 
-bool compareTwoOps(bool haveMask, const KoCompositeOp *op1, const KoCompositeOp *op2)
+bool compareTwoOps(bool haveMask, const KoCompositeOp *op1, const KoCompositeOp *op2,
+                   quint8 uint8Precision = 10, float floatPrecision = 0)
 {
     Q_ASSERT(op1->colorSpace()->pixelSize() == op2->colorSpace()->pixelSize());
     const quint32 pixelSize = op1->colorSpace()->pixelSize();
@@ -338,10 +342,10 @@ bool compareTwoOps(bool haveMask, const KoCompositeOp *op1, const KoCompositeOp
 
     bool compareResult = true;
     if (pixelSize == 4) {
-        compareResult = compareTwoOpsPixels<quint8>(tiles, 10);
+        compareResult = compareTwoOpsPixels<quint8>(tiles, uint8Precision);
     }
     else if (pixelSize == 16) {
-        compareResult = compareTwoOpsPixels<float>(tiles, 0);
+        compareResult = compareTwoOpsPixels<float>(tiles, floatPrecision);
     }
     else {
         qFatal("Pixel size %i is not implemented", pixelSize);
@@ -649,6 +653,169 @@ void KisCompositionBenchmark::compareRgbF32OverOps()
     delete opAct;
 }
 
+template<class Traits>
+KoCompositeOp* createLegacySeparableOp(const KoColorSpace *cs, const QString &id)
+{
+    typedef typename Traits::channels_type T;
+
+    if (id == COMPOSITE_MULT) {
+        return new KoCompositeOpGenericSC<Traits, &cfMultiply<T> >(cs, id, id, KoCompositeOp::categoryArithmetic());
+    } else if (id == COMPOSITE_SCREEN) {
+        return new KoCompositeOpGenericSC<Traits, &cfScreen<T> >(cs, id, id, KoCompositeOp::categoryLight());
+    } else if (id == COMPOSITE_OVERLAY) {
+        return new KoCompositeOpGenericSC<Traits, &cfOverlay<T> >(cs, id, id, KoCompositeOp::categoryMix());
+    } else if (id == COMPOSITE_HARD_LIGHT) {
+        return new KoCompositeOpGenericSC<Traits, &cfHardLight<T> >(cs, id, id, KoCompositeOp::categoryLight());
+    } else if (id == COMPOSITE_ADD) {
+        return new KoCompositeOpGenericSC<Traits, &cfAddition<T> >(cs, id, id, KoCompositeOp::categoryArithmetic());
+    } else if (id == COMPOSITE_SUBTRACT) {
+        return new KoCompositeOpGenericSC<Traits, &cfSubtract<T> >(cs, id, id, KoCompositeOp::categoryArithmetic());
+    } else if (id == COMPOSITE_DIFF) {
+        return new KoCompositeOpGenericSC<Traits, &cfDifference<T> >(cs, id, id, KoCompositeOp::categoryNegative());
+    } else if (id == COMPOSITE_EXCLUSION) {
+        return new KoCompositeOpGenericSC<Traits, &cfExclusion<T> >(cs, id, id, KoCompositeOp::categoryNegative());
+    } else if (id == COMPOSITE_DARKEN) {
+        return new KoCompositeOpGenericSC<Traits, &cfDarkenOnly<T> >(cs, id, id, KoCompositeOp::categoryDark());
+    } else if (id == COMPOSITE_LIGHTEN) {
+        return new KoCompositeOpGenericSC<Traits, &cfLightenOnly<T> >(cs, id, id, KoCompositeOp::categoryLight());
+    }
+
+    qFatal("Unknown separable composite op: %s", id.toLatin1().data());
+    return 0;
+}
+
+void separableOpsData()
+{
+    QTest::addColumn<QString>("id");
+
+    QTest::newRow("multiply") << COMPOSITE_MULT;
+    QTest::newRow("screen") << COMPOSITE_SCREEN;
+    QTest::newRow("overlay") << COMPOSITE_OVERLAY;
+    QTest::newRow("hard_light") << COMPOSITE_HARD_LIGHT;
+    QTest::newRow("add") << COMPOSITE_ADD;
+    QTest::newRow("subtract") << COMPOSITE_SUBTRACT;
+    QTest::newRow("diff") << COMPOSITE_DIFF;
+    QTest::newRow("exclusion") << COMPOSITE_EXCLUSION;
+    QTest::newRow("darken") << COMPOSITE_DARKEN;
+    QTest::newRow("lighten") << COMPOSITE_LIGHTEN;
+}
+
+void KisCompositionBenchmark::compareSeparableOps_data()
+{
+    separableOpsData();
+}
+
+void KisCompositionBenchmark::compareSeparableOps()
+{
+    QFETCH(QString, id);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KoCompositeOp *opAct = KoOptimizedCompositeOpFactory::createSeparableOp32(cs, id, id, QString());
+    if (!opAct) {
+        QSKIP("No optimized version of the op for this architecture");
+    }
+
+    KoCompositeOp *opExp = createLegacySeparableOp<KoBgrU8Traits>(cs, id);
+
+    QVERIFY(compareTwoOps(true, opAct, opExp));
+    QVERIFY(compareTwoOps(false, opAct, opExp));
+
+    delete opExp;
+    delete opAct;
+}
+
+void KisCompositionBenchmark::compareRgbF32SeparableOps_data()
+{
+    separableOpsData();
+}
+
+void KisCompositionBenchmark::compareRgbF32SeparableOps()
+{
+    QFETCH(QString, id);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", "");
+    KoCompositeOp *opAct = KoOptimizedCompositeOpFactory::createSeparableOp128(cs, id, id, QString());
+    if (!opAct) {
+        QSKIP("No optimized version of the op for this architecture");
+    }
+
+    KoCompositeOp *opExp = createLegacySeparableOp<KoRgbF32Traits>(cs, id);
+
+    QVERIFY(compareTwoOps(true, opAct, opExp, 0, 1e-4));
+    QVERIFY(compareTwoOps(false, opAct, opExp, 0, 1e-4));
+
+    delete opExp;
+    delete opAct;
+}
+
+void KisCompositionBenchmark::testRgb8CompositeSeparableLegacy_data()
+{
+    separableOpsData();
+}
+
+void KisCompositionBenchmark::testRgb8CompositeSeparableLegacy()
+{
+    QFETCH(QString, id);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KoCompositeOp *op = createLegacySeparableOp<KoBgrU8Traits>(cs, id);
+    benchmarkCompositeOp(op, "Legacy");
+    delete op;
+}
+
+void KisCompositionBenchmark::testRgb8CompositeSeparableOptimized_data()
+{
+    separableOpsData();
+}
+
+void KisCompositionBenchmark::testRgb8CompositeSeparableOptimized()
+{
+    QFETCH(QString, id);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KoCompositeOp *op = KoOptimizedCompositeOpFactory::createSeparableOp32(cs, id, id, QString());
+    if (!op) {
+        QSKIP("No optimized version of the op for this architecture");
+    }
+
+    benchmarkCompositeOp(op, "Optimized");
+    delete op;
+}
+
+void KisCompositionBenchmark::testRgbF32CompositeSeparableLegacy_data()
+{
+    separableOpsData();
+}
+
+void KisCompositionBenchmark::testRgbF32CompositeSeparableLegacy()
+{
+    QFETCH(QString, id);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", "");
+    KoCompositeOp *op = createLegacySeparableOp<KoRgbF32Traits>(cs, id);
+    benchmarkCompositeOp(op, "RGBF32 Legacy");
+    delete op;
+}
+
+void KisCompositionBenchmark::testRgbF32CompositeSeparableOptimized_data()
+{
+    separableOpsData();
+}
+
+void KisCompositionBenchmark::testRgbF32CompositeSeparableOptimized()
+{
+    QFETCH(QString, id);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", "");
+    KoCompositeOp *op = KoOptimizedCompositeOpFactory::createSeparableOp128(cs, id, id, QString());
+    if (!op) {
+        QSKIP("No optimized version of the op for this architecture");
+    }
+
+    benchmarkCompositeOp(op, "RGBF32 Optimized");
+    delete op;
+}
+
 void KisCompositionBenchmark::testRgb8CompositeAlphaDarkenLegacy()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
@@ -40,6 +40,11 @@ private Q_SLOTS:
     void compareOverOpsNoMask();
     void compareRgbF32OverOps();
 
+    void compareSeparableOps_data();
+    void compareSeparableOps();
+    void compareRgbF32SeparableOps_data();
+    void compareRgbF32SeparableOps();
+
     void testRgb8CompositeAlphaDarkenLegacy();
     void testRgb8CompositeAlphaDarkenOptimized();
 
@@ -49,6 +54,16 @@ private Q_SLOTS:
     void testRgbF32CompositeOverLegacy();
     void testRgbF32CompositeOverOptimized();
 
+    void testRgb8CompositeSeparableLegacy_data();
+    void testRgb8CompositeSeparableLegacy();
+    void testRgb8CompositeSeparableOptimized_data();
+    void testRgb8CompositeSeparableOptimized();
+
+    void testRgbF32CompositeSeparableLegacy_data();
+    void testRgbF32CompositeSeparableLegacy();
+    void testRgbF32CompositeSeparableOptimized_data();
+    void testRgbF32CompositeSeparableOptimized();
+
     void testRgb8CompositeAlphaDarkenReal_Aligned();
     void testRgb8CompositeOverReal_Aligned();
 
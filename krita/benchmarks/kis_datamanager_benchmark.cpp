@@ -20,6 +20,7 @@
 #include "kis_benchmark_values.h"
 
 #include <qtest_kde.h>
+#include <QThreadPool>
 #include <kis_datamanager.h>
 
 // RGBA
@@ -199,4 +200,78 @@ void KisDatamanagerBenchmark::benchmarkMemCpy()
 }
 
 
+#define TILE_DIMENSION 64
+#define NUM_TILE_ACCESSES 200000
+
+class KisTileAccessJob : public QRunnable
+{
+public:
+    KisTileAccessJob(KisDataManager &dataManager, int seed)
+        : m_dm(dataManager), m_seed(seed)
+    {
+    }
+
+    void run() {
+        const int numCols = TEST_IMAGE_WIDTH / TILE_DIMENSION;
+        const int numRows = TEST_IMAGE_HEIGHT / TILE_DIMENSION;
+
+        // a cheap LCG, so that qrand() does not become a bottleneck itself
+        quint32 random = m_seed;
+
+        for (int i = 0; i < NUM_TILE_ACCESSES; i++) {
+            random = random * 1103515245 + 12345;
+            const int col = (random >> 8) % numCols;
+            const int row = (random >> 20) % numRows;
+
+            // every 8th access is a write access
+            KisTileSP tile = m_dm.getTile(col, row, !(i & 0x7));
+            Q_UNUSED(tile);
+        }
+    }
+
+private:
+    KisDataManager &m_dm;
+    int m_seed;
+};
+
+void KisDatamanagerBenchmark::benchmarkConcurrentTileAccess_data()
+{
+    QTest::addColumn<int>("numThreads");
+
+    const int maxThreads = qMax(QThread::idealThreadCount(), 16);
+    for (int i = 1; i <= maxThreads; i *= 2) {
+        QTest::newRow(QString("%1 threads").arg(i).toLatin1()) << i;
+    }
+}
+
+void KisDatamanagerBenchmark::benchmarkConcurrentTileAccess()
+{
+    QFETCH(int, numThreads);
+
+    quint8 *p = new quint8[PIXEL_SIZE];
+    memset(p, 0, PIXEL_SIZE);
+    KisDataManager dm(PIXEL_SIZE, p);
+
+    /**
+     * Half of the tiles exist, the other half is accessed
+     * either through the default tile or created lazily
+     */
+    quint8 *bytes = new quint8[PIXEL_SIZE * TEST_IMAGE_WIDTH * TEST_IMAGE_HEIGHT / 2];
+    memset(bytes, 128, PIXEL_SIZE * TEST_IMAGE_WIDTH * TEST_IMAGE_HEIGHT / 2);
+    dm.writeBytes(bytes, 0, 0, TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT / 2);
+    delete[] bytes;
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(numThreads);
+
+    QBENCHMARK {
+        for (int i = 0; i < numThreads; i++) {
+            pool.start(new KisTileAccessJob(dm, i));
+        }
+        pool.waitForDone();
+    }
+
+    delete[] p;
+}
+
 QTEST_KDEMAIN(KisDatamanagerBenchmark, GUI)
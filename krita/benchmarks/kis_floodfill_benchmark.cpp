@@ -105,6 +105,68 @@ void KisFloodFillBenchmark::benchmarkFlood()
     //out.save("fill_output.png");
 }
 
+void KisFloodFillBenchmark::benchmarkFloodMultithreaded_data()
+{
+    QTest::addColumn<int>("threadCount");
+
+    QTest::newRow("1 thread") << 1;
+    QTest::newRow("2 threads") << 2;
+    QTest::newRow("4 threads") << 4;
+    QTest::newRow("8 threads") << 8;
+}
+
+void KisFloodFillBenchmark::benchmarkFloodMultithreaded()
+{
+    QFETCH(int, threadCount);
+
+    KoColor fg(m_colorSpace);
+    fg.fromQColor(Qt::blue);
+
+    // every data row starts from the same unfilled image
+    KisPaintDeviceSP device = new KisPaintDevice(*m_device);
+
+    QBENCHMARK
+    {
+        KisFillPainter fillPainter(device);
+        fillPainter.setPaintColor( fg );
+
+        fillPainter.beginTransaction(kundo2_noi18n("Flood Fill"));
+
+        fillPainter.setOpacity(OPACITY_OPAQUE_U8);
+        fillPainter.setFillThreshold(15);
+        fillPainter.setCompositeOp(COMPOSITE_OVER);
+        fillPainter.setCareForSelection(true);
+        fillPainter.setWidth(GMP_IMAGE_WIDTH);
+        fillPainter.setHeight(GMP_IMAGE_HEIGHT);
+        fillPainter.setThreadCount(threadCount);
+
+        fillPainter.fillColor(1, 1, device);
+
+        fillPainter.deleteTransaction();
+    }
+}
+
+void KisFloodFillBenchmark::benchmarkFloodSelectionMultithreaded_data()
+{
+    benchmarkFloodMultithreaded_data();
+}
+
+void KisFloodFillBenchmark::benchmarkFloodSelectionMultithreaded()
+{
+    QFETCH(int, threadCount);
+
+    QBENCHMARK
+    {
+        KisFillPainter fillPainter(m_device);
+        fillPainter.setFillThreshold(15);
+        fillPainter.setWidth(GMP_IMAGE_WIDTH);
+        fillPainter.setHeight(GMP_IMAGE_HEIGHT);
+        fillPainter.setThreadCount(threadCount);
+
+        KisSelectionSP selection = fillPainter.createFloodSelection(1, 1, m_device);
+        Q_UNUSED(selection);
+    }
+}
 
 void KisFloodFillBenchmark::cleanupTestCase()
 {
@@ -44,6 +44,10 @@ private Q_SLOTS:
     void cleanupTestCase();
     
     void benchmarkFlood();
+    void benchmarkFloodMultithreaded_data();
+    void benchmarkFloodMultithreaded();
+    void benchmarkFloodSelectionMultithreaded_data();
+    void benchmarkFloodSelectionMultithreaded();
     
     
     
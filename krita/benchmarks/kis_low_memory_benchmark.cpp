@@ -19,6 +19,7 @@
 #include "kis_low_memory_benchmark.h"
 
 #include <qtest_kde.h>
+#include <QElapsedTimer>
 
 #include "kis_benchmark_values.h"
 
@@ -37,6 +38,7 @@
 #include <kis_paintop_preset.h>
 
 #include "tiles3/kis_tile_data_store.h"
+#include "tiles3/swap/kis_tile_compressor_2.h"
 #include "kis_surrogate_undo_adapter.h"
 #include "kis_image_config.h"
 #define LOAD_PRESET_OR_RETURN(preset, fileName)                         \
@@ -227,5 +229,103 @@ void KisLowMemoryBenchmark::memory2000History100Pool500HugeBrush()
     benchmarkWideArea(presetFileName, rect, step, numCycles, true,
                       2000, 600, 500, 0);
 }
+/**
+ * Paints a few strokes on a huge layer and then compresses and
+ * decompresses all its tiles with every codec the swapper supports.
+ * Reports throughput (MiB/s of uncompressed data) and compression
+ * ratio for every codec.
+ */
+void KisLowMemoryBenchmark::benchmarkSwapCompression()
+{
+    QString presetFileName = "autobrush_300px.kpp";
+    KisPaintOpPresetSP preset = new KisPaintOpPreset(QString(FILES_DATA_DIR) + QDir::separator() + presetFileName);
+    LOAD_PRESET_OR_RETURN(preset, presetFileName);
+
+    const KoColorSpace *colorSpace = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, HUGE_IMAGE_SIZE, HUGE_IMAGE_SIZE, colorSpace, "compression sample image", true);
+    KisLayerSP layer = new KisPaintLayer(image, "compression sample", OPACITY_OPAQUE_U8, colorSpace);
+    image->addNode(layer, image->root());
+
+    KisPainter painter(layer->paintDevice());
+    painter.setPaintColor(KoColor(Qt::black, colorSpace));
+    painter.setPaintOpPreset(preset, layer, image);
+
+    /**
+     * Sparse strokes, so that we get default, partially
+     * painted and fully painted tiles
+     */
+    KisDistanceInformation currentDistance;
+    for (int y = 150; y < HUGE_IMAGE_SIZE / 2; y += 750) {
+        KisPaintInformation pi1(QPointF(150, y), 0.0);
+        KisPaintInformation pi2(QPointF(HUGE_IMAGE_SIZE - 150, y + 300), 1.0);
+        painter.paintLine(pi1, pi2, &currentDistance);
+    }
+
+    KisDataManagerSP dm = layer->paintDevice()->dataManager();
+    QRect extent = dm->extent();
+
+    const int tileWidth = KisTileData::WIDTH;
+    const int tileHeight = KisTileData::HEIGHT;
+
+    QVector<KisTileSP> tiles;
+    for (int row = extent.top() / tileHeight; row <= extent.bottom() / tileHeight; row++) {
+        for (int col = extent.left() / tileWidth; col <= extent.right() / tileWidth; col++) {
+            tiles.append(dm->getTile(col, row, false));
+        }
+    }
+
+    const qint32 pixelSize = colorSpace->pixelSize();
+    KisTiledDataManager scratchDM(pixelSize, dm->defaultPixel());
+    KisTileSP scratchTile = scratchDM.getTile(0, 0, true);
+
+    foreach (const QString &codec, KisTileCompressor2::supportedCompressions()) {
+        for (int internal = 0; internal <= 1; internal++) {
+            KisTileCompressor2 compressor(codec, internal);
+            QVector<QByteArray> buffers;
+            buffers.reserve(tiles.size());
+
+            qint64 uncompressedBytes = 0;
+            qint64 compressedBytes = 0;
+
+            QElapsedTimer timer;
+            timer.start();
+
+            foreach (KisTileSP tile, tiles) {
+                tile->lockForRead();
+                QByteArray buffer(compressor.tileDataBufferSize(tile->tileData()), 0);
+                qint32 bytesWritten;
+                compressor.compressTileData(tile->tileData(), (quint8*)buffer.data(),
+                                            buffer.size(), bytesWritten);
+                tile->unlock();
+
+                buffer.resize(bytesWritten);
+                buffers.append(buffer);
+
+                uncompressedBytes += tileWidth * tileHeight * pixelSize;
+                compressedBytes += bytesWritten;
+            }
+
+            const qint64 compressionTime = timer.restart();
+
+            scratchTile->lockForWrite();
+            foreach (const QByteArray &buffer, buffers) {
+                compressor.decompressTileData((quint8*)buffer.data(), buffer.size(),
+                                              scratchTile->tileData());
+            }
+            scratchTile->unlock();
+
+            const qint64 decompressionTime = timer.elapsed();
+
+            const qreal megabytes = qreal(uncompressedBytes) / (1024 * 1024);
+
+            dbgKrita << "Codec:" << codec
+                     << (internal ? "(swap)" : "(file)")
+                     << "tiles:" << tiles.size()
+                     << "compress:" << megabytes * 1000.0 / qMax(compressionTime, qint64(1)) << "MiB/s"
+                     << "decompress:" << megabytes * 1000.0 / qMax(decompressionTime, qint64(1)) << "MiB/s"
+                     << "ratio:" << qreal(compressedBytes) / uncompressedBytes;
+        }
+    }
+}
 
 QTEST_KDEMAIN(KisLowMemoryBenchmark, GUI)
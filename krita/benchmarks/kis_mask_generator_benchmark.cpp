@@ -29,6 +29,16 @@
 
 #include "kis_circle_mask_generator.h"
 #include "kis_rect_mask_generator.h"
+#include "kis_gauss_circle_mask_generator.h"
+#include "kis_gauss_rect_mask_generator.h"
+#include "kis_curve_circle_mask_generator.h"
+#include "kis_curve_rect_mask_generator.h"
+#include "kis_cubic_curve.h"
+#include "kis_brush_mask_applicator_base.h"
+#include "kis_fixed_paint_device.h"
+
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
 
 void KisMaskGeneratorBenchmark::benchmarkCircle()
 {
@@ -75,4 +85,72 @@ void KisMaskGeneratorBenchmark::benchmarkSquare()
     }
 }
 
+/**
+ * Renders a 1000x1000 dab with the applicator of the generator, the
+ * same way KisAutoBrush does. The vectorized applicators are used
+ * when the generator supports them and Vc is available.
+ */
+void benchmarkApplicator(KisMaskGenerator *generator)
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    const QRect rc(0, 0, 1000, 1000);
+
+    KisFixedPaintDeviceSP dev = new KisFixedPaintDevice(cs);
+    dev->setRect(rc);
+    dev->initialize();
+
+    MaskProcessingData data(dev, cs, 0.0, 1.0,
+                            0.5 * rc.width(), 0.5 * rc.height(), 0.0);
+
+    KisBrushMaskApplicatorBase *applicator = generator->applicator();
+    applicator->initializeData(&data);
+
+    QBENCHMARK{
+        applicator->process(rc);
+    }
+}
+
+KisCubicCurve softBrushCurve()
+{
+    QList<QPointF> points;
+    points << QPointF(0.0, 1.0) << QPointF(0.5, 0.5) << QPointF(1.0, 0.0);
+    return KisCubicCurve(points);
+}
+
+void KisMaskGeneratorBenchmark::benchmarkCircleApplicator()
+{
+    KisCircleMaskGenerator gen(1000, 1.0, 0.5, 0.5, 2, true);
+    benchmarkApplicator(&gen);
+}
+
+void KisMaskGeneratorBenchmark::benchmarkSquareApplicator()
+{
+    KisRectangleMaskGenerator gen(1000, 1.0, 0.5, 0.5, 2, true);
+    benchmarkApplicator(&gen);
+}
+
+void KisMaskGeneratorBenchmark::benchmarkGaussCircleApplicator()
+{
+    KisGaussCircleMaskGenerator gen(1000, 1.0, 0.5, 0.5, 2, true);
+    benchmarkApplicator(&gen);
+}
+
+void KisMaskGeneratorBenchmark::benchmarkGaussSquareApplicator()
+{
+    KisGaussRectangleMaskGenerator gen(1000, 1.0, 0.5, 0.5, 2, true);
+    benchmarkApplicator(&gen);
+}
+
+void KisMaskGeneratorBenchmark::benchmarkCurveCircleApplicator()
+{
+    KisCurveCircleMaskGenerator gen(1000, 1.0, 0.5, 0.5, 2, softBrushCurve(), true);
+    benchmarkApplicator(&gen);
+}
+
+void KisMaskGeneratorBenchmark::benchmarkCurveSquareApplicator()
+{
+    KisCurveRectangleMaskGenerator gen(1000, 1.0, 0.5, 0.5, 2, softBrushCurve(), true);
+    benchmarkApplicator(&gen);
+}
+
 QTEST_KDEMAIN(KisMaskGeneratorBenchmark, GUI)
@@ -28,7 +28,13 @@ private Q_SLOTS:
     void benchmarkCircle();
     void benchmarkSIMD();
     void benchmarkSquare();
-    
+
+    void benchmarkCircleApplicator();
+    void benchmarkSquareApplicator();
+    void benchmarkGaussCircleApplicator();
+    void benchmarkGaussSquareApplicator();
+    void benchmarkCurveCircleApplicator();
+    void benchmarkCurveSquareApplicator();
 };
 
 #endif
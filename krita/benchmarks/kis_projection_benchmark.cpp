@@ -21,12 +21,16 @@
 #include "kis_benchmark_values.h"
 
 #include <KoColor.h>
+#include <KoColorSpaceRegistry.h>
 
 #include <kis_group_layer.h>
 #include <kis_paint_device.h>
 #include <KisDocument.h>
 #include <kis_image.h>
 #include <KisPart.h>
+#include <kis_image_config.h>
+#include <kis_paint_layer.h>
+#include <kis_config.h>
 
 void KisProjectionBenchmark::initTestCase()
 {
@@ -58,5 +62,100 @@ void KisProjectionBenchmark::benchmarkLoading()
     }
 }
 
+void KisProjectionBenchmark::benchmarkFullRefreshScaling_data()
+{
+    QTest::addColumn<int>("numThreads");
+
+    for (int numThreads = 1; numThreads <= 32; numThreads *= 2) {
+        QTest::newRow(QString("%1 threads").arg(numThreads).toLatin1()) << numThreads;
+    }
+}
+
+void KisProjectionBenchmark::benchmarkFullRefreshScaling()
+{
+    QFETCH(int, numThreads);
+
+    /**
+     * The number of threads of the updater context is read
+     * from the config when the image is created
+     */
+    KisImageConfig config;
+    const int savedNumThreads = config.maxNumberOfThreads();
+    config.setMaxNumberOfThreads(numThreads);
+
+    KisDocument *doc = KisPart::instance()->createDocument();
+    doc->loadNativeFormat(QString(FILES_DATA_DIR) + QDir::separator() + "load_test.kra");
+
+    config.setMaxNumberOfThreads(savedNumThreads);
+
+    QBENCHMARK{
+        doc->image()->refreshGraph();
+    }
+
+    delete doc;
+}
+
+/**
+ * Creates a document resembling an archival file: a lot of layers,
+ * most of which are hidden
+ */
+namespace {
+
+QString createManyLayersDocument()
+{
+    const QString fileName = QString(FILES_OUTPUT_DIR) + QDir::separator() + "many_layers_test.kra";
+    if (QFile::exists(fileName)) return fileName;
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    const int numLayers = 200;
+    const int numVisibleLayers = 10;
+
+    KisImageSP image = new KisImage(0, 3000, 2000, cs, "many layers");
+
+    for (int i = 0; i < numLayers; i++) {
+        KisPaintLayerSP layer = new KisPaintLayer(image, QString("layer%1").arg(i), OPACITY_OPAQUE_U8, cs);
+        layer->paintDevice()->fill(QRect(10 * i, 7 * i, 1500, 1200), KoColor(QColor(i, 255 - i, 128), cs));
+        layer->setVisible(i % (numLayers / numVisibleLayers) == 0);
+        image->addNode(layer, image->root());
+    }
+
+    KisDocument *doc = KisPart::instance()->createDocument();
+    doc->setCurrentImage(image);
+    doc->saveNativeFormat(fileName);
+    delete doc;
+
+    return fileName;
+}
+
+}
+
+void KisProjectionBenchmark::benchmarkTimeToFirstPaint_data()
+{
+    QTest::addColumn<bool>("lazy");
+
+    QTest::newRow("eager") << false;
+    QTest::newRow("lazy") << true;
+}
+
+void KisProjectionBenchmark::benchmarkTimeToFirstPaint()
+{
+    QFETCH(bool, lazy);
+
+    const QString fileName = createManyLayersDocument();
+
+    KisConfig cfg;
+    const bool savedLoadLazily = cfg.loadKraLazily();
+    cfg.setLoadKraLazily(lazy);
+
+    QBENCHMARK{
+        KisDocument *doc = KisPart::instance()->createDocument();
+        doc->loadNativeFormat(fileName);
+        doc->image()->refreshGraph();
+        doc->image()->waitForDone();
+        delete doc;
+    }
+
+    cfg.setLoadKraLazily(savedLoadLazily);
+}
 
 QTEST_KDEMAIN(KisProjectionBenchmark, GUI)
@@ -32,6 +32,12 @@ private Q_SLOTS:
 
     void benchmarkProjection();
     void benchmarkLoading();
+
+    void benchmarkFullRefreshScaling_data();
+    void benchmarkFullRefreshScaling();
+
+    void benchmarkTimeToFirstPaint_data();
+    void benchmarkTimeToFirstPaint();
 };
 
 #endif
@@ -0,0 +1,221 @@
+/*
+ *  Copyright (c) 2015 Calligra developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_psd_benchmark.h"
+
+#include <qtest_kde.h>
+
+#include <QFile>
+#include <QRegExp>
+#include <QTextStream>
+
+#include <kis_debug.h>
+
+#include <KoColor.h>
+#include <KoColorSpaceRegistry.h>
+
+#include <KisDocument.h>
+#include <KisImportExportManager.h>
+#include <KisPart.h>
+#include <kis_image.h>
+#include <kis_group_layer.h>
+#include <kis_paint_device.h>
+#include <kis_paint_layer.h>
+
+#define PSD_MIMETYPE "image/vnd.adobe.photoshop"
+
+namespace {
+
+const int imageSize = 8000;
+const int numLayers = 6;
+
+QString largePsdFileName()
+{
+    return QString(FILES_OUTPUT_DIR) + QDir::separator() + "large_layers_test.psd";
+}
+
+KisImageSP createLargeImage()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    KisImageSP image = new KisImage(0, imageSize, imageSize, cs, "large psd");
+
+    for (int i = 0; i < numLayers; i++) {
+        KisPaintLayerSP layer = new KisPaintLayer(image, QString("layer%1").arg(i), OPACITY_OPAQUE_U8, cs);
+
+        for (int j = 0; j < 16; j++) {
+            const QRect rc(j * 400 + i * 50, j * 300, imageSize / 2, imageSize / 3);
+            layer->paintDevice()->fill(rc, KoColor(QColor(16 * j, 255 - 40 * i, 8 * (i + j), 100 + 10 * j), cs));
+        }
+
+        image->addNode(layer, image->root());
+    }
+
+    image->refreshGraph();
+    image->waitForDone();
+
+    return image;
+}
+
+/**
+ * Creates the fixture on the first run, it takes too much space to
+ * be kept in the repository
+ */
+QString createLargePsdFile()
+{
+    const QString fileName = largePsdFileName();
+    if (QFile::exists(fileName)) return fileName;
+
+    KisDocument *doc = KisPart::instance()->createDocument();
+    doc->setCurrentImage(createLargeImage());
+    doc->setBackupFile(false);
+    doc->setOutputMimeType(PSD_MIMETYPE);
+    doc->saveAs(QUrl::fromLocalFile(fileName));
+    delete doc;
+
+    return fileName;
+}
+
+KisDocument* loadPsdDocument(const QString &fileName)
+{
+    KisDocument *doc = KisPart::instance()->createDocument();
+
+    KisImportExportManager manager(doc);
+    manager.setBatchMode(true);
+
+    KisImportExportFilter::ConversionStatus status;
+    manager.importDocument(fileName, QString(), status);
+
+    return doc;
+}
+
+void saveDocument(KisDocument *doc)
+{
+    doc->setBackupFile(false);
+    doc->setOutputMimeType(PSD_MIMETYPE);
+    doc->saveAs(QUrl::fromLocalFile(QString(FILES_OUTPUT_DIR) + QDir::separator() + "large_layers_test_out.psd"));
+}
+
+/**
+ * The peak resident memory of the process is tracked by the kernel
+ * in VmHWM. Writing "5" into clear_refs resets it to the current
+ * value (Linux 4.0 and later).
+ */
+class PeakMemoryMeter
+{
+public:
+    bool start() {
+        QFile file("/proc/self/clear_refs");
+        if (!file.open(QIODevice::WriteOnly) || file.write("5") != 1) {
+            return false;
+        }
+        file.close();
+
+        m_baseline = readStatusValue("VmRSS:");
+        return m_baseline >= 0;
+    }
+
+    void report() {
+        const qint64 peakMemory = readStatusValue("VmHWM:") - m_baseline;
+
+        dbgKrita << "Peak memory:" << peakMemory / 1024 / 1024 << "MiB";
+        QTest::setBenchmarkResult(peakMemory, QTest::BytesAllocated);
+    }
+
+private:
+    static qint64 readStatusValue(const QString &key) {
+        QFile file("/proc/self/status");
+        if (!file.open(QIODevice::ReadOnly)) return -1;
+
+        QTextStream stream(&file);
+        QString line;
+        while (!(line = stream.readLine()).isNull()) {
+            if (line.startsWith(key)) {
+                return line.section(QRegExp("\\s+"), 1, 1).toLongLong() * 1024;
+            }
+        }
+
+        return -1;
+    }
+
+private:
+    qint64 m_baseline;
+};
+
+}
+
+void KisPsdBenchmark::initTestCase()
+{
+    createLargePsdFile();
+}
+
+void KisPsdBenchmark::benchmarkLoading()
+{
+    QBENCHMARK_ONCE {
+        KisDocument *doc = loadPsdDocument(largePsdFileName());
+        QVERIFY(doc->image());
+        delete doc;
+    }
+}
+
+void KisPsdBenchmark::benchmarkSaving()
+{
+    KisDocument *doc = loadPsdDocument(largePsdFileName());
+    QVERIFY(doc->image());
+
+    QBENCHMARK_ONCE {
+        saveDocument(doc);
+    }
+
+    delete doc;
+}
+
+void KisPsdBenchmark::benchmarkLoadingPeakMemory()
+{
+    PeakMemoryMeter meter;
+    if (!meter.start()) {
+        QSKIP("Peak memory can be measured on Linux only");
+    }
+
+    KisDocument *doc = loadPsdDocument(largePsdFileName());
+    QVERIFY(doc->image());
+
+    meter.report();
+
+    delete doc;
+}
+
+void KisPsdBenchmark::benchmarkSavingPeakMemory()
+{
+    KisDocument *doc = loadPsdDocument(largePsdFileName());
+    QVERIFY(doc->image());
+
+    PeakMemoryMeter meter;
+    if (!meter.start()) {
+        delete doc;
+        QSKIP("Peak memory can be measured on Linux only");
+    }
+
+    saveDocument(doc);
+
+    meter.report();
+
+    delete doc;
+}
+
+QTEST_KDEMAIN(KisPsdBenchmark, GUI)
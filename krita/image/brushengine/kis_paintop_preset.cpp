@@ -71,6 +71,8 @@ KisPaintOpPreset::~KisPaintOpPreset()
 
 KisPaintOpPresetSP KisPaintOpPreset::clone() const
 {
+    ensureLoaded();
+
     KisPaintOpPresetSP preset = new KisPaintOpPreset();
 
     if (settings()) {
@@ -100,12 +102,14 @@ bool KisPaintOpPreset::isPresetDirty() const
 
 void KisPaintOpPreset::setPaintOp(const KoID & paintOp)
 {
+    ensureLoaded();
     Q_ASSERT(m_d->settings);
     m_d->settings->setProperty("paintop", paintOp.id());
 }
 
 KoID KisPaintOpPreset::paintOp() const
 {
+    ensureLoaded();
     Q_ASSERT(m_d->settings);
     return KoID(m_d->settings->getString("paintop"), name());
 }
@@ -115,6 +119,9 @@ void KisPaintOpPreset::setSettings(KisPaintOpSettingsSP settings)
     Q_ASSERT(settings);
     Q_ASSERT(!settings->getString("paintop", "").isEmpty());
 
+    // otherwise the settings would be overwritten by the lazy loading later
+    ensureLoaded();
+
     DirtyStateSaver dirtyStateSaver(this);
 
     if (settings) {
@@ -129,6 +136,7 @@ void KisPaintOpPreset::setSettings(KisPaintOpSettingsSP settings)
 
 KisPaintOpSettingsSP KisPaintOpPreset::settings() const
 {
+    ensureLoaded();
     Q_ASSERT(m_d->settings);
     Q_ASSERT(!m_d->settings->getString("paintop", "").isEmpty());
 
@@ -245,6 +253,8 @@ bool KisPaintOpPreset::save()
     if (filename().isEmpty())
         return false;
 
+    ensureLoaded();
+
     QString paintopid = m_d->settings->getString("paintop", "");
 
     if (paintopid.isEmpty())
@@ -258,6 +268,8 @@ bool KisPaintOpPreset::save()
 
 void KisPaintOpPreset::toXML(QDomDocument& doc, QDomElement& elt) const
 {
+    ensureLoaded();
+
     QString paintopid = m_d->settings->getString("paintop", "");
 
     elt.setAttribute("paintopid", paintopid);
@@ -318,6 +330,8 @@ void KisPaintOpPreset::fromXML(const QDomElement& presetElt)
 
 bool KisPaintOpPreset::saveToDevice(QIODevice *dev) const
 {
+    ensureLoaded();
+
     QImageWriter writer(dev, "PNG");
 
     QDomDocument doc;
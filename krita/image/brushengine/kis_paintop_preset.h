@@ -77,6 +77,11 @@ public:
     QString defaultFileExtension() const {
         return ".kpp";
     }
+
+    bool supportsLazyLoading() const {
+        return true;
+    }
+
     void setPresetDirty(bool value);
 
     bool isPresetDirty() const;
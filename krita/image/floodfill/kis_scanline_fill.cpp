@@ -21,6 +21,8 @@
 #include <KoAlwaysInline.h>
 
 #include <QStack>
+#include <QBitArray>
+#include <QtConcurrentMap>
 #include <KoColor.h>
 #include <KoColorSpace.h>
 #include <KoCompositeOpRegistry.h>
@@ -29,6 +31,7 @@
 #include "kis_pixel_selection.h"
 #include "kis_random_accessor_ng.h"
 #include "kis_fill_sanity_checks.h"
+#include "tiles3/kis_tile_data.h"
 
 
 template <class BaseClass>
@@ -195,6 +198,11 @@ struct Q_DECL_HIDDEN KisScanlineFill::Private
     QPoint startPoint;
     QRect boundingRect;
     int threshold;
+    int threadCount;
+
+    KoColor srcColor;
+    KoColor fillColor;
+    KisPixelSelectionSP pixelSelection;
 
     int rowIncrement;
     KisFillIntervalMap backwardMap;
@@ -212,6 +220,57 @@ struct Q_DECL_HIDDEN KisScanlineFill::Private
     }
 };
 
+/**
+ * A horizontal band of the bounding rect processed by a single
+ * thread. The band is filled with a simple span-based algorithm
+ * which keeps a bitmap of the pixels it has already checked, so the
+ * band can be safely reentered when the neighbours pass new
+ * intervals into it.
+ */
+struct Q_DECL_HIDDEN KisScanlineFill::Band
+{
+    QRect rect;
+    QBitArray visited;
+
+    QVector<KisFillInterval> incoming;
+    QVector<KisFillInterval> outgoingTop;
+    QVector<KisFillInterval> outgoingBottom;
+
+    inline int bitIndex(int x, int y) const {
+        return (y - rect.top()) * rect.width() + x - rect.left();
+    }
+
+    /**
+     * Returns true if the pixel has already been checked and marks it
+     * as checked otherwise
+     */
+    inline bool testAndSetVisited(int x, int y) {
+        const int index = bitIndex(x, y);
+        if (visited.testBit(index)) return true;
+
+        visited.setBit(index);
+        return false;
+    }
+};
+
+struct KisScanlineFill::ProcessBandFunctor
+{
+    typedef void result_type;
+
+    ProcessBandFunctor(KisScanlineFill *fill)
+        : m_fill(fill) {}
+
+    void operator() (Band *band) {
+        if (m_fill->m_d->pixelSelection) {
+            m_fill->fillSelectionImpl(band);
+        } else {
+            m_fill->fillColorImpl(band);
+        }
+    }
+
+    KisScanlineFill *m_fill;
+};
+
 
 KisScanlineFill::KisScanlineFill(KisPaintDeviceSP device, const QPoint &startPoint, const QRect &boundingRect)
     : m_d(new Private)
@@ -224,6 +283,7 @@ KisScanlineFill::KisScanlineFill(KisPaintDeviceSP device, const QPoint &startPoi
     m_d->rowIncrement = 1;
 
     m_d->threshold = 0;
+    m_d->threadCount = 1;
 }
 
 KisScanlineFill::~KisScanlineFill()
@@ -235,6 +295,11 @@ void KisScanlineFill::setThreshold(int threshold)
     m_d->threshold = threshold;
 }
 
+void KisScanlineFill::setThreadCount(int threadCount)
+{
+    m_d->threadCount = qMax(1, threadCount);
+}
+
 template <class T>
 void KisScanlineFill::extendedPass(KisFillInterval *currentInterval, int srcRow, bool extendRight, T &pixelPolicy)
 {
@@ -392,73 +457,271 @@ void KisScanlineFill::runImpl(T &pixelPolicy)
     }
 }
 
+template <class T>
+void KisScanlineFill::runImpl(T &pixelPolicy, Band *band)
+{
+    if (band) {
+        processBand(band, pixelPolicy);
+    } else {
+        runImpl(pixelPolicy);
+    }
+}
+
+template <class T>
+void KisScanlineFill::processBandLine(Band *band, const KisFillInterval &interval, QStack<KisFillInterval> *stack, T &pixelPolicy)
+{
+    const QRect &rc = band->rect;
+    const int row = interval.row;
+    const int lastX = qMin(interval.end, rc.right());
+    int x = qMax(interval.start, rc.left());
+
+    while (x <= lastX) {
+        if (band->testAndSetVisited(x, row)) {
+            x++;
+            continue;
+        }
+
+        pixelPolicy.m_srcIt->moveTo(x, row);
+        quint8 *pixelPtr = const_cast<quint8*>(pixelPolicy.m_srcIt->rawDataConst());
+        quint8 opacity = pixelPolicy.calculateOpacity(pixelPtr);
+
+        if (!opacity) {
+            x++;
+            continue;
+        }
+
+        pixelPolicy.fillPixel(pixelPtr, opacity, x, row);
+        KisFillInterval span(x, x, row);
+
+        /**
+         * The pixels that have already been visited are either not
+         * fillable or belong to a span whose neighbours have already
+         * been queued, so the extension stops on them
+         */
+        for (int left = x - 1; left >= rc.left(); left--) {
+            if (band->testAndSetVisited(left, row)) break;
+
+            pixelPolicy.m_srcIt->moveTo(left, row);
+            pixelPtr = const_cast<quint8*>(pixelPolicy.m_srcIt->rawDataConst());
+            opacity = pixelPolicy.calculateOpacity(pixelPtr);
+            if (!opacity) break;
+
+            pixelPolicy.fillPixel(pixelPtr, opacity, left, row);
+            span.start = left;
+        }
+
+        for (int right = x + 1; right <= rc.right(); right++) {
+            if (band->testAndSetVisited(right, row)) break;
+
+            pixelPolicy.m_srcIt->moveTo(right, row);
+            pixelPtr = const_cast<quint8*>(pixelPolicy.m_srcIt->rawDataConst());
+            opacity = pixelPolicy.calculateOpacity(pixelPtr);
+            if (!opacity) break;
+
+            pixelPolicy.fillPixel(pixelPtr, opacity, right, row);
+            span.end = right;
+        }
+
+        for (int rowIncrement = -1; rowIncrement <= 1; rowIncrement += 2) {
+            KisFillInterval next(span.start, span.end, row + rowIncrement);
+
+            if (next.row < m_d->boundingRect.top() ||
+                next.row > m_d->boundingRect.bottom()) {
+
+                continue;
+            }
+
+            if (next.row < rc.top()) {
+                band->outgoingTop.append(next);
+            } else if (next.row > rc.bottom()) {
+                band->outgoingBottom.append(next);
+            } else {
+                stack->push(next);
+            }
+        }
+
+        x = span.end + 1;
+    }
+}
+
+template <class T>
+void KisScanlineFill::processBand(Band *band, T &pixelPolicy)
+{
+    if (band->visited.isEmpty()) {
+        band->visited.resize(band->rect.width() * band->rect.height());
+    }
+
+    QStack<KisFillInterval> stack;
+    foreach (const KisFillInterval &interval, band->incoming) {
+        stack.push(interval);
+    }
+    band->incoming.clear();
+
+    while (!stack.isEmpty()) {
+        processBandLine(band, stack.pop(), &stack, pixelPolicy);
+    }
+}
+
+void KisScanlineFill::runParallel()
+{
+    const QRect &rc = m_d->boundingRect;
+    const int tileHeight = KisTileData::HEIGHT;
+
+    int bandHeight = (rc.height() + m_d->threadCount - 1) / m_d->threadCount;
+    bandHeight = qMax(1, (bandHeight + tileHeight - 1) / tileHeight) * tileHeight;
+
+    /**
+     * The band borders are aligned to the tile grid, so the threads
+     * never write into the same tile
+     */
+    QVector<Band> bands;
+    int top = rc.top();
+    while (top <= rc.bottom()) {
+        int tileOffset = top % tileHeight;
+        if (tileOffset < 0) tileOffset += tileHeight;
+
+        const int bottom = qMin(top - tileOffset + bandHeight - 1, rc.bottom());
+
+        Band band;
+        band.rect = QRect(rc.left(), top, rc.width(), bottom - top + 1);
+        bands.append(band);
+
+        top = bottom + 1;
+    }
+
+    for (int i = 0; i < bands.size(); i++) {
+        if (bands[i].rect.contains(m_d->startPoint)) {
+            bands[i].incoming.append(KisFillInterval(m_d->startPoint.x(), m_d->startPoint.x(), m_d->startPoint.y()));
+            break;
+        }
+    }
+
+    QVector<Band*> activeBands;
+
+    while (1) {
+        activeBands.clear();
+        for (int i = 0; i < bands.size(); i++) {
+            if (!bands[i].incoming.isEmpty()) {
+                activeBands.append(&bands[i]);
+            }
+        }
+
+        if (activeBands.isEmpty()) break;
+
+        if (activeBands.size() == 1) {
+            ProcessBandFunctor(this)(activeBands.first());
+        } else {
+            QtConcurrent::blockingMap(activeBands, ProcessBandFunctor(this));
+        }
+
+        /**
+         * Pass the intervals crossing the band borders to the
+         * neighbours. They will be processed in the next round.
+         */
+        for (int i = 0; i < bands.size(); i++) {
+            if (i > 0) {
+                bands[i - 1].incoming += bands[i].outgoingTop;
+            }
+            if (i < bands.size() - 1) {
+                bands[i + 1].incoming += bands[i].outgoingBottom;
+            }
+
+            bands[i].outgoingTop.clear();
+            bands[i].outgoingBottom.clear();
+        }
+    }
+}
+
 void KisScanlineFill::fillColor(const KoColor &fillColor)
 {
     KisRandomConstAccessorSP it = m_d->device->createRandomConstAccessorNG(m_d->startPoint.x(), m_d->startPoint.y());
-    KoColor srcColor(it->rawDataConst(), m_d->device->colorSpace());
+    m_d->srcColor = KoColor(it->rawDataConst(), m_d->device->colorSpace());
+    m_d->fillColor = fillColor;
+    m_d->pixelSelection = 0;
 
+    if (m_d->threadCount > 1) {
+        runParallel();
+    } else {
+        fillColorImpl(0);
+    }
+}
+
+void KisScanlineFill::fillSelection(KisPixelSelectionSP pixelSelection)
+{
+    KisRandomConstAccessorSP it = m_d->device->createRandomConstAccessorNG(m_d->startPoint.x(), m_d->startPoint.y());
+    m_d->srcColor = KoColor(it->rawDataConst(), m_d->device->colorSpace());
+    m_d->pixelSelection = pixelSelection;
+
+    if (m_d->threadCount > 1) {
+        runParallel();
+    } else {
+        fillSelectionImpl(0);
+    }
+
+    m_d->pixelSelection = 0;
+}
+
+void KisScanlineFill::fillColorImpl(Band *band)
+{
     const int pixelSize = m_d->device->pixelSize();
 
     if (pixelSize == 1) {
         SelectionPolicy<false, DifferencePolicyOptimized<quint8>, FillWithColor>
-            policy(m_d->device, srcColor, m_d->threshold);
-        policy.setFillColor(fillColor);
-        runImpl(policy);
+            policy(m_d->device, m_d->srcColor, m_d->threshold);
+        policy.setFillColor(m_d->fillColor);
+        runImpl(policy, band);
     } else if (pixelSize == 2) {
         SelectionPolicy<false, DifferencePolicyOptimized<quint16>, FillWithColor>
-            policy(m_d->device, srcColor, m_d->threshold);
-        policy.setFillColor(fillColor);
-        runImpl(policy);
+            policy(m_d->device, m_d->srcColor, m_d->threshold);
+        policy.setFillColor(m_d->fillColor);
+        runImpl(policy, band);
     } else if (pixelSize == 4) {
         SelectionPolicy<false, DifferencePolicyOptimized<quint32>, FillWithColor>
-            policy(m_d->device, srcColor, m_d->threshold);
-        policy.setFillColor(fillColor);
-        runImpl(policy);
+            policy(m_d->device, m_d->srcColor, m_d->threshold);
+        policy.setFillColor(m_d->fillColor);
+        runImpl(policy, band);
     } else if (pixelSize == 8) {
         SelectionPolicy<false, DifferencePolicyOptimized<quint64>, FillWithColor>
-              policy(m_d->device, srcColor, m_d->threshold);
-        policy.setFillColor(fillColor);
-        runImpl(policy);
+              policy(m_d->device, m_d->srcColor, m_d->threshold);
+        policy.setFillColor(m_d->fillColor);
+        runImpl(policy, band);
     } else {
         SelectionPolicy<false, DifferencePolicySlow, FillWithColor>
-              policy(m_d->device, srcColor, m_d->threshold);
-        policy.setFillColor(fillColor);
-        runImpl(policy);
+              policy(m_d->device, m_d->srcColor, m_d->threshold);
+        policy.setFillColor(m_d->fillColor);
+        runImpl(policy, band);
     }
 }
 
-void KisScanlineFill::fillSelection(KisPixelSelectionSP pixelSelection)
+void KisScanlineFill::fillSelectionImpl(Band *band)
 {
-    KisRandomConstAccessorSP it = m_d->device->createRandomConstAccessorNG(m_d->startPoint.x(), m_d->startPoint.y());
-    KoColor srcColor(it->rawDataConst(), m_d->device->colorSpace());
-
     const int pixelSize = m_d->device->pixelSize();
 
     if (pixelSize == 1) {
         SelectionPolicy<true, DifferencePolicyOptimized<quint8>, CopyToSelection>
-            policy(m_d->device, srcColor, m_d->threshold);
-        policy.setDestinationSelection(pixelSelection);
-        runImpl(policy);
+            policy(m_d->device, m_d->srcColor, m_d->threshold);
+        policy.setDestinationSelection(m_d->pixelSelection);
+        runImpl(policy, band);
     } else if (pixelSize == 2) {
         SelectionPolicy<true, DifferencePolicyOptimized<quint16>, CopyToSelection>
-            policy(m_d->device, srcColor, m_d->threshold);
-        policy.setDestinationSelection(pixelSelection);
-        runImpl(policy);
+            policy(m_d->device, m_d->srcColor, m_d->threshold);
+        policy.setDestinationSelection(m_d->pixelSelection);
+        runImpl(policy, band);
     } else if (pixelSize == 4) {
         SelectionPolicy<true, DifferencePolicyOptimized<quint32>, CopyToSelection>
-            policy(m_d->device, srcColor, m_d->threshold);
-        policy.setDestinationSelection(pixelSelection);
-        runImpl(policy);
+            policy(m_d->device, m_d->srcColor, m_d->threshold);
+        policy.setDestinationSelection(m_d->pixelSelection);
+        runImpl(policy, band);
     } else if (pixelSize == 8) {
         SelectionPolicy<true, DifferencePolicyOptimized<quint64>, CopyToSelection>
-              policy(m_d->device, srcColor, m_d->threshold);
-        policy.setDestinationSelection(pixelSelection);
-        runImpl(policy);
+              policy(m_d->device, m_d->srcColor, m_d->threshold);
+        policy.setDestinationSelection(m_d->pixelSelection);
+        runImpl(policy, band);
     } else {
         SelectionPolicy<true, DifferencePolicySlow, CopyToSelection>
-              policy(m_d->device, srcColor, m_d->threshold);
-        policy.setDestinationSelection(pixelSelection);
-        runImpl(policy);
+              policy(m_d->device, m_d->srcColor, m_d->threshold);
+        policy.setDestinationSelection(m_d->pixelSelection);
+        runImpl(policy, band);
     }
 }
 
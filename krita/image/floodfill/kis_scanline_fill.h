@@ -20,6 +20,7 @@
 #define __KIS_SCANLINE_FILL_H
 
 #include <QScopedPointer>
+#include <QStack>
 
 #include <kritaimage_export.h>
 #include <kis_types.h>
@@ -39,10 +40,23 @@ public:
 
     void setThreshold(int threshold);
 
+    /**
+     * Sets the number of threads used for filling. When \p threadCount
+     * is greater than one, the bounding rect is split into horizontal
+     * bands aligned to the tile grid, which are filled concurrently.
+     * The intervals crossing the band borders are passed to the
+     * neighbouring bands, so the result is exactly the same as the
+     * one of the single-threaded fill.
+     */
+    void setThreadCount(int threadCount);
+
 private:
     friend class KisScanlineFillTest;
     Q_DISABLE_COPY(KisScanlineFill)
 
+    struct Band;
+    struct ProcessBandFunctor;
+
     template <class T>
     void processLine(KisFillInterval interval, const int rowIncrement, T &pixelPolicy);
 
@@ -53,6 +67,19 @@ private:
     template <class T>
     void runImpl(T &pixelPolicy);
 
+    template <class T>
+    void runImpl(T &pixelPolicy, Band *band);
+
+    template <class T>
+    void processBand(Band *band, T &pixelPolicy);
+
+    template <class T>
+    void processBandLine(Band *band, const KisFillInterval &interval, QStack<KisFillInterval> *stack, T &pixelPolicy);
+
+    void fillColorImpl(Band *band);
+    void fillSelectionImpl(Band *band);
+    void runParallel();
+
 private:
     void testingProcessLine(const KisFillInterval &processInterval);
     QVector<KisFillInterval> testingGetForwardIntervals() const;
@@ -72,6 +72,28 @@ public:
         return false;
     }
 
+    // the parameters of the fade, used by the vectorized row processors
+
+    inline qreal radius() const {
+        return m_radius;
+    }
+
+    inline quint8 fadeStartValue() const {
+        return m_fadeStartValue;
+    }
+
+    inline qreal antialiasingFadeStart() const {
+        return m_antialiasingFadeStart;
+    }
+
+    inline qreal antialiasingFadeCoeff() const {
+        return m_antialiasingFadeCoeff;
+    }
+
+    inline bool antialiasingEnabled() const {
+        return m_enableAntialiasing;
+    }
+
 private:
     qreal m_radius;
     quint8 m_fadeStartValue;
@@ -151,6 +173,36 @@ public:
         return false;
     }
 
+    // the parameters of the fade, used by the vectorized row processors
+
+    inline qreal xLimit() const {
+        return m_xLimit;
+    }
+
+    inline qreal yLimit() const {
+        return m_yLimit;
+    }
+
+    inline qreal xFadeLimitStart() const {
+        return m_xFadeLimitStart;
+    }
+
+    inline qreal yFadeLimitStart() const {
+        return m_yFadeLimitStart;
+    }
+
+    inline qreal xFadeCoeff() const {
+        return m_xFadeCoeff;
+    }
+
+    inline qreal yFadeCoeff() const {
+        return m_yFadeCoeff;
+    }
+
+    inline bool antialiasingEnabled() const {
+        return m_enableAntialiasing;
+    }
+
 private:
     qreal m_xLimit;
     qreal m_yLimit;
@@ -20,7 +20,18 @@
 
 #include "kis_circle_mask_generator.h"
 #include "kis_circle_mask_generator_p.h"
+#include "kis_rect_mask_generator.h"
+#include "kis_rect_mask_generator_p.h"
+#include "kis_gauss_circle_mask_generator.h"
+#include "kis_gauss_circle_mask_generator_p.h"
+#include "kis_gauss_rect_mask_generator.h"
+#include "kis_gauss_rect_mask_generator_p.h"
+#include "kis_curve_circle_mask_generator.h"
+#include "kis_curve_circle_mask_generator_p.h"
+#include "kis_curve_rect_mask_generator.h"
+#include "kis_curve_rect_mask_generator_p.h"
 #include "kis_brush_mask_applicators.h"
+#include "vc_extra_math.h"
 
 
 #define a(_s) #_s
@@ -44,6 +55,46 @@ MaskApplicatorFactory<KisCircleMaskGenerator, KisBrushMaskVectorApplicator>::cre
     return new KisBrushMaskVectorApplicator<KisCircleMaskGenerator,VC_IMPL>(maskGenerator);
 }
 
+template<>
+template<>
+MaskApplicatorFactory<KisRectangleMaskGenerator, KisBrushMaskVectorApplicator>::ReturnType
+MaskApplicatorFactory<KisRectangleMaskGenerator, KisBrushMaskVectorApplicator>::create<VC_IMPL>(ParamType maskGenerator)
+{
+    return new KisBrushMaskVectorApplicator<KisRectangleMaskGenerator,VC_IMPL>(maskGenerator);
+}
+
+template<>
+template<>
+MaskApplicatorFactory<KisGaussCircleMaskGenerator, KisBrushMaskVectorApplicator>::ReturnType
+MaskApplicatorFactory<KisGaussCircleMaskGenerator, KisBrushMaskVectorApplicator>::create<VC_IMPL>(ParamType maskGenerator)
+{
+    return new KisBrushMaskVectorApplicator<KisGaussCircleMaskGenerator,VC_IMPL>(maskGenerator);
+}
+
+template<>
+template<>
+MaskApplicatorFactory<KisGaussRectangleMaskGenerator, KisBrushMaskVectorApplicator>::ReturnType
+MaskApplicatorFactory<KisGaussRectangleMaskGenerator, KisBrushMaskVectorApplicator>::create<VC_IMPL>(ParamType maskGenerator)
+{
+    return new KisBrushMaskVectorApplicator<KisGaussRectangleMaskGenerator,VC_IMPL>(maskGenerator);
+}
+
+template<>
+template<>
+MaskApplicatorFactory<KisCurveCircleMaskGenerator, KisBrushMaskVectorApplicator>::ReturnType
+MaskApplicatorFactory<KisCurveCircleMaskGenerator, KisBrushMaskVectorApplicator>::create<VC_IMPL>(ParamType maskGenerator)
+{
+    return new KisBrushMaskVectorApplicator<KisCurveCircleMaskGenerator,VC_IMPL>(maskGenerator);
+}
+
+template<>
+template<>
+MaskApplicatorFactory<KisCurveRectangleMaskGenerator, KisBrushMaskVectorApplicator>::ReturnType
+MaskApplicatorFactory<KisCurveRectangleMaskGenerator, KisBrushMaskVectorApplicator>::create<VC_IMPL>(ParamType maskGenerator)
+{
+    return new KisBrushMaskVectorApplicator<KisCurveRectangleMaskGenerator,VC_IMPL>(maskGenerator);
+}
+
 #if defined HAVE_VC
 
 struct KisCircleMaskGenerator::FastRowProcessor
@@ -118,4 +169,431 @@ FastRowProcessor::process<VC_IMPL>(float* buffer, int width, float y, float cosa
     }
 }
 
+struct KisRectangleMaskGenerator::FastRowProcessor
+{
+    FastRowProcessor(KisRectangleMaskGenerator *maskGenerator)
+        : d(maskGenerator->d) {}
+
+    template<Vc::Implementation _impl>
+    void process(float* buffer, int width, float y, float cosa, float sina,
+                 float centerX, float centerY);
+
+    KisRectangleMaskGenerator::Private *d;
+};
+
+template<> void KisRectangleMaskGenerator::
+FastRowProcessor::process<VC_IMPL>(float* buffer, int width, float y, float cosa, float sina,
+                                   float centerX, float centerY)
+{
+    const bool useSmoothing = d->copyOfAntialiasEdges;
+
+    float y_ = y - centerY;
+    float sinay_ = sina * y_;
+    float cosay_ = cosa * y_;
+
+    float* bufferPointer = buffer;
+
+    Vc::float_v currentIndices(Vc::int_v::IndexesFromZero());
+
+    Vc::float_v increment((float)Vc::float_v::Size);
+    Vc::float_v vCenterX(centerX);
+
+    Vc::float_v vCosa(cosa);
+    Vc::float_v vSina(sina);
+    Vc::float_v vCosaY_(cosay_);
+    Vc::float_v vSinaY_(sinay_);
+
+    Vc::float_v vXCoeff(d->xcoeff);
+    Vc::float_v vYCoeff(d->ycoeff);
+
+    Vc::float_v vTransformedFadeX(d->transformedFadeX);
+    Vc::float_v vTransformedFadeY(d->transformedFadeY);
+
+    Vc::float_v vOne(1.0f);
+    Vc::float_v vZero(Vc::Zero);
+
+    for (int i=0; i < width; i+= Vc::float_v::Size){
+
+        Vc::float_v x_ = currentIndices - vCenterX;
+
+        Vc::float_v xr = Vc::abs(x_ * vCosa - vSinaY_);
+        Vc::float_v yr = Vc::abs(x_ * vSina + vCosaY_);
+
+        Vc::float_v nxr = xr * vXCoeff;
+        Vc::float_v nyr = yr * vYCoeff;
+
+        Vc::float_m outsideMask = (nxr > vOne) || (nyr > vOne);
+
+        if (useSmoothing) {
+            xr += vOne;
+            yr += vOne;
+        }
+
+        Vc::float_v fxr = xr * vTransformedFadeX;
+        Vc::float_v fyr = yr * vTransformedFadeY;
+
+        // the same priority of the fading directions as in valueAt()
+        Vc::float_m fadeXMask = (fxr > vOne) && ((fxr > fyr) || (fyr < vOne));
+        Vc::float_m fadeYMask = !fadeXMask && (fyr > vOne) && ((fyr > fxr) || (fxr < vOne));
+
+        Vc::float_v vFade(Vc::Zero);
+        vFade(fadeXMask) = nxr * (fxr - vOne) / (fxr - nxr);
+        vFade(fadeYMask) = nyr * (fyr - vOne) / (fyr - nyr);
+        vFade(outsideMask) = vOne;
+
+        vFade = Vc::max(vZero, Vc::min(vFade, vOne));
+
+        vFade.store(bufferPointer);
+        currentIndices = currentIndices + increment;
+
+        bufferPointer += Vc::float_v::Size;
+    }
+}
+
+struct KisGaussCircleMaskGenerator::FastRowProcessor
+{
+    FastRowProcessor(KisGaussCircleMaskGenerator *maskGenerator)
+        : d(maskGenerator->d) {}
+
+    template<Vc::Implementation _impl>
+    void process(float* buffer, int width, float y, float cosa, float sina,
+                 float centerX, float centerY);
+
+    KisGaussCircleMaskGenerator::Private *d;
+};
+
+template<> void KisGaussCircleMaskGenerator::
+FastRowProcessor::process<VC_IMPL>(float* buffer, int width, float y, float cosa, float sina,
+                                   float centerX, float centerY)
+{
+    const bool useSmoothing = d->fadeMaker.antialiasingEnabled();
+
+    float y_ = y - centerY;
+    float sinay_ = sina * y_;
+    float cosay_ = cosa * y_;
+
+    float* bufferPointer = buffer;
+
+    Vc::float_v currentIndices(Vc::int_v::IndexesFromZero());
+
+    Vc::float_v increment((float)Vc::float_v::Size);
+    Vc::float_v vCenterX(centerX);
+
+    Vc::float_v vCosa(cosa);
+    Vc::float_v vSina(sina);
+    Vc::float_v vCosaY_(cosay_);
+    Vc::float_v vSinaY_(sinay_);
+
+    Vc::float_v vYCoeff(d->ycoef);
+    Vc::float_v vDistFactor(d->distfactor);
+    Vc::float_v vCenter(d->center);
+
+    // the values are normalized to [0.0, 1.0] right here
+    Vc::float_v vAlphaFactor(d->alphafactor / 255.0);
+
+    Vc::float_v vRadius(d->fadeMaker.radius());
+    Vc::float_v vFadeStart(d->fadeMaker.antialiasingFadeStart());
+    Vc::float_v vFadeStartValue(d->fadeMaker.fadeStartValue() / 255.0);
+    Vc::float_v vFadeCoeff(d->fadeMaker.antialiasingFadeCoeff() / 255.0);
+
+    Vc::float_v vOne(1.0f);
+    Vc::float_v vZero(Vc::Zero);
+
+    for (int i=0; i < width; i+= Vc::float_v::Size){
+
+        Vc::float_v x_ = currentIndices - vCenterX;
+
+        Vc::float_v xr = x_ * vCosa - vSinaY_;
+        Vc::float_v yr = x_ * vSina + vCosaY_;
+
+        Vc::float_v dist = Vc::sqrt(pow2(xr) + pow2(yr * vYCoeff));
+        Vc::float_v valDist = dist * vDistFactor;
+
+        Vc::float_v fullFade = vAlphaFactor * (VcExtraMath::erf(valDist + vCenter) - VcExtraMath::erf(valDist - vCenter));
+        Vc::float_v vFade = vOne - fullFade;
+
+        if (useSmoothing) {
+            vFade(dist > vFadeStart) = vFadeStartValue + (dist - vFadeStart) * vFadeCoeff;
+        }
+
+        vFade(dist > vRadius) = vOne;
+
+        vFade = Vc::max(vZero, Vc::min(vFade, vOne));
+
+        vFade.store(bufferPointer);
+        currentIndices = currentIndices + increment;
+
+        bufferPointer += Vc::float_v::Size;
+    }
+}
+
+struct KisGaussRectangleMaskGenerator::FastRowProcessor
+{
+    FastRowProcessor(KisGaussRectangleMaskGenerator *maskGenerator)
+        : d(maskGenerator->d) {}
+
+    template<Vc::Implementation _impl>
+    void process(float* buffer, int width, float y, float cosa, float sina,
+                 float centerX, float centerY);
+
+    KisGaussRectangleMaskGenerator::Private *d;
+};
+
+template<> void KisGaussRectangleMaskGenerator::
+FastRowProcessor::process<VC_IMPL>(float* buffer, int width, float y, float cosa, float sina,
+                                   float centerX, float centerY)
+{
+    const bool useSmoothing = d->fadeMaker.antialiasingEnabled();
+
+    float y_ = y - centerY;
+    float sinay_ = sina * y_;
+    float cosay_ = cosa * y_;
+
+    float* bufferPointer = buffer;
+
+    Vc::float_v currentIndices(Vc::int_v::IndexesFromZero());
+
+    Vc::float_v increment((float)Vc::float_v::Size);
+    Vc::float_v vCenterX(centerX);
+
+    Vc::float_v vCosa(cosa);
+    Vc::float_v vSina(sina);
+    Vc::float_v vCosaY_(cosay_);
+    Vc::float_v vSinaY_(sinay_);
+
+    Vc::float_v vXFade(d->xfade);
+    Vc::float_v vYFade(d->yfade);
+    Vc::float_v vHalfWidth(d->halfWidth);
+    Vc::float_v vHalfHeight(d->halfHeight);
+
+    // the values are normalized to [0.0, 1.0] right here
+    Vc::float_v vAlphaFactor(d->alphafactor / 255.0);
+
+    Vc::float_v vXLimit(d->fadeMaker.xLimit());
+    Vc::float_v vYLimit(d->fadeMaker.yLimit());
+    Vc::float_v vXFadeLimitStart(d->fadeMaker.xFadeLimitStart());
+    Vc::float_v vYFadeLimitStart(d->fadeMaker.yFadeLimitStart());
+    Vc::float_v vXFadeCoeff(d->fadeMaker.xFadeCoeff());
+    Vc::float_v vYFadeCoeff(d->fadeMaker.yFadeCoeff());
+
+    Vc::float_v vOne(1.0f);
+    Vc::float_v vZero(Vc::Zero);
+
+    for (int i=0; i < width; i+= Vc::float_v::Size){
+
+        Vc::float_v x_ = currentIndices - vCenterX;
+
+        Vc::float_v xr = Vc::abs(x_ * vCosa - vSinaY_);
+        Vc::float_v yr = Vc::abs(x_ * vSina + vCosaY_);
+
+        Vc::float_v fullFade = vAlphaFactor *
+            (VcExtraMath::erf((vHalfWidth + xr) * vXFade) + VcExtraMath::erf((vHalfWidth - xr) * vXFade)) *
+            (VcExtraMath::erf((vHalfHeight + yr) * vYFade) + VcExtraMath::erf((vHalfHeight - yr) * vYFade));
+
+        Vc::float_v vFade = vOne - fullFade;
+
+        if (useSmoothing) {
+            Vc::float_m xFadeMask = xr > vXFadeLimitStart;
+            Vc::float_m yFadeMask = yr > vYFadeLimitStart;
+
+            vFade(xFadeMask) = vFade + (vOne - vFade) * (xr - vXFadeLimitStart) * vXFadeCoeff;
+            vFade(yFadeMask) = vFade + (vOne - vFade) * (yr - vYFadeLimitStart) * vYFadeCoeff;
+        }
+
+        vFade((xr > vXLimit) || (yr > vYLimit)) = vOne;
+
+        vFade = Vc::max(vZero, Vc::min(vFade, vOne));
+
+        vFade.store(bufferPointer);
+        currentIndices = currentIndices + increment;
+
+        bufferPointer += Vc::float_v::Size;
+    }
+}
+
+struct KisCurveCircleMaskGenerator::FastRowProcessor
+{
+    FastRowProcessor(KisCurveCircleMaskGenerator *maskGenerator)
+        : d(maskGenerator->d) {}
+
+    template<Vc::Implementation _impl>
+    void process(float* buffer, int width, float y, float cosa, float sina,
+                 float centerX, float centerY);
+
+    KisCurveCircleMaskGenerator::Private *d;
+};
+
+template<> void KisCurveCircleMaskGenerator::
+FastRowProcessor::process<VC_IMPL>(float* buffer, int width, float y, float cosa, float sina,
+                                   float centerX, float centerY)
+{
+    const bool useSmoothing = d->fadeMaker.antialiasingEnabled();
+    const float *curveData = d->curveDataFloat.constData();
+
+    float y_ = y - centerY;
+    float sinay_ = sina * y_;
+    float cosay_ = cosa * y_;
+
+    float* bufferPointer = buffer;
+
+    Vc::float_v currentIndices(Vc::int_v::IndexesFromZero());
+
+    Vc::float_v increment((float)Vc::float_v::Size);
+    Vc::float_v vCenterX(centerX);
+
+    Vc::float_v vCosa(cosa);
+    Vc::float_v vSina(sina);
+    Vc::float_v vCosaY_(cosay_);
+    Vc::float_v vSinaY_(sinay_);
+
+    Vc::float_v vXCoeff(d->xcoef);
+    Vc::float_v vYCoeff(d->ycoef);
+    Vc::float_v vCurveResolution(d->curveResolution);
+
+    Vc::float_v vRadius(d->fadeMaker.radius());
+    Vc::float_v vFadeStart(d->fadeMaker.antialiasingFadeStart());
+    Vc::float_v vFadeStartValue(d->fadeMaker.fadeStartValue() / 255.0);
+    Vc::float_v vFadeCoeff(d->fadeMaker.antialiasingFadeCoeff() / 255.0);
+
+    Vc::float_v vOne(1.0f);
+    Vc::float_v vZero(Vc::Zero);
+    Vc::int_v vIndexOne(Vc::One);
+
+    for (int i=0; i < width; i+= Vc::float_v::Size){
+
+        Vc::float_v x_ = currentIndices - vCenterX;
+
+        Vc::float_v xr = x_ * vCosa - vSinaY_;
+        Vc::float_v yr = x_ * vSina + vCosaY_;
+
+        Vc::float_v dist = pow2(xr * vXCoeff) + pow2(yr * vYCoeff);
+
+        // the pixels outside the mask are overwritten below, but
+        // their curve indexes must stay inside the curve as well
+        Vc::float_v distance = Vc::min(dist, vOne) * vCurveResolution;
+
+        Vc::int_v alphaValue(distance);
+        Vc::float_v alphaValueF = distance - Vc::float_v(alphaValue);
+
+        Vc::float_v curveValue;
+        Vc::float_v nextCurveValue;
+        curveValue.gather(curveData, alphaValue);
+        nextCurveValue.gather(curveData, alphaValue + vIndexOne);
+
+        Vc::float_v alpha = (vOne - alphaValueF) * curveValue + alphaValueF * nextCurveValue;
+        Vc::float_v vFade = vOne - alpha;
+
+        if (useSmoothing) {
+            vFade(dist > vFadeStart) = vFadeStartValue + (dist - vFadeStart) * vFadeCoeff;
+        }
+
+        vFade(dist > vRadius) = vOne;
+
+        vFade = Vc::max(vZero, Vc::min(vFade, vOne));
+
+        vFade.store(bufferPointer);
+        currentIndices = currentIndices + increment;
+
+        bufferPointer += Vc::float_v::Size;
+    }
+}
+
+struct KisCurveRectangleMaskGenerator::FastRowProcessor
+{
+    FastRowProcessor(KisCurveRectangleMaskGenerator *maskGenerator)
+        : d(maskGenerator->d) {}
+
+    template<Vc::Implementation _impl>
+    void process(float* buffer, int width, float y, float cosa, float sina,
+                 float centerX, float centerY);
+
+    KisCurveRectangleMaskGenerator::Private *d;
+};
+
+template<> void KisCurveRectangleMaskGenerator::
+FastRowProcessor::process<VC_IMPL>(float* buffer, int width, float y, float cosa, float sina,
+                                   float centerX, float centerY)
+{
+    const bool useSmoothing = d->fadeMaker.antialiasingEnabled();
+    const float *curveData = d->curveDataFloat.constData();
+
+    float y_ = y - centerY;
+    float sinay_ = sina * y_;
+    float cosay_ = cosa * y_;
+
+    float* bufferPointer = buffer;
+
+    Vc::float_v currentIndices(Vc::int_v::IndexesFromZero());
+
+    Vc::float_v increment((float)Vc::float_v::Size);
+    Vc::float_v vCenterX(centerX);
+
+    Vc::float_v vCosa(cosa);
+    Vc::float_v vSina(sina);
+    Vc::float_v vCosaY_(cosay_);
+    Vc::float_v vSinaY_(sinay_);
+
+    Vc::float_v vXCoeff(d->xcoeff);
+    Vc::float_v vYCoeff(d->ycoeff);
+    Vc::float_v vCurveResolution(d->curveResolution);
+    Vc::int_v vIntCurveResolution(d->curveResolution);
+
+    Vc::float_v vXLimit(d->fadeMaker.xLimit());
+    Vc::float_v vYLimit(d->fadeMaker.yLimit());
+    Vc::float_v vXFadeLimitStart(d->fadeMaker.xFadeLimitStart());
+    Vc::float_v vYFadeLimitStart(d->fadeMaker.yFadeLimitStart());
+    Vc::float_v vXFadeCoeff(d->fadeMaker.xFadeCoeff());
+    Vc::float_v vYFadeCoeff(d->fadeMaker.yFadeCoeff());
+
+    Vc::float_v vOne(1.0f);
+    Vc::float_v vZero(Vc::Zero);
+    Vc::float_v vHalf(0.5f);
+
+    for (int i=0; i < width; i+= Vc::float_v::Size){
+
+        Vc::float_v x_ = currentIndices - vCenterX;
+
+        Vc::float_v xr = Vc::abs(x_ * vCosa - vSinaY_);
+        Vc::float_v yr = Vc::abs(x_ * vSina + vCosaY_);
+
+        // the pixels outside the mask are overwritten below, but
+        // their curve indexes must stay inside the curve as well
+        Vc::float_v nxr = Vc::min(xr * vXCoeff, vOne);
+        Vc::float_v nyr = Vc::min(yr * vYCoeff, vOne);
+
+        // qRound() for positive values
+        Vc::int_v sIndex(nxr * vCurveResolution + vHalf);
+        Vc::int_v tIndex(nyr * vCurveResolution + vHalf);
+
+        Vc::int_v sIndexInverted = vIntCurveResolution - sIndex;
+        Vc::int_v tIndexInverted = vIntCurveResolution - tIndex;
+
+        Vc::float_v curveS, curveT, curveSInverted, curveTInverted;
+        curveS.gather(curveData, sIndex);
+        curveT.gather(curveData, tIndex);
+        curveSInverted.gather(curveData, sIndexInverted);
+        curveTInverted.gather(curveData, tIndexInverted);
+
+        Vc::float_v blend = curveS * (vOne - curveSInverted) * curveT * (vOne - curveTInverted);
+        Vc::float_v vFade = vOne - blend;
+
+        if (useSmoothing) {
+            Vc::float_m xFadeMask = xr > vXFadeLimitStart;
+            Vc::float_m yFadeMask = yr > vYFadeLimitStart;
+
+            vFade(xFadeMask) = vFade + (vOne - vFade) * (xr - vXFadeLimitStart) * vXFadeCoeff;
+            vFade(yFadeMask) = vFade + (vOne - vFade) * (yr - vYFadeLimitStart) * vYFadeCoeff;
+        }
+
+        vFade((xr > vXLimit) || (yr > vYLimit)) = vOne;
+
+        vFade = Vc::max(vZero, Vc::min(vFade, vOne));
+
+        vFade.store(bufferPointer);
+        currentIndices = currentIndices + increment;
+
+        bufferPointer += Vc::float_v::Size;
+    }
+}
+
 #endif /* defined HAVE_VC */
@@ -34,6 +34,9 @@
 #include <QRect>
 #include <QString>
 #include <QVector>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrentMap>
 
 #include <kis_debug.h>
 #include <klocalizedstring.h>
@@ -49,6 +52,8 @@
 #include "kis_types.h"
 
 #include "kis_selection.h"
+#include "kis_update_job_item.h"
+#include "tiles3/kis_tile_data.h"
 
 #include "kis_convolution_worker.h"
 #include "kis_convolution_worker_spatial.h"
@@ -88,29 +93,161 @@ KisConvolutionWorker<factory>* KisConvolutionPainter::createWorker(const KisConv
     return worker;
 }
 
+namespace {
+
+/**
+ * The painter is usually called by the filters that already run in
+ * the threads of an updater context (or of the global thread pool),
+ * so the cores may be busy with the other jobs. Don't split the area
+ * into more bands than there are idle cores plus the calling thread,
+ * which convolves one of the bands itself.
+ */
+int availableThreadCount(int requestedThreadCount)
+{
+    QThreadPool *pool = QThreadPool::globalInstance();
+
+    const int idlePoolThreads = pool->maxThreadCount() - pool->activeThreadCount();
+    const int idleCores = QThread::idealThreadCount() - KisUpdateJobItem::numRunningJobs();
+
+    return qBound(1, qMin(idlePoolThreads, idleCores) + 1, requestedThreadCount);
+}
+
+template<class factory>
+struct ConvolutionJob {
+    KisConvolutionWorker<factory> *worker;
+    QPoint srcPos;
+    QPoint dstPos;
+    QSize areaSize;
+};
+
+template<class factory>
+struct ExecuteConvolutionJobFunctor {
+    typedef void result_type;
+
+    ExecuteConvolutionJobFunctor(const KisConvolutionKernelSP kernel,
+                                 const KisPaintDeviceSP src,
+                                 const QRect &dataRect)
+        : m_kernel(kernel), m_src(src), m_dataRect(dataRect) {}
+
+    void operator() (const ConvolutionJob<factory> &job) {
+        job.worker->execute(m_kernel, m_src, job.srcPos, job.dstPos, job.areaSize, m_dataRect);
+    }
+
+    KisConvolutionKernelSP m_kernel;
+    KisPaintDeviceSP m_src;
+    QRect m_dataRect;
+};
+
+}
+
+template<class factory>
+void KisConvolutionPainter::executeWorkers(const KisConvolutionKernelSP kernel, const KisPaintDeviceSP src,
+                                           QPoint srcPos, QPoint dstPos, QSize areaSize,
+                                           const QRect &dataRect)
+{
+    const int tileHeight = KisTileData::HEIGHT;
+    const int threadCount = availableThreadCount(m_threadCount);
+
+    int bandHeight = (areaSize.height() + threadCount - 1) / threadCount;
+    bandHeight = qMax(1, (bandHeight + tileHeight - 1) / tileHeight) * tileHeight;
+
+    if (threadCount <= 1 || areaSize.height() <= bandHeight) {
+        KisConvolutionWorker<factory> *worker;
+        worker = createWorker<factory>(kernel, this, progressUpdater());
+        worker->setThreadCount(threadCount);
+        worker->execute(kernel, src, srcPos, dstPos, areaSize, dataRect);
+        delete worker;
+        return;
+    }
+
+    /**
+     * The workers read pixels from the neighbouring bands, so for
+     * the in-place convolution they must read them from a snapshot
+     * taken before any of the bands is written
+     */
+    KisPaintDeviceSP srcDevice = src;
+    if (src == device()) {
+        srcDevice = new KisPaintDevice(*src);
+    }
+
+    QVector<ConvolutionJob<factory> > jobs;
+    KisConvolutionBandsProgress bandsProgress(progressUpdater());
+
+    const int areaBottom = dstPos.y() + areaSize.height() - 1;
+    int bandTop = dstPos.y();
+
+    while (bandTop <= areaBottom) {
+        int tileOffset = bandTop % tileHeight;
+        if (tileOffset < 0) tileOffset += tileHeight;
+
+        // the bands never share a destination tile
+        const int bandBottom = qMin(bandTop - tileOffset + bandHeight - 1, areaBottom);
+        const int offset = bandTop - dstPos.y();
+
+        ConvolutionJob<factory> job;
+        job.worker = createWorker<factory>(kernel, this, 0);
+        job.srcPos = srcPos + QPoint(0, offset);
+        job.dstPos = dstPos + QPoint(0, offset);
+        job.areaSize = QSize(areaSize.width(), bandBottom - bandTop + 1);
+        job.worker->setBandsProgress(&bandsProgress,
+                                     bandsProgress.addBand(job.areaSize.height()));
+        jobs.append(job);
+
+        bandTop = bandBottom + 1;
+    }
+
+    if (progressUpdater()) {
+        progressUpdater()->setProgress(0);
+    }
+
+    QtConcurrent::blockingMap(jobs, ExecuteConvolutionJobFunctor<factory>(kernel, srcDevice, dataRect));
+
+    foreach (const ConvolutionJob<factory> &job, jobs) {
+        delete job.worker;
+    }
+
+    if (progressUpdater() && !progressUpdater()->interrupted()) {
+        progressUpdater()->setProgress(100);
+    }
+}
+
 
 KisConvolutionPainter::KisConvolutionPainter()
     : KisPainter(),
-      m_enginePreference(NONE)
+      m_enginePreference(NONE),
+      m_threadCount(1)
 {
 }
 
 KisConvolutionPainter::KisConvolutionPainter(KisPaintDeviceSP device)
     : KisPainter(device),
-      m_enginePreference(NONE)
+      m_enginePreference(NONE),
+      m_threadCount(1)
 {
 }
 
 KisConvolutionPainter::KisConvolutionPainter(KisPaintDeviceSP device, KisSelectionSP selection)
     : KisPainter(device, selection),
-      m_enginePreference(NONE)
+      m_enginePreference(NONE),
+      m_threadCount(1)
 {
 }
 
 KisConvolutionPainter::KisConvolutionPainter(KisPaintDeviceSP device, TestingEnginePreference enginePreference)
     : KisPainter(device),
-      m_enginePreference(enginePreference)
+      m_enginePreference(enginePreference),
+      m_threadCount(1)
+{
+}
+
+void KisConvolutionPainter::setThreadCount(int threadCount)
+{
+    m_threadCount = qMax(1, threadCount);
+}
+
+int KisConvolutionPainter::threadCount() const
 {
+    return m_threadCount;
 }
 
 void KisConvolutionPainter::applyMatrix(const KisConvolutionKernelSP kernel, const KisPaintDeviceSP src, QPoint srcPos, QPoint dstPos, QSize areaSize, KisConvolutionBorderOp borderOp)
@@ -142,19 +279,13 @@ void KisConvolutionPainter::applyMatrix(const KisConvolutionKernelSP kernel, con
          */
 
         if(dataRect.isValid()) {
-            KisConvolutionWorker<RepeatIteratorFactory> *worker;
-            worker = createWorker<RepeatIteratorFactory>(kernel, this, progressUpdater());
-            worker->execute(kernel, src, srcPos, dstPos, areaSize, dataRect);
-            delete worker;
+            executeWorkers<RepeatIteratorFactory>(kernel, src, srcPos, dstPos, areaSize, dataRect);
         }
         break;
     }
     case BORDER_IGNORE:
     default: {
-        KisConvolutionWorker<StandardIteratorFactory> *worker;
-        worker = createWorker<StandardIteratorFactory>(kernel, this, progressUpdater());
-        worker->execute(kernel, src, srcPos, dstPos, areaSize, QRect());
-        delete worker;
+        executeWorkers<StandardIteratorFactory>(kernel, src, srcPos, dstPos, areaSize, QRect());
     }
     }
 }
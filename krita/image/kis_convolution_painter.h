@@ -69,6 +69,30 @@ public:
     void applyMatrix(const KisConvolutionKernelSP kernel, const KisPaintDeviceSP src, QPoint srcPos, QPoint dstPos, QSize areaSize,
                      KisConvolutionBorderOp borderOp = BORDER_REPEAT);
 
+    /**
+     * Set the number of threads applyMatrix() may use. The destination
+     * area is split into horizontal bands aligned to the tile grid and
+     * every band is convolved by its own worker. If the area is too
+     * small to be split, the FFT worker transforms the channels in
+     * parallel instead. The default value is 1.
+     *
+     * The number of threads is limited by the idle cores left by the
+     * jobs of the updater contexts and the global thread pool, so the
+     * painter can be used by the filters running in these threads.
+     * The progress of the bands is reported to the progress updater
+     * of the painter and every band stops when it is cancelled.
+     *
+     * When the source and the destination devices are the same, the
+     * bands read the source pixels from a copy-on-write snapshot of
+     * the device, so they never see the results of each other.
+     */
+    void setThreadCount(int threadCount);
+
+    /**
+     * \see setThreadCount()
+     */
+    int threadCount() const;
+
 protected:
     friend class KisConvolutionPainterTest;
     enum TestingEnginePreference {
@@ -87,7 +111,13 @@ private:
                                                     KisPainter *painter,
                                                     KoUpdater *progress);
 
+    template<class factory>
+        void executeWorkers(const KisConvolutionKernelSP kernel, const KisPaintDeviceSP src,
+                            QPoint srcPos, QPoint dstPos, QSize areaSize,
+                            const QRect &dataRect);
+
 private:
     TestingEnginePreference m_enginePreference;
+    int m_threadCount;
 };
 #endif //KIS_CONVOLUTION_PAINTER_H_
@@ -27,6 +27,9 @@
 #include "kis_repeat_iterators_pixel.h"
 #include "kis_painter.h"
 #include <QBitArray>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QVector>
 
 struct StandardIteratorFactory {
     typedef KisHLineIteratorSP HLineIterator;
@@ -66,6 +69,64 @@ struct RepeatIteratorFactory {
     }
 };
 
+/**
+ * Collects the progress of the workers convolving the bands of the
+ * same area in parallel and reports the progress of the whole area
+ * to the updater of the painter. The cancellation of the painter is
+ * forwarded to every band through it as well.
+ */
+class KisConvolutionBandsProgress
+{
+public:
+    KisConvolutionBandsProgress(KoUpdater *progress)
+        : m_progress(progress),
+          m_totalWeight(0)
+    {
+    }
+
+    /**
+     * Registers a band, whose share in the total progress is
+     * proportional to \p weight. Should be called before the
+     * workers are started.
+     *
+     * \return the index of the band
+     */
+    int addBand(int weight)
+    {
+        m_bandProgress.append(0);
+        m_bandWeights.append(weight);
+        m_totalWeight += weight;
+        return m_bandProgress.size() - 1;
+    }
+
+    void setProgress(int band, int percent)
+    {
+        if (!m_progress) return;
+
+        QMutexLocker locker(&m_mutex);
+        m_bandProgress[band] = percent;
+
+        qint64 weightedProgress = 0;
+        for (int i = 0; i < m_bandProgress.size(); i++) {
+            weightedProgress += qint64(m_bandProgress[i]) * m_bandWeights[i];
+        }
+
+        m_progress->setProgress(m_totalWeight ? weightedProgress / m_totalWeight : 100);
+    }
+
+    bool interrupted() const
+    {
+        return m_progress && m_progress->interrupted();
+    }
+
+private:
+    KoUpdater *m_progress;
+    QMutex m_mutex;
+    QVector<int> m_bandProgress;
+    QVector<int> m_bandWeights;
+    qint64 m_totalWeight;
+};
+
 template <class _IteratorFactory_>
 class KisConvolutionWorker
 {
@@ -74,6 +135,10 @@ public:
     {
         m_painter = painter;
         m_progress = progress;
+        m_bandsProgress = 0;
+        m_band = -1;
+        m_lastProgress = -1;
+        m_threadCount = 1;
     }
 
     virtual ~KisConvolutionWorker()
@@ -82,6 +147,51 @@ public:
 
     virtual void execute(const KisConvolutionKernelSP kernel, const KisPaintDeviceSP src, QPoint srcPos, QPoint dstPos, QSize areaSize, const QRect& dataRect) = 0;
 
+    /**
+     * The number of threads the worker may use internally
+     * inside a single execute() call
+     */
+    void setThreadCount(int threadCount)
+    {
+        m_threadCount = qMax(1, threadCount);
+    }
+
+    /**
+     * Report the progress and check for the cancellation through
+     * \p progress instead of the updater passed to the constructor.
+     * Used when the worker convolves one of the bands of the area.
+     */
+    void setBandsProgress(KisConvolutionBandsProgress *progress, int band)
+    {
+        m_bandsProgress = progress;
+        m_band = band;
+    }
+
+protected:
+    bool hasProgress() const
+    {
+        return m_progress || m_bandsProgress;
+    }
+
+    void reportProgress(int percent)
+    {
+        if (percent == m_lastProgress) return;
+        m_lastProgress = percent;
+
+        if (m_bandsProgress) {
+            m_bandsProgress->setProgress(m_band, percent);
+        } else if (m_progress) {
+            m_progress->setProgress(percent);
+        }
+    }
+
+    bool progressInterrupted() const
+    {
+        return m_bandsProgress ?
+            m_bandsProgress->interrupted() :
+            m_progress && m_progress->interrupted();
+    }
+
 protected:
     QList<KoChannelInfo *> convolvableChannelList(const KisPaintDeviceSP src)
     {
@@ -105,6 +215,10 @@ protected:
 protected:
     KisPainter* m_painter;
     KoUpdater* m_progress;
+    KisConvolutionBandsProgress *m_bandsProgress;
+    int m_band;
+    int m_lastProgress;
+    int m_threadCount;
 };
 
 
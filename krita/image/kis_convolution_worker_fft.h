@@ -32,6 +32,7 @@
 #include <QTextStream>
 #include <QFile>
 #include <QDir>
+#include <QtConcurrentMap>
 
 #include <fftw3.h>
 
@@ -140,17 +141,29 @@ public:
         addToProgress(progressPerFFT);
         if (isInterrupted()) return;
 
-        for (quint32 k = 0; k < m_channelFFT.size(); ++k)
-        {
-            fftw_execute_dft_r2c(fftwPlanForward, (double*)(m_channelFFT[k]), m_channelFFT[k]);
-            addToProgress(progressPerFFT);
+        if (this->m_threadCount > 1 && m_channelFFT.size() > 1) {
+            /**
+             * The plans are shared by all the channels, which is safe,
+             * because fftw_execute_dft_*() functions are reentrant
+             */
+            QtConcurrent::blockingMap(m_channelFFT,
+                                      ConvolveChannelFunctor(this, fftwPlanForward, fftwPlanBackward));
+
+            addToProgress(2 * progressPerFFT * m_channelFFT.size());
             if (isInterrupted()) return;
+        } else {
+            for (quint32 k = 0; k < m_channelFFT.size(); ++k)
+            {
+                fftw_execute_dft_r2c(fftwPlanForward, (double*)(m_channelFFT[k]), m_channelFFT[k]);
+                addToProgress(progressPerFFT);
+                if (isInterrupted()) return;
 
-            fftMultiply(m_channelFFT[k], m_kernelFFT);
+                fftMultiply(m_channelFFT[k], m_kernelFFT);
 
-            fftw_execute_dft_c2r(fftwPlanBackward, m_channelFFT[k], (double*)m_channelFFT[k]);
-            addToProgress(progressPerFFT);
-            if (isInterrupted()) return;
+                fftw_execute_dft_c2r(fftwPlanBackward, m_channelFFT[k], (double*)m_channelFFT[k]);
+                addToProgress(progressPerFFT);
+                if (isInterrupted()) return;
+            }
         }
 
         KisConvolutionWorkerFFTLock::fftwMutex.lock();
@@ -167,6 +180,29 @@ public:
         cleanUp();
     }
 
+    struct ConvolveChannelFunctor {
+        typedef void result_type;
+
+        ConvolveChannelFunctor(KisConvolutionWorkerFFT *worker,
+                               fftw_plan planForward,
+                               fftw_plan planBackward)
+            : m_worker(worker),
+              m_planForward(planForward),
+              m_planBackward(planBackward)
+        {
+        }
+
+        void operator() (fftw_complex *channel) {
+            fftw_execute_dft_r2c(m_planForward, (double*)channel, channel);
+            m_worker->fftMultiply(channel, m_worker->m_kernelFFT);
+            fftw_execute_dft_c2r(m_planBackward, channel, (double*)channel);
+        }
+
+        KisConvolutionWorkerFFT *m_worker;
+        fftw_plan m_planForward;
+        fftw_plan m_planBackward;
+    };
+
     struct FFTInfo {
         FFTInfo(qreal _fftScale,
                 QList<KoChannelInfo*> _convChannelList,
@@ -472,14 +508,12 @@ private:
     {
         m_currentProgress += amount;
 
-        if (this->m_progress) {
-            this->m_progress->setProgress((int)m_currentProgress);
-        }
+        this->reportProgress((int)m_currentProgress);
     }
 
     bool isInterrupted()
     {
-        if (this->m_progress && this->m_progress->interrupted()) {
+        if (this->progressInterrupted()) {
             cleanUp();
             return true;
         }
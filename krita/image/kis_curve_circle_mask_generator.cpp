@@ -18,6 +18,16 @@
 
 #include <cmath>
 
+#include <config-vc.h>
+#ifdef HAVE_VC
+#if defined(__clang__)
+#pragma GCC diagnostic ignored "-Wundef"
+#pragma GCC diagnostic ignored "-Wlocal-type-template-args"
+#endif
+#include <Vc/Vc>
+#include <Vc/IO>
+#endif
+
 #include <QDomDocument>
 #include <QVector>
 #include <QPointF>
@@ -28,27 +38,10 @@
 
 #include "kis_base_mask_generator.h"
 #include "kis_curve_circle_mask_generator.h"
+#include "kis_curve_circle_mask_generator_p.h"
 #include "kis_cubic_curve.h"
-#include "kis_antialiasing_fade_maker.h"
-
-
+#include "kis_brush_mask_applicator_factories.h"
 
-struct Q_DECL_HIDDEN KisCurveCircleMaskGenerator::Private
-{
-    Private(bool enableAntialiasing)
-        : fadeMaker(*this, enableAntialiasing)
-    {
-    }
-
-    qreal xcoef, ycoef;
-    qreal curveResolution;
-    QVector<qreal> curveData;
-    QList<QPointF> curvePoints;
-    bool dirty;
-
-    KisAntialiasingFadeMaker1D<Private> fadeMaker;
-    inline quint8 value(qreal dist) const;
-};
 
 KisCurveCircleMaskGenerator::KisCurveCircleMaskGenerator(qreal diameter, qreal ratio, qreal fh, qreal fv, int spikes, const KisCubicCurve &curve, bool antialiasEdges)
     : KisMaskGenerator(diameter, ratio, fh, fv, spikes, antialiasEdges, CIRCLE, SoftId), d(new Private(antialiasEdges))
@@ -56,11 +49,14 @@ KisCurveCircleMaskGenerator::KisCurveCircleMaskGenerator(qreal diameter, qreal r
     // here we set resolution for the maximum size of the brush!
     d->curveResolution = qRound(qMax(width(), height()) * OVERSAMPLING);
     d->curveData = curve.floatTransfer(d->curveResolution + 2);
+    d->updateCurveDataFloat();
     d->curvePoints = curve.points();
     setCurveString(curve.toString());
     d->dirty = false;
 
     setScale(1.0, 1.0);
+
+    d->applicator = createOptimizedClass<MaskApplicatorFactory<KisCurveCircleMaskGenerator, KisBrushMaskVectorApplicator> >(this);
 }
 
 void KisCurveCircleMaskGenerator::setScale(qreal scaleX, qreal scaleY)
@@ -78,14 +74,33 @@ void KisCurveCircleMaskGenerator::setScale(qreal scaleX, qreal scaleY)
 
 KisCurveCircleMaskGenerator::~KisCurveCircleMaskGenerator()
 {
+    delete d->applicator;
     delete d;
 }
 
+bool KisCurveCircleMaskGenerator::shouldVectorize() const
+{
+    return !shouldSupersample() && spikes() == 2;
+}
+
+KisBrushMaskApplicatorBase* KisCurveCircleMaskGenerator::applicator()
+{
+    return d->applicator;
+}
+
 bool KisCurveCircleMaskGenerator::shouldSupersample() const
 {
     return effectiveSrcWidth() < 10 || effectiveSrcHeight() < 10;
 }
 
+void KisCurveCircleMaskGenerator::Private::updateCurveDataFloat()
+{
+    curveDataFloat.resize(curveData.size());
+    for (int i = 0; i < curveData.size(); i++) {
+        curveDataFloat[i] = curveData[i];
+    }
+}
+
 inline quint8 KisCurveCircleMaskGenerator::Private::value(qreal dist) const
 {
     qreal distance = dist * curveResolution;
@@ -140,6 +155,7 @@ void KisCurveCircleMaskGenerator::setSoftness(qreal softness)
     d->dirty = true;
     KisMaskGenerator::setSoftness(softness);
     KisCurveCircleMaskGenerator::transformCurveForSoftness(softness,d->curvePoints, d->curveResolution+2, d->curveData);
+    d->updateCurveDataFloat();
     d->dirty = false;
 }
 
@@ -38,7 +38,8 @@ class QPointF;
  */
 class KRITAIMAGE_EXPORT KisCurveCircleMaskGenerator : public KisMaskGenerator
 {
-
+public:
+    struct FastRowProcessor;
 public:
 
     KisCurveCircleMaskGenerator(qreal radius, qreal ratio, qreal fh, qreal fv, int spikes,const KisCubicCurve& curve, bool antialiasEdges);
@@ -46,6 +47,10 @@ public:
 
     virtual quint8 valueAt(qreal x, qreal y) const;
 
+    virtual bool shouldVectorize() const;
+
+    KisBrushMaskApplicatorBase* applicator();
+
     void setScale(qreal scaleX, qreal scaleY);
 
     bool shouldSupersample() const;
@@ -0,0 +1,49 @@
+/*
+ *  Copyright (c) 2015 Calligra developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef _KIS_CURVE_CIRCLE_MASK_GENERATOR_P_H_
+#define _KIS_CURVE_CIRCLE_MASK_GENERATOR_P_H_
+
+#include <QVector>
+#include <QList>
+#include <QPointF>
+
+#include "kis_antialiasing_fade_maker.h"
+
+struct Q_DECL_HIDDEN KisCurveCircleMaskGenerator::Private
+{
+    Private(bool enableAntialiasing)
+        : fadeMaker(*this, enableAntialiasing)
+    {
+    }
+
+    qreal xcoef, ycoef;
+    qreal curveResolution;
+    QVector<qreal> curveData;
+    QVector<float> curveDataFloat; // a copy of curveData for the vectorized gathering
+    QList<QPointF> curvePoints;
+    bool dirty;
+
+    KisAntialiasingFadeMaker1D<Private> fadeMaker;
+    inline quint8 value(qreal dist) const;
+    void updateCurveDataFloat();
+
+    KisBrushMaskApplicatorBase *applicator;
+};
+
+#endif /* _KIS_CURVE_CIRCLE_MASK_GENERATOR_P_H_ */
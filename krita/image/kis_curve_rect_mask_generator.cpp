@@ -18,46 +18,40 @@
 
 #include <cmath>
 
+#include <config-vc.h>
+#ifdef HAVE_VC
+#if defined(__clang__)
+#pragma GCC diagnostic ignored "-Wundef"
+#pragma GCC diagnostic ignored "-Wlocal-type-template-args"
+#endif
+#include <Vc/Vc>
+#include <Vc/IO>
+#endif
+
 #include <QDomDocument>
 #include <QVector>
 #include <QPointF>
 
 #include <kis_fast_math.h>
 #include "kis_curve_rect_mask_generator.h"
+#include "kis_curve_rect_mask_generator_p.h"
 #include "kis_cubic_curve.h"
-#include "kis_antialiasing_fade_maker.h"
-
-
-struct Q_DECL_HIDDEN KisCurveRectangleMaskGenerator::Private
-{
-    Private(bool enableAntialiasing)
-        : fadeMaker(*this, enableAntialiasing)
-    {
-    }
+#include "kis_brush_mask_applicator_factories.h"
 
-    QVector<qreal> curveData;
-    QList<QPointF> curvePoints;
-    int curveResolution;
-    bool dirty;
-
-    qreal xcoeff;
-    qreal ycoeff;
-
-    KisAntialiasingFadeMaker2D<Private> fadeMaker;
-
-    quint8 value(qreal xr, qreal yr) const;
-};
 
 KisCurveRectangleMaskGenerator::KisCurveRectangleMaskGenerator(qreal diameter, qreal ratio, qreal fh, qreal fv, int spikes, const KisCubicCurve &curve, bool antialiasEdges)
     : KisMaskGenerator(diameter, ratio, fh, fv, spikes, antialiasEdges, RECTANGLE, SoftId), d(new Private(antialiasEdges))
 {
     d->curveResolution = qRound( qMax(width(),height()) * OVERSAMPLING);
     d->curveData = curve.floatTransfer( d->curveResolution + 1);
+    d->updateCurveDataFloat();
     d->curvePoints = curve.points();
     setCurveString(curve.toString());
     d->dirty = false;
 
     setScale(1.0, 1.0);
+
+    d->applicator = createOptimizedClass<MaskApplicatorFactory<KisCurveRectangleMaskGenerator, KisBrushMaskVectorApplicator> >(this);
 }
 
 void KisCurveRectangleMaskGenerator::setScale(qreal scaleX, qreal scaleY)
@@ -75,9 +69,28 @@ void KisCurveRectangleMaskGenerator::setScale(qreal scaleX, qreal scaleY)
 
 KisCurveRectangleMaskGenerator::~KisCurveRectangleMaskGenerator()
 {
+    delete d->applicator;
     delete d;
 }
 
+bool KisCurveRectangleMaskGenerator::shouldVectorize() const
+{
+    return !KisMaskGenerator::d->empty && spikes() == 2;
+}
+
+KisBrushMaskApplicatorBase* KisCurveRectangleMaskGenerator::applicator()
+{
+    return d->applicator;
+}
+
+void KisCurveRectangleMaskGenerator::Private::updateCurveDataFloat()
+{
+    curveDataFloat.resize(curveData.size());
+    for (int i = 0; i < curveData.size(); i++) {
+        curveDataFloat[i] = curveData[i];
+    }
+}
+
 quint8 KisCurveRectangleMaskGenerator::Private::value(qreal xr, qreal yr) const
 {
     xr = qAbs(xr) * xcoeff;
@@ -140,6 +153,7 @@ void KisCurveRectangleMaskGenerator::setSoftness(qreal softness)
     d->dirty = true;
     KisMaskGenerator::setSoftness(softness);
     KisCurveCircleMaskGenerator::transformCurveForSoftness(softness,d->curvePoints, d->curveResolution + 1, d->curveData);
+    d->updateCurveDataFloat();
     d->dirty = false;
 }
 
@@ -91,6 +91,7 @@ void KisFillPainter::initFillPainter()
     m_feather = 0;
     m_useCompositioning = false;
     m_threshold = 0;
+    m_threadCount = 1;
 }
 
 void KisFillPainter::fillSelection(const QRect &rc, const KoColor &color)
@@ -212,6 +213,7 @@ void KisFillPainter::fillColor(int startX, int startY, KisPaintDeviceSP sourceDe
 
         KisScanlineFill gc(device(), startPoint, fillBoundsRect);
         gc.setThreshold(m_threshold);
+        gc.setThreadCount(m_threadCount);
         gc.fillColor(paintColor());
 
     } else {
@@ -308,6 +310,7 @@ KisSelectionSP KisFillPainter::createFloodSelection(int startX, int startY, KisP
 
     KisScanlineFill gc(sourceDevice, startPoint, fillBoundsRect);
     gc.setThreshold(m_threshold);
+    gc.setThreadCount(m_threadCount);
     gc.fillSelection(pixelSelection);
 
     if (m_sizemod > 0) {
@@ -168,6 +168,21 @@ public:
         return m_threshold;
     }
 
+    /**
+     * Set the number of threads used by the flood fill operations. The
+     * fill area is split into tile-aligned horizontal bands which are
+     * filled concurrently. The default value is 1, which means the
+     * fill is done in the calling thread only.
+     */
+    void setThreadCount(int threadCount) {
+        m_threadCount = qMax(1, threadCount);
+    }
+
+    /** Returns the number of threads used by the flood fill operations */
+    int threadCount() const {
+        return m_threadCount;
+    }
+
     bool useCompositioning() const {
         return m_useCompositioning;
     }
@@ -228,6 +243,7 @@ private:
     int m_feather;
     int m_sizemod;
     int m_threshold;
+    int m_threadCount;
     int m_width, m_height;
     QRect m_rect;
     bool m_careForSelection;
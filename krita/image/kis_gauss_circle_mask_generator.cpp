@@ -19,6 +19,16 @@
 
 #include <cmath>
 
+#include <config-vc.h>
+#ifdef HAVE_VC
+#if defined(__clang__)
+#pragma GCC diagnostic ignored "-Wundef"
+#pragma GCC diagnostic ignored "-Wlocal-type-template-args"
+#endif
+#include <Vc/Vc>
+#include <Vc/IO>
+#endif
+
 #include <QDomDocument>
 #include <QVector>
 #include <QPointF>
@@ -29,7 +39,8 @@
 
 #include "kis_base_mask_generator.h"
 #include "kis_gauss_circle_mask_generator.h"
-#include "kis_antialiasing_fade_maker.h"
+#include "kis_gauss_circle_mask_generator_p.h"
+#include "kis_brush_mask_applicator_factories.h"
 
 #define M_SQRT_2 1.41421356237309504880
 
@@ -40,21 +51,6 @@
 #endif
 
 
-struct Q_DECL_HIDDEN KisGaussCircleMaskGenerator::Private
-{
-    Private(bool enableAntialiasing)
-        : fadeMaker(*this, enableAntialiasing)
-    {
-    }
-
-    qreal ycoef;
-    qreal fade;
-    qreal center, distfactor, alphafactor;
-    KisAntialiasingFadeMaker1D<Private> fadeMaker;
-
-    inline quint8 value(qreal dist) const;
-};
-
 KisGaussCircleMaskGenerator::KisGaussCircleMaskGenerator(qreal diameter, qreal ratio, qreal fh, qreal fv, int spikes, bool antialiasEdges)
     : KisMaskGenerator(diameter, ratio, fh, fv, spikes, antialiasEdges, CIRCLE, GaussId), d(new Private(antialiasEdges))
 {
@@ -64,6 +60,8 @@ KisGaussCircleMaskGenerator::KisGaussCircleMaskGenerator(qreal diameter, qreal r
     else if (d->fade == 1.0) d->fade = 1.0 - 1e-6; // would become undefined for fade == 0 or 1
     d->center = (2.5 * (6761.0*d->fade-10000.0))/(M_SQRT_2*6761.0*d->fade);
     d->alphafactor = 255.0 / (2.0 * erf(d->center));
+
+    d->applicator = createOptimizedClass<MaskApplicatorFactory<KisGaussCircleMaskGenerator, KisBrushMaskVectorApplicator> >(this);
 }
 
 void KisGaussCircleMaskGenerator::setScale(qreal scaleX, qreal scaleY)
@@ -76,9 +74,20 @@ void KisGaussCircleMaskGenerator::setScale(qreal scaleX, qreal scaleY)
 
 KisGaussCircleMaskGenerator::~KisGaussCircleMaskGenerator()
 {
+    delete d->applicator;
     delete d;
 }
 
+bool KisGaussCircleMaskGenerator::shouldVectorize() const
+{
+    return spikes() == 2;
+}
+
+KisBrushMaskApplicatorBase* KisGaussCircleMaskGenerator::applicator()
+{
+    return d->applicator;
+}
+
 inline quint8 KisGaussCircleMaskGenerator::Private::value(qreal dist) const
 {
     dist *= distfactor;
@@ -30,7 +30,8 @@
  */
 class KRITAIMAGE_EXPORT KisGaussCircleMaskGenerator : public KisMaskGenerator
 {
-
+public:
+    struct FastRowProcessor;
 public:
 
     KisGaussCircleMaskGenerator(qreal diameter, qreal ratio, qreal fh, qreal fv, int spikes, bool antialiasEdges);
@@ -38,6 +39,10 @@ public:
 
     virtual quint8 valueAt(qreal x, qreal y) const;
 
+    virtual bool shouldVectorize() const;
+
+    KisBrushMaskApplicatorBase* applicator();
+
     void setScale(qreal scaleX, qreal scaleY);
 
 private:
@@ -18,6 +18,17 @@
  */
 
 #include <cmath>
+
+#include <config-vc.h>
+#ifdef HAVE_VC
+#if defined(__clang__)
+#pragma GCC diagnostic ignored "-Wundef"
+#pragma GCC diagnostic ignored "-Wlocal-type-template-args"
+#endif
+#include <Vc/Vc>
+#include <Vc/IO>
+#endif
+
 #include <algorithm>
 
 #include <QDomDocument>
@@ -30,7 +41,8 @@
 
 #include "kis_base_mask_generator.h"
 #include "kis_gauss_rect_mask_generator.h"
-#include "kis_antialiasing_fade_maker.h"
+#include "kis_gauss_rect_mask_generator_p.h"
+#include "kis_brush_mask_applicator_factories.h"
 
 #define M_SQRT_2 1.41421356237309504880
 
@@ -40,26 +52,13 @@
 #define erf(x) boost::math::erf(x)
 #endif
 
-struct Q_DECL_HIDDEN KisGaussRectangleMaskGenerator::Private
-{
-    Private(bool enableAntialiasing)
-        : fadeMaker(*this, enableAntialiasing)
-    {
-    }
-
-    qreal xfade, yfade;
-    qreal halfWidth, halfHeight;
-    qreal alphafactor;
-
-    KisAntialiasingFadeMaker2D <Private> fadeMaker;
-
-    inline quint8 value(qreal x, qreal y) const;
-};
 
 KisGaussRectangleMaskGenerator::KisGaussRectangleMaskGenerator(qreal diameter, qreal ratio, qreal fh, qreal fv, int spikes, bool antialiasEdges)
     : KisMaskGenerator(diameter, ratio, fh, fv, spikes, antialiasEdges, RECTANGLE, GaussId), d(new Private(antialiasEdges))
 {
     setScale(1.0, 1.0);
+
+    d->applicator = createOptimizedClass<MaskApplicatorFactory<KisGaussRectangleMaskGenerator, KisBrushMaskVectorApplicator> >(this);
 }
 
 void KisGaussRectangleMaskGenerator::setScale(qreal scaleX, qreal scaleY)
@@ -82,9 +81,20 @@ void KisGaussRectangleMaskGenerator::setScale(qreal scaleX, qreal scaleY)
 
 KisGaussRectangleMaskGenerator::~KisGaussRectangleMaskGenerator()
 {
+    delete d->applicator;
     delete d;
 }
 
+bool KisGaussRectangleMaskGenerator::shouldVectorize() const
+{
+    return spikes() == 2;
+}
+
+KisBrushMaskApplicatorBase* KisGaussRectangleMaskGenerator::applicator()
+{
+    return d->applicator;
+}
+
 inline quint8 KisGaussRectangleMaskGenerator::Private::value(qreal xr, qreal yr) const
 {
     return (quint8) 255 - (quint8) (alphafactor * (erf((halfWidth + xr) * xfade) + erf((halfWidth - xr) * xfade))
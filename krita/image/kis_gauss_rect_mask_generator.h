@@ -30,13 +30,18 @@
  */
 class KRITAIMAGE_EXPORT KisGaussRectangleMaskGenerator : public KisMaskGenerator
 {
-
+public:
+    struct FastRowProcessor;
 public:
 
     KisGaussRectangleMaskGenerator(qreal diameter, qreal ratio, qreal fh, qreal fv, int spikes, bool antialiasEdges);
     virtual ~KisGaussRectangleMaskGenerator();
 
     virtual quint8 valueAt(qreal x, qreal y) const;
+
+    virtual bool shouldVectorize() const;
+
+    KisBrushMaskApplicatorBase* applicator();
     void setScale(qreal scaleX, qreal scaleY);
 
 private:
@@ -20,6 +20,7 @@
 
 #include "kis_convolution_kernel.h"
 #include <kis_convolution_painter.h>
+#include <kis_image_config.h>
 
 
 qreal KisGaussianKernel::sigmaFromRadius(qreal radius)
@@ -104,6 +105,7 @@ void KisGaussianKernel::applyGaussian(KisPaintDeviceSP device,
                                       KoUpdater *progressUpdater)
 {
     QPoint srcTopLeft = rect.topLeft();
+    const int threadCount = KisImageConfig().maxNumberOfThreads();
 
     if (xRadius > 0.0 && yRadius > 0.0) {
         KisPaintDeviceSP interm = new KisPaintDevice(device->colorSpace());
@@ -114,6 +116,7 @@ void KisGaussianKernel::applyGaussian(KisPaintDeviceSP device,
         qreal verticalCenter = qreal(kernelVertical->height()) / 2.0;
 
         KisConvolutionPainter horizPainter(interm);
+        horizPainter.setThreadCount(threadCount);
         horizPainter.setChannelFlags(channelFlags);
         horizPainter.setProgress(progressUpdater);
         horizPainter.applyMatrix(kernelHoriz, device,
@@ -123,12 +126,14 @@ void KisGaussianKernel::applyGaussian(KisPaintDeviceSP device,
 
 
         KisConvolutionPainter verticalPainter(device);
+        verticalPainter.setThreadCount(threadCount);
         verticalPainter.setChannelFlags(channelFlags);
         verticalPainter.setProgress(progressUpdater);
         verticalPainter.applyMatrix(kernelVertical, interm, srcTopLeft, srcTopLeft, rect.size(), BORDER_REPEAT);
 
     } else if (xRadius > 0.0) {
         KisConvolutionPainter painter(device);
+        painter.setThreadCount(threadCount);
         painter.setChannelFlags(channelFlags);
         painter.setProgress(progressUpdater);
 
@@ -137,6 +142,7 @@ void KisGaussianKernel::applyGaussian(KisPaintDeviceSP device,
 
     } else if (yRadius > 0.0) {
         KisConvolutionPainter painter(device);
+        painter.setThreadCount(threadCount);
         painter.setChannelFlags(channelFlags);
         painter.setProgress(progressUpdater);
 
@@ -166,6 +166,52 @@ void processGrid(ProcessCell &cellOp,
     }
 }
 
+/**
+ * A cell operation that only collects the grid points in the same
+ * order processGrid() visits them. Together with
+ * PrecalculatedTransformOp it lets the caller transform the points
+ * in any way it wants, e.g. on several threads.
+ */
+struct CollectGridPointsOp
+{
+    inline void processPoint(int col, int row,
+                             int prevCol, int prevRow,
+                             int colIndex, int rowIndex) {
+        Q_UNUSED(prevCol);
+        Q_UNUSED(prevRow);
+        Q_UNUSED(colIndex);
+        Q_UNUSED(rowIndex);
+
+        points << QPointF(col, row);
+    }
+
+    inline void nextLine() {
+    }
+
+    QVector<QPointF> points;
+};
+
+/**
+ * A forward transform that returns the points collected by
+ * CollectGridPointsOp and transformed beforehand
+ */
+struct PrecalculatedTransformOp
+{
+    PrecalculatedTransformOp(const QVector<QPointF> &transformedPoints)
+        : m_points(transformedPoints),
+          m_index(0)
+    {
+    }
+
+    inline QPointF operator() (const QPointF &pt) {
+        Q_UNUSED(pt);
+        return m_points[m_index++];
+    }
+
+    const QVector<QPointF> &m_points;
+    int m_index;
+};
+
 template <class ProcessPolygon, class ForwardTransform>
 void processGrid(ProcessPolygon &polygonOp, ForwardTransform &transformOp,
                  const QRect &srcBounds, const int pixelPrecision)
@@ -20,6 +20,8 @@
 #include "kis_histogram.h"
 
 #include <QVector>
+#include <QScopedPointer>
+#include <QtConcurrentMap>
 
 #include "kis_types.h"
 #include "kis_image.h"
@@ -28,6 +30,50 @@
 #include "KoColorSpace.h"
 #include "kis_debug.h"
 #include "kis_iterator_ng.h"
+#include "tiles3/kis_tile_data.h"
+
+
+namespace {
+
+/**
+ * The partial histograms are kept for blocks of 4x4 tiles, keeping
+ * them for every tile would take almost as much memory as the image
+ */
+const int blockWidth = 4 * KisTileData::WIDTH;
+const int blockHeight = 4 * KisTileData::HEIGHT;
+
+inline int divideFloor(int value, int divisor)
+{
+    return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+struct PartialHistogramJob {
+    QPair<int, int> index;
+    QRect rect;
+    KoHistogramProducerSP producer;
+};
+
+struct ProducePartialHistogramFunctor {
+    typedef void result_type;
+
+    ProducePartialHistogramFunctor(KisPaintDeviceSP device)
+        : m_device(device) {}
+
+    void operator() (const PartialHistogramJob &job) {
+        const KoColorSpace* cs = m_device->colorSpace();
+        KisSequentialConstIterator srcIt(m_device, job.rect);
+
+        int i;
+        do {
+            i = srcIt.nConseqPixels();
+            job.producer->addRegionToBin(srcIt.oldRawData(), 0, i, cs);
+        } while (srcIt.nextPixels(i));
+    }
+
+    KisPaintDeviceSP m_device;
+};
+
+}
 
 KisHistogram::KisHistogram(const KisPaintLayerSP layer,
                            KoHistogramProducerSP producer,
@@ -41,6 +87,8 @@ KisHistogram::KisHistogram(const KisPaintLayerSP layer,
     m_producer = producer;
     m_selection = false;
     m_channel = 0;
+    m_partialsViewFrom = 0.0;
+    m_partialsViewWidth = 0.0;
 
     updateHistogram();
 }
@@ -59,6 +107,8 @@ KisHistogram::KisHistogram(const KisPaintDeviceSP paintdev,
 
     m_selection = false;
     m_channel = 0;
+    m_partialsViewFrom = 0.0;
+    m_partialsViewWidth = 0.0;
 
     // TODO: Why does Krita crash when updateHistogram() is *not* called here?
     updateHistogram();
@@ -82,11 +132,19 @@ void KisHistogram::updateHistogram()
         return;
     }
 
-    KisSequentialConstIterator srcIt(m_paintDevice, m_bounds);
-    const KoColorSpace* cs = m_paintDevice->colorSpace();
-
     // Let the producer do it's work
     m_producer->clear();
+    m_partialHistograms.clear();
+
+    QScopedPointer<KoHistogramProducer> probe(m_producer->createEmptyCopy());
+    if (probe) {
+        updatePartialHistograms(m_bounds);
+        computeHistogram();
+        return;
+    }
+
+    KisSequentialConstIterator srcIt(m_paintDevice, m_bounds);
+    const KoColorSpace* cs = m_paintDevice->colorSpace();
     int i;
 
     // XXX: the original code depended on their being a selection mask in the iterator
@@ -102,6 +160,64 @@ void KisHistogram::updateHistogram()
     computeHistogram();
 }
 
+void KisHistogram::updateHistogram(const QRect &dirtyRect)
+{
+    if (m_partialHistograms.isEmpty() ||
+        m_producer->viewFrom() != m_partialsViewFrom ||
+        m_producer->viewWidth() != m_partialsViewWidth) {
+
+        updateHistogram();
+        return;
+    }
+
+    const QRect rc = dirtyRect & m_bounds;
+    if (!rc.isEmpty()) {
+        updatePartialHistograms(rc);
+    }
+
+    computeHistogram();
+}
+
+void KisHistogram::updatePartialHistograms(const QRect &rect)
+{
+    QVector<PartialHistogramJob> jobs;
+
+    const int firstCol = divideFloor(rect.left(), blockWidth);
+    const int lastCol = divideFloor(rect.right(), blockWidth);
+    const int firstRow = divideFloor(rect.top(), blockHeight);
+    const int lastRow = divideFloor(rect.bottom(), blockHeight);
+
+    for (int row = firstRow; row <= lastRow; row++) {
+        for (int col = firstCol; col <= lastCol; col++) {
+            const QRect blockRect(col * blockWidth, row * blockHeight, blockWidth, blockHeight);
+
+            PartialHistogramJob job;
+            job.index = BlockIndex(col, row);
+            job.rect = blockRect & m_bounds;
+            job.producer = KoHistogramProducerSP(m_producer->createEmptyCopy());
+
+            if (!job.rect.isEmpty()) {
+                jobs.append(job);
+            }
+        }
+    }
+
+    QtConcurrent::blockingMap(jobs, ProducePartialHistogramFunctor(m_paintDevice));
+
+    foreach (const PartialHistogramJob &job, jobs) {
+        KoHistogramProducerSP oldProducer = m_partialHistograms.value(job.index);
+        if (!oldProducer.isNull()) {
+            m_producer->removeBins(oldProducer.data());
+        }
+
+        m_producer->addBins(job.producer.data());
+        m_partialHistograms.insert(job.index, job.producer);
+    }
+
+    m_partialsViewFrom = m_producer->viewFrom();
+    m_partialsViewWidth = m_producer->viewWidth();
+}
+
 void KisHistogram::computeHistogram()
 {
     if (!m_producer) return;
@@ -21,6 +21,8 @@
 
 #include <QVector>
 #include <QRect>
+#include <QHash>
+#include <QPair>
 
 #include "KoHistogramProducer.h"
 
@@ -43,6 +45,11 @@ enum enumHistogramType {
  *
  * The calculations are done in the range 0 - 1, instead of the native range that a pixel
  * might have, so it's not always as precise as it could be. But you can't have it all...
+ *
+ * When the producer supports KoHistogramProducer::createEmptyCopy(), the bounds are split
+ * into blocks of several tiles, the partial histograms of the blocks are produced in
+ * parallel and kept, so updateHistogram(dirtyRect) recomputes only the blocks touched
+ * by the change.
  */
 class KRITAIMAGE_EXPORT KisHistogram : public KisShared
 {
@@ -118,6 +125,15 @@ public:
     /** Updates the information in the producer */
     void updateHistogram();
 
+    /**
+     * Updates the information in the producer after the pixels in
+     * \p dirtyRect have changed. Only the partial histograms of the
+     * blocks intersecting the rect are recomputed. Falls back to the
+     * full update if the view of the producer has changed since the
+     * last update.
+     */
+    void updateHistogram(const QRect &dirtyRect);
+
     /**
      * (Re)computes the mathematical information from the information currently in the producer.
      * Needs to be called when you change the selection and want to get that information
@@ -142,6 +158,7 @@ public:
     inline void setProducer(KoHistogramProducerSP producer) {
         m_channel = 0;
         m_producer = producer;
+        m_partialHistograms.clear();
     }
     inline void setChannel(qint32 channel) {
         Q_ASSERT(m_channel < m_completeCalculations.size());
@@ -178,6 +195,12 @@ private:
     QVector<Calculations> calculateForRange(double from, double to);
     Calculations calculateSingleRange(int channel, double from, double to);
 
+    /**
+     * Recomputes the partial histograms of the blocks intersecting
+     * \p rect in parallel and merges them into the producer
+     */
+    void updatePartialHistograms(const QRect &rect);
+
     const KisPaintDeviceSP m_paintDevice;
     QRect m_bounds;
     KoHistogramProducerSP m_producer;
@@ -188,6 +211,10 @@ private:
     bool m_selection;
 
     QVector<Calculations> m_completeCalculations, m_selectionCalculations;
+
+    typedef QPair<int, int> BlockIndex;
+    QHash<BlockIndex, KoHistogramProducerSP> m_partialHistograms;
+    qreal m_partialsViewFrom, m_partialsViewWidth;
 };
 
 
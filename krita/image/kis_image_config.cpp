@@ -119,6 +119,21 @@ void KisImageConfig::setSchedulerBalancingRatio(qreal value)
     m_config.writeEntry("schedulerBalancingRatio", value);
 }
 
+int KisImageConfig::maxNumberOfThreads(bool requestDefault) const
+{
+    /**
+     * The key is shared with KisConfig::maxNumberOfThreads()
+     */
+    return !requestDefault ?
+        m_config.readEntry("maxthreads", QThread::idealThreadCount()) :
+        QThread::idealThreadCount();
+}
+
+void KisImageConfig::setMaxNumberOfThreads(int value)
+{
+    m_config.writeEntry("maxthreads", value);
+}
+
 int KisImageConfig::maxSwapSize(bool requestDefault) const
 {
     return !requestDefault ?
@@ -150,6 +165,16 @@ void KisImageConfig::setSwapWindowSize(int value)
     m_config.writeEntry("swapWindowSize", value);
 }
 
+QString KisImageConfig::swapCompression() const
+{
+    return m_config.readEntry("swapCompression", "LZ4");
+}
+
+void KisImageConfig::setSwapCompression(const QString &value)
+{
+    m_config.writeEntry("swapCompression", value);
+}
+
 int KisImageConfig::tilesHardLimit() const
 {
     qreal hp = qreal(memoryHardLimitPercent()) / 100.0;
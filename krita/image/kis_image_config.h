@@ -48,6 +48,9 @@ public:
     qreal schedulerBalancingRatio() const;
     void setSchedulerBalancingRatio(qreal value);
 
+    int maxNumberOfThreads(bool requestDefault = false) const;
+    void setMaxNumberOfThreads(int value);
+
     int maxSwapSize(bool requestDefault = false) const;
     void setMaxSwapSize(int value);
 
@@ -57,6 +60,9 @@ public:
     int swapWindowSize() const;
     void setSwapWindowSize(int value);
 
+    QString swapCompression() const;
+    void setSwapCompression(const QString &value);
+
     int tilesHardLimit() const; // MiB
     int tilesSoftLimit() const; // MiB
     int poolLimit() const; // MiB
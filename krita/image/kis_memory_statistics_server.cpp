@@ -106,8 +106,12 @@ KisMemoryStatisticsServer::fetchMemoryStatistics(KisImageSP image) const
     stats.realMemorySize = tileStats.realMemorySize;
     stats.historicalMemorySize = tileStats.historicalMemorySize;
     stats.poolSize = tileStats.poolSize;
+    stats.sharedMemorySize = tileStats.sharedMemorySize;
+    stats.sharingSavedMemorySize = tileStats.sharingSavedMemorySize;
 
     stats.swapSize = tileStats.swapSize;
+    stats.swapInStallTime = tileStats.swapInStallTime;
+    stats.prefetchHitRate = tileStats.prefetchHitRate;
 
     KisImageConfig cfg;
 
@@ -40,8 +40,12 @@ public:
               realMemorySize(0),
               historicalMemorySize(0),
               poolSize(0),
+              sharedMemorySize(0),
+              sharingSavedMemorySize(0),
 
               swapSize(0),
+              swapInStallTime(0),
+              prefetchHitRate(0.0),
 
               totalMemoryLimit(0),
               tilesHardLimit(0),
@@ -56,8 +60,12 @@ public:
         qint64 realMemorySize;
         qint64 historicalMemorySize;
         qint64 poolSize;
+        qint64 sharedMemorySize;
+        qint64 sharingSavedMemorySize;
 
         qint64 swapSize;
+        qint64 swapInStallTime;
+        qreal prefetchHitRate;
 
         qint64 totalMemoryLimit;
         qint64 tilesHardLimit;
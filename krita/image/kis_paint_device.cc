@@ -25,6 +25,11 @@
 #include <QList>
 #include <QHash>
 #include <QIODevice>
+#include <QBuffer>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QScopedPointer>
+#include <QtConcurrentMap>
 
 #include <klocalizedstring.h>
 
@@ -34,6 +39,8 @@
 #include <KoColorSpace.h>
 #include <KoColorSpaceRegistry.h>
 #include <KoColorModelStandardIds.h>
+#include <KoColorConversionCache.h>
+#include <KoColorConversionTransformation.h>
 #include <KoIntegerMaths.h>
 
 #include "kis_global.h"
@@ -55,6 +62,8 @@
 
 #include "kis_default_bounds.h"
 #include "kis_lock_free_cache.h"
+#include "kis_image_config.h"
+#include "krita_utils.h"
 
 
 class PaintDeviceCache
@@ -185,6 +194,24 @@ struct Q_DECL_HIDDEN KisPaintDevice::Private
     QScopedPointer<KisPaintDeviceWrappedStrategy> wrappedStrategy;
 
     KisPaintDeviceStrategy* currentStrategy();
+
+    /**
+     * The compressed tiles passed to readLazily(). Every access to the
+     * data manager should go through ensureDataLoaded(), so that the
+     * data is decoded before anyone sees the tiles.
+     */
+    QByteArray pendingData;
+    QAtomicInt hasPendingData;
+    QMutex pendingDataLock;
+
+    inline void ensureDataLoaded() {
+        if (hasPendingData.loadAcquire()) {
+            loadPendingData();
+        }
+    }
+
+    void loadPendingData();
+    void discardPendingData();
 };
 
 #include "kis_paint_device_strategies.h"
@@ -198,8 +225,37 @@ KisPaintDevice::Private::Private(KisPaintDevice *paintDevice)
 {
 }
 
+void KisPaintDevice::Private::loadPendingData()
+{
+    QMutexLocker l(&pendingDataLock);
+    if (!hasPendingData.load()) return;
+
+    QBuffer buffer(&pendingData);
+    buffer.open(QIODevice::ReadOnly);
+
+    if (!dataManager->read(&buffer)) {
+        warnKrita << "Failed to decode the lazily loaded pixel data of" << q->objectName();
+    }
+
+    buffer.close();
+    pendingData.clear();
+    cache.invalidate();
+
+    hasPendingData.storeRelease(0);
+}
+
+void KisPaintDevice::Private::discardPendingData()
+{
+    QMutexLocker l(&pendingDataLock);
+
+    pendingData.clear();
+    hasPendingData.storeRelease(0);
+}
+
 KisPaintDevice::Private::KisPaintDeviceStrategy* KisPaintDevice::Private::currentStrategy()
 {
+    ensureDataLoaded();
+
     if (!defaultBounds->wrapAroundMode()) {
         return basicStrategy.data();
     }
@@ -285,7 +341,18 @@ KisPaintDevice::KisPaintDevice(const KisPaintDevice& rhs)
         m_d->y = rhs.m_d->y;
 
         Q_ASSERT(rhs.m_d->dataManager);
-        m_d->dataManager = new KisDataManager(*rhs.m_d->dataManager);
+
+        {
+            // the clone shares the pending data instead of decoding it
+            QMutexLocker l(&rhs.m_d->pendingDataLock);
+
+            m_d->dataManager = new KisDataManager(*rhs.m_d->dataManager);
+
+            if (rhs.m_d->hasPendingData.load()) {
+                m_d->pendingData = rhs.m_d->pendingData;
+                m_d->hasPendingData.storeRelease(1);
+            }
+        }
         Q_CHECK_PTR(m_d->dataManager);
         m_d->cache.setupCache();
 
@@ -443,11 +510,13 @@ QRegion KisPaintDevice::region() const
 
 QRect KisPaintDevice::nonDefaultPixelArea() const
 {
+    m_d->ensureDataLoaded();
     return m_d->cache.nonDefaultPixelArea();
 }
 
 QRect KisPaintDevice::exactBounds() const
 {
+    m_d->ensureDataLoaded();
     return m_d->cache.exactBounds();
 }
 
@@ -640,6 +709,7 @@ void KisPaintDevice::crop(const QRect &rect)
 
 void KisPaintDevice::purgeDefaultPixels()
 {
+    m_d->ensureDataLoaded();
     m_d->dataManager->purge(m_d->dataManager->extent());
 }
 
@@ -656,6 +726,7 @@ const quint8 *KisPaintDevice::defaultPixel() const
 
 void KisPaintDevice::clear()
 {
+    m_d->discardPendingData();
     m_d->dataManager->clear();
     m_d->cache.invalidate();
 }
@@ -678,16 +749,102 @@ void KisPaintDevice::fill(qint32 x, qint32 y, qint32 w, qint32 h, const quint8 *
 
 bool KisPaintDevice::write(KisPaintDeviceWriter &store)
 {
+    {
+        QMutexLocker l(&m_d->pendingDataLock);
+        if (m_d->hasPendingData.load()) {
+            return store.write(m_d->pendingData);
+        }
+    }
+
     return m_d->dataManager->write(store);
 }
 
 bool KisPaintDevice::read(QIODevice *stream)
 {
+    m_d->discardPendingData();
     bool retval = m_d->dataManager->read(stream);
     m_d->cache.invalidate();
     return retval;
 }
 
+void KisPaintDevice::readLazily(const QByteArray &data)
+{
+    QMutexLocker l(&m_d->pendingDataLock);
+
+    m_d->pendingData = data;
+    m_d->hasPendingData.storeRelease(1);
+    m_d->cache.invalidate();
+}
+
+bool KisPaintDevice::hasPendingData() const
+{
+    return m_d->hasPendingData.loadAcquire();
+}
+
+namespace {
+
+void convertRect(const KisPaintDevice *src, KisPaintDevice *dst, const QRect &rc,
+                 const KoColorConversionTransformation *transformation)
+{
+    KisRandomConstAccessorSP srcIt = src->createRandomConstAccessorNG(rc.x(), rc.y());
+    KisRandomAccessorSP dstIt = dst->createRandomAccessorNG(rc.x(), rc.y());
+
+    for (qint32 row = rc.y(); row <= rc.bottom(); ++row) {
+
+        qint32 column = rc.x();
+        qint32 columnsRemaining = rc.width();
+
+        while (columnsRemaining > 0) {
+
+            qint32 numContiguousDstColumns = dstIt->numContiguousColumns(column);
+            qint32 numContiguousSrcColumns = srcIt->numContiguousColumns(column);
+
+            qint32 columns = qMin(numContiguousDstColumns, numContiguousSrcColumns);
+            columns = qMin(columns, columnsRemaining);
+
+            srcIt->moveTo(column, row);
+            dstIt->moveTo(column, row);
+
+            transformation->transform(srcIt->rawDataConst(), dstIt->rawData(), columns);
+
+            column += columns;
+            columnsRemaining -= columns;
+        }
+    }
+}
+
+/**
+ * Every stripe gets its own transformation, because the transformations
+ * are not thread-safe and the ones from KoColorConversionCache would
+ * make the workers wait for each other
+ */
+struct ConvertStripeFunctor {
+    typedef void result_type;
+
+    ConvertStripeFunctor(const KisPaintDevice *src, KisPaintDevice *dst,
+                         KoColorConversionTransformation::Intent renderingIntent,
+                         KoColorConversionTransformation::ConversionFlags conversionFlags)
+        : m_src(src), m_dst(dst),
+          m_renderingIntent(renderingIntent),
+          m_conversionFlags(conversionFlags)
+    {
+    }
+
+    void operator() (const QRect &rc) {
+        QScopedPointer<KoColorConversionTransformation> transformation(
+            m_src->colorSpace()->createColorConverter(m_dst->colorSpace(), m_renderingIntent, m_conversionFlags));
+
+        convertRect(m_src, m_dst, rc, transformation.data());
+    }
+
+    const KisPaintDevice *m_src;
+    KisPaintDevice *m_dst;
+    KoColorConversionTransformation::Intent m_renderingIntent;
+    KoColorConversionTransformation::ConversionFlags m_conversionFlags;
+};
+
+}
+
 KUndo2Command* KisPaintDevice::convertTo(const KoColorSpace * dstColorSpace, KoColorConversionTransformation::Intent renderingIntent, KoColorConversionTransformation::ConversionFlags conversionFlags)
 {
     m_d->cache.invalidate();
@@ -700,15 +857,9 @@ KUndo2Command* KisPaintDevice::convertTo(const KoColorSpace * dstColorSpace, KoC
     dst.setX(x());
     dst.setY(y());
 
-    qint32 x, y, w, h;
     QRect rc = exactBounds();
 
-    x = rc.x();
-    y = rc.y();
-    w = rc.width();
-    h = rc.height();
-
-    if (w == 0 || h == 0) {
+    if (rc.isEmpty()) {
         quint8 *defPixel = new quint8[dstColorSpace->pixelSize()];
         memset(defPixel, 0, pixelSize());
         m_d->colorSpace->convertPixelsTo(defaultPixel(), defPixel, dstColorSpace, 1, renderingIntent, conversionFlags);
@@ -716,34 +867,21 @@ KUndo2Command* KisPaintDevice::convertTo(const KoColorSpace * dstColorSpace, KoC
         delete[] defPixel;
     }
     else {
-        KisRandomConstAccessorSP srcIt = createRandomConstAccessorNG(x, y);
-        KisRandomAccessorSP dstIt = dst.createRandomAccessorNG(x, y);
-
-        for (qint32 row = y; row < y + h; ++row) {
-
-            qint32 column = x;
-            qint32 columnsRemaining = w;
-
-            while (columnsRemaining > 0) {
-
-                qint32 numContiguousDstColumns = dstIt->numContiguousColumns(column);
-                qint32 numContiguousSrcColumns = srcIt->numContiguousColumns(column);
-
-                qint32 columns = qMin(numContiguousDstColumns, numContiguousSrcColumns);
-                columns = qMin(columns, columnsRemaining);
-
-                srcIt->moveTo(column, row);
-                dstIt->moveTo(column, row);
-
-                const quint8 *srcData = srcIt->rawDataConst();
-                quint8 *dstData = dstIt->rawData();
-
-                m_d->colorSpace->convertPixelsTo(srcData, dstData, dstColorSpace, columns, renderingIntent, conversionFlags);
-
-                column += columns;
-                columnsRemaining -= columns;
-            }
+        /**
+         * The stripes are aligned to the tile grid, so the workers
+         * never write into the same destination tile
+         */
+        QVector<QRect> stripes =
+            KritaUtils::splitRectIntoTileAlignedStripes(rc, KisImageConfig().maxNumberOfThreads(), Qt::Horizontal);
+
+        if (stripes.size() > 1) {
+            QtConcurrent::blockingMap(stripes, ConvertStripeFunctor(this, &dst, renderingIntent, conversionFlags));
+        } else {
+            KoCachedColorConversionTransformation transformation =
+                KoColorSpaceRegistry::instance()->colorConversionCache()->
+                cachedConverter(m_d->colorSpace, dstColorSpace, renderingIntent, conversionFlags);
 
+            convertRect(this, &dst, rc, transformation.transformation());
         }
     }
     KisDataManagerSP oldData = m_d->dataManager;
@@ -776,6 +914,7 @@ void KisPaintDevice::setProfile(const KoColorProfile * profile)
 
 void KisPaintDevice::setDataManager(KisDataManagerSP data, const KoColorSpace * colorSpace)
 {
+    m_d->discardPendingData();
     m_d->dataManager = data;
     m_d->cache.setupCache();
 
@@ -919,6 +1058,7 @@ QImage KisPaintDevice::createThumbnail(qint32 w, qint32 h, QRect rect, KoColorCo
 
 QImage KisPaintDevice::createThumbnail(qint32 w, qint32 h, KoColorConversionTransformation::Intent renderingIntent, KoColorConversionTransformation::ConversionFlags conversionFlags)
 {
+    m_d->ensureDataLoaded();
     return m_d->cache.createThumbnail(w, h, renderingIntent, conversionFlags);
 }
 
@@ -946,12 +1086,14 @@ KisVLineConstIteratorSP KisPaintDevice::createVLineConstIteratorNG(qint32 x, qin
 
 KisRepeatHLineConstIteratorSP KisPaintDevice::createRepeatHLineConstIterator(qint32 x, qint32 y, qint32 w, const QRect& _dataWidth) const
 {
+    m_d->ensureDataLoaded();
     KisDataManager* dm = const_cast< KisDataManager*>(m_d->dataManager.data());
     return new KisRepeatHLineConstIteratorNG(dm, x, y, w, m_d->x, m_d->y, _dataWidth);
 }
 
 KisRepeatVLineConstIteratorSP KisPaintDevice::createRepeatVLineConstIterator(qint32 x, qint32 y, qint32 h, const QRect& _dataWidth) const
 {
+    m_d->ensureDataLoaded();
     KisDataManager* dm = const_cast< KisDataManager*>(m_d->dataManager.data());
     return new KisRepeatVLineConstIteratorNG(dm, x, y, h, m_d->x, m_d->y, _dataWidth);
 }
@@ -1112,6 +1254,7 @@ void KisPaintDevice::writePlanarBytes(QVector<quint8*> planes, qint32 x, qint32
 
 KisDataManagerSP KisPaintDevice::dataManager() const
 {
+    m_d->ensureDataLoaded();
     return m_d->dataManager;
 }
 
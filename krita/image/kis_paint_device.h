@@ -114,6 +114,21 @@ public:
      */
     bool read(QIODevice *stream);
 
+    /**
+     * Fill this paint device with the pixels from \p data lazily. The
+     * data has the same format as the one written by write(), but the
+     * tiles are decoded only when the pixels of the device are
+     * accessed for the first time. Until then the device keeps only
+     * the compressed data, and write() stores it as it is.
+     */
+    void readLazily(const QByteArray &data);
+
+    /**
+     * @return true if the data passed to readLazily() has not been
+     * decoded yet
+     */
+    bool hasPendingData() const;
+
 public:
 
     /**
@@ -25,6 +25,8 @@
 #include <QTransform>
 #include <QVector3D>
 #include <QPolygonF>
+#include <QMutex>
+#include <QtConcurrentMap>
 
 #include <KoUpdater.h>
 #include <KoColor.h>
@@ -42,7 +44,7 @@
 
 
 KisPerspectiveTransformWorker::KisPerspectiveTransformWorker(KisPaintDeviceSP dev, QPointF center, double aX, double aY, double distance, KoUpdaterPtr progress)
-        : m_dev(dev), m_progressUpdater(progress)
+        : m_dev(dev), m_progressUpdater(progress), m_threadCount(1)
 
 {
     QMatrix4x4 m;
@@ -58,7 +60,7 @@ KisPerspectiveTransformWorker::KisPerspectiveTransformWorker(KisPaintDeviceSP de
 }
 
 KisPerspectiveTransformWorker::KisPerspectiveTransformWorker(KisPaintDeviceSP dev, const QTransform &transform, KoUpdaterPtr progress)
-    : m_dev(dev), m_progressUpdater(progress)
+    : m_dev(dev), m_progressUpdater(progress), m_threadCount(1)
 {
     init(transform);
 }
@@ -107,6 +109,139 @@ void KisPerspectiveTransformWorker::setForwardTransform(const QTransform &transf
     init(transform);
 }
 
+void KisPerspectiveTransformWorker::setThreadCount(int threadCount)
+{
+    m_threadCount = qMax(1, threadCount);
+}
+
+int KisPerspectiveTransformWorker::threadCount() const
+{
+    return m_threadCount;
+}
+
+namespace {
+
+void transformRect(KisRandomSubAccessorSP srcAcc,
+                   KisRandomAccessorSP accessor,
+                   const QTransform &backwardTransform,
+                   const QRectF &srcClipRect,
+                   const QRect &rect)
+{
+    for (int y = rect.y(); y < rect.y() + rect.height(); ++y) {
+        for (int x = rect.x(); x < rect.x() + rect.width(); ++x) {
+
+            QPointF dstPoint(x, y);
+            QPointF srcPoint = backwardTransform.map(dstPoint);
+
+            if (srcClipRect.contains(srcPoint)) {
+                accessor->moveTo(dstPoint.x(), dstPoint.y());
+                srcAcc->moveTo(srcPoint.x(), srcPoint.y());
+                srcAcc->sampledOldRawData(accessor->rawData());
+            }
+        }
+    }
+}
+
+struct TransformStripeFunctor {
+    typedef void result_type;
+
+    TransformStripeFunctor(KisPaintDeviceSP srcDev,
+                           KisPaintDeviceSP dstDev,
+                           const QTransform &backwardTransform,
+                           const QRectF &srcClipRect,
+                           KisProgressUpdateHelper *progressHelper,
+                           QMutex *progressLock)
+        : m_srcDev(srcDev),
+          m_dstDev(dstDev),
+          m_backwardTransform(backwardTransform),
+          m_srcClipRect(srcClipRect),
+          m_progressHelper(progressHelper),
+          m_progressLock(progressLock)
+    {
+    }
+
+    void operator() (const QVector<QRect> &rects) {
+        if (rects.isEmpty()) return;
+
+        KisRandomSubAccessorSP srcAcc = m_srcDev->createRandomSubAccessor();
+        KisRandomAccessorSP accessor = m_dstDev->createRandomAccessorNG(rects.first().x(), rects.first().y());
+
+        foreach (const QRect &rect, rects) {
+            transformRect(srcAcc, accessor, m_backwardTransform, m_srcClipRect, rect);
+
+            QMutexLocker l(m_progressLock);
+            m_progressHelper->step();
+        }
+    }
+
+    KisPaintDeviceSP m_srcDev;
+    KisPaintDeviceSP m_dstDev;
+    QTransform m_backwardTransform;
+    QRectF m_srcClipRect;
+    KisProgressUpdateHelper *m_progressHelper;
+    QMutex *m_progressLock;
+};
+
+}
+
+void KisPerspectiveTransformWorker::processRects(KisPaintDeviceSP srcDev,
+                                                 KisPaintDeviceSP dstDev,
+                                                 const QRectF &srcClipRect,
+                                                 const QVector<QRect> &dstRects)
+{
+    if (m_threadCount <= 1) {
+        KisProgressUpdateHelper progressHelper(m_progressUpdater, 100, dstRects.size());
+
+        KisRandomSubAccessorSP srcAcc = srcDev->createRandomSubAccessor();
+        KisRandomAccessorSP accessor = dstDev->createRandomAccessorNG(0, 0);
+
+        foreach (const QRect &rect, dstRects) {
+            transformRect(srcAcc, accessor, m_backwardTransform, srcClipRect, rect);
+            progressHelper.step();
+        }
+        return;
+    }
+
+    QRect boundRect;
+    foreach (const QRect &rect, dstRects) {
+        boundRect |= rect;
+    }
+
+    /**
+     * Every stripe gets only the pieces of the rects lying inside it,
+     * so no two threads ever write into the same tile. The source
+     * pixels are only read, so they can be shared.
+     */
+    QVector<QRect> stripes =
+        KritaUtils::splitRectIntoTileAlignedStripes(boundRect, m_threadCount, Qt::Horizontal);
+
+    QVector<QVector<QRect> > jobs;
+    int numPieces = 0;
+
+    foreach (const QRect &stripe, stripes) {
+        QVector<QRect> job;
+
+        foreach (const QRect &rect, dstRects) {
+            QRect piece = rect & stripe;
+            if (!piece.isEmpty()) {
+                job.append(piece);
+                numPieces++;
+            }
+        }
+
+        jobs.append(job);
+    }
+
+    KisProgressUpdateHelper progressHelper(m_progressUpdater, 100, numPieces);
+    QMutex progressLock;
+
+    QtConcurrent::blockingMap(jobs, TransformStripeFunctor(srcDev, dstDev,
+                                                           m_backwardTransform,
+                                                           srcClipRect,
+                                                           &progressHelper,
+                                                           &progressLock));
+}
+
 void KisPerspectiveTransformWorker::run()
 {
     KIS_ASSERT_RECOVER_RETURN(m_dev);
@@ -121,27 +256,7 @@ void KisPerspectiveTransformWorker::run()
 
     KIS_ASSERT_RECOVER_NOOP(!m_isIdentity);
 
-    KisProgressUpdateHelper progressHelper(m_progressUpdater, 100, m_dstRegion.rectCount());
-
-    KisRandomSubAccessorSP srcAcc = cloneDevice->createRandomSubAccessor();
-    KisRandomAccessorSP accessor = m_dev->createRandomAccessorNG(0, 0);
-
-    foreach(const QRect &rect, m_dstRegion.rects()) {
-        for (int y = rect.y(); y < rect.y() + rect.height(); ++y) {
-            for (int x = rect.x(); x < rect.x() + rect.width(); ++x) {
-
-                QPointF dstPoint(x, y);
-                QPointF srcPoint = m_backwardTransform.map(dstPoint);
-
-                if (m_srcRect.contains(srcPoint)) {
-                    accessor->moveTo(dstPoint.x(), dstPoint.y());
-                    srcAcc->moveTo(srcPoint.x(), srcPoint.y());
-                    srcAcc->sampledOldRawData(accessor->rawData());
-                }
-            }
-        }
-        progressHelper.step();
-    }
+    processRects(cloneDevice, m_dev, m_srcRect, m_dstRegion.rects());
 }
 
 void KisPerspectiveTransformWorker::runPartialDst(KisPaintDeviceSP srcDev,
@@ -156,26 +271,12 @@ void KisPerspectiveTransformWorker::runPartialDst(KisPaintDeviceSP srcDev,
     QRectF srcClipRect = srcDev->exactBounds();
     if (srcClipRect.isEmpty()) return;
 
-    KisProgressUpdateHelper progressHelper(m_progressUpdater, 100, dstRect.height());
-
-    KisRandomSubAccessorSP srcAcc = srcDev->createRandomSubAccessor();
-    KisRandomAccessorSP accessor = dstDev->createRandomAccessorNG(dstRect.x(), dstRect.y());
-
+    QVector<QRect> rows;
     for (int y = dstRect.y(); y < dstRect.y() + dstRect.height(); ++y) {
-        for (int x = dstRect.x(); x < dstRect.x() + dstRect.width(); ++x) {
-
-            QPointF dstPoint(x, y);
-            QPointF srcPoint = m_backwardTransform.map(dstPoint);
-
-            if (srcClipRect.contains(srcPoint)) {
-                accessor->moveTo(dstPoint.x(), dstPoint.y());
-                srcAcc->moveTo(srcPoint.x(), srcPoint.y());
-                srcAcc->sampledOldRawData(accessor->rawData());
-            }
-        }
-        progressHelper.step();
+        rows.append(QRect(dstRect.x(), y, dstRect.width(), 1));
     }
 
+    processRects(srcDev, dstDev, srcClipRect, rows);
 }
 
 QTransform KisPerspectiveTransformWorker::forwardTransform() const
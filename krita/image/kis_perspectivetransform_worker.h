@@ -45,6 +45,15 @@ public:
 
     void setForwardTransform(const QTransform &transform);
 
+    /**
+     * Set the number of threads run() and runPartialDst() may use.
+     * The destination area is split into stripes of rows aligned to
+     * the tile grid, which are processed independently. The default
+     * value is 1.
+     */
+    void setThreadCount(int threadCount);
+    int threadCount() const;
+
     QTransform forwardTransform() const;
     QTransform backwardTransform() const;
 
@@ -56,6 +65,11 @@ private:
                     QRegion *dstRegion,
                     QPolygonF *dstClipPolygon);
 
+    void processRects(KisPaintDeviceSP srcDev,
+                      KisPaintDeviceSP dstDev,
+                      const QRectF &srcClipRect,
+                      const QVector<QRect> &dstRects);
+
 private:
     KisPaintDeviceSP m_dev;
     KoUpdaterPtr m_progressUpdater;
@@ -64,6 +78,7 @@ private:
     QTransform m_backwardTransform;
     QTransform m_forwardTransform;
     bool m_isIdentity;
+    int m_threadCount;
 };
 
 #endif
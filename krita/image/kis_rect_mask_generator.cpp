@@ -18,11 +18,23 @@
 
 #include <cmath>
 
+#include <config-vc.h>
+#ifdef HAVE_VC
+#if defined(__clang__)
+#pragma GCC diagnostic ignored "-Wundef"
+#pragma GCC diagnostic ignored "-Wlocal-type-template-args"
+#endif
+#include <Vc/Vc>
+#include <Vc/IO>
+#endif
+
 #include <QDomDocument>
 
 #include "kis_fast_math.h"
 
 #include "kis_rect_mask_generator.h"
+#include "kis_rect_mask_generator_p.h"
+#include "kis_brush_mask_applicator_factories.h"
 #include "kis_base_mask_generator.h"
 
 #ifdef Q_OS_WIN
@@ -32,15 +44,6 @@
 #endif
 #endif
 
-struct Q_DECL_HIDDEN KisRectangleMaskGenerator::Private {
-    double m_c;
-    qreal xcoeff;
-    qreal ycoeff;
-    qreal xfadecoeff;
-    qreal yfadecoeff;
-    qreal transformedFadeX;
-    qreal transformedFadeY;
-};
 
 KisRectangleMaskGenerator::KisRectangleMaskGenerator(qreal radius, qreal ratio, qreal fh, qreal fv, int spikes, bool antialiasEdges)
     : KisMaskGenerator(radius, ratio, fh, fv, spikes, antialiasEdges, RECTANGLE, DefaultId), d(new Private)
@@ -58,6 +61,11 @@ KisRectangleMaskGenerator::KisRectangleMaskGenerator(qreal radius, qreal ratio,
     }
 
     setScale(1.0, 1.0);
+
+    // store the variable locally to allow vector implementation read it easily
+    d->copyOfAntialiasEdges = antialiasEdges;
+
+    d->applicator = createOptimizedClass<MaskApplicatorFactory<KisRectangleMaskGenerator, KisBrushMaskVectorApplicator> >(this);
 }
 
 void KisRectangleMaskGenerator::setScale(qreal scaleX, qreal scaleY)
@@ -82,9 +90,20 @@ void KisRectangleMaskGenerator::setSoftness(qreal softness)
 
 KisRectangleMaskGenerator::~KisRectangleMaskGenerator()
 {
+    delete d->applicator;
     delete d;
 }
 
+bool KisRectangleMaskGenerator::shouldVectorize() const
+{
+    return !shouldSupersample() && spikes() == 2;
+}
+
+KisBrushMaskApplicatorBase* KisRectangleMaskGenerator::applicator()
+{
+    return d->applicator;
+}
+
 bool KisRectangleMaskGenerator::shouldSupersample() const
 {
     return effectiveSrcWidth() < 10 || effectiveSrcHeight() < 10;
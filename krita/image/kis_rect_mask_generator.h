@@ -29,14 +29,17 @@
  */
 class KRITAIMAGE_EXPORT KisRectangleMaskGenerator : public KisMaskGenerator
 {
-
+public:
+    struct FastRowProcessor;
 public:
 
     KisRectangleMaskGenerator(qreal radius, qreal ratio, qreal fh, qreal fv, int spikes, bool antialiasEdges);
     virtual ~KisRectangleMaskGenerator();
 
     virtual bool shouldSupersample() const;
+    virtual bool shouldVectorize() const;
     virtual quint8 valueAt(qreal x, qreal y) const;
+    KisBrushMaskApplicatorBase* applicator();
     void setScale(qreal scaleX, qreal scaleY);
     void setSoftness(qreal softness);
 
@@ -23,6 +23,7 @@
 
 #include <KoColorSpace.h>
 #include "kis_convolution_painter.h"
+#include "kis_image_config.h"
 #include "kis_convolution_kernel.h"
 #include "kis_pixel_selection.h"
 
@@ -497,12 +498,15 @@ void KisFeatherSelectionFilter::process(KisPixelSelectionSP pixelSelection, cons
     KisConvolutionKernelSP kernelVertical = KisConvolutionKernel::fromMatrix(gaussianMatrix.transpose(), 0, gaussianMatrix.sum());
 
     KisPaintDeviceSP interm = new KisPaintDevice(pixelSelection->colorSpace());
+    const int threadCount = KisImageConfig().maxNumberOfThreads();
     KisConvolutionPainter horizPainter(interm);
+    horizPainter.setThreadCount(threadCount);
     horizPainter.setChannelFlags(interm->colorSpace()->channelFlags(false, true));
     horizPainter.applyMatrix(kernelHoriz, pixelSelection, rect.topLeft(), rect.topLeft(), rect.size(), BORDER_REPEAT);
     horizPainter.end();
 
     KisConvolutionPainter verticalPainter(pixelSelection);
+    verticalPainter.setThreadCount(threadCount);
     verticalPainter.setChannelFlags(pixelSelection->colorSpace()->channelFlags(false, true));
     verticalPainter.applyMatrix(kernelVertical, interm, rect.topLeft(), rect.topLeft(), rect.size(), BORDER_REPEAT);
     verticalPainter.end();
@@ -23,6 +23,8 @@
 #include "kis_image_config.h"
 #include "kis_full_refresh_walker.h"
 #include "kis_spontaneous_job.h"
+#include "krita_utils.h"
+#include "tiles3/kis_tile_data.h"
 
 
 //#define ENABLE_DEBUG_JOIN
@@ -53,6 +55,7 @@
 
 
 KisSimpleUpdateQueue::KisSimpleUpdateQueue()
+    : m_unsplittableGraphSequenceNumber(-1)
 {
     updateSettings();
 }
@@ -103,8 +106,44 @@ bool KisSimpleUpdateQueue::processOneJob(KisUpdaterContext &updaterContext)
             item->recalculate(item->requestedRect());
 
         if(updaterContext.isJobAllowed(item)) {
-            updaterContext.addMergeJob(item);
             iter.remove();
+
+            /**
+             * If there are more idle threads than the jobs in the
+             * queue, the big job would keep one thread busy while the
+             * others have nothing to do. Split it into tile-aligned
+             * parts and let the idle threads take the rest of them
+             * in the following calls.
+             */
+            const qint32 numSpareThreads = updaterContext.numSpareThreads();
+            const qint32 numQueuedJobs = m_updatesList.size() + 1;
+
+            if (numSpareThreads > numQueuedJobs &&
+                !isKnownUnsplittable(item)) {
+
+                bool partsIntersect = false;
+                KisWalkersList parts =
+                    splitWalker(item, numSpareThreads - numQueuedJobs + 1,
+                                &partsIntersect);
+
+                if (!parts.isEmpty()) {
+                    item = parts.takeFirst();
+
+                    foreach (KisBaseRectsWalkerSP part, parts) {
+                        iter.insert(part);
+                    }
+                } else if (partsIntersect) {
+                    /**
+                     * Don't collect the rects of the same graph
+                     * again for every following update of the node
+                     */
+                    m_unsplittableNode = item->startNode();
+                    m_unsplittableGraphSequenceNumber =
+                        item->startNode()->graphSequenceNumber();
+                }
+            }
+
+            updaterContext.addMergeJob(item);
             jobAdded = true;
             break;
         }
@@ -159,6 +198,17 @@ void KisSimpleUpdateQueue::addJob(KisNodeSP node, const QRect& rc,
     if(trySplitJob(node, rc, cropRect, type)) return;
     if(tryMergeJob(node, rc, cropRect, type)) return;
 
+    KisBaseRectsWalkerSP walker = createWalker(type, cropRect);
+    walker->collectRects(node, rc);
+
+    m_lock.lock();
+    m_updatesList.append(walker);
+    m_lock.unlock();
+}
+
+KisBaseRectsWalkerSP KisSimpleUpdateQueue::createWalker(KisBaseRectsWalker::UpdateType type,
+                                                       const QRect &cropRect)
+{
     KisBaseRectsWalkerSP walker;
 
     if (type == KisBaseRectsWalker::UPDATE) {
@@ -172,11 +222,106 @@ void KisSimpleUpdateQueue::addJob(KisNodeSP node, const QRect& rc,
     }
     /* else if(type == KisBaseRectsWalker::UNSUPPORTED) fatalKrita; */
 
-    walker->collectRects(node, rc);
+    return walker;
+}
 
-    m_lock.lock();
-    m_updatesList.append(walker);
-    m_lock.unlock();
+inline bool walkersIntersect(KisBaseRectsWalkerSP walker1,
+                             KisBaseRectsWalkerSP walker2)
+{
+    return walker1->accessRect().intersects(walker2->changeRect()) ||
+        walker2->accessRect().intersects(walker1->changeRect());
+}
+
+inline qint32 alignToTiles(qint32 value, qint32 tileSize)
+{
+    return ((value + tileSize - 1) / tileSize) * tileSize;
+}
+
+bool KisSimpleUpdateQueue::isKnownUnsplittable(KisBaseRectsWalkerSP walker) const
+{
+    return m_unsplittableNode.isValid() &&
+        m_unsplittableNode == walker->startNode().data() &&
+        m_unsplittableGraphSequenceNumber == walker->startNode()->graphSequenceNumber();
+}
+
+KisWalkersList KisSimpleUpdateQueue::splitWalker(KisBaseRectsWalkerSP walker, qint32 numParts, bool *partsIntersect)
+{
+    /**
+     * Parts smaller than this are not worth the overhead
+     * of collecting the rects
+     */
+    const qint32 minPartWidth = 2 * KisTileData::WIDTH;
+    const qint32 minPartHeight = 2 * KisTileData::HEIGHT;
+
+    KisWalkersList parts;
+
+    const KisBaseRectsWalker::UpdateType type = walker->type();
+    if (type == KisBaseRectsWalker::UNSUPPORTED) return parts;
+
+    const QRect rc = walker->requestedRect();
+
+    /**
+     * If the graph has filters that need some extra area
+     * around the requested rect, the parts will block each
+     * other in the updater context, so splitting makes no
+     * sense. The original walker already knows that, so
+     * check it before collecting the rects for every patch.
+     */
+    if (walker->needRectVaries() ||
+        !rc.contains(walker->uncroppedChangeRect()) ||
+        !rc.contains(walker->accessRect())) {
+
+        return parts;
+    }
+
+    qint32 numCols = 1;
+    qint32 numRows = 1;
+
+    while (numCols * numRows < numParts) {
+        const bool canSplitHorizontally = rc.width() / (numCols + 1) >= minPartWidth;
+        const bool canSplitVertically = rc.height() / (numRows + 1) >= minPartHeight;
+
+        if (canSplitHorizontally &&
+            (!canSplitVertically || rc.width() / numCols >= rc.height() / numRows)) {
+
+            numCols++;
+        } else if (canSplitVertically) {
+            numRows++;
+        } else {
+            break;
+        }
+    }
+
+    if (numCols * numRows <= 1) return parts;
+
+    const QSize patchSize(alignToTiles((rc.width() + numCols - 1) / numCols, KisTileData::WIDTH),
+                          alignToTiles((rc.height() + numRows - 1) / numRows, KisTileData::HEIGHT));
+
+    QVector<QRect> patches = KritaUtils::splitRectIntoPatches(rc, patchSize);
+    if (patches.size() <= 1) return parts;
+
+    foreach (const QRect &patch, patches) {
+        KisBaseRectsWalkerSP part = createWalker(type, walker->cropRect());
+        part->collectRects(walker->startNode(), patch);
+
+        /**
+         * Some layers (e.g. clones) may still access the area
+         * outside the patch, check it for every part
+         */
+        foreach (KisBaseRectsWalkerSP otherPart, parts) {
+            if (walkersIntersect(part, otherPart)) {
+                if (partsIntersect) {
+                    *partsIntersect = true;
+                }
+                parts.clear();
+                return parts;
+            }
+        }
+
+        parts.append(part);
+    }
+
+    return parts;
 }
 
 void KisSimpleUpdateQueue::addSpontaneousJob(KisSpontaneousJob *spontaneousJob)
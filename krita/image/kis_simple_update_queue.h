@@ -52,10 +52,26 @@ public:
 
     void updateSettings();
 
+    /**
+     * Splits the requested rect of the \p walker into (approximately)
+     * \p numParts tile-aligned patches and creates a separate walker
+     * for every patch. The split is done only if the resulting walkers
+     * can be executed in parallel, that is their access and change rects
+     * do not intersect. Otherwise (or if the walker is too small to be
+     * split) an empty list is returned. The graphs that need or change
+     * the area outside the requested rect are rejected without
+     * collecting the rects of the patches. If the rects of the
+     * collected patches intersect, \p partsIntersect is set to true.
+     */
+    static KisWalkersList splitWalker(KisBaseRectsWalkerSP walker, qint32 numParts, bool *partsIntersect = 0);
+
 protected:
+    static KisBaseRectsWalkerSP createWalker(KisBaseRectsWalker::UpdateType type, const QRect &cropRect);
+
     void addJob(KisNodeSP node, const QRect& rc, const QRect& cropRect, KisBaseRectsWalker::UpdateType type);
 
     bool processOneJob(KisUpdaterContext &updaterContext);
+    bool isKnownUnsplittable(KisBaseRectsWalkerSP walker) const;
 
     bool trySplitJob(KisNodeSP node, const QRect& rc, const QRect& cropRect, KisBaseRectsWalker::UpdateType type);
     bool tryMergeJob(KisNodeSP node, const QRect& rc, const QRect& cropRect, KisBaseRectsWalker::UpdateType type);
@@ -70,6 +86,13 @@ protected:
     KisWalkersList m_updatesList;
     KisSpontaneousJobsList m_spontaneousJobsList;
 
+    /**
+     * The start node of the last walker that could not be split,
+     * valid while the graph of the node stays the same
+     */
+    KisNodeWSP m_unsplittableNode;
+    int m_unsplittableGraphSequenceNumber;
+
     /**
      * Parameters of optimization
      * (loaded from a configuration file)
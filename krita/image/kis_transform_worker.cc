@@ -26,6 +26,8 @@
 #include <klocalizedstring.h>
 
 #include <QTransform>
+#include <QMutex>
+#include <QtConcurrentMap>
 
 #include <KoColorSpace.h>
 #include <KoCompositeOpRegistry.h>
@@ -40,6 +42,7 @@
 #include "kis_painter.h"
 #include "kis_filter_weights_applicator.h"
 #include "kis_progress_update_helper.h"
+#include "krita_utils.h"
 
 
 KisTransformWorker::KisTransformWorker(KisPaintDeviceSP dev,
@@ -63,6 +66,7 @@ KisTransformWorker::KisTransformWorker(KisPaintDeviceSP dev,
     m_ytranslate = ytranslate;
     m_progressUpdater = progress;
     m_filter = filter;
+    m_threadCount = 1;
 }
 
 KisTransformWorker::~KisTransformWorker()
@@ -193,6 +197,70 @@ void updateBounds<KisVLineIteratorSP>(QRect &boundRect, const KisFilterWeightsAp
     boundRect.setHeight(newBounds.size());
 }
 
+template <class iter>
+QVector<QRect> splitIntoStripes(int firstLine, int numLines, int numStripes);
+
+template <>
+QVector<QRect> splitIntoStripes<KisHLineIteratorSP>(int firstLine, int numLines, int numStripes)
+{
+    return KritaUtils::splitRectIntoTileAlignedStripes(QRect(0, firstLine, 1, numLines),
+                                                       numStripes, Qt::Horizontal);
+}
+
+template <>
+QVector<QRect> splitIntoStripes<KisVLineIteratorSP>(int firstLine, int numLines, int numStripes)
+{
+    return KritaUtils::splitRectIntoTileAlignedStripes(QRect(firstLine, 0, numLines, 1),
+                                                       numStripes, Qt::Vertical);
+}
+
+namespace {
+
+struct TransformPassStripe {
+    int firstLine;
+    QVector<KisFilterWeightsApplicator::LinePos> dstLines;
+};
+
+template <class T>
+struct ProcessTransformStripeFunctor {
+    typedef void result_type;
+
+    ProcessTransformStripeFunctor(KisFilterWeightsApplicator *applicator,
+                                  KisFilterWeightsBuffer *buffer,
+                                  qreal filterSupport,
+                                  const KisFilterWeightsApplicator::LinePos &srcPos,
+                                  KisProgressUpdateHelper *progressHelper,
+                                  QMutex *progressLock)
+        : m_applicator(applicator),
+          m_buffer(buffer),
+          m_filterSupport(filterSupport),
+          m_srcPos(srcPos),
+          m_progressHelper(progressHelper),
+          m_progressLock(progressLock)
+    {
+    }
+
+    void operator() (TransformPassStripe &stripe) {
+        for (int i = 0; i < stripe.dstLines.size(); i++) {
+            stripe.dstLines[i] =
+                m_applicator->processLine<T>(m_srcPos, stripe.firstLine + i,
+                                             m_buffer, m_filterSupport);
+
+            QMutexLocker l(m_progressLock);
+            m_progressHelper->step();
+        }
+    }
+
+    KisFilterWeightsApplicator *m_applicator;
+    KisFilterWeightsBuffer *m_buffer;
+    qreal m_filterSupport;
+    KisFilterWeightsApplicator::LinePos m_srcPos;
+    KisProgressUpdateHelper *m_progressHelper;
+    QMutex *m_progressLock;
+};
+
+}
+
 template <class T>
 void KisTransformWorker::transformPass(KisPaintDevice *src, KisPaintDevice *dst,
                                        double floatscale, double shear, double dx,
@@ -210,14 +278,54 @@ void KisTransformWorker::transformPass(KisPaintDevice *src, KisPaintDevice *dst,
 
     KisFilterWeightsApplicator::LinePos dstBounds;
 
-    for (int i = firstLine; i < firstLine + numLines; i++) {
-        KisFilterWeightsApplicator::LinePos dstPos;
+    QVector<QRect> stripeRects;
+    if (m_threadCount > 1) {
+        stripeRects = splitIntoStripes<T>(firstLine, numLines, m_threadCount);
+    }
+
+    if (stripeRects.size() > 1) {
+        /**
+         * Every line is read and written by its own call to
+         * processLine(), so the stripes are independent even when the
+         * pass is done in-place. The bounds are united in the original
+         * order to get exactly the same result as the serial loop.
+         */
+        QVector<TransformPassStripe> stripes;
+
+        foreach (const QRect &rc, stripeRects) {
+            qint32 unusedStart, unusedLen, stripeLines;
+
+            TransformPassStripe stripe;
+            calcDimensions<T>(rc, unusedStart, unusedLen, stripe.firstLine, stripeLines);
+            stripe.dstLines.resize(stripeLines);
+            stripes.append(stripe);
+        }
+
+        QMutex progressLock;
         KisFilterWeightsApplicator::LinePos srcPos(srcStart, srcLen);
 
-        dstPos = applicator.processLine<T>(srcPos, i, &buf, filterStrategy->support());
-        dstBounds.unite(dstPos);
+        QtConcurrent::blockingMap(stripes,
+                                  ProcessTransformStripeFunctor<T>(&applicator, &buf,
+                                                                   filterStrategy->support(),
+                                                                   srcPos,
+                                                                   &progressHelper,
+                                                                   &progressLock));
 
-        progressHelper.step();
+        foreach (const TransformPassStripe &stripe, stripes) {
+            foreach (const KisFilterWeightsApplicator::LinePos &dstPos, stripe.dstLines) {
+                dstBounds.unite(dstPos);
+            }
+        }
+    } else {
+        for (int i = firstLine; i < firstLine + numLines; i++) {
+            KisFilterWeightsApplicator::LinePos dstPos;
+            KisFilterWeightsApplicator::LinePos srcPos(srcStart, srcLen);
+
+            dstPos = applicator.processLine<T>(srcPos, i, &buf, filterStrategy->support());
+            dstBounds.unite(dstPos);
+
+            progressHelper.step();
+        }
     }
 
     updateBounds<T>(m_boundRect, dstBounds);
@@ -230,6 +338,16 @@ void swapValues(T *a, T *b) {
     *b = c;
 }
 
+void KisTransformWorker::setThreadCount(int threadCount)
+{
+    m_threadCount = qMax(1, threadCount);
+}
+
+int KisTransformWorker::threadCount() const
+{
+    return m_threadCount;
+}
+
 bool KisTransformWorker::run()
 {
     return runPartial(m_dev->exactBounds());
@@ -92,6 +92,20 @@ public:
     bool run();
     bool runPartial(const QRect &processRect);
 
+    /**
+     * Set the number of threads the scaling and shearing passes may
+     * use. Every pass is split into stripes of rows (or columns)
+     * aligned to the tile grid, which are processed independently.
+     * The result does not depend on the number of threads. The
+     * default value is 1.
+     */
+    void setThreadCount(int threadCount);
+
+    /**
+     * \see setThreadCount()
+     */
+    int threadCount() const;
+
     /**
      * Returns a matrix of the transformation executed by the worker.
      * Resulting transformation has the following form (in Qt's matrix
@@ -155,6 +169,7 @@ private:
     KoUpdaterPtr m_progressUpdater;
     KisFilterStrategy *m_filter;
     QRect m_boundRect;
+    int m_threadCount;
 };
 
 #endif // KIS_TRANSFORM_VISITOR_H_
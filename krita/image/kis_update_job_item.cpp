@@ -21,3 +21,5 @@
 /**
  * This cpp-file is for QObject support mostly
  */
+
+QAtomicInt KisUpdateJobItem::s_numRunningJobs;
@@ -21,6 +21,7 @@
 
 #include <QRunnable>
 #include <QReadWriteLock>
+#include <QAtomicInt>
 
 #include "kis_stroke_job.h"
 #include "kis_spontaneous_job.h"
@@ -54,6 +55,8 @@ public:
             m_exclusiveJobLock->lockForRead();
         }
 
+        s_numRunningJobs.ref();
+
         if(m_type == MERGE) {
             runMergeJob();
         } else {
@@ -62,6 +65,8 @@ public:
             delete m_runnableJob;
         }
 
+        s_numRunningJobs.deref();
+
         setDone();
 
         emit sigDoSomeUsefulWork();
@@ -130,6 +135,16 @@ public:
         return m_changeRect;
     }
 
+    /**
+     * The number of jobs being executed by all the updater
+     * contexts at the moment. The jobs that split their work
+     * into several threads should check it to not oversubscribe
+     * the CPU.
+     */
+    static inline int numRunningJobs() {
+        return s_numRunningJobs;
+    }
+
 Q_SIGNALS:
     void sigContinueUpdate(const QRect& rc);
     void sigDoSomeUsefulWork();
@@ -169,6 +184,8 @@ private:
      */
     QReadWriteLock *m_exclusiveJobLock;
 
+    static QAtomicInt s_numRunningJobs;
+
     bool m_exclusive;
 
     volatile Type m_type;
@@ -169,8 +169,28 @@ void KisUpdateScheduler::fullRefresh(KisNodeSP root, const QRect& rc, const QRec
     if(needLock) lock();
     m_d->updaterContext->lock();
 
-    Q_ASSERT(m_d->updaterContext->isJobAllowed(walker));
-    m_d->updaterContext->addMergeJob(walker);
+    /**
+     * Spread the refresh over all the threads of the context
+     * instead of merging the whole image in a single one
+     */
+    KisWalkersList parts =
+        KisSimpleUpdateQueue::splitWalker(walker, m_d->updaterContext->numSpareThreads());
+
+    if (parts.isEmpty()) {
+        parts.append(walker);
+    }
+
+    foreach (KisBaseRectsWalkerSP part, parts) {
+        if (!m_d->updaterContext->hasSpareThread() ||
+            !m_d->updaterContext->isJobAllowed(part)) {
+
+            m_d->updaterContext->waitForDone();
+        }
+
+        Q_ASSERT(m_d->updaterContext->isJobAllowed(part));
+        m_d->updaterContext->addMergeJob(part);
+    }
+
     m_d->updaterContext->waitForDone();
 
     m_d->updaterContext->unlock();
@@ -22,15 +22,19 @@
 #include <QThreadPool>
 
 #include "kis_update_job_item.h"
+#include "kis_image_config.h"
 
 
 KisUpdaterContext::KisUpdaterContext(qint32 threadCount)
 {
     if(threadCount <= 0) {
-        threadCount = QThread::idealThreadCount();
+        KisImageConfig config;
+        threadCount = config.maxNumberOfThreads();
         threadCount = threadCount > 0 ? threadCount : 1;
     }
 
+    m_threadPool.setMaxThreadCount(threadCount);
+
     m_jobs.resize(threadCount);
     for(qint32 i = 0; i < m_jobs.size(); i++) {
         m_jobs[i] = new KisUpdateJobItem(&m_exclusiveJobLock);
@@ -83,6 +87,18 @@ bool KisUpdaterContext::hasSpareThread()
     return found;
 }
 
+qint32 KisUpdaterContext::numSpareThreads()
+{
+    qint32 numSpare = 0;
+
+    foreach(const KisUpdateJobItem *item, m_jobs) {
+        if(!item->isRunning()) {
+            numSpare++;
+        }
+    }
+    return numSpare;
+}
+
 bool KisUpdaterContext::isJobAllowed(KisBaseRectsWalkerSP walker)
 {
     bool intersects = false;
@@ -36,6 +36,11 @@ class KRITAIMAGE_EXPORT KisUpdaterContext : public QObject
     Q_OBJECT
 
 public:
+    /**
+     * Creates a context with \p threadCount threads. If \p threadCount
+     * is not positive, the number of threads is taken from
+     * KisImageConfig::maxNumberOfThreads()
+     */
     KisUpdaterContext(qint32 threadCount = -1);
     virtual ~KisUpdaterContext();
 
@@ -54,6 +59,14 @@ public:
      */
     bool hasSpareThread();
 
+    /**
+     * Returns the number of threads that are not running any
+     * job at the moment. Should be called with the lock held.
+     *
+     * \see lock()
+     */
+    qint32 numSpareThreads();
+
     /**
      * Checks whether the walker intersects with any
      * of currently executing walkers. If it does,
@@ -27,6 +27,7 @@
 #include <QVector2D>
 #include <QPainter>
 #include <QVarLengthArray>
+#include <QtConcurrentMap>
 
 #include <KoColorSpace.h>
 #include <KoColor.h>
@@ -183,7 +184,7 @@ QPointF KisWarpTransformWorker::rigidTransformMath(QPointF v, QVector<QPointF> p
 }
 
 KisWarpTransformWorker::KisWarpTransformWorker(WarpType warpType, KisPaintDeviceSP dev, QVector<QPointF> origPoint, QVector<QPointF> transfPoint, qreal alpha, KoUpdater *progress)
-        : m_dev(dev), m_progress(progress)
+        : m_dev(dev), m_progress(progress), m_threadCount(1)
 {
     m_origPoint = origPoint;
     m_transfPoint = transfPoint;
@@ -209,6 +210,16 @@ KisWarpTransformWorker::~KisWarpTransformWorker()
 {
 }
 
+void KisWarpTransformWorker::setThreadCount(int threadCount)
+{
+    m_threadCount = qMax(1, threadCount);
+}
+
+int KisWarpTransformWorker::threadCount() const
+{
+    return m_threadCount;
+}
+
 struct KisWarpTransformWorker::FunctionTransformOp
 {
     FunctionTransformOp(KisWarpTransformWorker::WarpMathFunction function,
@@ -232,6 +243,24 @@ struct KisWarpTransformWorker::FunctionTransformOp
     qreal m_alpha;
 };
 
+namespace {
+
+template <class TransformOp>
+struct TransformPointFunctor
+{
+    typedef void result_type;
+
+    TransformPointFunctor(const TransformOp &op) : m_op(op) {}
+
+    void operator() (QPointF &pt) {
+        pt = m_op(pt);
+    }
+
+    TransformOp m_op;
+};
+
+}
+
 void KisWarpTransformWorker::run()
 {
 
@@ -258,8 +287,35 @@ void KisWarpTransformWorker::run()
 
     FunctionTransformOp functionOp(m_warpMathFunction, m_origPoint, m_transfPoint, m_alpha);
     GridIterationTools::PaintDevicePolygonOp polygonOp(srcdev, m_dev);
-    GridIterationTools::processGrid(polygonOp, functionOp,
-                                    srcBounds, pixelPrecision);
+
+    if (m_threadCount > 1) {
+        /**
+         * Every grid point is independent, so they are transformed in
+         * parallel. The polygons of the neighbouring cells may overlap
+         * in the destination, so they are still painted sequentially.
+         */
+        GridIterationTools::CollectGridPointsOp collectOp;
+        GridIterationTools::processGrid(collectOp, srcBounds, pixelPrecision);
+
+        QVector<QPointF> transformedPoints = collectOp.points;
+        QtConcurrent::blockingMap(transformedPoints,
+                                  TransformPointFunctor<FunctionTransformOp>(functionOp));
+
+        if (m_progress) {
+            m_progress->setProgress(50);
+        }
+
+        GridIterationTools::PrecalculatedTransformOp precalculatedOp(transformedPoints);
+        GridIterationTools::processGrid(polygonOp, precalculatedOp,
+                                        srcBounds, pixelPrecision);
+    } else {
+        GridIterationTools::processGrid(polygonOp, functionOp,
+                                        srcBounds, pixelPrecision);
+    }
+
+    if (m_progress) {
+        m_progress->setProgress(100);
+    }
 }
 
 QImage KisWarpTransformWorker::transformQImage(WarpType warpType,
@@ -67,6 +67,14 @@ public:
     // Perform the prepated transformation
     void run();
 
+    /**
+     * Set the number of threads run() may use for calculating the
+     * transformed grid, which is the most expensive part of the
+     * warp. The default value is 1.
+     */
+    void setThreadCount(int threadCount);
+    int threadCount() const;
+
 private:
     struct FunctionTransformOp;
     typedef QPointF (*WarpMathFunction)(QPointF, QVector<QPointF>, QVector<QPointF>, qreal);
@@ -78,6 +86,7 @@ private:
     qreal m_alpha;
     KisPaintDeviceSP m_dev;
     KoUpdater *m_progress;
+    int m_threadCount;
 };
 
 #endif
@@ -30,6 +30,7 @@
 
 #include "kis_image_config.h"
 #include "kis_debug.h"
+#include "tiles3/kis_tile_data.h"
 
 
 namespace KritaUtils
@@ -67,6 +68,38 @@ namespace KritaUtils
         return patches;
     }
 
+    QVector<QRect> splitRectIntoTileAlignedStripes(const QRect &rc, int numStripes, Qt::Orientation orientation)
+    {
+        QVector<QRect> stripes;
+        if (rc.isEmpty()) return stripes;
+
+        const bool horizontal = orientation == Qt::Horizontal;
+        const int tileSize = horizontal ? KisTileData::HEIGHT : KisTileData::WIDTH;
+        const int start = horizontal ? rc.top() : rc.left();
+        const int end = start + (horizontal ? rc.height() : rc.width());
+
+        numStripes = qMax(1, numStripes);
+        int stripeSize = (end - start + numStripes - 1) / numStripes;
+        stripeSize = qMax(1, (stripeSize + tileSize - 1) / tileSize) * tileSize;
+
+        int stripeStart = start;
+
+        while (stripeStart < end) {
+            int tileOffset = stripeStart % tileSize;
+            if (tileOffset < 0) tileOffset += tileSize;
+
+            const int stripeEnd = qMin(stripeStart - tileOffset + stripeSize, end);
+
+            stripes.append(horizontal ?
+                           QRect(rc.left(), stripeStart, rc.width(), stripeEnd - stripeStart) :
+                           QRect(stripeStart, rc.top(), stripeEnd - stripeStart, rc.height()));
+
+            stripeStart = stripeEnd;
+        }
+
+        return stripes;
+    }
+
     bool checkInTriangle(const QRectF &rect,
                          const QPolygonF &triangle)
     {
@@ -35,6 +35,14 @@ namespace KritaUtils
 
     QVector<QRect> KRITAIMAGE_EXPORT splitRectIntoPatches(const QRect &rc, const QSize &patchSize);
 
+    /**
+     * Split \p rc into about \p numStripes stripes aligned to the
+     * tile grid, so that no two stripes share a tile and can be
+     * written from different threads. Qt::Horizontal gives bands of
+     * rows, Qt::Vertical gives bands of columns.
+     */
+    QVector<QRect> KRITAIMAGE_EXPORT splitRectIntoTileAlignedStripes(const QRect &rc, int numStripes, Qt::Orientation orientation);
+
     QRegion KRITAIMAGE_EXPORT splitTriangles(const QPointF &center,
                                              const QVector<QPointF> &points);
     QRegion KRITAIMAGE_EXPORT splitPath(const QPainterPath &path);
@@ -26,6 +26,7 @@
 #include <KoColorSpace.h>
 #include <KoColorSpaceRegistry.h>
 #include <KoColorSpaceTraits.h>
+#include <KoProgressUpdater.h>
 
 #include "kis_types.h"
 #include "kis_paint_device.h"
@@ -437,4 +438,96 @@ void KisConvolutionPainterTest::testGaussianDetailsFFTW()
     testGaussianDetails(true);
 }
 
+void KisConvolutionPainterTest::testMultithreaded(bool useFftw)
+{
+    QImage referenceImage(QString(FILES_DATA_DIR) + QDir::separator() + "hakonepa.png");
+    QRect imageRect(QPoint(), referenceImage.size());
+
+    KisPaintDeviceSP serialDev = new KisPaintDevice(KoColorSpaceRegistry::instance()->rgb8());
+    serialDev->convertFromQImage(referenceImage, 0, 0, 0);
+    KisPaintDeviceSP threadedDev = new KisPaintDevice(*serialDev);
+
+    KisConvolutionKernelSP kernel = KisGaussianKernel::createVerticalKernel(useFftw ? 10 : 2);
+
+    KisConvolutionPainter::TestingEnginePreference enginePreference =
+        useFftw ?
+        KisConvolutionPainter::FFTW :
+        KisConvolutionPainter::SPATIAL;
+
+    /**
+     * Convolve the devices in place to check that the bands
+     * do not read the pixels written by each other
+     */
+    KisConvolutionPainter serialPainter(serialDev, enginePreference);
+    serialPainter.beginTransaction();
+    serialPainter.applyMatrix(kernel, serialDev, imageRect.topLeft(), imageRect.topLeft(),
+                              imageRect.size(), BORDER_REPEAT);
+    serialPainter.deleteTransaction();
+
+    KisConvolutionPainter threadedPainter(threadedDev, enginePreference);
+    threadedPainter.setThreadCount(4);
+    threadedPainter.beginTransaction();
+    threadedPainter.applyMatrix(kernel, threadedDev, imageRect.topLeft(), imageRect.topLeft(),
+                                imageRect.size(), BORDER_REPEAT);
+    threadedPainter.deleteTransaction();
+
+    QImage serialImage = serialDev->convertToQImage(0, imageRect);
+    QImage threadedImage = threadedDev->convertToQImage(0, imageRect);
+
+    // the FFT of a band has different rounding errors than the FFT of the whole image
+    QPoint errpoint;
+    if (!TestUtil::compareQImages(errpoint, serialImage, threadedImage, useFftw ? 1 : 0, useFftw ? 1 : 0)) {
+        serialImage.save("multithreaded_serial.png");
+        threadedImage.save("multithreaded_threaded.png");
+        QFAIL(QString("Multithreaded convolution differs from the serial one at %1,%2")
+              .arg(errpoint.x()).arg(errpoint.y()).toLatin1());
+    }
+}
+
+void KisConvolutionPainterTest::testMultithreadedSpatial()
+{
+    testMultithreaded(false);
+}
+
+void KisConvolutionPainterTest::testMultithreadedFFTW()
+{
+    testMultithreaded(true);
+}
+
+void KisConvolutionPainterTest::testMultithreadedCancel()
+{
+    QImage referenceImage(QString(FILES_DATA_DIR) + QDir::separator() + "hakonepa.png");
+    QRect imageRect(QPoint(), referenceImage.size());
+
+    KisPaintDeviceSP dev = new KisPaintDevice(KoColorSpaceRegistry::instance()->rgb8());
+    dev->convertFromQImage(referenceImage, 0, 0, 0);
+
+    KisConvolutionKernelSP kernel = KisGaussianKernel::createVerticalKernel(2);
+
+    TestUtil::TestProgressBar bar;
+    KoProgressUpdater pu(&bar);
+    KoUpdaterPtr updater = pu.startSubtask();
+
+    KisConvolutionPainter painter(dev, KisConvolutionPainter::SPATIAL);
+    painter.setThreadCount(4);
+    painter.setProgress(updater);
+    painter.applyMatrix(kernel, dev, imageRect.topLeft(), imageRect.topLeft(),
+                        imageRect.size(), BORDER_REPEAT);
+
+    QCOMPARE(updater->progress(), 100);
+
+    // every band should stop after the first column
+    dev->convertFromQImage(referenceImage, 0, 0, 0);
+    pu.cancel();
+
+    painter.applyMatrix(kernel, dev, imageRect.topLeft(), imageRect.topLeft(),
+                        imageRect.size(), BORDER_REPEAT);
+
+    QImage resultImage = dev->convertToQImage(0, imageRect);
+
+    QPoint errpoint;
+    QVERIFY(TestUtil::compareQImages(errpoint, referenceImage.convertToFormat(QImage::Format_ARGB32),
+                                     resultImage, 0, 0, imageRect.height()));
+}
+
 QTEST_KDEMAIN(KisConvolutionPainterTest, GUI)
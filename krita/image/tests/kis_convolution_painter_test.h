@@ -35,6 +35,7 @@ private:
     void testGaussian(bool useFftw);
     void testGaussianSmall(bool useFftw);
     void testGaussianDetails(bool useFftw);
+    void testMultithreaded(bool useFftw);
 
 private Q_SLOTS:
 
@@ -56,6 +57,10 @@ private Q_SLOTS:
 
     void testGaussianDetailsSpatial();
     void testGaussianDetailsFFTW();
+
+    void testMultithreadedSpatial();
+    void testMultithreadedFFTW();
+    void testMultithreadedCancel();
 };
 
 #endif
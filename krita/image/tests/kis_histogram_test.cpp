@@ -22,6 +22,8 @@
 #include <KoColorSpace.h>
 #include <KoColorSpaceRegistry.h>
 #include <KoHistogramProducer.h>
+#include <KoBasicHistogramProducers.h>
+#include <KoColor.h>
 #include "kis_paint_device.h"
 #include "kis_histogram.h"
 #include "kis_paint_layer.h"
@@ -44,5 +46,33 @@ void KisHistogramTest::testCreation()
     }
 }
 
+void KisHistogramTest::testIncrementalUpdate()
+{
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    const QRect bounds(0, 0, 600, 600);
+    dev->fill(bounds, KoColor(Qt::white, cs));
+
+    KoHistogramProducerSP incrementalProducer(new KoBasicU8HistogramProducer(KoID("RGB8HISTO", "RGB8"), cs));
+    KisHistogram incremental(dev, bounds, incrementalProducer, LINEAR);
+    QCOMPARE(incrementalProducer->count(), qint32(bounds.width() * bounds.height()));
+
+    const QRect dirtyRect(250, 250, 100, 100);
+    dev->fill(dirtyRect, KoColor(Qt::red, cs));
+    incremental.updateHistogram(dirtyRect);
+
+    KoHistogramProducerSP fullProducer(new KoBasicU8HistogramProducer(KoID("RGB8HISTO", "RGB8"), cs));
+    KisHistogram full(dev, bounds, fullProducer, LINEAR);
+
+    QCOMPARE(incrementalProducer->count(), fullProducer->count());
+
+    for (int channel = 0; channel < int(cs->channelCount()); channel++) {
+        for (int bin = 0; bin < fullProducer->numberOfBins(); bin++) {
+            QCOMPARE(incrementalProducer->getBinAt(channel, bin),
+                     fullProducer->getBinAt(channel, bin));
+        }
+    }
+}
 
 QTEST_KDEMAIN(KisHistogramTest, GUI)
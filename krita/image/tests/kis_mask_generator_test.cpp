@@ -21,6 +21,13 @@
 
 #include <qtest_kde.h>
 #include "kis_mask_generator.h"
+#include "kis_cubic_curve.h"
+#include "kis_brush_mask_applicator_base.h"
+#include "kis_fixed_paint_device.h"
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
 
 #include <QDomDocument>
 #include <QImage>
@@ -102,4 +109,79 @@ void KisMaskGeneratorTest::testSquareSerialisation()
     delete cmg2;
 }
 
+/**
+ * Compares the dab rendered by the applicator of the generator (which
+ * is vectorized when possible) against the values of valueAt()
+ */
+bool checkApplicator(KisMaskGenerator *generator)
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    const QRect rc(0, 0, 100, 100);
+
+    KisFixedPaintDeviceSP dev = new KisFixedPaintDevice(cs);
+    dev->setRect(rc);
+    dev->initialize();
+
+    KoColor white(Qt::white, cs);
+    dev->fill(rc.x(), rc.y(), rc.width(), rc.height(), white.data());
+
+    const qreal centerX = 0.5 * rc.width();
+    const qreal centerY = 0.5 * rc.height();
+
+    MaskProcessingData data(dev, cs, 0.0, 1.0, centerX, centerY, 0.0);
+
+    KisBrushMaskApplicatorBase *applicator = generator->applicator();
+    applicator->initializeData(&data);
+    applicator->process(rc);
+
+    const quint8 *pixel = dev->data();
+
+    for (int y = rc.top(); y <= rc.bottom(); y++) {
+        for (int x = rc.left(); x <= rc.right(); x++) {
+            const int expected = 255 - generator->valueAt(x - centerX, y - centerY);
+            const int actual = cs->opacityU8(pixel);
+
+            // the vectorized versions do not truncate the intermediate values
+            if (qAbs(expected - actual) > 2) {
+                qDebug() << "Different pixel at" << x << y
+                         << "expected:" << expected << "actual:" << actual;
+                return false;
+            }
+
+            pixel += cs->pixelSize();
+        }
+    }
+
+    return true;
+}
+
+void KisMaskGeneratorTest::testVectorizedApplicators()
+{
+    QList<QPointF> points;
+    points << QPointF(0.0, 1.0) << QPointF(0.5, 0.5) << QPointF(1.0, 0.0);
+    KisCubicCurve curve(points);
+
+    for (int i = 0; i < 2; i++) {
+        const bool antialiasEdges = i;
+
+        KisCircleMaskGenerator circle(80, 1.0, 0.5, 0.5, 2, antialiasEdges);
+        QVERIFY(checkApplicator(&circle));
+
+        KisRectangleMaskGenerator rect(80, 0.7, 0.5, 0.3, 2, antialiasEdges);
+        QVERIFY(checkApplicator(&rect));
+
+        KisGaussCircleMaskGenerator gaussCircle(80, 1.0, 0.5, 0.5, 2, antialiasEdges);
+        QVERIFY(checkApplicator(&gaussCircle));
+
+        KisGaussRectangleMaskGenerator gaussRect(80, 0.7, 0.5, 0.3, 2, antialiasEdges);
+        QVERIFY(checkApplicator(&gaussRect));
+
+        KisCurveCircleMaskGenerator curveCircle(80, 1.0, 0.5, 0.5, 2, curve, antialiasEdges);
+        QVERIFY(checkApplicator(&curveCircle));
+
+        KisCurveRectangleMaskGenerator curveRect(80, 0.7, 0.5, 0.3, 2, curve, antialiasEdges);
+        QVERIFY(checkApplicator(&curveRect));
+    }
+}
+
 QTEST_KDEMAIN(KisMaskGeneratorTest, GUI)
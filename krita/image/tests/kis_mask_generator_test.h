@@ -28,6 +28,8 @@ private Q_SLOTS:
 
     void testCircleSerialisation();
     void testSquareSerialisation();
+
+    void testVectorizedApplicators();
 };
 
 #endif
@@ -20,6 +20,7 @@
 #include <qtest_kde.h>
 
 #include <QTime>
+#include <QBuffer>
 
 #include <KoColor.h>
 #include <KoColorSpace.h>
@@ -38,6 +39,7 @@
 #include "testutil.h"
 #include "kis_transaction.h"
 #include "kis_image.h"
+#include "kis_image_config.h"
 
 class KisFakePaintDeviceWriter : public KisPaintDeviceWriter {
 public:
@@ -1375,4 +1377,106 @@ void KisPaintDeviceTest::testCacheState()
     pool.waitForDone();
 }
 
+void KisPaintDeviceTest::testLazyLoading()
+{
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    KoStore * readStore =
+        KoStore::createStore(QString(FILES_DATA_DIR) + QDir::separator() + "store_test.kra", KoStore::Read);
+    readStore->open("built image/layers/layer0");
+    QByteArray data = readStore->read(readStore->size());
+    readStore->close();
+    delete readStore;
+
+    KisPaintDeviceSP ref = new KisPaintDevice(cs);
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::ReadOnly);
+    QVERIFY(ref->read(&buffer));
+    buffer.close();
+
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    dev->readLazily(data);
+    QVERIFY(dev->hasPendingData());
+
+    // the copy shares the pending data and does not decode it
+    KisPaintDeviceSP copy = new KisPaintDevice(*dev);
+    QVERIFY(dev->hasPendingData());
+    QVERIFY(copy->hasPendingData());
+
+    // writing the device stores the pending data as it is
+    KoStore * writeStore =
+        KoStore::createStore(QString(FILES_OUTPUT_DIR) + QDir::separator() + "lazy_store_test_out.kra", KoStore::Write);
+    KisFakePaintDeviceWriter fakeWriter(writeStore);
+    writeStore->open("built image/layers/layer0");
+    QVERIFY(dev->write(fakeWriter));
+    writeStore->close();
+    delete writeStore;
+    QVERIFY(dev->hasPendingData());
+
+    // the first access decodes the data
+    QCOMPARE(dev->exactBounds(), QRect(0, 0, 100, 100));
+    QVERIFY(!dev->hasPendingData());
+    QVERIFY(copy->hasPendingData());
+
+    QPoint pt;
+    if (!TestUtil::comparePaintDevices(pt, ref, dev)) {
+        QFAIL(QString("Lazily loaded device differs, first different pixel: %1,%2 ").arg(pt.x()).arg(pt.y()).toLatin1());
+    }
+    if (!TestUtil::comparePaintDevices(pt, ref, copy)) {
+        QFAIL(QString("Copy of the lazily loaded device differs, first different pixel: %1,%2 ").arg(pt.x()).arg(pt.y()).toLatin1());
+    }
+
+    KisPaintDeviceSP dev2 = new KisPaintDevice(cs);
+    readStore =
+        KoStore::createStore(QString(FILES_OUTPUT_DIR) + QDir::separator() + "lazy_store_test_out.kra", KoStore::Read);
+    readStore->open("built image/layers/layer0");
+    QVERIFY(dev2->read(readStore->device()));
+    readStore->close();
+    delete readStore;
+
+    if (!TestUtil::comparePaintDevices(pt, ref, dev2)) {
+        QFAIL(QString("Saving the pending data is not pixel perfect, first different pixel: %1,%2 ").arg(pt.x()).arg(pt.y()).toLatin1());
+    }
+
+    // clearing the device drops the pending data
+    KisPaintDeviceSP dev3 = new KisPaintDevice(cs);
+    dev3->readLazily(data);
+    dev3->clear();
+    QVERIFY(!dev3->hasPendingData());
+    QVERIFY(dev3->exactBounds().isEmpty());
+}
+
+void KisPaintDeviceTest::testParallelConvertTo()
+{
+    const KoColorSpace *rgb = KoColorSpaceRegistry::instance()->rgb16();
+    const KoColorSpace *lab = KoColorSpaceRegistry::instance()->lab16();
+
+    QImage image(QString(FILES_DATA_DIR) + QDir::separator() + "hakonepa.png");
+
+    KisPaintDeviceSP dev = new KisPaintDevice(rgb);
+    dev->convertFromQImage(image, 0, 13, 17);
+
+    KisPaintDeviceSP serialDev = new KisPaintDevice(*dev);
+    KisPaintDeviceSP parallelDev = new KisPaintDevice(*dev);
+
+    KisImageConfig config;
+    const int savedNumThreads = config.maxNumberOfThreads();
+
+    config.setMaxNumberOfThreads(1);
+    delete serialDev->convertTo(lab);
+
+    config.setMaxNumberOfThreads(4);
+    delete parallelDev->convertTo(lab);
+
+    config.setMaxNumberOfThreads(savedNumThreads);
+
+    QVERIFY(*parallelDev->colorSpace() == *lab);
+    QCOMPARE(parallelDev->exactBounds(), serialDev->exactBounds());
+
+    QPoint pt;
+    if (!TestUtil::comparePaintDevices(pt, serialDev, parallelDev)) {
+        QFAIL(QString("Parallel conversion differs from the serial one, first different pixel: %1,%2 ").arg(pt.x()).arg(pt.y()).toLatin1());
+    }
+}
+
 QTEST_KDEMAIN(KisPaintDeviceTest, GUI)
@@ -62,6 +62,10 @@ private Q_SLOTS:
     void testMoveWrapAround();
 
     void testCacheState();
+
+    void testLazyLoading();
+
+    void testParallelConvertTo();
 };
 
 #endif
@@ -70,4 +70,22 @@ void KisPerspectiveTransformWorkerTest::testSimpleTransform()
     t.checkLayer("simple_transform");
 }
 
+void KisPerspectiveTransformWorkerTest::testMultithreaded()
+{
+    PerspectiveWorkerTester t;
+    KisPaintDeviceSP dev = t.paintDevice();
+
+    QPointF dx(326, 214);
+    qreal aX = 1.32;
+    qreal aY = 0.8;
+    qreal z = 1024;
+
+    KisPerspectiveTransformWorker worker(dev, dx, aX, aY, z, 0);
+    worker.setThreadCount(4);
+    worker.run();
+
+    // the stripes must give exactly the same result as the serial run
+    t.checkLayer("simple_transform");
+}
+
 QTEST_KDEMAIN(KisPerspectiveTransformWorkerTest, GUI)
@@ -30,6 +30,7 @@
 #include <KoColorSpaceRegistry.h>
 #include "kis_types.h"
 #include "kis_paint_device.h"
+#include "kis_pixel_selection.h"
 
 
 void KisScanlineFillTest::testFillGeneral(const QVector<KisFillInterval> &initialBackwardIntervals,
@@ -247,4 +248,82 @@ void KisScanlineFillTest::testFillBackwardCollisionSanityCheck()
 #endif /* ENABLE_FILL_SANITY_CHECKS */
 }
 
+/**
+ * Creates a device with a serpentine corridor, so that the fill
+ * crosses the band borders many times in both directions
+ */
+static KisPaintDeviceSP createSerpentineDevice(const QRect &rc)
+{
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    KoColor wallColor(Qt::white, cs);
+
+    int wallIndex = 0;
+    for (int y = rc.top() + 10; y <= rc.bottom(); y += 20) {
+        const bool gapOnTheLeft = wallIndex++ % 2;
+        const int left = gapOnTheLeft ? rc.left() + 15 : rc.left();
+        const int width = rc.width() - 15;
+
+        dev->fill(left, y, width, 3, wallColor.data());
+    }
+
+    // a vertical wall in the middle with a hole in every corridor
+    for (int y = rc.top(); y <= rc.bottom(); y += 20) {
+        dev->fill(rc.center().x(), y, 2, 15, wallColor.data());
+    }
+
+    return dev;
+}
+
+void KisScanlineFillTest::testParallelFillColor()
+{
+    const QRect rc(0, 0, 300, 500);
+
+    KisPaintDeviceSP dev1 = createSerpentineDevice(rc);
+    KisPaintDeviceSP dev2 = createSerpentineDevice(rc);
+
+    const KoColor fillColor(Qt::red, dev1->colorSpace());
+
+    KisScanlineFill gc1(dev1, QPoint(1, 1), rc);
+    gc1.fillColor(fillColor);
+
+    KisScanlineFill gc2(dev2, QPoint(1, 1), rc);
+    gc2.setThreadCount(4);
+    gc2.fillColor(fillColor);
+
+    QPoint errpoint;
+    if (!TestUtil::comparePaintDevices(errpoint, dev1, dev2)) {
+        QFAIL(QString("Parallel fill differs from the single-threaded one at (%1, %2)")
+              .arg(errpoint.x()).arg(errpoint.y()).toLatin1());
+    }
+}
+
+void KisScanlineFillTest::testParallelFillSelection()
+{
+    const QRect rc(0, 0, 300, 500);
+
+    KisPaintDeviceSP dev = createSerpentineDevice(rc);
+
+    KisPixelSelectionSP selection1 = new KisPixelSelection();
+    KisPixelSelectionSP selection2 = new KisPixelSelection();
+
+    KisScanlineFill gc1(dev, QPoint(1, 1), rc);
+    gc1.setThreshold(20);
+    gc1.fillSelection(selection1);
+
+    KisScanlineFill gc2(dev, QPoint(1, 1), rc);
+    gc2.setThreshold(20);
+    gc2.setThreadCount(4);
+    gc2.fillSelection(selection2);
+
+    QCOMPARE(selection2->selectedExactRect(), selection1->selectedExactRect());
+
+    QPoint errpoint;
+    if (!TestUtil::comparePaintDevices(errpoint, selection1, selection2)) {
+        QFAIL(QString("Parallel selection differs from the single-threaded one at (%1, %2)")
+              .arg(errpoint.x()).arg(errpoint.y()).toLatin1());
+    }
+}
+
 QTEST_KDEMAIN(KisScanlineFillTest, GUI)
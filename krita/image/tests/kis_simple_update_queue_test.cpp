@@ -32,6 +32,7 @@
 
 #include "kis_update_job_item.h"
 #include "kis_simple_update_queue.h"
+#include "kis_merge_walker.h"
 #include "scheduler_utils.h"
 
 
@@ -249,5 +250,91 @@ void KisSimpleUpdateQueueTest::testSpontaneousJobsCompression()
     QCOMPARE(jobsList[0], job3);
 }
 
+void KisSimpleUpdateQueueTest::testSplitWalker()
+{
+    QRect imageRect(0,0,512,512);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "split test");
+
+    KisPaintLayerSP paintLayer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+
+    image->lock();
+    image->addNode(paintLayer);
+    image->unlock();
+
+    KisBaseRectsWalkerSP walker = new KisMergeWalker(imageRect);
+    walker->collectRects(paintLayer, imageRect);
+
+    KisWalkersList parts = KisSimpleUpdateQueue::splitWalker(walker, 4);
+
+    QCOMPARE(parts.size(), 4);
+    QVERIFY(checkWalker(parts[0], QRect(0,0,256,256)));
+    QVERIFY(checkWalker(parts[1], QRect(256,0,256,256)));
+    QVERIFY(checkWalker(parts[2], QRect(0,256,256,256)));
+    QVERIFY(checkWalker(parts[3], QRect(256,256,256,256)));
+
+    foreach (KisBaseRectsWalkerSP part, parts) {
+        QCOMPARE(part->type(), walker->type());
+        QVERIFY(part->startNode() == walker->startNode());
+    }
+
+    // too small to be split
+    walker->collectRects(paintLayer, QRect(0,0,200,200));
+    QVERIFY(KisSimpleUpdateQueue::splitWalker(walker, 4).isEmpty());
+
+    // the blur makes the parts depend on each other
+    KisFilterSP filter = KisFilterRegistry::instance()->value("blur");
+    Q_ASSERT(filter);
+    KisFilterConfiguration *configuration = filter->defaultConfiguration(0);
+
+    KisAdjustmentLayerSP blurLayer = new KisAdjustmentLayer(image, "blur", configuration, 0);
+
+    image->lock();
+    image->addNode(blurLayer);
+    image->unlock();
+
+    walker->collectRects(paintLayer, imageRect);
+
+    // ... and it is visible without collecting the rects of the parts
+    bool partsIntersect = false;
+    QVERIFY(KisSimpleUpdateQueue::splitWalker(walker, 4, &partsIntersect).isEmpty());
+    QVERIFY(!partsIntersect);
+}
+
+void KisSimpleUpdateQueueTest::testSplitForSpareThreads()
+{
+    KisTestableUpdaterContext context(4);
+
+    QRect imageRect(0,0,512,512);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "split test");
+
+    KisPaintLayerSP paintLayer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+
+    image->lock();
+    image->addNode(paintLayer);
+    image->unlock();
+
+    KisTestableSimpleUpdateQueue queue;
+    KisWalkersList& walkersList = queue.getWalkersList();
+
+    queue.addUpdateJob(paintLayer, imageRect, imageRect);
+    QCOMPARE(walkersList.size(), 1);
+
+    queue.processQueue(context);
+
+    QVector<KisUpdateJobItem*> jobs = context.getJobs();
+
+    QCOMPARE(jobs.size(), 4);
+    QVERIFY(checkWalker(jobs[0]->walker(), QRect(0,0,256,256)));
+    QVERIFY(checkWalker(jobs[1]->walker(), QRect(256,0,256,256)));
+    QVERIFY(checkWalker(jobs[2]->walker(), QRect(0,256,256,256)));
+    QVERIFY(checkWalker(jobs[3]->walker(), QRect(256,256,256,256)));
+
+    QCOMPARE(walkersList.size(), 0);
+}
+
 QTEST_KDEMAIN(KisSimpleUpdateQueueTest, NoGUI)
 
@@ -994,4 +994,48 @@ void KisTransformWorkerTest::testPartialProcessing()
     TestUtil::checkQImage(result, "transform_test", "partial", "single");
 }
 
+void KisTransformWorkerTest::testMultithreaded()
+{
+    TestUtil::TestProgressBar bar;
+    KoProgressUpdater pu(&bar);
+    KoUpdaterPtr updater = pu.startSubtask();
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    QImage image(TestUtil::fetchDataFileLazy("test_transform_quality.png"));
+
+    KisPaintDeviceSP serialDev = new KisPaintDevice(cs);
+    serialDev->convertFromQImage(image, 0);
+
+    KisPaintDeviceSP threadedDev = new KisPaintDevice(cs);
+    threadedDev->convertFromQImage(image, 0);
+
+    KisFilterStrategy * filter = new KisBicubicFilterStrategy();
+
+    KisTransformWorker serialWorker(serialDev, 1.3, 0.7,
+                                    0.2, 0.1,
+                                    0.0, 0.0,
+                                    M_PI / 7,
+                                    15, -10, 0, filter);
+    serialWorker.run();
+
+    KisTransformWorker threadedWorker(threadedDev, 1.3, 0.7,
+                                      0.2, 0.1,
+                                      0.0, 0.0,
+                                      M_PI / 7,
+                                      15, -10, updater, filter);
+    threadedWorker.setThreadCount(4);
+    threadedWorker.run();
+
+    QCOMPARE(threadedDev->exactBounds(), serialDev->exactBounds());
+
+    QPoint errpoint;
+    if (!TestUtil::compareQImages(errpoint,
+                                  serialDev->convertToQImage(0),
+                                  threadedDev->convertToQImage(0))) {
+        QFAIL(QString("Threaded transform differs from the serial one, first different pixel: %1,%2 \n").arg(errpoint.x()).arg(errpoint.y()).toLatin1());
+    }
+
+    delete filter;
+}
+
 QTEST_KDEMAIN(KisTransformWorkerTest, GUI)
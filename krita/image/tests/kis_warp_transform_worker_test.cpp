@@ -79,6 +79,54 @@ void KisWarpTransformWorkerTest::test()
     TestUtil::checkQImage(result, "warp_transform_test", "simple", "tr");
 }
 
+void KisWarpTransformWorkerTest::testMultithreaded()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    QImage image(TestUtil::fetchDataFileLazy("test_transform_quality_second.png"));
+
+    KisPaintDeviceSP serialDev = new KisPaintDevice(cs);
+    serialDev->convertFromQImage(image, 0);
+
+    KisPaintDeviceSP threadedDev = new KisPaintDevice(cs);
+    threadedDev->convertFromQImage(image, 0);
+
+    QVector<QPointF> origPoints;
+    QVector<QPointF> transfPoints;
+    qreal alpha = 1.0;
+
+    QRectF bounds(serialDev->exactBounds());
+
+    origPoints << bounds.topLeft();
+    origPoints << bounds.topRight();
+    origPoints << bounds.bottomRight();
+    origPoints << bounds.bottomLeft();
+
+    transfPoints << bounds.topLeft();
+    transfPoints << bounds.bottomLeft() + 0.6 * (bounds.topRight() - bounds.bottomLeft());
+    transfPoints << bounds.topLeft() + 0.8 * (bounds.bottomRight() - bounds.topLeft());
+    transfPoints << bounds.bottomLeft() + QPointF(200, 0);
+
+    KisWarpTransformWorker serialWorker(KisWarpTransformWorker::RIGID_TRANSFORM,
+                                        serialDev, origPoints, transfPoints,
+                                        alpha, 0);
+    serialWorker.run();
+
+    KisWarpTransformWorker threadedWorker(KisWarpTransformWorker::RIGID_TRANSFORM,
+                                          threadedDev, origPoints, transfPoints,
+                                          alpha, 0);
+    threadedWorker.setThreadCount(4);
+    threadedWorker.run();
+
+    QCOMPARE(threadedDev->exactBounds(), serialDev->exactBounds());
+
+    QPoint errpoint;
+    if (!TestUtil::compareQImages(errpoint,
+                                  serialDev->convertToQImage(0),
+                                  threadedDev->convertToQImage(0))) {
+        QFAIL(QString("Threaded warp differs from the serial one, first different pixel: %1,%2 \n").arg(errpoint.x()).arg(errpoint.y()).toLatin1());
+    }
+}
+
 void KisWarpTransformWorkerTest::testQImage()
 {
     TestUtil::TestProgressBar bar;
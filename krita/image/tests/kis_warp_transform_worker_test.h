@@ -27,6 +27,7 @@ class KisWarpTransformWorkerTest : public QObject
 private Q_SLOTS:
     void test();
     void testQImage();
+    void testMultithreaded();
     void testForwardInterpolator();
     void testBackwardInterpolatorXShear();
     void testBackwardInterpolatorYShear();
@@ -0,0 +1,296 @@
+/*
+ *  Copyright (c) 2004 C. Boemann <cbo@boemann.dk>
+ *            (c) 2009 Dmitry Kazakov <dimula73@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KIS_CONCURRENT_TILE_HASH_TABLE_H_
+#define KIS_CONCURRENT_TILE_HASH_TABLE_H_
+
+#include <QAtomicInt>
+#include <QAtomicPointer>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QVector>
+
+#include "kis_tile.h"
+
+
+/**
+ * A drop-in replacement for KisTileHashTableTraits that is optimized
+ * for the case when many threads access the same table concurrently
+ * (e.g. all the updater threads painting on a single layer).
+ *
+ * Lookups (getExistedTile(), tileExists(), getReadOnlyTileLazy() and
+ * the fast path of getTileLazy()) take no locks at all. The readers
+ * only register themselves in a "delete blockers" counter (the same
+ * idea as the one used in KisLocklessStack) and walk the chains
+ * through atomically published head pointers.
+ *
+ * Modifications of the chains are serialized by a small set of
+ * striped bucket locks, so two threads creating tiles in different
+ * buckets do not wait for each other. The tiles unlinked from the
+ * table are not released immediately: they are put into a "pending"
+ * list and freed only when no reader can have a pointer to them
+ * (that is when the number of the delete blockers drops to zero).
+ *
+ * Whole-table operations (iteration, clear(), changing the default
+ * tile data, copying) take the table lock exclusively and still block
+ * all the writers.
+ *
+ * NOTE: the tile's next() pointer is not reset on unlinking, because
+ * a reader may be walking through the unlinked tile at that very
+ * moment. It is reset only when the tile is actually reclaimed, so
+ * you cannot move a tile to another table with this class (use the
+ * legacy KisTileHashTableTraits for that, like KisMementoManager
+ * does).
+ */
+template<class T>
+class KisConcurrentTileHashTableTraits
+{
+public:
+    typedef T               TileType;
+    typedef KisSharedPtr<T> TileTypeSP;
+    typedef KisWeakSharedPtr<T> TileTypeWSP;
+
+    KisConcurrentTileHashTableTraits(KisMementoManager *mm);
+    KisConcurrentTileHashTableTraits(const KisConcurrentTileHashTableTraits<T> &ht,
+                                     KisMementoManager *mm);
+
+    ~KisConcurrentTileHashTableTraits();
+
+    bool isEmpty() {
+        return !m_numTiles.load();
+    }
+
+    bool tileExists(qint32 col, qint32 row);
+
+    /**
+     * Returns a tile in position (col,row). If no tile exists,
+     * returns null.
+     * \param col column of the tile
+     * \param row row of the tile
+     */
+    TileTypeSP getExistedTile(qint32 col, qint32 row);
+
+    /**
+     * Returns a tile in position (col,row). If no tile exists,
+     * creates a new one, attaches it to the list and returns.
+     * \param col column of the tile
+     * \param row row of the tile
+     * \param newTile out-parameter, returns true if a new tile
+     *                was created
+     */
+    TileTypeSP getTileLazy(qint32 col, qint32 row, bool& newTile);
+
+    /**
+     * Returns a tile in position (col,row). If no tile exists,
+     * creates nothing, but returns shared default tile object
+     * of the table. Be careful, this object has column and row
+     * parameters set to (qint32_MIN, qint32_MIN).
+     * \param col column of the tile
+     * \param row row of the tile
+     */
+    TileTypeSP getReadOnlyTileLazy(qint32 col, qint32 row);
+    void addTile(TileTypeSP tile);
+    void deleteTile(TileTypeSP tile);
+    void deleteTile(qint32 col, qint32 row);
+
+    void clear();
+
+    void setDefaultTileData(KisTileData *defaultTileData);
+    KisTileData* defaultTileData() const;
+
+    qint32 numTiles() {
+        return m_numTiles.load();
+    }
+
+    void debugPrintInfo();
+    void debugMaxListLength(qint32 &min, qint32 &max);
+
+private:
+    /**
+     * Marks a section of code that reads the chains without
+     * taking any locks. No tile unlinked from the table is
+     * freed while at least one guard is alive.
+     */
+    class ReadGuard
+    {
+    public:
+        ReadGuard(const KisConcurrentTileHashTableTraits<T> *ht)
+            : m_ht(const_cast<KisConcurrentTileHashTableTraits<T>*>(ht))
+        {
+            m_ht->m_deleteBlockers.ref();
+        }
+
+        ~ReadGuard() {
+            m_ht->m_deleteBlockers.deref();
+            m_ht->tryReclaim();
+        }
+
+    private:
+        KisConcurrentTileHashTableTraits<T> *m_ht;
+    };
+
+private:
+    T* getTile(qint32 col, qint32 row) const;
+    void linkTile(TileTypeSP tile);
+    TileTypeSP unlinkTile(qint32 col, qint32 row);
+
+    inline void setDefaultTileDataImp(KisTileData *defaultTileData);
+    inline KisTileData* defaultTileDataImp() const;
+
+    inline QMutex* bucketLock(qint32 idx) {
+        return &m_bucketLocks[idx & (NUM_BUCKET_LOCKS - 1)];
+    }
+
+    void tryReclaim();
+    void reclaimAll();
+
+    static inline quint32 calculateHash(qint32 col, qint32 row);
+
+    inline qint32 debugChainLen(qint32 idx);
+    void debugListLengthDistibution();
+
+private:
+    template<class U> friend class KisConcurrentTileHashTableIteratorTraits;
+
+    static const qint32 TABLE_SIZE = 1024;
+    static const qint32 NUM_BUCKET_LOCKS = 64;
+
+    /**
+     * m_hashTable owns the heads of the chains, m_heads publishes
+     * them to the lock-free readers. Both are changed under the
+     * corresponding bucket lock only.
+     */
+    TileTypeSP *m_hashTable;
+    QAtomicPointer<T> *m_heads;
+    QMutex *m_bucketLocks;
+
+    QAtomicInt m_numTiles;
+
+    QAtomicPointer<KisTileData> m_defaultTileData;
+    KisMementoManager *m_mementoManager;
+
+    QAtomicInt m_deleteBlockers;
+    QAtomicInt m_numPendingObjects;
+    QMutex m_pendingLock;
+    QVector<TileTypeSP> m_pendingTiles;
+    QVector<KisTileData*> m_pendingTileData;
+
+    /**
+     * Taken for read by the modifiers of the chains and for write
+     * by the whole-table operations
+     */
+    mutable QReadWriteLock m_lock;
+};
+
+#include "kis_concurrent_tile_hash_table_p.h"
+
+
+/**
+ * Walks through all tiles inside hash table
+ * Note: the iterator locks the table exclusively, so the only thing
+ *       you can do with the table while iterating is to delete the
+ *       current tile. Lock-free lookups from the other threads are
+ *       still allowed.
+ */
+template<class T>
+class KisConcurrentTileHashTableIteratorTraits
+{
+public:
+    typedef T               TileType;
+    typedef KisSharedPtr<T> TileTypeSP;
+
+    KisConcurrentTileHashTableIteratorTraits(KisConcurrentTileHashTableTraits<T> *ht) {
+        m_hashTable = ht;
+        m_hashTable->m_lock.lockForWrite();
+
+        m_index = nextNonEmptyList(0);
+        if (m_index < KisConcurrentTileHashTableTraits<T>::TABLE_SIZE)
+            m_tile = m_hashTable->m_hashTable[m_index];
+    }
+
+    ~KisConcurrentTileHashTableIteratorTraits<T>() {
+        if (m_index != -1)
+            destroy();
+    }
+
+    KisConcurrentTileHashTableIteratorTraits<T>& operator++() {
+        next();
+        return *this;
+    }
+
+    void next() {
+        if (m_tile) {
+            m_tile = m_tile->next();
+            if (!m_tile) {
+                qint32 idx = nextNonEmptyList(m_index + 1);
+                if (idx < KisConcurrentTileHashTableTraits<T>::TABLE_SIZE) {
+                    m_index = idx;
+                    m_tile = m_hashTable->m_hashTable[idx];
+                } else {
+                    //EOList reached
+                    destroy();
+                }
+            }
+        }
+    }
+
+    TileTypeSP tile() const {
+        return m_tile;
+    }
+    bool isDone() const {
+        return !m_tile;
+    }
+
+    void deleteCurrent() {
+        TileTypeSP tile = m_tile;
+        next();
+
+        /**
+         * The iterator owns the table exclusively, so no bucket
+         * lock is needed here
+         */
+        m_hashTable->unlinkTile(tile->col(), tile->row());
+    }
+
+    void destroy() {
+        m_index = -1;
+        m_hashTable->m_lock.unlock();
+        m_hashTable->tryReclaim();
+    }
+protected:
+    TileTypeSP m_tile;
+    qint32 m_index;
+    KisConcurrentTileHashTableTraits<T> *m_hashTable;
+
+protected:
+    qint32 nextNonEmptyList(qint32 startIdx) {
+        qint32 idx = startIdx;
+
+        while (idx < KisConcurrentTileHashTableTraits<T>::TABLE_SIZE &&
+                !m_hashTable->m_hashTable[idx]) {
+            idx++;
+        }
+
+        return idx;
+    }
+private:
+    Q_DISABLE_COPY(KisConcurrentTileHashTableIteratorTraits<T>)
+};
+
+#endif /* KIS_CONCURRENT_TILE_HASH_TABLE_H_ */
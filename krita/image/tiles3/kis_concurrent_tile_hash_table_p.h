@@ -0,0 +1,487 @@
+/*
+ *  Copyright (c) 2004 C. Boemann <cbo@boemann.dk>
+ *            (c) 2009 Dmitry Kazakov <dimula73@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include <QtGlobal>
+#include "kis_debug.h"
+#include "kis_global.h"
+
+
+template<class T>
+KisConcurrentTileHashTableTraits<T>::KisConcurrentTileHashTableTraits(KisMementoManager *mm)
+        : m_lock(QReadWriteLock::NonRecursive)
+{
+    m_hashTable = new TileTypeSP [TABLE_SIZE];
+    Q_CHECK_PTR(m_hashTable);
+
+    m_heads = new QAtomicPointer<T> [TABLE_SIZE];
+    Q_CHECK_PTR(m_heads);
+
+    m_bucketLocks = new QMutex [NUM_BUCKET_LOCKS];
+    Q_CHECK_PTR(m_bucketLocks);
+
+    m_mementoManager = mm;
+}
+
+template<class T>
+KisConcurrentTileHashTableTraits<T>::KisConcurrentTileHashTableTraits(const KisConcurrentTileHashTableTraits<T> &ht,
+        KisMementoManager *mm)
+        : m_lock(QReadWriteLock::NonRecursive)
+{
+    /**
+     * The modifiers of the source table take its lock for read,
+     * so we need an exclusive access to get a consistent copy
+     */
+    QWriteLocker locker(&ht.m_lock);
+
+    m_mementoManager = mm;
+    setDefaultTileDataImp(ht.m_defaultTileData.load());
+
+    m_hashTable = new TileTypeSP [TABLE_SIZE];
+    Q_CHECK_PTR(m_hashTable);
+
+    m_heads = new QAtomicPointer<T> [TABLE_SIZE];
+    Q_CHECK_PTR(m_heads);
+
+    m_bucketLocks = new QMutex [NUM_BUCKET_LOCKS];
+    Q_CHECK_PTR(m_bucketLocks);
+
+    TileTypeSP foreignTile;
+    TileType* nativeTile;
+    TileType* nativeTileHead;
+    for (qint32 i = 0; i < TABLE_SIZE; i++) {
+        nativeTileHead = 0;
+
+        foreignTile = ht.m_hashTable[i];
+        while (foreignTile) {
+            nativeTile = new TileType(*foreignTile, m_mementoManager);
+            nativeTile->setNext(nativeTileHead);
+            nativeTileHead = nativeTile;
+
+            foreignTile = foreignTile->next();
+        }
+
+        m_hashTable[i] = nativeTileHead;
+        m_heads[i].storeRelease(nativeTileHead);
+    }
+    m_numTiles.store(ht.m_numTiles.load());
+}
+
+template<class T>
+KisConcurrentTileHashTableTraits<T>::~KisConcurrentTileHashTableTraits()
+{
+    clear();
+    setDefaultTileDataImp(0);
+    reclaimAll();
+
+    delete[] m_hashTable;
+    delete[] m_heads;
+    delete[] m_bucketLocks;
+}
+
+template<class T>
+quint32 KisConcurrentTileHashTableTraits<T>::calculateHash(qint32 col, qint32 row)
+{
+    return ((row << 5) + (col & 0x1F)) & 0x3FF;
+}
+
+template<class T>
+T* KisConcurrentTileHashTableTraits<T>::getTile(qint32 col, qint32 row) const
+{
+    /**
+     * Should be called either inside a ReadGuard or with the bucket
+     * lock held. The tiles we walk through cannot be freed in both
+     * cases, even if they are unlinked from the chain concurrently.
+     */
+    qint32 idx = calculateHash(col, row);
+    T *tile = m_heads[idx].loadAcquire();
+
+    while (tile) {
+        if (tile->col() == col &&
+                tile->row() == row) {
+
+            return tile;
+        }
+
+        tile = tile->next().data();
+    }
+
+    return 0;
+}
+
+template<class T>
+void KisConcurrentTileHashTableTraits<T>::linkTile(TileTypeSP tile)
+{
+    qint32 idx = calculateHash(tile->col(), tile->row());
+    TileTypeSP firstTile = m_hashTable[idx];
+
+    Q_ASSERT_X(!tile->next(), "KisConcurrentTileHashTableTraits<T>::linkTile",
+               "A tile can't be shared by several hash tables, sorry.");
+
+    /**
+     * The tile must be fully linked before it becomes visible
+     * to the lock-free readers
+     */
+    tile->setNext(firstTile);
+    m_hashTable[idx] = tile;
+    m_heads[idx].storeRelease(tile.data());
+
+    m_numTiles.ref();
+}
+
+template<class T>
+typename KisConcurrentTileHashTableTraits<T>::TileTypeSP
+KisConcurrentTileHashTableTraits<T>::unlinkTile(qint32 col, qint32 row)
+{
+    qint32 idx = calculateHash(col, row);
+    TileTypeSP tile = m_hashTable[idx];
+    TileTypeSP prevTile = 0;
+
+    for (; tile; tile = tile->next()) {
+        if (tile->col() == col &&
+                tile->row() == row) {
+
+            if (prevTile) {
+                prevTile->setNext(tile->next());
+            } else {
+                m_hashTable[idx] = tile->next();
+                m_heads[idx].storeRelease(m_hashTable[idx].data());
+            }
+
+            /**
+             * The shared pointer may still be accessed by someone, so
+             * we need to disconnects the tile from memento manager
+             * explicitly. The link to the next tile is kept untouched
+             * until the tile is reclaimed, because some reader may be
+             * walking through it right now.
+             */
+            tile->notifyDead();
+            m_numTiles.deref();
+
+            QMutexLocker locker(&m_pendingLock);
+            m_pendingTiles.append(tile);
+            m_numPendingObjects.ref();
+
+            return tile;
+        }
+        prevTile = tile;
+    }
+
+    return 0;
+}
+
+template<class T>
+void KisConcurrentTileHashTableTraits<T>::tryReclaim()
+{
+    // a fast-path without write ops
+    if (!m_numPendingObjects.load()) return;
+
+    /**
+     * Someone else is already reclaiming or adding objects,
+     * let him do the job
+     */
+    if (!m_pendingLock.tryLock()) return;
+
+    QVector<TileTypeSP> tiles;
+    QVector<KisTileData*> tileDatas;
+
+    /**
+     * All the objects in the pending lists are already unreachable
+     * from the table, so if there are no delete blockers right now,
+     * no one can have a pointer to them anymore.
+     */
+    if (!m_deleteBlockers.fetchAndAddOrdered(0)) {
+        tiles.swap(m_pendingTiles);
+        tileDatas.swap(m_pendingTileData);
+        m_numPendingObjects.fetchAndAddOrdered(-(tiles.size() + tileDatas.size()));
+    }
+
+    m_pendingLock.unlock();
+
+    foreach (TileTypeSP tile, tiles) {
+        tile->setNext(0);
+    }
+
+    foreach (KisTileData *td, tileDatas) {
+        td->unblockSwapping();
+        td->release();
+    }
+}
+
+template<class T>
+void KisConcurrentTileHashTableTraits<T>::reclaimAll()
+{
+    Q_ASSERT(!m_deleteBlockers.load());
+
+    QMutexLocker locker(&m_pendingLock);
+
+    foreach (TileTypeSP tile, m_pendingTiles) {
+        tile->setNext(0);
+    }
+
+    foreach (KisTileData *td, m_pendingTileData) {
+        td->unblockSwapping();
+        td->release();
+    }
+
+    m_pendingTiles.clear();
+    m_pendingTileData.clear();
+    m_numPendingObjects.store(0);
+}
+
+template<class T>
+inline void KisConcurrentTileHashTableTraits<T>::setDefaultTileDataImp(KisTileData *defaultTileData)
+{
+    KisTileData *oldTileData = m_defaultTileData.load();
+
+    if (defaultTileData) {
+        defaultTileData->acquire();
+        defaultTileData->blockSwapping();
+    }
+
+    m_defaultTileData.storeRelease(defaultTileData);
+
+    /**
+     * getReadOnlyTileLazy() may be attaching the old default
+     * data to a new tile right now, so we cannot release it
+     * immediately
+     */
+    if (oldTileData) {
+        QMutexLocker locker(&m_pendingLock);
+        m_pendingTileData.append(oldTileData);
+        m_numPendingObjects.ref();
+    }
+}
+
+template<class T>
+inline KisTileData* KisConcurrentTileHashTableTraits<T>::defaultTileDataImp() const
+{
+    return m_defaultTileData.loadAcquire();
+}
+
+
+template<class T>
+bool KisConcurrentTileHashTableTraits<T>::tileExists(qint32 col, qint32 row)
+{
+    ReadGuard guard(this);
+    return getTile(col, row);
+}
+
+template<class T>
+typename KisConcurrentTileHashTableTraits<T>::TileTypeSP
+KisConcurrentTileHashTableTraits<T>::getExistedTile(qint32 col, qint32 row)
+{
+    ReadGuard guard(this);
+    return getTile(col, row);
+}
+
+template<class T>
+typename KisConcurrentTileHashTableTraits<T>::TileTypeSP
+KisConcurrentTileHashTableTraits<T>::getTileLazy(qint32 col, qint32 row,
+                                                 bool& newTile)
+{
+    newTile = false;
+
+    {
+        ReadGuard guard(this);
+        T *tile = getTile(col, row);
+        if (tile) return tile;
+    }
+
+    QReadLocker tableLocker(&m_lock);
+    QMutexLocker bucketLocker(bucketLock(calculateHash(col, row)));
+
+    /**
+     * Someone could have created the tile while we were waiting
+     * for the lock, so check once again
+     */
+    TileTypeSP tile = getTile(col, row);
+    if (!tile) {
+        tile = new TileType(col, row, defaultTileDataImp(), m_mementoManager);
+        linkTile(tile);
+        newTile = true;
+    }
+
+    return tile;
+}
+
+template<class T>
+typename KisConcurrentTileHashTableTraits<T>::TileTypeSP
+KisConcurrentTileHashTableTraits<T>::getReadOnlyTileLazy(qint32 col, qint32 row)
+{
+    ReadGuard guard(this);
+
+    TileTypeSP tile = getTile(col, row);
+    if (!tile)
+        tile = new TileType(col, row, defaultTileDataImp(), 0);
+
+    return tile;
+}
+
+template<class T>
+void KisConcurrentTileHashTableTraits<T>::addTile(TileTypeSP tile)
+{
+    QReadLocker tableLocker(&m_lock);
+    QMutexLocker bucketLocker(bucketLock(calculateHash(tile->col(), tile->row())));
+    linkTile(tile);
+}
+
+template<class T>
+void KisConcurrentTileHashTableTraits<T>::deleteTile(qint32 col, qint32 row)
+{
+    {
+        QReadLocker tableLocker(&m_lock);
+        QMutexLocker bucketLocker(bucketLock(calculateHash(col, row)));
+
+        unlinkTile(col, row);
+    }
+
+    tryReclaim();
+}
+
+template<class T>
+void KisConcurrentTileHashTableTraits<T>::deleteTile(TileTypeSP tile)
+{
+    deleteTile(tile->col(), tile->row());
+}
+
+template<class T>
+void KisConcurrentTileHashTableTraits<T>::clear()
+{
+    {
+        QWriteLocker locker(&m_lock);
+        QMutexLocker pendingLocker(&m_pendingLock);
+
+        TileTypeSP tile = 0;
+        qint32 i;
+
+        for (i = 0; i < TABLE_SIZE; i++) {
+            tile = m_hashTable[i];
+
+            m_heads[i].storeRelease(0);
+            m_hashTable[i] = 0;
+
+            while (tile) {
+                /**
+                 * About disconnection of tiles see a comment in unlinkTile()
+                 */
+                tile->notifyDead();
+                m_pendingTiles.append(tile);
+                m_numPendingObjects.ref();
+
+                tile = tile->next();
+                m_numTiles.deref();
+            }
+        }
+
+        Q_ASSERT(!m_numTiles.load());
+    }
+
+    tryReclaim();
+}
+
+template<class T>
+void KisConcurrentTileHashTableTraits<T>::setDefaultTileData(KisTileData *defaultTileData)
+{
+    {
+        QWriteLocker locker(&m_lock);
+        setDefaultTileDataImp(defaultTileData);
+    }
+
+    tryReclaim();
+}
+
+template<class T>
+KisTileData* KisConcurrentTileHashTableTraits<T>::defaultTileData() const
+{
+    return defaultTileDataImp();
+}
+
+
+/*************** Debugging stuff ***************/
+
+template<class T>
+void KisConcurrentTileHashTableTraits<T>::debugPrintInfo()
+{
+    dbgTiles << "==========================\n"
+             << "ConcurrentTileHashTable:"
+             << "\n   def. data:\t\t" << m_defaultTileData.load()
+             << "\n   numTiles:\t\t" << m_numTiles.load()
+             << "\n   pending:\t\t" << m_numPendingObjects.load();
+    debugListLengthDistibution();
+    dbgTiles << "==========================\n";
+}
+
+template<class T>
+qint32 KisConcurrentTileHashTableTraits<T>::debugChainLen(qint32 idx)
+{
+    qint32 len = 0;
+    for (TileTypeSP it = m_hashTable[idx]; it; it = it->next(), len++) ;
+    return len;
+}
+
+template<class T>
+void KisConcurrentTileHashTableTraits<T>::debugMaxListLength(qint32 &min, qint32 &max)
+{
+    QWriteLocker locker(&m_lock);
+
+    qint32 maxLen = 0;
+    qint32 minLen = m_numTiles.load();
+    qint32 tmp = 0;
+
+    for (qint32 i = 0; i < TABLE_SIZE; i++) {
+        tmp = debugChainLen(i);
+        if (tmp > maxLen)
+            maxLen = tmp;
+        if (tmp < minLen)
+            minLen = tmp;
+    }
+
+    min = minLen;
+    max = maxLen;
+}
+
+template<class T>
+void KisConcurrentTileHashTableTraits<T>::debugListLengthDistibution()
+{
+    qint32 min, max;
+    qint32 arraySize;
+    qint32 tmp;
+
+    debugMaxListLength(min, max);
+    arraySize = max - min + 1;
+
+    qint32 *array = new qint32[arraySize];
+    memset(array, 0, sizeof(qint32)*arraySize);
+
+    QWriteLocker locker(&m_lock);
+
+    for (qint32 i = 0; i < TABLE_SIZE; i++) {
+        tmp = debugChainLen(i);
+        array[tmp-min]++;
+    }
+
+    dbgTiles << QString("   minChain:\t\t%1\n"
+                        "   maxChain:\t\t%2").arg(min).arg(max);
+
+    dbgTiles << "   Chain size distribution:";
+    for (qint32 i = 0; i < arraySize; i++)
+        dbgTiles << QString("      %1:\t%2\n").arg(i + min).arg(array[i]);
+
+    delete[] array;
+}
@@ -220,6 +220,12 @@ void KisHLineIterator2::preallocateTiles()
         unlockTile(m_tilesCache[i].oldtile);
         fetchTileDataForCache(m_tilesCache[i], m_leftCol + i, m_row);
     }
+
+    /**
+     * The line iterators almost always go on to the next row
+     * of tiles, so let the swap read it while we are busy
+     */
+    m_dataManager->prefetchTiles(m_leftCol, m_row + 1, m_tilesCacheSize, 1);
 }
 
 qint32 KisHLineIterator2::x() const
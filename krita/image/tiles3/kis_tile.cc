@@ -160,6 +160,16 @@ inline void KisTile::safeReleaseOldTileData(KisTileData *td)
     }
 }
 
+void KisTile::prefetch() const
+{
+    /**
+     * The barrier lock guarantees the tile data is not
+     * released by a concurrent COW while we are queueing it
+     */
+    QMutexLocker locker(&m_swapBarrierLock);
+    m_tileData->prefetch();
+}
+
 void KisTile::lockForRead() const
 {
     DEBUG_LOG_ACTION("lock [R]");
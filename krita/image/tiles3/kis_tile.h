@@ -75,6 +75,13 @@ public:
     void lockForWrite();
     void unlock() const;
 
+    /**
+     * Hints the tiles engine that the tile is going to be
+     * accessed soon, so if its data has been swapped out, it
+     * should be read in background
+     */
+    void prefetch() const;
+
     /* this allows us work directly on tile's data */
     inline quint8 *data() const {
         return m_tileData->data();
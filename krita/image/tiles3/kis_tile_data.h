@@ -101,6 +101,12 @@ inline void KisTileData::unblockSwapping() {
     m_swapLock.unlock();
 }
 
+inline void KisTileData::prefetch() {
+    if(!m_data) {
+        m_store->prefetchTileData(this);
+    }
+}
+
 inline KisChunk KisTileData::swapChunk() const {
     return m_swapChunk;
 }
@@ -107,6 +107,12 @@ public:
     inline void blockSwapping();
     inline void unblockSwapping();
 
+    /**
+     * Asks the store to read the data from the swap in background
+     * if it is not present in memory
+     */
+    inline void prefetch();
+
     /**
      * The position of the tile data in a swap file
      */
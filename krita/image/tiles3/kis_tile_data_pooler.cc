@@ -94,6 +94,8 @@ KisTileDataPooler::KisTileDataPooler(KisTileDataStore *store, qint32 memoryLimit
     m_lastPoolMemoryMetric = 0;
     m_lastRealMemoryMetric = 0;
     m_lastHistoricalMemoryMetric = 0;
+    m_lastSharedMemoryMetric = 0;
+    m_lastSharingSavedMemoryMetric = 0;
 
     if(memoryLimit >= 0) {
         m_memoryLimit = memoryLimit;
@@ -200,12 +202,16 @@ void KisTileDataPooler::run()
 
         qint32 statRealMemory;
         qint32 statHistoricalMemory;
+        qint32 statSharedMemory;
+        qint32 statSharingSavedMemory;
 
 
         getLists(iter, beggers, donors,
                  memoryOccupied,
                  statRealMemory,
-                 statHistoricalMemory);
+                 statHistoricalMemory,
+                 statSharedMemory,
+                 statSharingSavedMemory);
 
         m_lastCycleHadWork =
             processLists(beggers, donors, memoryOccupied);
@@ -213,6 +219,8 @@ void KisTileDataPooler::run()
         m_lastPoolMemoryMetric = memoryOccupied;
         m_lastRealMemoryMetric = statRealMemory;
         m_lastHistoricalMemoryMetric = statHistoricalMemory;
+        m_lastSharedMemoryMetric = statSharedMemory;
+        m_lastSharingSavedMemoryMetric = statSharingSavedMemory;
 
         m_store->endIteration(iter);
 
@@ -236,6 +244,16 @@ qint64 KisTileDataPooler::lastHistoricalMemoryMetric() const
     return m_lastHistoricalMemoryMetric;
 }
 
+qint64 KisTileDataPooler::lastSharedMemoryMetric() const
+{
+    return m_lastSharedMemoryMetric;
+}
+
+qint64 KisTileDataPooler::lastSharingSavedMemoryMetric() const
+{
+    return m_lastSharingSavedMemoryMetric;
+}
+
 inline int KisTileDataPooler::clonesMetric(KisTileData *td, int numClones) {
     return numClones * td->pixelSize();
 }
@@ -270,11 +288,15 @@ void KisTileDataPooler::getLists(Iter *iter,
                                  QList<KisTileData*> &donors,
                                  qint32 &memoryOccupied,
                                  qint32 &statRealMemory,
-                                 qint32 &statHistoricalMemory)
+                                 qint32 &statHistoricalMemory,
+                                 qint32 &statSharedMemory,
+                                 qint32 &statSharingSavedMemory)
 {
     memoryOccupied = 0;
     statRealMemory = 0;
     statHistoricalMemory = 0;
+    statSharedMemory = 0;
+    statSharingSavedMemory = 0;
 
     qint32 needMemoryTotal = 0;
     qint32 canDonorMemoryTotal = 0;
@@ -306,6 +328,17 @@ void KisTileDataPooler::getLists(Iter *iter,
         } else {
             statRealMemory += item->pixelSize();
         }
+
+        /**
+         * The tile data used by several tiles at once (device clones,
+         * layer duplicates and history items). Every extra user would
+         * have taken a separate copy without copy-on-write.
+         */
+        const qint32 numUsers = item->m_usersCount;
+        if (numUsers > 1) {
+            statSharedMemory += item->pixelSize();
+            statSharingSavedMemory += (numUsers - 1) * item->pixelSize();
+        }
     }
 
     DEBUG_LISTS(memoryOccupied,
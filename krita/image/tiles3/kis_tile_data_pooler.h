@@ -43,6 +43,8 @@ public:
     qint64 lastPoolMemoryMetric() const;
     qint64 lastRealMemoryMetric() const;
     qint64 lastHistoricalMemoryMetric() const;
+    qint64 lastSharedMemoryMetric() const;
+    qint64 lastSharingSavedMemoryMetric() const;
 
 protected:
     static const qint32 MAX_NUM_CLONES;
@@ -68,7 +70,9 @@ protected:
                       QList<KisTileData*> &donors,
                       qint32 &memoryOccupied,
                       qint32 &statRealMemory,
-                      qint32 &statHistoricalMemory);
+                      qint32 &statHistoricalMemory,
+                      qint32 &statSharedMemory,
+                      qint32 &statSharingSavedMemory);
 
     bool processLists(QList<KisTileData*> &beggers,
                       QList<KisTileData*> &donors,
@@ -86,6 +90,8 @@ protected:
     qint32 m_lastPoolMemoryMetric;
     qint32 m_lastRealMemoryMetric;
     qint32 m_lastHistoricalMemoryMetric;
+    qint32 m_lastSharedMemoryMetric;
+    qint32 m_lastSharingSavedMemoryMetric;
 };
 
 
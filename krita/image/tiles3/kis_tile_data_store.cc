@@ -18,6 +18,7 @@
 
 
 #include <kglobal.h>
+#include <QElapsedTimer>
 
 // to disable assert when the leak tracker is active
 #include "config-memory-leak-tracker.h"
@@ -68,16 +69,22 @@ qint64 __preclone_miss_age = 0;
 KisTileDataStore::KisTileDataStore()
     : m_pooler(this),
       m_swapper(this),
+      m_prefetcher(this),
       m_numTiles(0),
-      m_memoryMetric(0)
+      m_memoryMetric(0),
+      m_numDemandSwapIns(0),
+      m_numPrefetchedSwapIns(0),
+      m_swapInStallTime(0)
 {
     m_clockIterator = m_tileDataList.end();
     m_pooler.start();
     m_swapper.start();
+    m_prefetcher.start(QThread::LowPriority);
 }
 
 KisTileDataStore::~KisTileDataStore()
 {
+    m_prefetcher.terminatePrefetcher();
     m_pooler.terminatePooler();
     m_swapper.terminateSwapper();
 
@@ -106,11 +113,21 @@ KisTileDataStore::MemoryStatistics KisTileDataStore::memoryStatistics()
     stats.realMemorySize = m_pooler.lastRealMemoryMetric() * metricCoeff;
     stats.historicalMemorySize = m_pooler.lastHistoricalMemoryMetric() * metricCoeff;
     stats.poolSize = m_pooler.lastPoolMemoryMetric() * metricCoeff;
+    stats.sharedMemorySize = m_pooler.lastSharedMemoryMetric() * metricCoeff;
+    stats.sharingSavedMemorySize = m_pooler.lastSharingSavedMemoryMetric() * metricCoeff;
 
     stats.totalMemorySize = memoryMetric() * metricCoeff + stats.poolSize;
 
     stats.swapSize = m_swappedStore.totalMemoryMetric() * metricCoeff;
 
+    stats.numDemandSwapIns = m_numDemandSwapIns;
+    stats.numPrefetchedSwapIns = m_numPrefetchedSwapIns;
+    stats.swapInStallTime = m_swapInStallTime;
+
+    const qint64 totalSwapIns = m_numDemandSwapIns + m_numPrefetchedSwapIns;
+    stats.prefetchHitRate =
+        totalSwapIns > 0 ? qreal(m_numPrefetchedSwapIns) / totalSwapIns : 0.0;
+
     return stats;
 }
 
@@ -205,6 +222,9 @@ void KisTileDataStore::ensureTileDataLoaded(KisTileData *td)
     while(!td->data()) {
         td->m_swapLock.unlock();
 
+        QElapsedTimer stallTimer;
+        stallTimer.start();
+
         /**
          * The order of this heavy locking is very important.
          * Change it only in case, you really know what you are doing.
@@ -231,8 +251,12 @@ void KisTileDataStore::ensureTileDataLoaded(KisTileData *td)
             registerTileDataImp(td);
 
             td->m_swapLock.unlock();
+
+            m_numDemandSwapIns++;
         }
 
+        m_swapInStallTime += stallTimer.nsecsElapsed() / 1000;
+
         m_listLock.unlock();
 
         /**
@@ -243,6 +267,29 @@ void KisTileDataStore::ensureTileDataLoaded(KisTileData *td)
     }
 }
 
+void KisTileDataStore::prefetchSwapIn(KisTileData *td)
+{
+    QMutexLocker lock(&m_listLock);
+
+    /**
+     * Keep the same lock ordering as ensureTileDataLoaded()
+     * does. If someone holds the swap lock, then the tile data
+     * is either being read right now or is already loaded, so
+     * there is no reason to wait for it.
+     */
+    if (!td->m_swapLock.tryLockForWrite()) return;
+
+    if (!td->data()) {
+        m_swappedStore.swapInTileData(td);
+        registerTileDataImp(td);
+        td->resetAge();
+
+        m_numPrefetchedSwapIns++;
+    }
+
+    td->m_swapLock.unlock();
+}
+
 bool KisTileDataStore::trySwapTileData(KisTileData *td)
 {
     /**
@@ -340,9 +387,15 @@ void KisTileDataStore::debugClear()
 void KisTileDataStore::testingRereadConfig() {
     m_pooler.testingRereadConfig();
     m_swapper.testingRereadConfig();
+    m_prefetcher.testingRereadConfig();
     kickPooler();
 }
 
+void KisTileDataStore::testingWaitForPrefetcher()
+{
+    m_prefetcher.testingWaitForIdle();
+}
+
 void KisTileDataStore::testingSuspendPooler()
 {
     m_pooler.terminatePooler();
@@ -25,6 +25,7 @@
 
 #include "kis_tile_data_pooler.h"
 #include "swap/kis_tile_data_swapper.h"
+#include "swap/kis_tile_data_prefetcher.h"
 #include "swap/kis_swapped_data_store.h"
 
 class KisTileDataStoreIterator;
@@ -53,7 +54,37 @@ public:
 
         qint64 poolSize;
 
+        /**
+         * Copy-on-write statistics. \p sharedMemorySize is the size of
+         * the tile data used by more than one tile (device clones,
+         * layer duplicates, history), \p sharingSavedMemorySize is
+         * the memory the extra users would have taken without sharing.
+         */
+        qint64 sharedMemorySize;
+        qint64 sharingSavedMemorySize;
+
         qint64 swapSize;
+
+        /**
+         * Swap-in statistics. A "demand" swap-in happens when some
+         * thread accesses a tile that is not in memory and has to
+         * wait for it, a "prefetched" one is done in background by
+         * KisTileDataPrefetcher.
+         */
+        qint64 numDemandSwapIns;
+        qint64 numPrefetchedSwapIns;
+
+        /**
+         * Total time (in microseconds) the threads spent waiting
+         * for the demanded tiles to be read from the swap
+         */
+        qint64 swapInStallTime;
+
+        /**
+         * The fraction of the swap-ins that have been done
+         * in background, without stalling anyone
+         */
+        qreal prefetchHitRate;
     };
 
     MemoryStatistics memoryStatistics();
@@ -105,6 +136,23 @@ public:
         m_swapper.kick();
     }
 
+    /**
+     * Asks the prefetcher thread to read the tile data from
+     * the swap in background. Does nothing if the data is
+     * already in memory.
+     */
+    inline void prefetchTileData(KisTileData *td) {
+        m_prefetcher.enqueue(td);
+    }
+
+    /**
+     * Returns true if there is at least one tile data stored
+     * in the swap file, that is if prefetching makes sense at all
+     */
+    inline bool hasSwappedTiles() const {
+        return m_swappedStore.numTiles() > 0;
+    }
+
     /**
      * Try swap out the tile data.
      * It may fail in case the tile is being accessed
@@ -143,6 +191,9 @@ private:
     inline void unregisterTileDataImp(KisTileData *td);
     void freeRegisteredTiles();
 
+    friend class KisTileDataPrefetcher;
+    void prefetchSwapIn(KisTileData *td);
+
     friend class DeadlockyThread;
     friend class KisLowMemoryTests;
     void debugSwapAll();
@@ -154,9 +205,12 @@ private:
 
     friend class KisLowMemoryBenchmark;
     void testingRereadConfig();
+
+    void testingWaitForPrefetcher();
 private:
     KisTileDataPooler m_pooler;
     KisTileDataSwapper m_swapper;
+    KisTileDataPrefetcher m_prefetcher;
 
     friend class KisTileDataStoreTest;
     friend class KisTileDataPoolerTest;
@@ -174,6 +228,13 @@ private:
      * metric = num_bytes / (KisTileData::WIDTH * KisTileData::HEIGHT)
      */
     qint64 m_memoryMetric;
+
+    /**
+     * Swap-in statistics, protected by m_listLock
+     */
+    qint64 m_numDemandSwapIns;
+    qint64 m_numPrefetchedSwapIns;
+    qint64 m_swapInStallTime;
 };
 
 template<typename T>
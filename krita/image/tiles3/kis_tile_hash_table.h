@@ -220,7 +220,15 @@ private:
 };
 
 
-typedef KisTileHashTableTraits<KisTile> KisTileHashTable;
-typedef KisTileHashTableIteratorTraits<KisTile> KisTileHashTableIterator;
+/**
+ * KisTiledDataManager's tile table is accessed by many threads
+ * simultaneously, so it uses the lock-free-lookup implementation.
+ * KisMementoManager still uses the legacy one, because it needs
+ * to move tiles between the tables.
+ */
+#include "kis_concurrent_tile_hash_table.h"
+
+typedef KisConcurrentTileHashTableTraits<KisTile> KisTileHashTable;
+typedef KisConcurrentTileHashTableIteratorTraits<KisTile> KisTileHashTableIterator;
 
 #endif /* KIS_TILEHASHTABLE_H_ */
@@ -278,6 +278,41 @@ wrongString:
     return false;
 }
 
+void KisTiledDataManager::prefetchTiles(qint32 firstCol, qint32 firstRow,
+                                        qint32 numCols, qint32 numRows)
+{
+    /**
+     * This check is lock-free, so it is cheap to call
+     * this method in the iterators
+     */
+    if (!KisTileDataStore::instance()->hasSwappedTiles()) return;
+
+    const qint32 lastCol = firstCol + numCols - 1;
+    const qint32 lastRow = firstRow + numRows - 1;
+
+    for (qint32 row = firstRow; row <= lastRow; row++) {
+        for (qint32 col = firstCol; col <= lastCol; col++) {
+            KisTileSP tile = m_hashTable->getExistedTile(col, row);
+            if (tile) {
+                tile->prefetch();
+            }
+        }
+    }
+}
+
+void KisTiledDataManager::prefetchRect(const QRect &rect)
+{
+    if (rect.isEmpty()) return;
+
+    const qint32 firstCol = xToCol(rect.left());
+    const qint32 firstRow = yToRow(rect.top());
+    const qint32 lastCol = xToCol(rect.right());
+    const qint32 lastRow = yToRow(rect.bottom());
+
+    prefetchTiles(firstCol, firstRow,
+                  lastCol - firstCol + 1, lastRow - firstRow + 1);
+}
+
 void KisTiledDataManager::purge(const QRect& area)
 {
     QWriteLocker locker(&m_lock);
@@ -453,6 +488,21 @@ void KisTiledDataManager::clear()
 }
 
 
+KisTileData* KisTiledDataManager::droppableDefaultTileData(KisTiledDataManager *srcDM) const
+{
+    /**
+     * The tiles of the source that still reference its default tile
+     * data can be just dropped from the destination instead of being
+     * shared, but only when the default pixels of the managers are
+     * the same. Otherwise we should keep the source pixels.
+     */
+    const bool sameDefaultPixel =
+        m_pixelSize == srcDM->m_pixelSize &&
+        !memcmp(m_defaultPixel, srcDM->m_defaultPixel, m_pixelSize);
+
+    return sameDefaultPixel ? srcDM->m_hashTable->defaultTileData() : 0;
+}
+
 template<bool useOldSrcData>
 void KisTiledDataManager::bitBltImpl(KisTiledDataManager *srcDM, const QRect &rect)
 {
@@ -469,6 +519,8 @@ void KisTiledDataManager::bitBltImpl(KisTiledDataManager *srcDM, const QRect &re
     qint32 firstRow = yToRow(rect.top());
     qint32 lastRow = yToRow(rect.bottom());
 
+    KisTileData *srcDefaultTileData = droppableDefaultTileData(srcDM);
+
     for (qint32 row = firstRow; row <= lastRow; ++row) {
         for (qint32 column = firstColumn; column <= lastColumn; ++column) {
 
@@ -487,11 +539,14 @@ void KisTiledDataManager::bitBltImpl(KisTiledDataManager *srcDM, const QRect &re
 
                  srcTile->lockForRead();
                  KisTileData *td = srcTile->tileData();
-                 KisTileSP clonedTile = new KisTile(column, row, td, m_mementoManager);
+                 KisTileSP clonedTile = td != srcDefaultTileData ?
+                     new KisTile(column, row, td, m_mementoManager) : 0;
                  srcTile->unlock();
 
-                 m_hashTable->addTile(clonedTile);
-                 updateExtent(column, row);
+                 if (clonedTile) {
+                     m_hashTable->addTile(clonedTile);
+                     updateExtent(column, row);
+                 }
             } else {
                 const qint32 lineSize = cloneTileRect.width() * pixelSize;
                 qint32 rowsRemaining = cloneTileRect.height();
@@ -531,6 +586,8 @@ void KisTiledDataManager::bitBltRoughImpl(KisTiledDataManager *srcDM, const QRec
     qint32 firstRow = yToRow(rect.top());
     qint32 lastRow = yToRow(rect.bottom());
 
+    KisTileData *srcDefaultTileData = droppableDefaultTileData(srcDM);
+
     for (qint32 row = firstRow; row <= lastRow; ++row) {
         for (qint32 column = firstColumn; column <= lastColumn; ++column) {
 
@@ -548,11 +605,14 @@ void KisTiledDataManager::bitBltRoughImpl(KisTiledDataManager *srcDM, const QRec
 
             srcTile->lockForRead();
             KisTileData *td = srcTile->tileData();
-            KisTileSP clonedTile = new KisTile(column, row, td, m_mementoManager);
+            KisTileSP clonedTile = td != srcDefaultTileData ?
+                new KisTile(column, row, td, m_mementoManager) : 0;
             srcTile->unlock();
 
-            m_hashTable->addTile(clonedTile);
-            updateExtent(column, row);
+            if (clonedTile) {
+                m_hashTable->addTile(clonedTile);
+                updateExtent(column, row);
+            }
         }
     }
 }
@@ -107,6 +107,20 @@ public:
         return tile ? tile : getTile(col, row, false);
     }
 
+    /**
+     * Asks the tiles engine to read the tiles of the area from
+     * the swap in background. The area is given in tiles'
+     * coordinates. Non-existing tiles are skipped.
+     */
+    void prefetchTiles(qint32 firstCol, qint32 firstRow,
+                       qint32 numCols, qint32 numRows);
+
+    /**
+     * The same as prefetchTiles(), but the area is
+     * given in pixels
+     */
+    void prefetchRect(const QRect &rect);
+
     KisMementoSP getMemento() {
         QWriteLocker locker(&m_lock);
         KisMementoSP memento = m_mementoManager->getMemento();
@@ -202,7 +216,9 @@ public:
      * Clones rect from another datamanager. The cloned area will be
      * shared between both datamanagers as much as possible using
      * copy-on-write. Parts of the rect that cannot be shared
-     * (cross tiles) are deep-copied,
+     * (cross tiles) are deep-copied. The source tiles which contain
+     * default pixels only are not cloned at all, the destination
+     * just drops its own tiles there.
      */
     void bitBlt(KisTiledDataManager *srcDM, const QRect &rect);
 
@@ -336,6 +352,8 @@ private:
 
     quint8* duplicatePixel(qint32 num, const quint8 *pixel);
 
+    KisTileData* droppableDefaultTileData(KisTiledDataManager *srcDM) const;
+
     template<bool useOldSrcData>
         void bitBltImpl(KisTiledDataManager *srcDM, const QRect &rect);
     template<bool useOldSrcData>
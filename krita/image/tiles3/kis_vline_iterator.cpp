@@ -222,6 +222,12 @@ void KisVLineIterator2::preallocateTiles()
         unlockTile(m_tilesCache[i].oldtile);
         fetchTileDataForCache(m_tilesCache[i], m_column, m_topRow + i );
     }
+
+    /**
+     * Let the swap read the next column of tiles
+     * while we are busy with this one
+     */
+    m_dataManager->prefetchTiles(m_column + 1, m_topRow, 1, m_tilesCacheSize);
 }
 
 qint32 KisVLineIterator2::x() const
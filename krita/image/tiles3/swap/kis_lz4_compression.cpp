@@ -0,0 +1,254 @@
+/*
+ *  Copyright (c) 2015 Calligra developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_lz4_compression.h"
+#include "kis_debug.h"
+
+#include <string.h>
+
+
+#define HASH_LOG  12
+#define HASH_SIZE (1 << HASH_LOG)
+
+#define MIN_MATCH      4
+#define MAX_DISTANCE   65535
+/* the last match must start at least 12 bytes before the end of the block */
+#define MF_LIMIT       12
+/* the last 5 bytes of the block are always literals */
+#define LAST_LITERALS  5
+
+#define RUN_BITS       4
+#define RUN_MASK       ((1 << RUN_BITS) - 1)
+#define SKIP_TRIGGER   5
+
+static inline quint32 readU32(const quint8 *p)
+{
+    quint32 value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static inline quint32 hashSequence(quint32 sequence)
+{
+    return (sequence * 2654435761U) >> (32 - HASH_LOG);
+}
+
+static inline quint8* writeLength(quint8 *op, qint32 length)
+{
+    while (length >= 255) {
+        *op++ = 255;
+        length -= 255;
+    }
+    *op++ = length;
+    return op;
+}
+
+static inline quint8* writeLiterals(quint8 *op, const quint8 *anchor, qint32 literalLength, quint8 *token)
+{
+    if (literalLength >= RUN_MASK) {
+        *token = RUN_MASK << RUN_BITS;
+        op = writeLength(op, literalLength - RUN_MASK);
+    } else {
+        *token = literalLength << RUN_BITS;
+    }
+
+    memcpy(op, anchor, literalLength);
+    return op + literalLength;
+}
+
+int lz4_compress(const quint8 *input, int length, quint8 *output)
+{
+    const quint8 *ip = input;
+    const quint8 *anchor = input;
+    const quint8 *const iend = input + length;
+    quint8 *op = output;
+
+    if (length >= MF_LIMIT + 1) {
+        const quint8 *const mflimit = iend - MF_LIMIT;
+        const quint8 *const matchlimit = iend - LAST_LITERALS;
+
+        /* positions of the sequences relative to the input */
+        quint32 htab[HASH_SIZE];
+        memset(htab, 0, sizeof(htab));
+
+        qint32 searchCounter = 1 << SKIP_TRIGGER;
+
+        while (ip <= mflimit) {
+            const quint32 sequence = readU32(ip);
+            const quint32 hash = hashSequence(sequence);
+            const quint8 *ref = input + htab[hash];
+            htab[hash] = ip - input;
+
+            if (ref >= ip ||
+                ip - ref > MAX_DISTANCE ||
+                readU32(ref) != sequence) {
+
+                /**
+                 * The data seems to be incompressible, so
+                 * accelerate the search
+                 */
+                ip += searchCounter++ >> SKIP_TRIGGER;
+                continue;
+            }
+            searchCounter = 1 << SKIP_TRIGGER;
+
+            /* extend the match backwards */
+            while (ip > anchor && ref > input && ip[-1] == ref[-1]) {
+                ip--;
+                ref--;
+            }
+
+            /* extend the match forward */
+            const quint8 *matchEnd = ip + MIN_MATCH;
+            const quint8 *refEnd = ref + MIN_MATCH;
+            while (matchEnd < matchlimit && *matchEnd == *refEnd) {
+                matchEnd++;
+                refEnd++;
+            }
+
+            quint8 *token = op++;
+            op = writeLiterals(op, anchor, ip - anchor, token);
+
+            const qint32 offset = ip - ref;
+            *op++ = offset & 0xFF;
+            *op++ = offset >> 8;
+
+            const qint32 matchLength = matchEnd - ip - MIN_MATCH;
+            if (matchLength >= RUN_MASK) {
+                *token |= RUN_MASK;
+                op = writeLength(op, matchLength - RUN_MASK);
+            } else {
+                *token |= matchLength;
+            }
+
+            ip = anchor = matchEnd;
+
+            /* fill the hash table with the tail of the match */
+            if (ip <= mflimit) {
+                htab[hashSequence(readU32(ip - 2))] = ip - 2 - input;
+            }
+        }
+    }
+
+    /* the last sequence contains literals only */
+    quint8 *token = op++;
+    op = writeLiterals(op, anchor, iend - anchor, token);
+
+    return op - output;
+}
+
+static inline bool readLength(const quint8 *&ip, const quint8 *iend, quint32 &length)
+{
+    quint32 s;
+    do {
+        if (ip >= iend) return false;
+        s = *ip++;
+        length += s;
+    } while (s == 255);
+
+    return true;
+}
+
+int lz4_decompress(const quint8 *input, int length, quint8 *output, int maxout)
+{
+    const quint8 *ip = input;
+    const quint8 *const iend = input + length;
+    quint8 *op = output;
+    quint8 *const oend = output + maxout;
+
+    while (ip < iend) {
+        const quint32 token = *ip++;
+
+        /* literals */
+        quint32 literalLength = token >> RUN_BITS;
+        if (literalLength == RUN_MASK &&
+            !readLength(ip, iend, literalLength)) {
+
+            return 0;
+        }
+
+        if (literalLength > quint32(iend - ip) ||
+            literalLength > quint32(oend - op)) {
+
+            return 0;
+        }
+
+        memcpy(op, ip, literalLength);
+        op += literalLength;
+        ip += literalLength;
+
+        /* the last sequence has no match part */
+        if (ip >= iend) break;
+
+        /* back reference */
+        if (iend - ip < 2) return 0;
+
+        const quint32 offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+
+        if (!offset || offset > quint32(op - output)) return 0;
+
+        quint32 matchLength = token & RUN_MASK;
+        if (matchLength == RUN_MASK &&
+            !readLength(ip, iend, matchLength)) {
+
+            return 0;
+        }
+        matchLength += MIN_MATCH;
+
+        if (matchLength > quint32(oend - op)) return 0;
+
+        const quint8 *ref = op - offset;
+        if (offset >= matchLength) {
+            memcpy(op, ref, matchLength);
+            op += matchLength;
+        } else {
+            /* overlapping copy, e.g. a run of equal bytes */
+            for (; matchLength; --matchLength)
+                *op++ = *ref++;
+        }
+    }
+
+    return op - output;
+}
+
+
+KisLz4Compression::KisLz4Compression()
+{
+}
+
+KisLz4Compression::~KisLz4Compression()
+{
+}
+
+qint32 KisLz4Compression::compress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength)
+{
+    Q_UNUSED(outputLength);
+    return lz4_compress(input, inputLength, output);
+}
+
+qint32 KisLz4Compression::decompress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength)
+{
+    return lz4_decompress(input, inputLength, output, outputLength);
+}
+
+qint32 KisLz4Compression::outputBufferSize(qint32 dataSize)
+{
+    // the worst case is a single literal run
+    return dataSize + dataSize / 255 + 16;
+}
@@ -21,9 +21,7 @@
 #include "kis_memory_window.h"
 #include "kis_image_config.h"
 
-#include "kis_tile_compressor_2.h"
-
-//#define COMPRESSOR_VERSION 2
+#include "kis_tile_compressor_factory.h"
 
 KisSwappedDataStore::KisSwappedDataStore()
     : m_memoryMetric(0)
@@ -36,8 +34,7 @@ KisSwappedDataStore::KisSwappedDataStore()
     m_allocator = new KisChunkAllocator(swapSlabSize, maxSwapSize);
     m_swapSpace = new KisMemoryWindow(config.swapDir(), swapWindowSize);
 
-    // FIXME: use a factory after the patch is committed
-    m_compressor = new KisTileCompressor2();
+    m_compressor = KisTileCompressorFactory::createInternal(config.swapCompression());
 }
 
 KisSwappedDataStore::~KisSwappedDataStore()
@@ -18,16 +18,26 @@
 
 #include "kis_tile_compressor_2.h"
 #include "kis_lzf_compression.h"
+#include "kis_lz4_compression.h"
 #include <QIODevice>
 #include "kis_paint_device_writer.h"
 #define TILE_DATA_SIZE(pixelSize) ((pixelSize) * KisTileData::WIDTH * KisTileData::HEIGHT)
 
-const QString KisTileCompressor2::m_compressionName = "LZF";
 
-
-KisTileCompressor2::KisTileCompressor2()
+KisTileCompressor2::KisTileCompressor2(const QString &compressionName,
+                                       bool internalStorage)
+    : m_internalStorage(internalStorage)
 {
-    m_compression = new KisLzfCompression();
+    m_compression = createCompression(compressionName);
+    m_compressionName = compressionName;
+
+    if (!m_compression) {
+        warnTiles << "Unknown tile compression" << compressionName
+                  << "falling back to LZF";
+
+        m_compression = new KisLzfCompression();
+        m_compressionName = "LZF";
+    }
 }
 
 KisTileCompressor2::~KisTileCompressor2()
@@ -35,6 +45,22 @@ KisTileCompressor2::~KisTileCompressor2()
     delete m_compression;
 }
 
+QStringList KisTileCompressor2::supportedCompressions()
+{
+    return QStringList() << "LZF" << "LZ4";
+}
+
+KisAbstractCompression* KisTileCompressor2::createCompression(const QString &compressionName)
+{
+    if (compressionName == "LZF") {
+        return new KisLzfCompression();
+    } else if (compressionName == "LZ4") {
+        return new KisLz4Compression();
+    }
+
+    return 0;
+}
+
 bool KisTileCompressor2::writeTile(KisTileSP tile, KisPaintDeviceWriter &store)
 {
     const qint32 tileDataSize = TILE_DATA_SIZE(tile->pixelSize());
@@ -75,7 +101,18 @@ bool KisTileCompressor2::readTile(QIODevice *stream, KisTiledDataManager *dm)
         qint32 dataSize = headerItems.takeFirst().toInt();
 
         Q_ASSERT(headerItems.isEmpty());
-        Q_ASSERT(compressionName == m_compressionName);
+
+        if (compressionName != m_compressionName) {
+            KisAbstractCompression *compression = createCompression(compressionName);
+            if (!compression) {
+                warnFile << "Unknown tile compression:" << compressionName;
+                return false;
+            }
+
+            delete m_compression;
+            m_compression = compression;
+            m_compressionName = compressionName;
+        }
 
         qint32 row = yToRow(dm, y);
         qint32 col = xToCol(dm, x);
@@ -124,6 +161,15 @@ void KisTileCompressor2::compressTileData(KisTileData *tileData,
     Q_ASSERT(bufferSize >= tileDataSize + 1);
 #endif
 
+    if (m_internalStorage &&
+        isUniformData(tileData->data(), tileDataSize, pixelSize)) {
+
+        buffer[0] = UNIFORM_DATA_FLAG;
+        memcpy(buffer + 1, tileData->data(), pixelSize);
+        bytesWritten = pixelSize + 1;
+        return;
+    }
+
     prepareWorkBuffers(tileDataSize);
 
     KisAbstractCompression::linearizeColors(tileData->data(), (quint8*)m_linearizationBuffer.data(),
@@ -165,6 +211,24 @@ bool KisTileCompressor2::decompressTileData(quint8 *buffer,
         }
         return false;
     }
+    else if (buffer[0] == UNIFORM_DATA_FLAG) {
+        if (bufferSize < pixelSize + 1) return false;
+
+        quint8 *dst = tileData->data();
+        memcpy(dst, buffer + 1, pixelSize);
+
+        /**
+         * Fill the rest of the tile by doubling the already
+         * filled part on every step
+         */
+        qint32 filled = pixelSize;
+        while (filled < tileDataSize) {
+            const qint32 chunk = qMin(filled, tileDataSize - filled);
+            memcpy(dst + filled, dst, chunk);
+            filled += chunk;
+        }
+        return true;
+    }
     else {
         memcpy(tileData->data(), buffer + 1, tileDataSize);
         return true;
@@ -173,6 +237,17 @@ bool KisTileCompressor2::decompressTileData(quint8 *buffer,
 
 }
 
+bool KisTileCompressor2::isUniformData(const quint8 *data, qint32 tileDataSize, qint32 pixelSize)
+{
+    /**
+     * A buffer is periodic with a period of pixelSize (that is all the
+     * pixels are equal) iff it is equal to itself shifted by one pixel.
+     * Most of the tiles of sparse layers are filled with the default
+     * pixel, so they end up in here.
+     */
+    return !memcmp(data, data + pixelSize, tileDataSize - pixelSize);
+}
+
 qint32 KisTileCompressor2::tileDataBufferSize(KisTileData *tileData)
 {
     return TILE_DATA_SIZE(tileData->pixelSize()) + 1;
@@ -21,14 +21,32 @@
 
 #include "kis_abstract_tile_compressor.h"
 
+#include <QStringList>
+
 class KisAbstractCompression;
 
 class KRITAIMAGE_EXPORT KisTileCompressor2 : public KisAbstractTileCompressor
 {
 public:
-    KisTileCompressor2();
+    /**
+     * \param compressionName the codec used for compressing the tiles,
+     *        see supportedCompressions()
+     * \param internalStorage the compressed data is never written
+     *        to a file (e.g. it is used by the swapper), so the
+     *        compressor may use the encodings unknown to the other
+     *        versions of Krita, like storing uniform tiles as a
+     *        single pixel
+     */
+    KisTileCompressor2(const QString &compressionName = "LZF",
+                       bool internalStorage = false);
     virtual ~KisTileCompressor2();
 
+    /**
+     * The list of codecs that can be passed to the constructor.
+     * The first one is the default codec for the file format.
+     */
+    static QStringList supportedCompressions();
+
     bool writeTile(KisTileSP tile, KisPaintDeviceWriter &store);
     bool readTile(QIODevice *io, KisTiledDataManager *dm);
 
@@ -49,16 +67,22 @@ private:
     void prepareWorkBuffers(qint32 tileDataSize);
     void prepareStreamingBuffer(qint32 tileDataSize);
 
+    bool isUniformData(const quint8 *data, qint32 tileDataSize, qint32 pixelSize);
+
+    static KisAbstractCompression* createCompression(const QString &compressionName);
+
 private:
     static const qint8 RAW_DATA_FLAG = 0;
     static const qint8 COMPRESSED_DATA_FLAG = 1;
+    static const qint8 UNIFORM_DATA_FLAG = 2;
 
 private:
     QByteArray m_linearizationBuffer;
     QByteArray m_compressionBuffer;
     QByteArray m_streamingBuffer;
     KisAbstractCompression *m_compression;
-    static const QString m_compressionName;
+    QString m_compressionName;
+    bool m_internalStorage;
 };
 
 #endif /* __KIS_TILE_COMPRESSOR_2_H */
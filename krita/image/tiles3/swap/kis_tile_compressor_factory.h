@@ -39,6 +39,15 @@ public:
         };
     }
 
+    /**
+     * Creates a compressor for the data that never leaves the
+     * current session, e.g. for the swap file. Such compressors
+     * may use any codec from KisTileCompressor2::supportedCompressions()
+     */
+    static KisAbstractTileCompressor* createInternal(const QString &compressionName) {
+        return new KisTileCompressor2(compressionName, true);
+    }
+
 private:
     KisTileCompressorFactory();
 };
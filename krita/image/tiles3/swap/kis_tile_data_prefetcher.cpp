@@ -0,0 +1,160 @@
+/*
+ *  Copyright (c) 2015 Calligra developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include <QMutex>
+#include <QQueue>
+#include <QWaitCondition>
+
+#include "tiles3/swap/kis_tile_data_prefetcher.h"
+#include "tiles3/swap/kis_tile_data_swapper_p.h"
+#include "tiles3/kis_tile_data.h"
+#include "tiles3/kis_tile_data_store.h"
+#include "kis_debug.h"
+
+/**
+ * 1024 tiles of 64x64 RGBA8 pixels is 16 MiB, which is about
+ * four screens of the canvas
+ */
+const qint32 KisTileDataPrefetcher::MAX_QUEUE_SIZE = 1024;
+
+
+struct Q_DECL_HIDDEN KisTileDataPrefetcher::Private
+{
+public:
+    KisTileDataStore *store;
+    KisStoreLimits limits;
+
+    QMutex lock;
+    QWaitCondition hasWork;
+    QWaitCondition becameIdle;
+    QQueue<KisTileData*> queue;
+    bool isIdle;
+    bool shouldExitFlag;
+};
+
+KisTileDataPrefetcher::KisTileDataPrefetcher(KisTileDataStore *store)
+    : QThread(),
+      m_d(new Private())
+{
+    m_d->store = store;
+    m_d->isIdle = true;
+    m_d->shouldExitFlag = false;
+}
+
+KisTileDataPrefetcher::~KisTileDataPrefetcher()
+{
+    delete m_d;
+}
+
+void KisTileDataPrefetcher::enqueue(KisTileData *td)
+{
+    KisTileData *droppedTileData = 0;
+
+    td->ref();
+
+    {
+        QMutexLocker locker(&m_d->lock);
+
+        if (m_d->queue.size() >= MAX_QUEUE_SIZE) {
+            droppedTileData = m_d->queue.dequeue();
+        }
+
+        m_d->queue.enqueue(td);
+        m_d->hasWork.wakeOne();
+    }
+
+    /**
+     * Dereferencing may free the tile data, which takes the
+     * store's lock, so do it outside our own lock
+     */
+    if (droppedTileData) {
+        droppedTileData->deref();
+    }
+}
+
+void KisTileDataPrefetcher::terminatePrefetcher()
+{
+    {
+        QMutexLocker locker(&m_d->lock);
+        m_d->shouldExitFlag = true;
+        m_d->hasWork.wakeAll();
+    }
+
+    wait();
+
+    QQueue<KisTileData*> droppedQueue;
+
+    {
+        QMutexLocker locker(&m_d->lock);
+        droppedQueue.swap(m_d->queue);
+        m_d->isIdle = true;
+        m_d->shouldExitFlag = false;
+        m_d->becameIdle.wakeAll();
+    }
+
+    foreach (KisTileData *td, droppedQueue) {
+        td->deref();
+    }
+}
+
+bool KisTileDataPrefetcher::canPrefetch() const
+{
+    return m_d->store->memoryMetric() < m_d->limits.hardLimit();
+}
+
+void KisTileDataPrefetcher::run()
+{
+    while (1) {
+        KisTileData *td = 0;
+
+        {
+            QMutexLocker locker(&m_d->lock);
+
+            while (m_d->queue.isEmpty() && !m_d->shouldExitFlag) {
+                m_d->isIdle = true;
+                m_d->becameIdle.wakeAll();
+                m_d->hasWork.wait(&m_d->lock);
+            }
+
+            if (m_d->shouldExitFlag) return;
+
+            td = m_d->queue.dequeue();
+            m_d->isIdle = false;
+        }
+
+        if (canPrefetch()) {
+            m_d->store->prefetchSwapIn(td);
+        }
+
+        td->deref();
+    }
+}
+
+void KisTileDataPrefetcher::testingRereadConfig()
+{
+    m_d->limits = KisStoreLimits();
+}
+
+void KisTileDataPrefetcher::testingWaitForIdle()
+{
+    QMutexLocker locker(&m_d->lock);
+
+    while (!m_d->queue.isEmpty() || !m_d->isIdle) {
+        m_d->becameIdle.wait(&m_d->lock);
+    }
+}
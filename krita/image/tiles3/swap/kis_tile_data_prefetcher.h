@@ -0,0 +1,79 @@
+/*
+ *  Copyright (c) 2015 Calligra developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#ifndef KIS_TILE_DATA_PREFETCHER_H_
+#define KIS_TILE_DATA_PREFETCHER_H_
+
+#include <QObject>
+#include <QThread>
+
+#include "kritaimage_export.h"
+
+
+class KisTileDataStore;
+class KisTileData;
+
+/**
+ * A background thread that reads swapped out tile data back into
+ * memory before someone actually asks for it.
+ *
+ * The requests come from the places that can predict the access
+ * pattern: the line iterators (the next row/column of tiles) and the
+ * canvas (the area around the viewport while the user pans). The
+ * thread processes the requests in FIFO order. When the queue
+ * overflows, the oldest requests are dropped, because they are the
+ * least likely to be still relevant.
+ *
+ * The prefetcher never pushes the store over the hard limit,
+ * otherwise it would just fight against the swapper.
+ */
+class KRITAIMAGE_EXPORT KisTileDataPrefetcher : public QThread
+{
+    Q_OBJECT
+
+public:
+    KisTileDataPrefetcher(KisTileDataStore *store);
+    virtual ~KisTileDataPrefetcher();
+
+    /**
+     * Adds \p td to the queue. The tile data is ref'ed by the
+     * prefetcher until the request is processed or dropped.
+     */
+    void enqueue(KisTileData *td);
+
+    void terminatePrefetcher();
+
+    void testingRereadConfig();
+
+    /**
+     * Waits until all the queued requests are processed
+     */
+    void testingWaitForIdle();
+
+private:
+    void run();
+    bool canPrefetch() const;
+
+private:
+    static const qint32 MAX_QUEUE_SIZE;
+
+private:
+    struct Private;
+    Private * const m_d;
+};
+
+#endif /* KIS_TILE_DATA_PREFETCHER_H_ */
@@ -23,6 +23,7 @@
 
 #include "../../../sdk/tests/testutil.h"
 #include "tiles3/swap/kis_lzf_compression.h"
+#include "tiles3/swap/kis_lz4_compression.h"
 #include <kis_debug.h>
 
 #define TEST_FILE "tile.png"
@@ -261,6 +262,50 @@ void KisCompressionTests::benchmarkDecompressionLzfTwoPass()
     benchmarkDecompressionTwoPass(compression);
     delete compression;
 }
+void KisCompressionTests::testLz4RoundTrip()
+{
+    KisAbstractCompression *compression = new KisLz4Compression();
+
+    roundTrip(compression);
+    roundTripTwoPass(compression);
+
+    delete compression;
+}
+
+void KisCompressionTests::testLz4Overflow()
+{
+    KisAbstractCompression *compression = new KisLz4Compression();
+    testOverflow(compression);
+    delete compression;
+}
+
+void KisCompressionTests::benchmarkCompressionLz4()
+{
+    KisAbstractCompression *compression = new KisLz4Compression();
+    benchmarkCompression(compression);
+    delete compression;
+}
+
+void KisCompressionTests::benchmarkCompressionLz4TwoPass()
+{
+    KisAbstractCompression *compression = new KisLz4Compression();
+    benchmarkCompressionTwoPass(compression);
+    delete compression;
+}
+
+void KisCompressionTests::benchmarkDecompressionLz4()
+{
+    KisAbstractCompression *compression = new KisLz4Compression();
+    benchmarkDecompression(compression);
+    delete compression;
+}
+
+void KisCompressionTests::benchmarkDecompressionLz4TwoPass()
+{
+    KisAbstractCompression *compression = new KisLz4Compression();
+    benchmarkDecompressionTwoPass(compression);
+    delete compression;
+}
 
 QTEST_KDEMAIN(KisCompressionTests, NoGUI)
 
@@ -48,6 +48,14 @@ private Q_SLOTS:
     void benchmarkCompressionLzfTwoPass();
     void benchmarkDecompressionLzf();
     void benchmarkDecompressionLzfTwoPass();
+
+    void testLz4RoundTrip();
+    void testLz4Overflow();
+
+    void benchmarkCompressionLz4();
+    void benchmarkCompressionLz4TwoPass();
+    void benchmarkDecompressionLz4();
+    void benchmarkDecompressionLz4TwoPass();
 };
 
 #endif /* KIS_COMPRESSION_TESTS_H */
@@ -179,6 +179,67 @@ void KisTileCompressorsTest::testLowLevelRoundTripIncompressible2()
     delete compressor;
 }
 
+void KisTileCompressorsTest::testRoundTripLz4()
+{
+    KisAbstractTileCompressor *compressor = new KisTileCompressor2("LZ4");
+    doRoundTrip(compressor);
+    delete compressor;
+}
+
+void KisTileCompressorsTest::testLowLevelRoundTripLz4()
+{
+    KisAbstractTileCompressor *compressor = new KisTileCompressor2("LZ4");
+    doLowLevelRoundTrip(compressor);
+    delete compressor;
+}
+
+void KisTileCompressorsTest::testLowLevelRoundTripIncompressibleLz4()
+{
+    KisAbstractTileCompressor *compressor = new KisTileCompressor2("LZ4");
+    doLowLevelRoundTripIncompressible(compressor);
+    delete compressor;
+}
+
+void KisTileCompressorsTest::testLowLevelRoundTripUniformInternal()
+{
+    KisAbstractTileCompressor *compressor = new KisTileCompressor2("LZ4", true);
+    doLowLevelRoundTrip(compressor);
+    doLowLevelRoundTripIncompressible(compressor);
+    delete compressor;
+}
+
+void KisTileCompressorsTest::testReadForeignCompression()
+{
+    quint8 defaultPixel = 0;
+    KisTiledDataManager dm(1, &defaultPixel);
+
+    quint8 oddPixel1 = 128;
+    dm.clear(64, 64, 64, 64, &oddPixel1);
+
+    KoStoreFake fakeStore;
+    KisFakePaintDeviceWriter writer(&fakeStore);
+
+    KisTileSP tile11 = dm.getTile(1, 1, false);
+
+    KisAbstractTileCompressor *writeCompressor = new KisTileCompressor2("LZ4");
+    QVERIFY(writeCompressor->writeTile(tile11, writer));
+    delete writeCompressor;
+    tile11 = 0;
+
+    fakeStore.startReading();
+    dm.clear();
+
+    /**
+     * The codec is written into the tile header, so the
+     * default compressor should be able to read it
+     */
+    KisAbstractTileCompressor *readCompressor = new KisTileCompressor2();
+    QVERIFY(readCompressor->readTile(fakeStore.device(), &dm));
+    delete readCompressor;
+
+    tile11 = dm.getTile(1, 1, false);
+    QVERIFY(memoryIsFilled(oddPixel1, tile11->data(), TILESIZE));
+}
 
 QTEST_KDEMAIN(KisTileCompressorsTest, NoGUI)
 
@@ -38,6 +38,13 @@ private Q_SLOTS:
     void testRoundTrip2();
     void testLowLevelRoundTrip2();
     void testLowLevelRoundTripIncompressible2();
+
+    void testRoundTripLz4();
+    void testLowLevelRoundTripLz4();
+    void testLowLevelRoundTripIncompressibleLz4();
+    void testLowLevelRoundTripUniformInternal();
+
+    void testReadForeignCompression();
 };
 
 #endif /* KIS_TILE_COMPRESSORS_TEST_H */
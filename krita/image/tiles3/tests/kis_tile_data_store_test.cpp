@@ -181,5 +181,59 @@ void KisTileDataStoreTest::testSwapping()
     }
 }
 
+void KisTileDataStoreTest::testPrefetching()
+{
+    KisImageConfig config;
+    config.setMemoryHardLimitPercent(50);
+    config.setMemorySoftLimitPercent(0);
+
+    KisTileDataStore *store = KisTileDataStore::instance();
+    store->debugClear();
+    store->testingRereadConfig();
+
+    const qint32 pixelSize = 1;
+    quint8 defaultPixel = 128;
+    KisTiledDataManager dm(pixelSize, &defaultPixel);
+
+    const qint32 numCols = 10;
+
+    for(qint32 col = 0; col < numCols; col++) {
+        KisTileSP tile = dm.getTile(col, 0, true);
+        tile->lockForWrite();
+        memset(tile->data(), COLUMN2COLOR(col), TILESIZE);
+        tile->unlock();
+    }
+
+    store->debugSwapAll();
+    QVERIFY(store->hasSwappedTiles());
+
+    for(qint32 col = 0; col < numCols; col++) {
+        QVERIFY(!dm.getTile(col, 0, false)->tileData()->data());
+    }
+
+    KisTileDataStore::MemoryStatistics statsBefore = store->memoryStatistics();
+
+    // prefetch the first half of the tiles only
+    dm.prefetchRect(QRect(0, 0, numCols / 2 * KisTileData::WIDTH, KisTileData::HEIGHT));
+    store->testingWaitForPrefetcher();
+
+    KisTileDataStore::MemoryStatistics statsAfter = store->memoryStatistics();
+    QCOMPARE(statsAfter.numPrefetchedSwapIns - statsBefore.numPrefetchedSwapIns, qint64(numCols / 2));
+    QCOMPARE(statsAfter.numDemandSwapIns, statsBefore.numDemandSwapIns);
+
+    for(qint32 col = 0; col < numCols; col++) {
+        KisTileSP tile = dm.getTile(col, 0, false);
+        QCOMPARE(bool(tile->tileData()->data()), col < numCols / 2);
+
+        tile->lockForRead();
+        QVERIFY(memoryIsFilled(COLUMN2COLOR(col), tile->data(), TILESIZE));
+        tile->unlock();
+    }
+
+    statsAfter = store->memoryStatistics();
+    QCOMPARE(statsAfter.numDemandSwapIns - statsBefore.numDemandSwapIns, qint64(numCols / 2));
+    QVERIFY(statsAfter.prefetchHitRate > 0.0);
+}
+
 QTEST_KDEMAIN(KisTileDataStoreTest, NoGUI)
 
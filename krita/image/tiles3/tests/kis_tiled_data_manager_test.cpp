@@ -349,6 +349,42 @@ void KisTiledDataManagerTest::testBitBltRough()
     delete[] buffer;
 }
 
+void KisTiledDataManagerTest::testBitBltRoughDefaultTiles()
+{
+    quint8 defaultPixel = 0;
+    KisTiledDataManager srcDM(1, &defaultPixel);
+    KisTiledDataManager dstDM(1, &defaultPixel);
+
+    quint8 oddPixel1 = 128;
+    quint8 oddPixel2 = 129;
+
+    QRect dataRect(64,64,64,64);
+    QRect cloneRect(0,0,256,256);
+    QRect dataTilesRect(1,1,1,1);
+
+    srcDM.clear(dataRect, &oddPixel1);
+    dstDM.clear(cloneRect, &oddPixel2);
+
+    dstDM.bitBltRough(&srcDM, cloneRect);
+
+    quint8 *buffer = new quint8[cloneRect.width()*cloneRect.height()];
+
+    dstDM.readBytes(buffer, cloneRect.x(), cloneRect.y(), cloneRect.width(), cloneRect.height());
+
+    QVERIFY(checkHole(buffer, oddPixel1, dataRect,
+                      defaultPixel, cloneRect));
+
+    delete[] buffer;
+
+    // the tile with data is shared...
+    QVERIFY(checkTilesShared(&srcDM, &dstDM, false, false, dataTilesRect));
+
+    // ... and the default ones are just dropped
+    KisTileData *dstDefaultTileData = dstDM.getTile(100, 100, false)->tileData();
+    QCOMPARE(dstDM.getTile(0, 0, false)->tileData(), dstDefaultTileData);
+    QCOMPARE(dstDM.getTile(3, 3, false)->tileData(), dstDefaultTileData);
+}
+
 void KisTiledDataManagerTest::testTransactions()
 {
     quint8 defaultPixel = 0;
@@ -803,5 +839,67 @@ void KisTiledDataManagerTest::stressTest()
     pool.waitForDone();
 }
 
+class KisTileLookupStressJob : public QRunnable
+{
+public:
+    KisTileLookupStressJob(KisTiledDataManager &dataManager, QRect tilesRect, int seed)
+        : m_tilesRect(tilesRect), m_seed(seed), dm(dataManager)
+    {
+    }
+
+    void run() {
+        qsrand(m_seed);
+
+        for(qint32 i = 0; i < NUM_CYCLES * 100; i++) {
+            qint32 col = m_tilesRect.x() + qrand() % m_tilesRect.width();
+            qint32 row = m_tilesRect.y() + qrand() % m_tilesRect.height();
+
+            KisTileSP tile = dm.getTile(col, row, i & 0x1);
+            tile->lockForRead();
+            tile->unlock();
+
+            if (!(i % 97)) {
+                dm.purge(tile->extent());
+            }
+        }
+    }
+
+private:
+    QRect m_tilesRect;
+    int m_seed;
+    KisTiledDataManager &dm;
+};
+
+void KisTiledDataManagerTest::stressTestTileLookups()
+{
+    quint8 defaultPixel = 0;
+    KisTiledDataManager dm(1, &defaultPixel);
+
+    const int numThreads = 8;
+    QRect tilesRect(-4, -4, 16, 16);
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(numThreads);
+
+    for(qint32 i = 0; i < numThreads; i++) {
+        pool.start(new KisTileLookupStressJob(dm, tilesRect, i));
+    }
+    pool.waitForDone();
+
+    /**
+     * Every tile should be created only once, no matter how many
+     * threads asked for it simultaneously
+     */
+    for(qint32 row = tilesRect.y(); row <= tilesRect.bottom(); row++) {
+        for(qint32 col = tilesRect.x(); col <= tilesRect.right(); col++) {
+            KisTileSP tile1 = dm.getTile(col, row, true);
+            KisTileSP tile2 = dm.getTile(col, row, true);
+            QCOMPARE(tile1.data(), tile2.data());
+            QCOMPARE(tile1->col(), col);
+            QCOMPARE(tile1->row(), row);
+        }
+    }
+}
+
 QTEST_KDEMAIN(KisTiledDataManagerTest, NoGUI)
 
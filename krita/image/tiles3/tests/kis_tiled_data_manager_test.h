@@ -49,6 +49,7 @@ private Q_SLOTS:
     void testVersionedBitBlt();
     void testBitBltOldData();
     void testBitBltRough();
+    void testBitBltRoughDefaultTiles();
     void testTransactions();
     void testPurgeHistory();
     void testUndoSetDefaultPixel();
@@ -60,6 +61,7 @@ private Q_SLOTS:
     void benchmarkCOWWithPooler();
 
     void stressTest();
+    void stressTestTileLookups();
 };
 
 #endif /* KIS_TILED_DATA_MANAGER_TEST_H */
@@ -0,0 +1,68 @@
+/*
+ *  Copyright (c) 2015 Calligra developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef VC_EXTRA_MATH_H
+#define VC_EXTRA_MATH_H
+
+#include <config-vc.h>
+
+#if defined HAVE_VC
+
+#include <Vc/Vc>
+#include <Vc/IO>
+
+/**
+ * Math functions that are missing in Vc
+ */
+class VcExtraMath
+{
+public:
+    /**
+     * The error function, approximated with the formula 7.1.26 from
+     * Abramowitz and Stegun. The maximum absolute error is 1.5e-7,
+     * which is far below the 8-bit precision of the brush masks.
+     */
+    static inline Vc::float_v erf(Vc::float_v::AsArg x) {
+        const Vc::float_v a1( 0.254829592f);
+        const Vc::float_v a2(-0.284496736f);
+        const Vc::float_v a3( 1.421413741f);
+        const Vc::float_v a4(-1.453152027f);
+        const Vc::float_v a5( 1.061405429f);
+        const Vc::float_v p(0.3275911f);
+
+        const Vc::float_v vOne(1.0f);
+        const Vc::float_v vZero(Vc::Zero);
+
+        // erf(x) is 1.0 in float precision for larger values
+        const Vc::float_v vPrecisionLimit(9.3f);
+
+        Vc::float_v xa = Vc::abs(x);
+
+        Vc::float_v t = vOne / (vOne + p * xa);
+        Vc::float_v y = vOne - (((((a5 * t + a4) * t) + a3) * t + a2) * t + a1) * t * Vc::exp(-xa * xa);
+
+        y(xa >= vPrecisionLimit) = vOne;
+        y(x < vZero) = -y;
+
+        return y;
+    }
+};
+
+#endif /* defined HAVE_VC */
+
+#endif /* VC_EXTRA_MATH_H */
@@ -24,6 +24,7 @@
 #include <math.h>
 
 #include <QRect>
+#include <QDomDocument>
 #include <QDomElement>
 #include <QtConcurrentMap>
 #include <QByteArray>
@@ -80,6 +81,27 @@ KisAutoBrush::KisAutoBrush(KisMaskGenerator* as, qreal angle, qreal randomness,
     setImage(image);
 }
 
+KisAutoBrush::KisAutoBrush(const KisAutoBrush& rhs)
+    : KisBrush(rhs)
+    , d(new Private)
+{
+    QDomDocument doc;
+    QDomElement shapeElt = doc.createElement("MaskGenerator");
+    rhs.d->shape->toXML(doc, shapeElt);
+
+    d->shape = KisMaskGenerator::fromXML(shapeElt);
+    d->randomness = rhs.d->randomness;
+    d->density = rhs.d->density;
+    d->idealThreadCountCached = rhs.d->idealThreadCountCached;
+
+    setImage(rhs.image());
+}
+
+KisAutoBrush* KisAutoBrush::clone() const
+{
+    return new KisAutoBrush(*this);
+}
+
 KisAutoBrush::~KisAutoBrush()
 {
     delete d->shape;
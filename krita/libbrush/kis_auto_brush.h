@@ -33,9 +33,16 @@ class BRUSH_EXPORT KisAutoBrush : public KisBrush
 public:
 
     KisAutoBrush(KisMaskGenerator* as, qreal angle, qreal randomness, qreal density = 1.0);
+    KisAutoBrush(const KisAutoBrush& rhs);
 
     virtual ~KisAutoBrush();
 
+    /**
+     * @return a copy of the brush with its own mask generator, so the
+     * copy can generate the masks concurrently with the original
+     */
+    KisAutoBrush* clone() const;
+
 public:
 
     virtual KisFixedPaintDeviceSP paintDevice(const KoColorSpace*,
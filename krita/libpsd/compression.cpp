@@ -238,6 +238,13 @@ QByteArray Compression::uncompress(quint32 unpacked_len, QByteArray bytes, Compr
     return QByteArray();
 }
 
+void Compression::uncompressRLE(const char *src, int packedLength, char *dst, int unpackedLength)
+{
+    if (packedLength < 1 || unpackedLength < 1) return;
+
+    decode_packbits(src, dst, packedLength, unpackedLength);
+}
+
 QByteArray Compression::compress(QByteArray bytes, Compression::CompressionType compressionType)
 {
     if (bytes.size() < 1) return QByteArray();
@@ -34,6 +34,13 @@ public:
     };
 
     static QByteArray uncompress(quint32 unpacked_len, QByteArray bytes, CompressionType compressionType);
+
+    /**
+     * Decodes a single PackBits packed row into \p dst directly. \p dst
+     * must have space for \p unpackedLength bytes.
+     */
+    static void uncompressRLE(const char *src, int packedLength, char *dst, int unpackedLength);
+
     static QByteArray compress(QByteArray bytes, CompressionType compressionType);
 };
 
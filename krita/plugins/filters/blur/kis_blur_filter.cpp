@@ -24,6 +24,7 @@
 
 #include <kis_convolution_kernel.h>
 #include <kis_convolution_painter.h>
+#include <kis_image_config.h>
 
 #include "kis_wdg_blur.h"
 #include "ui_wdgblur.h"
@@ -102,6 +103,7 @@ void KisBlurFilter::processImpl(KisPaintDeviceSP device,
     KisConvolutionKernelSP kernel = KisConvolutionKernel::fromMaskGenerator(kas, rotate * M_PI / 180.0);
     delete kas;
     KisConvolutionPainter painter(device);
+    painter.setThreadCount(KisImageConfig().maxNumberOfThreads());
     painter.setChannelFlags(channelFlags);
     painter.setProgress(progressUpdater);
     painter.applyMatrix(kernel, device, srcTopLeft, srcTopLeft, rect.size(), BORDER_REPEAT);
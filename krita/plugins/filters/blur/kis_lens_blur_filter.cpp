@@ -26,6 +26,7 @@
 
 #include <kis_convolution_kernel.h>
 #include <kis_convolution_painter.h>
+#include <kis_image_config.h>
 
 #include "ui_wdg_lens_blur.h"
 
@@ -168,6 +169,7 @@ void KisLensBlurFilter::processImpl(KisPaintDeviceSP device,
 
     // apply convolution
     KisConvolutionPainter painter(device);
+    painter.setThreadCount(KisImageConfig().maxNumberOfThreads());
     painter.setChannelFlags(channelFlags);
     painter.setProgress(progressUpdater);
 
@@ -26,6 +26,7 @@
 
 #include <kis_convolution_kernel.h>
 #include <kis_convolution_painter.h>
+#include <kis_image_config.h>
 
 #include "ui_wdg_motion_blur.h"
 
@@ -122,6 +123,7 @@ void KisMotionBlurFilter::processImpl(KisPaintDeviceSP device,
 
     // apply convolution
     KisConvolutionPainter painter(device);
+    painter.setThreadCount(KisImageConfig().maxNumberOfThreads());
     painter.setChannelFlags(channelFlags);
     painter.setProgress(progressUpdater);
 
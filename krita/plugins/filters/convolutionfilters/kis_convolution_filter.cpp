@@ -26,6 +26,7 @@
 
 #include "kis_painter.h"
 #include "kis_convolution_painter.h"
+#include <kis_image_config.h>
 #include "kis_convolution_kernel.h"
 #include <filter/kis_filter_configuration.h>
 #include <kis_selection.h>
@@ -50,6 +51,7 @@ void KisConvolutionFilter::processImpl(KisPaintDeviceSP device,
     Q_ASSERT(device != 0);
 
     KisConvolutionPainter painter(device);
+    painter.setThreadCount(KisImageConfig().maxNumberOfThreads());
 
     QBitArray channelFlags;
     if (config) {
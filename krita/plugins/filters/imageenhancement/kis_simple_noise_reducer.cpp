@@ -27,6 +27,7 @@
 #include <kis_mask_generator.h>
 #include <kis_convolution_kernel.h>
 #include <kis_convolution_painter.h>
+#include <kis_image_config.h>
 #include <kis_global.h>
 #include <widgets/kis_multi_integer_filter_widget.h>
 #include <filter/kis_filter_configuration.h>
@@ -99,6 +100,7 @@ void KisSimpleNoiseReducer::processImpl(KisPaintDeviceSP device,
 
     KisPaintDeviceSP interm = new KisPaintDevice(*device); // TODO no need for a full copy and then a transaction
     KisConvolutionPainter painter(interm);
+    painter.setThreadCount(KisImageConfig().maxNumberOfThreads());
     painter.beginTransaction();
     painter.applyMatrix(kernel, interm, srcTopLeft, srcTopLeft, applyRect.size(), BORDER_REPEAT);
     painter.deleteTransaction();
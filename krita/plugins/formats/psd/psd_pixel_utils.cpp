@@ -21,6 +21,8 @@
 #include <QtGlobal>
 #include <QMap>
 #include <QIODevice>
+#include <QSharedPointer>
+#include <QtConcurrentMap>
 
 
 #include <KoColorSpace.h>
@@ -36,6 +38,7 @@
 #include "psd_layer_record.h"
 #include <asl/kis_offset_keeper.h>
 #include "kis_iterator_ng.h"
+#include "tiles3/kis_tile_data.h"
 
 #include "config_psd.h"
 #ifdef HAVE_ZLIB
@@ -259,65 +262,29 @@ void readLabPixelCommon(int channelSize,
 }
 
 /**********************************************************************/
-/* Two functions copied from the abandoned PSDParse library (GPL)     */
+/* A function adapted from the abandoned PSDParse library (GPL)       */
 /* See: http://www.telegraphics.com.au/svn/psdparse/trunk/psd_zip.c   */
 /* Created by Patrick in 2007.02.02, libpsd@graphest.com              */
 /* Modifications by Toby Thain <toby@telegraphics.com.au>             */
 /**********************************************************************/
 
-typedef bool psd_status;
 typedef quint8 psd_uchar;
 typedef int psd_int;
 typedef quint8 Bytef;
 
-psd_status psd_unzip_without_prediction(psd_uchar *src_buf, psd_int src_len, 
-                                        psd_uchar *dst_buf, psd_int dst_len)
-{
-#ifdef HAVE_ZLIB
-    z_stream stream;
-    psd_int state;
-
-    memset(&stream, 0, sizeof(z_stream));
-    stream.data_type = Z_BINARY;
-
-    stream.next_in = (Bytef *)src_buf;
-    stream.avail_in = src_len;
-    stream.next_out = (Bytef *)dst_buf;
-    stream.avail_out = dst_len;
-
-    if(inflateInit(&stream) != Z_OK)
-        return 0;
-
-    do {
-        state = inflate(&stream, Z_PARTIAL_FLUSH);
-        if(state == Z_STREAM_END)
-            break;
-        if(state == Z_DATA_ERROR || state != Z_OK)
-            break;
-    }  while (stream.avail_out > 0);
-
-    if (state != Z_STREAM_END && state != Z_OK)
-        return 0;
-
-    return 1;
-
-#endif /* HAVE_ZLIB */
-
-    return 0;
-}
-
-psd_status psd_unzip_with_prediction(psd_uchar *src_buf, psd_int src_len, 
-                                     psd_uchar *dst_buf, psd_int dst_len, 
-                                     psd_int row_size, psd_int color_depth)
+/**
+ * Reverts the prediction of the rows of ZIPWithPrediction-compressed
+ * data. The buffer must contain an integral number of rows. The data
+ * is inflated incrementally by ChannelStripDecoder, so this part of
+ * the original psd_unzip_with_prediction() is applied to every strip
+ * separately.
+ */
+void psd_unzip_prediction(psd_uchar *dst_buf, psd_int dst_len,
+                          psd_int row_size, psd_int color_depth)
 {
-    psd_status status;
     int len;
     psd_uchar * buf;
 
-    status = psd_unzip_without_prediction(src_buf, src_len, dst_buf, dst_len);
-    if(!status)
-        return status;
-
     buf = dst_buf;
     do {
         len = row_size;
@@ -343,47 +310,214 @@ psd_status psd_unzip_with_prediction(psd_uchar *src_buf, psd_int src_len,
             dst_len -= row_size;
         }
     } while(dst_len > 0);
-
-    return 1;
 }
 
 /**********************************************************************/
 /* End of third party block                                           */
 /**********************************************************************/
 
-QMap<quint16, QByteArray> fetchChannelsBytes(QIODevice *io, QVector<ChannelInfo*> channelInfoRecords,
-                                            int row, int width, int channelSize)
+/**
+ * Decodes the rows of a single channel strip by strip, so that only
+ * one strip of every channel is kept in memory while the pixels are
+ * written into the paint device.
+ *
+ * fetchStrip() reads the compressed data from the file and must be
+ * called in the thread owning the io device. decodeStrip() does not
+ * touch the file, so the strips of different channels are decoded
+ * concurrently.
+ */
+class ChannelStripDecoder
 {
-    const int uncompressedLength = width * channelSize;
+public:
+    ChannelStripDecoder(ChannelInfo *info, int width, int channelSize)
+        : m_info(info),
+          m_rowLength(width * channelSize),
+          m_channelSize(channelSize),
+          m_firstRow(0),
+          m_numRows(0)
+#ifdef HAVE_ZLIB
+          , m_zipInitialized(false)
+#endif
+    {
+        const Compression::CompressionType type = m_info->compressionType;
+
+        bool supported =
+            type == Compression::Uncompressed ||
+            type == Compression::RLE;
+
+#ifdef HAVE_ZLIB
+        supported |=
+            type == Compression::ZIP ||
+            type == Compression::ZIPWithPrediction;
+#endif
+
+        if (!supported) {
+            QString error = QString("Unsupported Compression mode: %1").arg(type);
+            dbgFile << "ERROR: ChannelStripDecoder:" << error;
+            throw KisAslReaderUtils::ASLParseException(error);
+        }
+    }
+
+    ~ChannelStripDecoder() {
+#ifdef HAVE_ZLIB
+        if (m_zipInitialized) {
+            inflateEnd(&m_zipStream);
+        }
+#endif
+    }
 
-    QMap<quint16, QByteArray> channelBytes;
+    qint16 channelId() const {
+        return m_info->channelId;
+    }
 
-    foreach(ChannelInfo *channelInfo, channelInfoRecords) {
-        // user supplied masks are ignored here
-        if (channelInfo->channelId < -1) continue;
+    const QByteArray& stripBytes() const {
+        return m_stripBytes;
+    }
+
+    QString error() const {
+        return m_error;
+    }
 
-        io->seek(channelInfo->channelDataStart + channelInfo->channelOffset);
+    void fetchStrip(QIODevice *io, int firstRow, int numRows) {
+        m_firstRow = firstRow;
+        m_numRows = numRows;
 
-        if (channelInfo->compressionType == Compression::Uncompressed) {
-            channelBytes[channelInfo->channelId] = io->read(uncompressedLength);
-            channelInfo->channelOffset += uncompressedLength;
+        switch (m_info->compressionType) {
+        case Compression::Uncompressed: {
+            const int length = m_numRows * m_rowLength;
+
+            io->seek(m_info->channelDataStart + m_info->channelOffset);
+            m_stripBytes = io->read(length);
+            m_info->channelOffset += length;
+
+            if (m_stripBytes.size() != length) {
+                m_error = "Unexpected end of the channel data";
+                m_stripBytes.resize(length);
+            }
+            break;
         }
-        else if (channelInfo->compressionType == Compression::RLE) {
-            int rleLength = channelInfo->rleRowLengths[row];
-            QByteArray compressedBytes = io->read(rleLength);
-            QByteArray uncompressedBytes = Compression::uncompress(uncompressedLength, compressedBytes, channelInfo->compressionType);
-            channelBytes.insert(channelInfo->channelId, uncompressedBytes);
-            channelInfo->channelOffset += rleLength;
+        case Compression::RLE: {
+            int length = 0;
+            for (int row = m_firstRow; row < m_firstRow + m_numRows; row++) {
+                length += m_info->rleRowLengths[row];
+            }
+
+            io->seek(m_info->channelDataStart + m_info->channelOffset);
+            m_compressedBytes = io->read(length);
+            m_info->channelOffset += length;
+
+            if (m_compressedBytes.size() != length) {
+                m_error = "Unexpected end of the channel data";
+            }
+            break;
         }
-        else {
-            QString error = QString("Unsupported Compression mode: %1").arg(channelInfo->compressionType);
-            dbgFile << "ERROR: fetchChannelsBytes:" << error;
-            throw KisAslReaderUtils::ASLParseException(error);
+        default:
+            // the zip stream cannot be split into rows without
+            // inflating it, so the whole of it is read once
+            if (m_compressedBytes.isEmpty()) {
+                io->seek(m_info->channelDataStart);
+                m_compressedBytes = io->read(m_info->channelDataLength);
+            }
+            break;
         }
     }
 
-    return channelBytes;
-}
+    void decodeStrip() {
+        switch (m_info->compressionType) {
+        case Compression::Uncompressed:
+            break;
+        case Compression::RLE:
+            decodeRLE();
+            break;
+        default:
+            decodeZIP();
+            break;
+        }
+    }
+
+private:
+    void decodeRLE() {
+        m_stripBytes = QByteArray(m_numRows * m_rowLength, 0);
+
+        const char *src = m_compressedBytes.constData();
+        const char *srcEnd = src + m_compressedBytes.size();
+        char *dst = m_stripBytes.data();
+
+        for (int row = m_firstRow; row < m_firstRow + m_numRows; row++) {
+            const int rleLength = qMin(int(m_info->rleRowLengths[row]), int(srcEnd - src));
+
+            Compression::uncompressRLE(src, rleLength, dst, m_rowLength);
+
+            src += rleLength;
+            dst += m_rowLength;
+        }
+
+        m_compressedBytes.clear();
+    }
+
+    void decodeZIP() {
+#ifdef HAVE_ZLIB
+        m_stripBytes = QByteArray(m_numRows * m_rowLength, 0);
+
+        if (!m_zipInitialized) {
+            memset(&m_zipStream, 0, sizeof(z_stream));
+            m_zipStream.data_type = Z_BINARY;
+            m_zipStream.next_in = (Bytef *)m_compressedBytes.data();
+            m_zipStream.avail_in = m_compressedBytes.size();
+
+            if (inflateInit(&m_zipStream) != Z_OK) {
+                m_error = "Failed to initialize zlib";
+                return;
+            }
+            m_zipInitialized = true;
+        }
+
+        m_zipStream.next_out = (Bytef *)m_stripBytes.data();
+        m_zipStream.avail_out = m_stripBytes.size();
+
+        int state = Z_OK;
+        do {
+            state = inflate(&m_zipStream, Z_PARTIAL_FLUSH);
+        } while (state == Z_OK && m_zipStream.avail_out > 0);
+
+        if (state != Z_STREAM_END && state != Z_OK) {
+            m_error = QString("Failed to unzip channel data: id = %1, compression = %2")
+                .arg(m_info->channelId).arg(m_info->compressionType);
+            return;
+        }
+
+        if (m_info->compressionType == Compression::ZIPWithPrediction) {
+            psd_unzip_prediction((psd_uchar*)m_stripBytes.data(), m_stripBytes.size(),
+                                 m_rowLength / m_channelSize, m_channelSize * 8);
+        }
+#endif /* HAVE_ZLIB */
+    }
+
+private:
+    ChannelInfo *m_info;
+    const int m_rowLength;
+    const int m_channelSize;
+
+    int m_firstRow;
+    int m_numRows;
+
+    QByteArray m_compressedBytes;
+    QByteArray m_stripBytes;
+    QString m_error;
+
+#ifdef HAVE_ZLIB
+    z_stream m_zipStream;
+    bool m_zipInitialized;
+#endif
+};
+
+typedef QSharedPointer<ChannelStripDecoder> ChannelStripDecoderSP;
+
+struct DecodeStripFunctor {
+    void operator() (ChannelStripDecoderSP &decoder) {
+        decoder->decodeStrip();
+    }
+};
 
 typedef boost::function<void(int, const QMap<quint16, QByteArray>&, int, quint8*)> PixelFunc;
 
@@ -401,58 +535,49 @@ void readCommon(KisPaintDeviceSP dev,
         return;
     }
 
-    if (infoRecords.first()->compressionType == Compression::ZIP ||
-        infoRecords.first()->compressionType == Compression::ZIPWithPrediction) {
+    QVector<ChannelStripDecoderSP> decoders;
 
-        const int numPixels = channelSize * layerRect.width() * layerRect.height();
+    foreach (ChannelInfo *info, infoRecords) {
+        // user supplied masks are read separately
+        if (info->channelId < -1) continue;
 
-        QMap<quint16, QByteArray> channelBytes;
+        decoders << ChannelStripDecoderSP(new ChannelStripDecoder(info, layerRect.width(), channelSize));
+    }
 
-        foreach (ChannelInfo *info, infoRecords) {
-            io->seek(info->channelDataStart);
-            QByteArray compressedBytes = io->read(info->channelDataLength);
-            QByteArray uncompressedBytes(numPixels, 0);
+    /**
+     * The channels are decoded by strips of the height of a tile, so
+     * no full-size copy of the layer is ever created, and every strip
+     * lands into a single row of tiles of the device.
+     */
+    const int stripHeight = KisTileData::HEIGHT;
 
-            bool status = false;
-            if (infoRecords.first()->compressionType == Compression::ZIP) {
-                status = psd_unzip_without_prediction((quint8*)compressedBytes.data(), compressedBytes.size(),
-                                                      (quint8*)uncompressedBytes.data(), uncompressedBytes.size());
-            } else {
-                status = psd_unzip_with_prediction((quint8*)compressedBytes.data(), compressedBytes.size(),
-                                                   (quint8*)uncompressedBytes.data(), uncompressedBytes.size(),
-                                                   layerRect.width(), channelSize * 8);
-            }
+    KisHLineIteratorSP it = dev->createHLineIteratorNG(layerRect.left(), layerRect.top(), layerRect.width());
 
-            if (!status) {
-                QString error = QString("Failed to unzip channel data: id = %1, compression = %2").arg(info->channelId).arg(info->compressionType);
-                dbgFile << "ERROR:" << error;
-                dbgFile << "      " << ppVar(info->channelId);
-                dbgFile << "      " << ppVar(info->channelDataStart);
-                dbgFile << "      " << ppVar(info->channelDataLength);
-                dbgFile << "      " << ppVar(info->compressionType);
-                throw KisAslReaderUtils::ASLParseException(error);
-            }
+    for (int firstRow = 0; firstRow < layerRect.height(); firstRow += stripHeight) {
+        const int numRows = qMin(stripHeight, layerRect.height() - firstRow);
 
-            channelBytes.insert(info->channelId, uncompressedBytes);
+        foreach (ChannelStripDecoderSP decoder, decoders) {
+            decoder->fetchStrip(io, firstRow, numRows);
         }
 
-        KisSequentialIterator it(dev, layerRect);
-        int col = 0;
-        do {
-            pixelFunc(channelSize, channelBytes, col, it.rawData());
-            col++;
-        } while(it.nextPixel());
+        QtConcurrent::blockingMap(decoders, DecodeStripFunctor());
+
+        QMap<quint16, QByteArray> channelBytes;
 
-    } else {
-        KisHLineIteratorSP it = dev->createHLineIteratorNG(layerRect.left(), layerRect.top(), layerRect.width());
-        for (int i = 0 ; i < layerRect.height(); i++) {
-            QMap<quint16, QByteArray> channelBytes;
+        foreach (ChannelStripDecoderSP decoder, decoders) {
+            if (!decoder->error().isEmpty()) {
+                dbgFile << "ERROR:" << decoder->error();
+                throw KisAslReaderUtils::ASLParseException(decoder->error());
+            }
+
+            channelBytes.insert(decoder->channelId(), decoder->stripBytes());
+        }
 
-            channelBytes = fetchChannelsBytes(io, infoRecords,
-                                              i, layerRect.width(), channelSize);
+        for (int row = 0; row < numRows; row++) {
+            const int rowOffset = row * layerRect.width();
 
-            for (qint64 col = 0; col < layerRect.width(); col++){
-                pixelFunc(channelSize, channelBytes, col, it->rawData());
+            for (int col = 0; col < layerRect.width(); col++) {
+                pixelFunc(channelSize, channelBytes, rowOffset + col, it->rawData());
                 it->nextPixel();
             }
             it->nextRow();
@@ -491,7 +616,29 @@ void readChannels(QIODevice *io,
     }
 }
 
-void writeChannelDataRLE(QIODevice *io, const quint8 *plane, const int channelSize, const QRect &rc, const qint64 sizeFieldOffset, const qint64 rleBlockOffset, const bool writeCompressionType)
+/**
+ * The RLE-compressed rows of a channel. The channels of a layer are
+ * stored one after another in the file, so the compressed rows are
+ * collected strip by strip and written when the whole layer has been
+ * compressed.
+ */
+struct CompressedChannel {
+    QVector<quint16> rowLengths;
+    QByteArray data;
+};
+
+void compressRowsRLE(const quint8 *plane, int rowLength, int numRows, CompressedChannel *channel)
+{
+    for (int row = 0; row < numRows; ++row) {
+        QByteArray uncompressed = QByteArray::fromRawData((const char*)plane + row * rowLength, rowLength);
+        QByteArray compressed = Compression::compress(uncompressed, Compression::RLE);
+
+        channel->rowLengths.append(compressed.size());
+        channel->data.append(compressed);
+    }
+}
+
+void writeCompressedChannelRLE(QIODevice *io, const CompressedChannel &channel, const qint64 sizeFieldOffset, const qint64 rleBlockOffset, const bool writeCompressionType)
 {
     typedef KisAslWriterUtils::OffsetStreamPusher<quint32> Pusher;
     QScopedPointer<Pusher> channelBlockSizeExternalTag;
@@ -505,9 +652,6 @@ void writeChannelDataRLE(QIODevice *io, const quint8 *plane, const int channelSi
 
     const bool externalRleBlock = rleBlockOffset >= 0;
 
-    // the start of RLE sizes block
-    const qint64 channelRLESizePos = externalRleBlock ? rleBlockOffset : io->pos();
-
     {
         QScopedPointer<KisOffsetKeeper> rleOffsetKeeper;
 
@@ -516,26 +660,23 @@ void writeChannelDataRLE(QIODevice *io, const quint8 *plane, const int channelSi
             io->seek(rleBlockOffset);
         }
 
-        // write zero's for the channel lengths block
-        for(int i = 0; i < rc.height(); ++i) {
-            // XXX: choose size for PSB!
-            const quint16 fakeRLEBLockSize = 0;
-            SAFE_WRITE_EX(io, fakeRLEBLockSize);
+        // XXX: choose size for PSB!
+        foreach (quint16 rowLength, channel.rowLengths) {
+            SAFE_WRITE_EX(io, rowLength);
         }
     }
 
-    quint32 stride = channelSize * rc.width();
-    for (qint32 row = 0; row < rc.height(); ++row) {
-
-        QByteArray uncompressed = QByteArray::fromRawData((const char*)plane + row * stride, stride);
-        QByteArray compressed = Compression::compress(uncompressed, Compression::RLE);
+    if (io->write(channel.data) != channel.data.size()) {
+        throw KisAslWriterUtils::ASLWriteException("Failed to write image data");
+    }
+}
 
-        KisAslWriterUtils::OffsetStreamPusher<quint16> rleExternalTag(io, 0, channelRLESizePos + row * sizeof(quint16));
+void writeChannelDataRLE(QIODevice *io, const quint8 *plane, const int channelSize, const QRect &rc, const qint64 sizeFieldOffset, const qint64 rleBlockOffset, const bool writeCompressionType)
+{
+    CompressedChannel channel;
+    compressRowsRLE(plane, channelSize * rc.width(), rc.height(), &channel);
 
-        if (io->write(compressed) != compressed.size()) {
-            throw KisAslWriterUtils::ASLWriteException("Failed to write image data");
-        }
-    }
+    writeCompressedChannelRLE(io, channel, sizeFieldOffset, rleBlockOffset, writeCompressionType);
 }
 
 inline void preparePixelForWrite(quint8 *dataPlane,
@@ -581,6 +722,26 @@ inline void preparePixelForWrite(quint8 *dataPlane,
     }
 }
 
+struct CompressStripJob {
+    quint8 *plane;
+    qint16 channelId;
+    CompressedChannel *channel;
+};
+
+struct CompressStripFunctor {
+    CompressStripFunctor(const QRect &_stripRect, int _channelSize, psd_color_mode _colorMode)
+        : stripRect(_stripRect), channelSize(_channelSize), colorMode(_colorMode) {}
+
+    void operator() (CompressStripJob &job) {
+        preparePixelForWrite(job.plane, stripRect.width() * stripRect.height(), channelSize, job.channelId, colorMode);
+        compressRowsRLE(job.plane, channelSize * stripRect.width(), stripRect.height(), job.channel);
+    }
+
+    QRect stripRect;
+    int channelSize;
+    psd_color_mode colorMode;
+};
+
 void writePixelDataCommon(QIODevice *io,
                           KisPaintDeviceSP dev,
                           const QRect &rc,
@@ -593,48 +754,71 @@ void writePixelDataCommon(QIODevice *io,
     // Empty rects must be processed separately on a higher level!
     KIS_ASSERT_RECOVER_RETURN(!rc.isEmpty());
 
-    QVector<quint8* > tmp = dev->readPlanarBytes(rc.x() - dev->x(), rc.y() - dev->y(), rc.width(), rc.height());
     const KoColorSpace *colorSpace = dev->colorSpace();
 
-    QVector<quint8*> planes;
+    // the indexes of the planes returned by readPlanarBytes() in the
+    // order of the psd channels
+    QVector<int> planeIndexes;
 
-    { // prepare 'planes' array
+    { // prepare 'planeIndexes' array
 
-        quint8 *alphaPlanePtr = 0;
+        int alphaPlaneIndex = -1;
 
         QList<KoChannelInfo*> origChannels = colorSpace->channels();
         foreach(KoChannelInfo *ch, KoChannelInfo::displayOrderSorted(origChannels)) {
             int channelIndex = KoChannelInfo::displayPositionToChannelIndex(ch->displayPosition(), origChannels);
 
-            quint8 *holder = 0;
-            qSwap(holder, tmp[channelIndex]);
-
             if (ch->channelType() == KoChannelInfo::ALPHA) {
-                qSwap(holder, alphaPlanePtr);
+                alphaPlaneIndex = channelIndex;
             } else {
-                planes.append(holder);
+                planeIndexes.append(channelIndex);
             }
         }
 
-        if (alphaPlanePtr) {
+        if (alphaPlaneIndex >= 0) {
             if (alphaFirst) {
-                planes.insert(0, alphaPlanePtr);
+                planeIndexes.insert(0, alphaPlaneIndex);
                 KIS_ASSERT_RECOVER_NOOP(writingInfoList.first().channelId == -1);
             } else {
-                planes.append(alphaPlanePtr);
+                planeIndexes.append(alphaPlaneIndex);
                 KIS_ASSERT_RECOVER_NOOP(
-                    (writingInfoList.size() == planes.size() - 1) ||
+                    (writingInfoList.size() == planeIndexes.size() - 1) ||
                     (writingInfoList.last().channelId == -1));
             }
         }
-
-        // now planes are holding pointers to quint8 arrays
-        tmp.clear();
     }
 
-    KIS_ASSERT_RECOVER_RETURN(planes.size() >= writingInfoList.size());
+    KIS_ASSERT_RECOVER_RETURN(planeIndexes.size() >= writingInfoList.size());
+
+    /**
+     * The device is read and compressed by strips of the height of a
+     * tile, so only the compressed data and a single strip of the
+     * uncompressed planes are kept in memory. The planes of a strip
+     * are compressed concurrently.
+     */
+    const int stripHeight = KisTileData::HEIGHT;
+
+    QVector<CompressedChannel> channels(writingInfoList.size());
 
-    const int numPixels = rc.width() * rc.height();
+    for (int y = rc.top(); y <= rc.bottom(); y += stripHeight) {
+        const QRect stripRect(rc.x(), y, rc.width(), qMin(stripHeight, rc.bottom() - y + 1));
+
+        QVector<quint8*> planes = dev->readPlanarBytes(stripRect.x() - dev->x(), stripRect.y() - dev->y(),
+                                                       stripRect.width(), stripRect.height());
+
+        QVector<CompressStripJob> jobs;
+        for (int i = 0; i < writingInfoList.size(); i++) {
+            CompressStripJob job;
+            job.plane = planes[planeIndexes[i]];
+            job.channelId = writingInfoList[i].channelId;
+            job.channel = &channels[i];
+            jobs.append(job);
+        }
+
+        QtConcurrent::blockingMap(jobs, CompressStripFunctor(stripRect, channelSize, colorMode));
+
+        qDeleteAll(planes);
+    }
 
     // write down the planes
 
@@ -643,23 +827,17 @@ void writePixelDataCommon(QIODevice *io,
             const ChannelWritingInfo &info = writingInfoList[i];
 
             dbgFile << "\tWriting channel" << i << "psd channel id" << info.channelId;
-
-            preparePixelForWrite(planes[i], numPixels, channelSize, info.channelId, colorMode);
-
             dbgFile << "\t\tchannel start" << ppVar(io->pos());
 
-            writeChannelDataRLE(io, planes[i], channelSize, rc, info.sizeFieldOffset, info.rleBlockOffset, writeCompressionType);
+            writeCompressedChannelRLE(io, channels[i], info.sizeFieldOffset, info.rleBlockOffset, writeCompressionType);
+
+            // release the memory as soon as possible
+            channels[i] = CompressedChannel();
         }
 
     } catch (KisAslWriterUtils::ASLWriteException &e) {
-        qDeleteAll(planes);
-        planes.clear();
-
         throw KisAslWriterUtils::ASLWriteException(PREPEND_METHOD(e.what()));
     }
-
-    qDeleteAll(planes);
-    planes.clear();
 }
 
 }
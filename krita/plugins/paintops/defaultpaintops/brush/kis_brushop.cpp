@@ -40,9 +40,13 @@
 #include <kis_color_source.h>
 #include <kis_pressure_sharpness_option.h>
 #include <kis_fixed_paint_device.h>
+#include <kis_auto_brush.h>
+#include <kis_image_config.h>
+#include <kis_dab_rendering_queue.h>
 
 KisBrushOp::KisBrushOp(const KisBrushBasedPaintOpSettings *settings, KisPainter *painter, KisNodeSP node, KisImageSP image)
-    : KisBrushBasedPaintOp(settings, painter), m_opacityOption(node), m_hsvTransformation(0)
+    : KisBrushBasedPaintOp(settings, painter), m_opacityOption(node), m_hsvTransformation(0),
+      m_dabRenderingQueue(0), m_isPaintingLine(false)
 {
     Q_UNUSED(image);
     Q_ASSERT(settings);
@@ -85,10 +89,35 @@ KisBrushOp::KisBrushOp(const KisBrushBasedPaintOpSettings *settings, KisPainter
 
     m_dabCache->setSharpnessPostprocessing(&m_sharpnessOption);
     m_rotationOption.applyFanCornersInfo(this);
+
+    /**
+     * The masks of the auto brush may be generated in the background
+     * while the previous dabs are composited. The other brushes keep
+     * state that depends on the order of the dabs or share their data
+     * with the resource server, so they cannot be copied for the
+     * rendering threads. The texture, sharpness and mirror options
+     * post-process the dab using the sensors, which must be evaluated
+     * in order as well.
+     */
+    const KisAutoBrush *autoBrush = dynamic_cast<const KisAutoBrush*>(m_brush.data());
+    const int numRenderingThreads = qMin(KisImageConfig().maxNumberOfThreads(), 4);
+
+    if (autoBrush &&
+        numRenderingThreads > 1 &&
+        m_colorSource->isUniformColor() &&
+        !m_dabCache->needSeparateOriginal() &&
+        !m_mirrorOption.isChecked()) {
+
+        m_dabRenderingQueue =
+            new KisDabRenderingQueue(autoBrush,
+                                     &m_precisionOption,
+                                     numRenderingThreads);
+    }
 }
 
 KisBrushOp::~KisBrushOp()
 {
+    delete m_dabRenderingQueue;
     qDeleteAll(m_hsvOptions);
     delete m_colorSource;
     delete m_hsvTransformation;
@@ -136,6 +165,31 @@ KisSpacingInformation KisBrushOp::paintAt(const KisPaintInformation& info)
         m_colorSource->applyColorTransformation(m_hsvTransformation);
     }
 
+    if (m_dabRenderingQueue && m_isPaintingLine) {
+        KisDabRenderingQueue::Request request;
+        request.colorSpace = device->compositionSourceColorSpace();
+        request.color = m_colorSource->uniformColor();
+        request.cursorPoint = cursorPos;
+        request.scale = scale;
+        request.rotation = rotation;
+        request.info = KisDabRenderingQueue::detachedInfo(info);
+        request.softnessFactor = m_softnessOption.apply(info);
+        request.opacity = painter()->opacity();
+        request.flow = painter()->flow();
+
+        painter()->setOpacity(origOpacity);
+
+        if (m_dabRenderingQueue->isFull()) {
+            compositeNextDab();
+        }
+        m_dabRenderingQueue->addRequest(request);
+
+        return effectiveSpacing(scale, rotation,
+                                m_spacingOption, info);
+    }
+
+    flushDabs();
+
     QRect dabRect;
     KisFixedPaintDeviceSP dab = m_dabCache->fetchDab(device->compositionSourceColorSpace(),
                                 m_colorSource,
@@ -183,6 +237,41 @@ void KisBrushOp::paintLine(const KisPaintInformation& pi1, const KisPaintInforma
 	painter()->renderMirrorMask(rc, m_lineCacheDevice);
     }
     else {
+        m_isPaintingLine = true;
         KisPaintOp::paintLine(pi1, pi2, currentDistance);
+        m_isPaintingLine = false;
+
+        flushDabs();
+    }
+}
+
+void KisBrushOp::compositeNextDab()
+{
+    KisDabRenderingQueue::Dab dab = m_dabRenderingQueue->takeDab();
+
+    // sanity check for the size calculation code
+    if (dab.device->bounds().size() != dab.rect.size()) {
+        warnKrita << "KisBrushOp: dab bounds is not dab rect. See bug 327156" << dab.device->bounds().size() << dab.rect.size();
+    }
+
+    quint8 origOpacity = painter()->opacity();
+    quint8 origFlow = painter()->flow();
+
+    painter()->setOpacity(dab.request.opacity);
+    painter()->setFlow(dab.request.flow);
+
+    painter()->bltFixed(dab.rect.topLeft(), dab.device, dab.device->bounds());
+    painter()->renderMirrorMaskSafe(dab.rect, dab.device, true);
+
+    painter()->setOpacity(origOpacity);
+    painter()->setFlow(origFlow);
+}
+
+void KisBrushOp::flushDabs()
+{
+    if (!m_dabRenderingQueue) return;
+
+    while (!m_dabRenderingQueue->isEmpty()) {
+        compositeNextDab();
     }
 }
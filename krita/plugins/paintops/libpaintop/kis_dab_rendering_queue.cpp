@@ -0,0 +1,135 @@
+/*
+ *  Copyright (c) 2015 Calligra developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_dab_rendering_queue.h"
+
+#include <QFuture>
+#include <QQueue>
+#include <QVector>
+#include <QtConcurrentRun>
+
+#include <kis_auto_brush.h>
+#include <kis_fixed_paint_device.h>
+
+#include "kis_dab_cache.h"
+
+
+namespace {
+
+struct DabRenderer {
+    DabRenderer(KisBrushSP _brush)
+        : brush(_brush),
+          cache(new KisDabCache(_brush))
+    {
+    }
+
+    ~DabRenderer() {
+        delete cache;
+    }
+
+    KisBrushSP brush;
+    KisDabCache *cache;
+};
+
+KisDabRenderingQueue::Dab renderDab(DabRenderer *renderer, const KisDabRenderingQueue::Request &request)
+{
+    KisDabRenderingQueue::Dab dab;
+    dab.request = request;
+
+    dab.device = renderer->cache->fetchDab(request.colorSpace,
+                                           request.color,
+                                           request.cursorPoint,
+                                           request.scale, request.scale,
+                                           request.rotation,
+                                           request.info,
+                                           request.softnessFactor,
+                                           &dab.rect);
+    return dab;
+}
+
+}
+
+struct KisDabRenderingQueue::Private
+{
+    Private() : nextRenderer(0) {}
+
+    ~Private() {
+        // no renderer may be deleted while it is still working
+        while (!jobs.isEmpty()) {
+            jobs.dequeue().waitForFinished();
+        }
+
+        qDeleteAll(renderers);
+    }
+
+    QVector<DabRenderer*> renderers;
+    QQueue<QFuture<Dab> > jobs;
+    int nextRenderer;
+};
+
+KisDabRenderingQueue::KisDabRenderingQueue(const KisAutoBrush *brush,
+                                           KisPrecisionOption *precisionOption,
+                                           int numThreads)
+    : m_d(new Private)
+{
+    for (int i = 0; i < qMax(1, numThreads); i++) {
+        DabRenderer *renderer = new DabRenderer(KisBrushSP(brush->clone()));
+
+        renderer->cache->setPrecisionOption(precisionOption);
+        m_d->renderers.append(renderer);
+    }
+}
+
+KisDabRenderingQueue::~KisDabRenderingQueue()
+{
+}
+
+KisPaintInformation KisDabRenderingQueue::detachedInfo(const KisPaintInformation &info)
+{
+    return KisPaintInformation::mix(info.pos(), 0.0, info, info);
+}
+
+void KisDabRenderingQueue::addRequest(const Request &request)
+{
+    Q_ASSERT(!isFull());
+
+    /**
+     * The renderers are used in a round-robin manner, so the renderer
+     * of the new dab is the one of the dab that was taken last
+     */
+    DabRenderer *renderer = m_d->renderers[m_d->nextRenderer];
+    m_d->nextRenderer = (m_d->nextRenderer + 1) % m_d->renderers.size();
+
+    m_d->jobs.enqueue(QtConcurrent::run(renderDab, renderer, request));
+}
+
+KisDabRenderingQueue::Dab KisDabRenderingQueue::takeDab()
+{
+    Q_ASSERT(!isEmpty());
+    return m_d->jobs.dequeue().result();
+}
+
+bool KisDabRenderingQueue::isFull() const
+{
+    return m_d->jobs.size() >= m_d->renderers.size();
+}
+
+bool KisDabRenderingQueue::isEmpty() const
+{
+    return m_d->jobs.isEmpty();
+}
@@ -0,0 +1,115 @@
+/*
+ *  Copyright (c) 2015 Calligra developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __KIS_DAB_RENDERING_QUEUE_H
+#define __KIS_DAB_RENDERING_QUEUE_H
+
+#include <QPointF>
+#include <QRect>
+#include <QScopedPointer>
+
+#include <KoColor.h>
+
+#include "kritapaintop_export.h"
+#include "kis_types.h"
+#include "kis_paint_information.h"
+
+class KoColorSpace;
+class KisAutoBrush;
+class KisPrecisionOption;
+
+
+/**
+ * @brief The KisDabRenderingQueue class renders the dabs of a stroke
+ * in the background
+ *
+ * The paintop computes the parameters of the dabs on the stroke
+ * thread, as usual, and adds them to the queue. The masks of the dabs
+ * are generated concurrently on several threads, while the paintop
+ * composites the dabs that are ready. takeDab() returns the dabs in
+ * the order they were added, so the result of the compositing is the
+ * same as with the serial rendering.
+ *
+ * Every rendering thread has its own copy of the brush and its own
+ * KisDabCache. The device of a taken dab belongs to the cache of its
+ * thread, so it must be composited before the next dab is added to
+ * the full queue.
+ *
+ * Only the auto brush can be copied for the threads. The dabs are not
+ * post-processed, so the queue must not be used when the mirror or
+ * sharpness options are enabled: they evaluate the sensors, which have
+ * state that depends on the order of the dabs.
+ */
+class PAINTOP_EXPORT KisDabRenderingQueue
+{
+public:
+    struct Request {
+        Request()
+            : colorSpace(0), scale(1.0), rotation(0.0),
+              softnessFactor(1.0), opacity(0), flow(0) {}
+
+        const KoColorSpace *colorSpace;
+        KoColor color;
+        QPointF cursorPoint;
+        qreal scale;
+        qreal rotation;
+        KisPaintInformation info;
+        qreal softnessFactor;
+        quint8 opacity;
+        quint8 flow;
+    };
+
+    struct Dab {
+        Request request;
+        KisFixedPaintDeviceSP device;
+        QRect rect;
+    };
+
+public:
+    KisDabRenderingQueue(const KisAutoBrush *brush,
+                         KisPrecisionOption *precisionOption,
+                         int numThreads);
+    ~KisDabRenderingQueue();
+
+    /**
+     * @return a copy of \p info that is not bound to the distance
+     * information of the stroke anymore, so it can be used by the
+     * rendering threads after the dab has been registered
+     */
+    static KisPaintInformation detachedInfo(const KisPaintInformation &info);
+
+    /**
+     * Starts rendering of the dab. The queue must not be full.
+     */
+    void addRequest(const Request &request);
+
+    /**
+     * Waits until the oldest dab in the queue is rendered and
+     * returns it
+     */
+    Dab takeDab();
+
+    bool isFull() const;
+    bool isEmpty() const;
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif /* __KIS_DAB_RENDERING_QUEUE_H */
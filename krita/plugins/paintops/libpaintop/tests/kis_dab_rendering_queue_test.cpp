@@ -0,0 +1,106 @@
+/*
+ *  Copyright (c) 2015 Calligra developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_dab_rendering_queue_test.h"
+
+#include <qtest_kde.h>
+
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+
+#include <kis_auto_brush.h>
+#include <kis_circle_mask_generator.h>
+#include <kis_fixed_paint_device.h>
+#include <kis_paint_information.h>
+
+#include "kis_dab_cache.h"
+#include "kis_dab_rendering_queue.h"
+#include "kis_precision_option.h"
+
+
+void compareWithSerialDab(KisDabCache *serialCache, const KisDabRenderingQueue::Dab &dab)
+{
+    const KisDabRenderingQueue::Request &request = dab.request;
+
+    QRect expectedRect;
+    KisFixedPaintDeviceSP expectedDab =
+        serialCache->fetchDab(request.colorSpace, request.color,
+                              request.cursorPoint,
+                              request.scale, request.scale,
+                              request.rotation,
+                              request.info,
+                              request.softnessFactor,
+                              &expectedRect);
+
+    QCOMPARE(dab.rect, expectedRect);
+    QCOMPARE(dab.device->bounds(), expectedDab->bounds());
+
+    const int numBytes = expectedDab->bounds().width() *
+        expectedDab->bounds().height() * expectedDab->pixelSize();
+
+    QVERIFY(!memcmp(dab.device->data(), expectedDab->data(), numBytes));
+}
+
+void KisDabRenderingQueueTest::testSameDabsAsSerialRendering()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    KisCircleMaskGenerator *generator = new KisCircleMaskGenerator(30, 0.7, 0.5, 0.5, 2, true);
+    KisAutoBrush brush(generator, 0.0, 0.0);
+
+    KisPrecisionOption precisionOption;
+    precisionOption.setPrecisionLevel(5);
+    precisionOption.setAutoPrecisionEnabled(false);
+
+    KisDabRenderingQueue queue(&brush, &precisionOption, 3);
+
+    KisBrushSP serialBrush(brush.clone());
+    KisDabCache serialCache(serialBrush);
+    serialCache.setPrecisionOption(&precisionOption);
+
+    int numDabs = 0;
+
+    for (int i = 0; i < 50; i++) {
+        KisDabRenderingQueue::Request request;
+        request.colorSpace = cs;
+        request.color = KoColor(i % 2 ? Qt::red : Qt::blue, cs);
+        request.cursorPoint = QPointF(10.3 * i, 5.7 * i);
+        request.scale = 1.0 + 0.02 * (i % 10);
+        request.rotation = 0.1 * (i % 7);
+        request.info = KisPaintInformation(request.cursorPoint, 1.0);
+        request.softnessFactor = 1.0;
+        request.opacity = OPACITY_OPAQUE_U8;
+        request.flow = OPACITY_OPAQUE_U8;
+
+        if (queue.isFull()) {
+            compareWithSerialDab(&serialCache, queue.takeDab());
+            numDabs++;
+        }
+
+        queue.addRequest(request);
+    }
+
+    while (!queue.isEmpty()) {
+        compareWithSerialDab(&serialCache, queue.takeDab());
+        numDabs++;
+    }
+
+    QCOMPARE(numDabs, 50);
+}
+
+QTEST_KDEMAIN(KisDabRenderingQueueTest, GUI)
@@ -46,6 +46,7 @@
 #include "kis_selection_options.h"
 #include "kis_paint_device.h"
 #include "kis_fill_painter.h"
+#include "kis_image_config.h"
 #include "kis_pixel_selection.h"
 #include "kis_selection_tool_helper.h"
 #include "kis_slider_spin_box.h"
@@ -98,6 +99,7 @@ void KisToolSelectContiguous::beginPrimaryAction(KoPointerEvent *event)
     fillpainter.setHeight(rc.height());
     fillpainter.setWidth(rc.width());
     fillpainter.setFillThreshold(m_fuzziness);
+    fillpainter.setThreadCount(KisImageConfig().maxNumberOfThreads());
 
     KisImageWSP image = currentImage();
     KisPaintDeviceSP sourceDevice = m_limitToCurrentLayer ? dev : image->projection();
@@ -22,6 +22,7 @@
 #include <QTransform>
 #include <KoUnit.h>
 #include "tool_transform_args.h"
+#include "kis_image_config.h"
 
 
 const int KisTransformUtils::rotationHandleVisualRadius = 12;
@@ -223,6 +224,8 @@ void KisTransformUtils::transformDevice(const ToolTransformArgs &config,
                                         KisPaintDeviceSP device,
                                         KisProcessingVisitor::ProgressHelper *helper)
 {
+    const int threadCount = KisImageConfig().maxNumberOfThreads();
+
     if (config.mode() == ToolTransformArgs::WARP) {
         KoUpdaterPtr updater = helper->updater();
 
@@ -232,6 +235,7 @@ void KisTransformUtils::transformDevice(const ToolTransformArgs &config,
                                       config.transfPoints(),
                                       config.alpha(),
                                       updater);
+        worker.setThreadCount(threadCount);
         worker.run();
     } else if (config.mode() == ToolTransformArgs::CAGE) {
         KoUpdaterPtr updater = helper->updater();
@@ -258,6 +262,7 @@ void KisTransformUtils::transformDevice(const ToolTransformArgs &config,
         KisTransformWorker transformWorker =
             createTransformWorker(config, device, updater1, &transformedCenter);
 
+        transformWorker.setThreadCount(threadCount);
         transformWorker.run();
 
         if (config.mode() == ToolTransformArgs::FREE_TRANSFORM) {
@@ -267,6 +272,7 @@ void KisTransformUtils::transformDevice(const ToolTransformArgs &config,
                                                             config.aY(),
                                                             config.cameraPos().z(),
                                                             updater2);
+            perspectiveWorker.setThreadCount(threadCount);
             perspectiveWorker.run();
         } else if (config.mode() == ToolTransformArgs::PERSPECTIVE_4POINT) {
             QTransform T =
@@ -276,6 +282,7 @@ void KisTransformUtils::transformDevice(const ToolTransformArgs &config,
             KisPerspectiveTransformWorker perspectiveWorker(device,
                                                             T.inverted() * config.flattenedPerspectiveTransform() * T,
                                                             updater2);
+            perspectiveWorker.setThreadCount(threadCount);
             perspectiveWorker.run();
         }
     }
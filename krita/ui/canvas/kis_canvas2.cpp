@@ -42,6 +42,8 @@
 #include "kis_coordinates_converter.h"
 #include "kis_prescaled_projection.h"
 #include "kis_image.h"
+#include "kis_paint_device.h"
+#include "kis_datamanager.h"
 #include "KisDocument.h"
 #include "flake/kis_shape_layer.h"
 #include "kis_canvas_resource_provider.h"
@@ -60,6 +62,7 @@
 #include "kis_infinity_manager.h"
 #include "kis_signal_compressor.h"
 #include "kis_display_color_converter.h"
+#include "kis_display_conversion_cache.h"
 #include "kis_exposure_gamma_correction_interface.h"
 #include "KisView.h"
 #include "kis_canvas_controller.h"
@@ -417,6 +420,12 @@ void KisCanvas2::initializeImage()
 
     m_d->coordinatesConverter->setImage(image);
 
+    /**
+     * The conversion cache must get the dirty rects before the
+     * canvas starts to read the updated pixels from it
+     */
+    KisDisplayConversionCache::forImage(image);
+
     connect(image, SIGNAL(sigImageUpdated(QRect)), SLOT(startUpdateCanvasProjection(QRect)), Qt::DirectConnection);
     connect(this, SIGNAL(sigCanvasCacheUpdated()), SLOT(updateCanvasProjection()));
     connect(image, SIGNAL(sigSizeChanged(const QPointF&, const QPointF&)), SLOT(startResizingImage()), Qt::DirectConnection);
@@ -670,6 +679,8 @@ void KisCanvas2::documentOffsetMoved(const QPoint &documentOffset)
 
     QPointF moveOffset = offsetAfter - offsetBefore;
 
+    prefetchViewportTiles(moveOffset);
+
     if (!m_d->currentCanvasIsOpenGL)
         m_d->prescaledProjection->viewportMoved(moveOffset);
 
@@ -678,6 +689,29 @@ void KisCanvas2::documentOffsetMoved(const QPoint &documentOffset)
     updateCanvas();
 }
 
+void KisCanvas2::prefetchViewportTiles(const QPointF &moveOffset)
+{
+    KisImageWSP image = this->image();
+    if (!image) return;
+
+    /**
+     * The user is most probably going to continue panning in the
+     * same direction, so ask the swap to read the area the
+     * viewport is moving to, before the canvas update needs it.
+     */
+    QRectF viewportRect =
+        m_d->coordinatesConverter->widgetToImage(QRectF(canvasWidget()->rect()));
+
+    qreal scaleX, scaleY;
+    m_d->coordinatesConverter->imageScale(&scaleX, &scaleY);
+
+    QRectF aheadRect = viewportRect.translated(-moveOffset.x() / scaleX,
+                                               -moveOffset.y() / scaleY);
+
+    QRect prefetchRect = (viewportRect | aheadRect).toAlignedRect() & image->bounds();
+    image->projection()->dataManager()->prefetchRect(prefetchRect);
+}
+
 void KisCanvas2::slotConfigChanged()
 {
     KisConfig cfg;
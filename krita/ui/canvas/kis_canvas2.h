@@ -253,6 +253,7 @@ private:
     void createQPainterCanvas();
     void createOpenGLCanvas();
     void updateCanvasWidgetImpl(const QRect &rc = QRect());
+    void prefetchViewportTiles(const QPointF &moveOffset);
 
 private:
 
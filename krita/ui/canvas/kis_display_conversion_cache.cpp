@@ -0,0 +1,317 @@
+/*
+ *  Copyright (c) 2015 Calligra developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_display_conversion_cache.h"
+
+#include <QByteArray>
+#include <QCache>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QScopedArrayPointer>
+
+#include <KoColorSpace.h>
+
+#include <kis_image.h>
+#include <kis_image_config.h>
+#include <kis_paint_device.h>
+#include "tiles3/kis_tile_data.h"
+#include "kis_config_notifier.h"
+
+
+namespace {
+
+struct TileKey {
+    TileKey(qint32 _col, qint32 _row,
+            const KoColorSpace *_srcColorSpace,
+            const KoColorSpace *_dstColorSpace,
+            KoColorConversionTransformation::Intent _renderingIntent,
+            KoColorConversionTransformation::ConversionFlags _conversionFlags)
+        : col(_col), row(_row),
+          srcColorSpace(_srcColorSpace),
+          dstColorSpace(_dstColorSpace),
+          renderingIntent(_renderingIntent),
+          conversionFlags(_conversionFlags)
+    {
+    }
+
+    bool operator==(const TileKey &rhs) const {
+        return col == rhs.col && row == rhs.row &&
+            srcColorSpace == rhs.srcColorSpace &&
+            dstColorSpace == rhs.dstColorSpace &&
+            renderingIntent == rhs.renderingIntent &&
+            conversionFlags == rhs.conversionFlags;
+    }
+
+    qint32 col;
+    qint32 row;
+    const KoColorSpace *srcColorSpace;
+    const KoColorSpace *dstColorSpace;
+    KoColorConversionTransformation::Intent renderingIntent;
+    KoColorConversionTransformation::ConversionFlags conversionFlags;
+};
+
+inline uint qHash(const TileKey &key)
+{
+    return ::qHash(key.col) ^ (::qHash(key.row) << 16) ^
+        ::qHash(key.srcColorSpace) ^ ::qHash(key.dstColorSpace) ^
+        (uint(key.renderingIntent) << 8) ^ uint(key.conversionFlags);
+}
+
+inline quint64 tileIndex(qint32 col, qint32 row)
+{
+    return (quint64(quint32(col)) << 32) | quint32(row);
+}
+
+inline qint32 divideFloor(qint32 value, qint32 divisor)
+{
+    return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+struct TileEntry {
+    TileEntry(const QByteArray &_data, qint64 _version)
+        : data(_data), version(_version) {}
+
+    QByteArray data;
+    qint64 version;
+};
+
+void copyRect(const quint8 *src, int srcRowStride,
+              quint8 *dst, int dstRowStride,
+              int rowLength, int numRows)
+{
+    for (int i = 0; i < numRows; i++) {
+        memcpy(dst, src, rowLength);
+        src += srcRowStride;
+        dst += dstRowStride;
+    }
+}
+
+}
+
+struct KisDisplayConversionCache::Private
+{
+    Private() : generation(0) {}
+
+    /**
+     * The version of a tile changes every time the tile is invalidated,
+     * so a tile converted concurrently with the invalidation is never
+     * used, even when it is stored after the invalidation happened.
+     */
+    qint64 tileVersion(qint32 col, qint32 row) const {
+        return (qint64(generation) << 32) + tileVersions.value(tileIndex(col, row), 0);
+    }
+
+    QByteArray convertRect(KisPaintDeviceSP projection, const QRect &rect,
+                           const KoColorSpace *dstColorSpace,
+                           KoColorConversionTransformation::Intent renderingIntent,
+                           KoColorConversionTransformation::ConversionFlags conversionFlags);
+
+    mutable QMutex mutex;
+    QCache<TileKey, TileEntry> tiles;
+    QHash<quint64, quint32> tileVersions;
+    quint32 generation;
+};
+
+QByteArray KisDisplayConversionCache::Private::convertRect(KisPaintDeviceSP projection, const QRect &rect,
+                                                           const KoColorSpace *dstColorSpace,
+                                                           KoColorConversionTransformation::Intent renderingIntent,
+                                                           KoColorConversionTransformation::ConversionFlags conversionFlags)
+{
+    const KoColorSpace *srcColorSpace = projection->colorSpace();
+    const int numPixels = rect.width() * rect.height();
+
+    QScopedArrayPointer<quint8> srcBytes(new quint8[srcColorSpace->pixelSize() * numPixels]);
+    projection->readBytes(srcBytes.data(), rect);
+
+    QByteArray result(dstColorSpace->pixelSize() * numPixels, Qt::Uninitialized);
+    srcColorSpace->convertPixelsTo(srcBytes.data(), (quint8*)result.data(), dstColorSpace,
+                                   numPixels, renderingIntent, conversionFlags);
+
+    return result;
+}
+
+KisDisplayConversionCache* KisDisplayConversionCache::forImage(KisImageWSP image)
+{
+    static QMutex creationMutex;
+    QMutexLocker l(&creationMutex);
+
+    KisImage *imagePtr = image.data();
+
+    KisDisplayConversionCache *cache =
+        imagePtr->findChild<KisDisplayConversionCache*>(QString(), Qt::FindDirectChildrenOnly);
+
+    if (!cache) {
+        cache = new KisDisplayConversionCache(imagePtr);
+
+        connect(imagePtr, SIGNAL(sigImageUpdated(QRect)), cache, SLOT(invalidate(QRect)), Qt::DirectConnection);
+        connect(imagePtr, SIGNAL(sigSizeChanged(QPointF,QPointF)), cache, SLOT(clear()), Qt::DirectConnection);
+        connect(imagePtr, SIGNAL(sigColorSpaceChanged(const KoColorSpace*)), cache, SLOT(clear()), Qt::DirectConnection);
+        connect(imagePtr, SIGNAL(sigProfileChanged(const KoColorProfile*)), cache, SLOT(clear()), Qt::DirectConnection);
+    }
+
+    return cache;
+}
+
+KisDisplayConversionCache::KisDisplayConversionCache(QObject *parent)
+    : QObject(parent),
+      m_d(new Private)
+{
+    slotConfigChanged();
+    connect(KisConfigNotifier::instance(), SIGNAL(configChanged()), SLOT(slotConfigChanged()));
+}
+
+KisDisplayConversionCache::~KisDisplayConversionCache()
+{
+}
+
+void KisDisplayConversionCache::readConverted(KisPaintDeviceSP projection, const QRect &rect,
+                                              const KoColorSpace *dstColorSpace,
+                                              KoColorConversionTransformation::Intent renderingIntent,
+                                              KoColorConversionTransformation::ConversionFlags conversionFlags,
+                                              quint8 *dst)
+{
+    if (rect.isEmpty()) return;
+
+    const KoColorSpace *srcColorSpace = projection->colorSpace();
+
+    if (*srcColorSpace == *dstColorSpace) {
+        projection->readBytes(dst, rect);
+        return;
+    }
+
+    const qint32 tileWidth = KisTileData::WIDTH;
+    const qint32 tileHeight = KisTileData::HEIGHT;
+    const int pixelSize = dstColorSpace->pixelSize();
+    const int dstRowStride = rect.width() * pixelSize;
+
+    const qint32 firstCol = divideFloor(rect.left(), tileWidth);
+    const qint32 lastCol = divideFloor(rect.right(), tileWidth);
+    const qint32 firstRow = divideFloor(rect.top(), tileHeight);
+    const qint32 lastRow = divideFloor(rect.bottom(), tileHeight);
+
+    for (qint32 row = firstRow; row <= lastRow; row++) {
+        for (qint32 col = firstCol; col <= lastCol; col++) {
+            const QRect tileRect(col * tileWidth, row * tileHeight, tileWidth, tileHeight);
+            const QRect patchRect = tileRect & rect;
+
+            const TileKey key(col, row, srcColorSpace, dstColorSpace, renderingIntent, conversionFlags);
+
+            QByteArray tileData;
+            qint64 version;
+
+            {
+                QMutexLocker l(&m_d->mutex);
+
+                version = m_d->tileVersion(col, row);
+                TileEntry *entry = m_d->tiles.object(key);
+                if (entry && entry->version == version) {
+                    tileData = entry->data;
+                }
+            }
+
+            if (tileData.isEmpty() && patchRect == tileRect) {
+                tileData = m_d->convertRect(projection, tileRect, dstColorSpace,
+                                            renderingIntent, conversionFlags);
+
+                QMutexLocker l(&m_d->mutex);
+                if (m_d->tileVersion(col, row) == version) {
+                    m_d->tiles.insert(key, new TileEntry(tileData, version), tileData.size() / 1024);
+                }
+            }
+
+            quint8 *dstPtr = dst +
+                (patchRect.y() - rect.y()) * dstRowStride +
+                (patchRect.x() - rect.x()) * pixelSize;
+
+            if (!tileData.isEmpty()) {
+                const quint8 *srcPtr = (const quint8*)tileData.constData() +
+                    ((patchRect.y() - tileRect.y()) * tileWidth +
+                     (patchRect.x() - tileRect.x())) * pixelSize;
+
+                copyRect(srcPtr, tileWidth * pixelSize,
+                         dstPtr, dstRowStride,
+                         patchRect.width() * pixelSize, patchRect.height());
+            } else {
+                /**
+                 * The tile is covered partially, so converting the
+                 * whole of it would cost more than the direct conversion
+                 */
+                QByteArray patchData = m_d->convertRect(projection, patchRect, dstColorSpace,
+                                                        renderingIntent, conversionFlags);
+
+                copyRect((const quint8*)patchData.constData(), patchRect.width() * pixelSize,
+                         dstPtr, dstRowStride,
+                         patchRect.width() * pixelSize, patchRect.height());
+            }
+        }
+    }
+}
+
+void KisDisplayConversionCache::setMemoryLimit(qint64 bytes)
+{
+    QMutexLocker l(&m_d->mutex);
+    m_d->tiles.setMaxCost(qMax(qint64(1), bytes / 1024));
+}
+
+void KisDisplayConversionCache::slotConfigChanged()
+{
+    /**
+     * The converted tiles are a second copy of the image, so they get
+     * a share of the memory the tiles of the images may occupy
+     */
+    const qint64 MiB = 1024 * 1024;
+    setMemoryLimit(qint64(KisImageConfig().tilesHardLimit()) * MiB / 16);
+}
+
+int KisDisplayConversionCache::numCachedTiles() const
+{
+    QMutexLocker l(&m_d->mutex);
+    return m_d->tiles.size();
+}
+
+void KisDisplayConversionCache::invalidate(const QRect &rect)
+{
+    if (rect.isEmpty()) return;
+
+    const qint32 firstCol = divideFloor(rect.left(), KisTileData::WIDTH);
+    const qint32 lastCol = divideFloor(rect.right(), KisTileData::WIDTH);
+    const qint32 firstRow = divideFloor(rect.top(), KisTileData::HEIGHT);
+    const qint32 lastRow = divideFloor(rect.bottom(), KisTileData::HEIGHT);
+
+    QMutexLocker l(&m_d->mutex);
+
+    /**
+     * The stale tiles are not removed from the cache, they just never
+     * match the version again and are pushed out by the fresh ones
+     */
+    for (qint32 row = firstRow; row <= lastRow; row++) {
+        for (qint32 col = firstCol; col <= lastCol; col++) {
+            m_d->tileVersions[tileIndex(col, row)]++;
+        }
+    }
+}
+
+void KisDisplayConversionCache::clear()
+{
+    QMutexLocker l(&m_d->mutex);
+
+    m_d->tiles.clear();
+    m_d->tileVersions.clear();
+    m_d->generation++;
+}
@@ -0,0 +1,108 @@
+/*
+ *  Copyright (c) 2015 Calligra developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __KIS_DISPLAY_CONVERSION_CACHE_H
+#define __KIS_DISPLAY_CONVERSION_CACHE_H
+
+#include <QObject>
+#include <QScopedPointer>
+
+#include <KoColorConversionTransformation.h>
+
+#include <kis_types.h>
+#include <kritaui_export.h>
+
+class KoColorSpace;
+
+
+/**
+ * KisDisplayConversionCache keeps the tiles of the image projection
+ * already converted into the display color space. The tiles are keyed
+ * by their position, the source and destination color spaces (that
+ * is, the profiles), the rendering intent and the conversion flags,
+ * so all the canvases showing the image share the converted pixels,
+ * and switching the display configuration back and forth does not
+ * convert the image again.
+ *
+ * The cache is owned by the image, \see forImage(). The tiles are
+ * invalidated only by the dirty rects the image reports with
+ * sigImageUpdated().
+ *
+ * The display filters (OCIO) are not cached, because their result
+ * depends on the exposure and gamma values that change continuously.
+ * The callers should use the cache only for the plain ICC conversion.
+ */
+class KRITAUI_EXPORT KisDisplayConversionCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @return the cache of \p image. It is created on the first call
+     * and deleted together with the image. The first call must happen
+     * in the GUI thread before any canvas connects to sigImageUpdated(),
+     * so that the cache sees the dirty rects first.
+     */
+    static KisDisplayConversionCache* forImage(KisImageWSP image);
+
+    ~KisDisplayConversionCache();
+
+    /**
+     * Reads \p rect of \p projection converted into \p dstColorSpace
+     * into \p dst. The buffer must be big enough to keep the whole
+     * rect. The tiles covered by the rect completely are taken from
+     * the cache or converted and stored there. The rest of the rect is
+     * converted directly.
+     *
+     * The method is thread-safe.
+     */
+    void readConverted(KisPaintDeviceSP projection, const QRect &rect,
+                       const KoColorSpace *dstColorSpace,
+                       KoColorConversionTransformation::Intent renderingIntent,
+                       KoColorConversionTransformation::ConversionFlags conversionFlags,
+                       quint8 *dst);
+
+    /**
+     * Sets the maximum amount of memory the converted tiles may occupy.
+     * By default, it is a sixteenth of the tiles hard limit of
+     * KisImageConfig and it is updated when the configuration changes.
+     */
+    void setMemoryLimit(qint64 bytes);
+
+    /**
+     * @return the number of the tiles stored in the cache. Used for
+     * testing purposes only.
+     */
+    int numCachedTiles() const;
+
+public Q_SLOTS:
+    void invalidate(const QRect &rect);
+    void clear();
+
+private Q_SLOTS:
+    void slotConfigChanged();
+
+private:
+    KisDisplayConversionCache(QObject *parent);
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif /* __KIS_DISPLAY_CONVERSION_CACHE_H */
@@ -18,6 +18,7 @@
 #include "kis_image_pyramid.h"
 
 #include <QBitArray>
+#include <QtConcurrentMap>
 #include <KoChannelInfo.h>
 #include <KoCompositeOp.h>
 #include <KoColorSpaceRegistry.h>
@@ -25,6 +26,7 @@
 #include <KoColorSpaceMaths.h>
 
 #include "kis_display_filter.h"
+#include "kis_display_conversion_cache.h"
 #include "kis_painter.h"
 #include "kis_iterator_ng.h"
 #include "kis_datamanager.h"
@@ -32,6 +34,8 @@
 #include "kis_debug.h"
 #include "kis_config.h"
 #include "kis_image_config.h"
+#include "krita_utils.h"
+#include "tiles3/kis_tile_data.h"
 
 //#define DEBUG_PYRAMID
 
@@ -53,6 +57,10 @@
 #include <half.h>
 #endif
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #define ceiledSize(sz) QSize(ceil((sz).width()), ceil((sz).height()))
 #define isOdd(x) ((x) & 0x01)
 
@@ -100,8 +108,37 @@ inline void alignRectBy2(qint32 &x, qint32 &y, qint32 &w, qint32 &h)
 
 /************* class KisImagePyramid ********************************/
 
+struct KisImagePyramid::RetrieveImageDataFunctor
+{
+    typedef void result_type;
+
+    RetrieveImageDataFunctor(KisImagePyramid *pyramid)
+        : m_pyramid(pyramid) {}
+
+    void operator() (const QRect &rect) {
+        m_pyramid->retrieveImageData(rect);
+    }
+
+    KisImagePyramid *m_pyramid;
+};
+
+struct KisImagePyramid::RecalculatePatchFunctor
+{
+    typedef void result_type;
+
+    RecalculatePatchFunctor(KisImagePyramid *pyramid)
+        : m_pyramid(pyramid) {}
+
+    void operator() (const QRect &rect) {
+        m_pyramid->recalculatePatch(rect);
+    }
+
+    KisImagePyramid *m_pyramid;
+};
+
 KisImagePyramid::KisImagePyramid(qint32 pyramidHeight)
-        : m_monitorProfile(0)
+        : m_conversionCache(0)
+        , m_monitorProfile(0)
         , m_monitorColorSpace(0)
         , m_pyramidHeight(pyramidHeight)
 {
@@ -175,6 +212,7 @@ void KisImagePyramid::setImage(KisImageWSP newImage)
 {
     if (newImage) {
         m_originalImage = newImage;
+        m_conversionCache = KisDisplayConversionCache::forImage(m_originalImage);
 
         clearPyramid();
         setImageSize(m_originalImage->width(), m_originalImage->height());
@@ -191,24 +229,22 @@ void KisImagePyramid::setImage(KisImageWSP newImage)
             retrieveImageData(rc);
         }
         else {
-            qint32 firstCol = rc.x() / patchWidth;
-            qint32 firstRow = rc.y() / patchHeight;
-
-            qint32 lastCol = (rc.x() + rc.width()) / patchWidth;
-            qint32 lastRow = (rc.y() + rc.height()) / patchHeight;
-
-            for(qint32 i = firstRow; i <= lastRow; i++) {
-                for(qint32 j = firstCol; j <= lastCol; j++) {
-                    QRect maxPatchRect(j * patchWidth,
-                                       i * patchHeight,
-                                       patchWidth, patchHeight);
-                    QRect patchRect = rc & maxPatchRect;
-                    retrieveImageData(patchRect);
-                }
+            /**
+             * retrieveImageData() may reset the channel flags, do it
+             * here before the patches are processed concurrently
+             */
+            const KoColorSpace *projectionCs = m_originalImage->projection()->colorSpace();
+            if (m_channelFlags.size() != projectionCs->channels().size()) {
+                setChannelFlags(QBitArray());
             }
 
+            QVector<QRect> patches =
+                KritaUtils::splitRectIntoPatches(rc, QSize(patchWidth, patchHeight));
+
+            QtConcurrent::blockingMap(patches, RetrieveImageDataFunctor(this));
         }
-        //TODO: check whether there is needed recalculateCache()
+
+        recalculatePyramid(rc);
     }
 }
 
@@ -236,13 +272,13 @@ void KisImagePyramid::retrieveImageData(const QRect &rect)
     QScopedArrayPointer<quint8> originalBytes(
         new quint8[originalProjection->colorSpace()->pixelSize() * numPixels]);
 
-    originalProjection->readBytes(originalBytes.data(), rect);
-
     if (m_displayFilter &&
         m_useOcio &&
         projectionCs->colorModelId() == RGBAColorModelID) {
 
 #ifdef HAVE_OCIO
+        originalProjection->readBytes(originalBytes.data(), rect);
+
         const KoColorProfile *destinationProfile =
             m_displayFilter->useInternalColorManagement() ?
             m_monitorProfile : projectionCs->profile();
@@ -280,15 +316,25 @@ void KisImagePyramid::retrieveImageData(const QRect &rect)
         if (m_channelFlags.size() != channelInfo.size()) {
             setChannelFlags(QBitArray());
         }
+
+        if (m_conversionCache && (m_channelFlags.isEmpty() || m_allChannelsSelected)) {
+            QScopedArrayPointer<quint8> dst(new quint8[m_monitorColorSpace->pixelSize() * numPixels]);
+            m_conversionCache->readConverted(originalProjection, rect, m_monitorColorSpace,
+                                             m_renderingIntent, m_conversionFlags, dst.data());
+
+            m_pyramid[ORIGINAL_INDEX]->writeBytes(dst.data(), rect);
+            return;
+        }
+
+        originalProjection->readBytes(originalBytes.data(), rect);
+
         if (!m_channelFlags.isEmpty() && !m_allChannelsSelected) {
             QScopedArrayPointer<quint8> dst(new quint8[projectionCs->pixelSize() * numPixels]);
 
             int channelSize = channelInfo[m_selectedChannelIndex]->size();
             int pixelSize = projectionCs->pixelSize();
 
-            KisConfig cfg;
-
-            if (m_onlyOneChannelSelected && !cfg.showSingleChannelAsColor()) {
+            if (m_onlyOneChannelSelected && !m_showSingleChannelAsColor) {
                 int selectedChannelPos = channelInfo[m_selectedChannelIndex]->pos();
                 for (uint pixelIndex = 0; pixelIndex < numPixels; ++pixelIndex) {
                     for (uint channelIndex = 0; channelIndex < projectionCs->channelCount(); ++channelIndex) {
@@ -334,17 +380,7 @@ void KisImagePyramid::retrieveImageData(const QRect &rect)
 
 void KisImagePyramid::recalculateCache(KisPPUpdateInfoSP info)
 {
-    KisPaintDevice *src;
-    KisPaintDevice *dst;
-    QRect currentSrcRect = info->dirtyImageRectVar;
-
-    for (int i = FIRST_NOT_ORIGINAL_INDEX; i < m_pyramidHeight; i++) {
-        src = m_pyramid[i-1].data();
-        dst = m_pyramid[i].data();
-        if (!currentSrcRect.isEmpty()) {
-            currentSrcRect = downsampleByFactor2(currentSrcRect, src, dst);
-        }
-    }
+    recalculatePyramid(info->dirtyImageRectVar);
 
 #ifdef DEBUG_PYRAMID
     QImage image = m_pyramid[ORIGINAL_INDEX]->convertToQImage(m_monitorProfile, m_renderingIntent, m_conversionFlags);
@@ -360,6 +396,43 @@ void KisImagePyramid::recalculateCache(KisPPUpdateInfoSP info)
 #endif
 }
 
+void KisImagePyramid::recalculatePyramid(const QRect &rect)
+{
+    if (m_pyramidHeight <= FIRST_NOT_ORIGINAL_INDEX || rect.isEmpty()) return;
+
+    /**
+     * Every patch should cover whole tiles on the topmost level
+     * of the pyramid, then no tile is written by two threads and
+     * the even alignment of the patches is kept on all the levels
+     */
+    const qint32 levelFactor = 1 << (m_pyramidHeight - 1);
+    const QSize patchSize(KisTileData::WIDTH * levelFactor,
+                          KisTileData::HEIGHT * levelFactor);
+
+    QVector<QRect> patches = KritaUtils::splitRectIntoPatches(rect, patchSize);
+
+    if (patches.size() == 1) {
+        recalculatePatch(patches.first());
+    } else {
+        QtConcurrent::blockingMap(patches, RecalculatePatchFunctor(this));
+    }
+}
+
+void KisImagePyramid::recalculatePatch(const QRect &rect)
+{
+    KisPaintDevice *src;
+    KisPaintDevice *dst;
+    QRect currentSrcRect = rect;
+
+    for (int i = FIRST_NOT_ORIGINAL_INDEX; i < m_pyramidHeight; i++) {
+        src = m_pyramid[i-1].data();
+        dst = m_pyramid[i].data();
+        if (!currentSrcRect.isEmpty()) {
+            currentSrcRect = downsampleByFactor2(currentSrcRect, src, dst);
+        }
+    }
+}
+
 QRect KisImagePyramid::downsampleByFactor2(const QRect& srcRect,
         KisPaintDevice* src,
         KisPaintDevice* dst)
@@ -411,10 +484,6 @@ void  KisImagePyramid::downsamplePixels(const quint8 *srcRow0,
                                         quint8 *dstRow,
                                         qint32 numSrcPixels)
 {
-    /**
-     * FIXME (mandatory): Use SSE and friends here.
-     */
-
     qint16 b = 0;
     qint16 g = 0;
     qint16 r = 0;
@@ -422,7 +491,39 @@ void  KisImagePyramid::downsamplePixels(const quint8 *srcRow0,
 
     static const qint32 pixelSize = 4; // This is preview argb8 mode
 
-    for (qint32 i = 0; i < numSrcPixels / 2; i++) {
+    qint32 numDstPixels = numSrcPixels / 2;
+
+#ifdef __SSE2__
+    /**
+     * Four source pixels of each row are widened to 16 bits, so
+     * the sum of four channel values cannot overflow. The two
+     * resulting pixels are exactly the same as the ones of the
+     * scalar version below.
+     */
+    const __m128i zero = _mm_setzero_si128();
+
+    for (; numDstPixels >= 2; numDstPixels -= 2) {
+        __m128i row0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(srcRow0));
+        __m128i row1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(srcRow1));
+
+        __m128i sumLo = _mm_add_epi16(_mm_unpacklo_epi8(row0, zero),
+                                      _mm_unpacklo_epi8(row1, zero));
+        __m128i sumHi = _mm_add_epi16(_mm_unpackhi_epi8(row0, zero),
+                                      _mm_unpackhi_epi8(row1, zero));
+
+        sumLo = _mm_add_epi16(sumLo, _mm_srli_si128(sumLo, 8));
+        sumHi = _mm_add_epi16(sumHi, _mm_srli_si128(sumHi, 8));
+
+        __m128i sum = _mm_srli_epi16(_mm_unpacklo_epi64(sumLo, sumHi), 2);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dstRow), _mm_packus_epi16(sum, sum));
+
+        dstRow += 2 * pixelSize;
+        srcRow0 += 4 * pixelSize;
+        srcRow1 += 4 * pixelSize;
+    }
+#endif /* __SSE2__ */
+
+    for (qint32 i = 0; i < numDstPixels; i++) {
         b = srcRow0[0] + srcRow1[0] + srcRow0[4] + srcRow1[4];
         g = srcRow0[1] + srcRow1[1] + srcRow0[5] + srcRow1[5];
         r = srcRow0[2] + srcRow1[2] + srcRow0[6] + srcRow1[6];
@@ -533,5 +634,6 @@ void KisImagePyramid::configChanged()
 {
     KisConfig cfg;
     m_useOcio = cfg.useOcio();
+    m_showSingleChannelAsColor = cfg.showSingleChannelAsColor();
 }
 
@@ -28,6 +28,8 @@
 #include <kis_paint_device.h>
 #include "kis_projection_backend.h"
 
+class KisDisplayConversionCache;
+
 
 class KisImagePyramid : QObject, public KisProjectionBackend
 {
@@ -79,6 +81,20 @@ private:
     void rebuildPyramid();
     void clearPyramid();
 
+    /**
+     * Recalculates all the pyramid levels for the dirty @rect of
+     * the original level. The rect is split into patches that cover
+     * whole tiles on every level of the pyramid, so the patches can
+     * be downsampled in parallel without touching each other's tiles.
+     */
+    void recalculatePyramid(const QRect &rect);
+
+    /**
+     * Downsamples one patch prepared by recalculatePyramid()
+     * through all the levels of the pyramid
+     */
+    void recalculatePatch(const QRect &rect);
+
     /**
      * Downsamples @srcRect from @src paint device and writes
      * result into proper place of @dst paint device
@@ -92,8 +108,8 @@ private:
      * and @srcRow1 into one line @dstRow
      * Note: @numSrcPixels must be EVEN
      */
-    void downsamplePixels(const quint8 *srcRow0, const quint8 *srcRow1,
-                          quint8 *dstRow, qint32 numSrcPixels);
+    static void downsamplePixels(const quint8 *srcRow0, const quint8 *srcRow1,
+                                 quint8 *dstRow, qint32 numSrcPixels);
 
     /**
      * Searches for the last pyramid plane that can cover
@@ -113,10 +129,15 @@ private Q_SLOTS:
 
     void configChanged();
 
+private:
+    struct RetrieveImageDataFunctor;
+    struct RecalculatePatchFunctor;
+
 private:
 
     QVector<KisPaintDeviceSP> m_pyramid;
     KisImageWSP  m_originalImage;
+    KisDisplayConversionCache *m_conversionCache;
 
     const KoColorProfile* m_monitorProfile;
     const KoColorSpace* m_monitorColorSpace;
@@ -133,6 +154,7 @@ private:
     qint32 m_pyramidHeight;
 
     bool m_useOcio;
+    bool m_showSingleChannelAsColor;
 
     QBitArray m_channelFlags;
     bool m_allChannelsSelected;
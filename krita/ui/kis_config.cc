@@ -1565,6 +1565,16 @@ void KisConfig::setCompressKra(bool compress)
     m_cfg.writeEntry("compressLayersInKra", compress);
 }
 
+bool KisConfig::loadKraLazily(bool defaultValue) const
+{
+    return (defaultValue ? true : m_cfg.readEntry("loadLayersInKraLazily", true));
+}
+
+void KisConfig::setLoadKraLazily(bool value)
+{
+    m_cfg.writeEntry("loadLayersInKraLazily", value);
+}
+
 bool KisConfig::toolOptionsInDocker(bool defaultValue) const
 {
     return (defaultValue ? true : m_cfg.readEntry("ToolOptionsInDocker", true));
@@ -457,6 +457,9 @@ public:
     bool compressKra(bool defaultValue = false) const;
     void setCompressKra(bool compress);
 
+    bool loadKraLazily(bool defaultValue = false) const;
+    void setLoadKraLazily(bool value);
+
     bool toolOptionsInDocker(bool defaultValue = false) const;
     void setToolOptionsInDocker(bool inDocker);
 
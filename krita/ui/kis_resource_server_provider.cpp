@@ -37,6 +37,7 @@
 #include <kis_debug.h>
 #include <KoPattern.h>
 #include <kis_paintop_preset.h>
+#include <kis_paintop_registry.h>
 #include <kis_workspace_resource.h>
 #include <kis_psd_layer_style_resource.h>
 
@@ -61,6 +62,12 @@ KisResourceServerProvider::KisResourceServerProvider()
     KGlobal::dirs()->addResourceType("psd_layer_style_collections", "data", "krita/asl");
 
     m_paintOpPresetServer = new KisPaintOpPresetResourceServer("kis_paintoppresets", "*.kpp");
+
+    // the presets of a paintop can be loaded only when its plugin is installed
+    QStringList paintOpIds(KisPaintOpRegistry::instance()->keys());
+    paintOpIds.sort();
+    m_paintOpPresetServer->setIndexEnvironment(paintOpIds.join(","));
+
     if (!QFileInfo(m_paintOpPresetServer->saveLocation()).exists()) {
         QDir().mkpath(m_paintOpPresetServer->saveLocation());
     }
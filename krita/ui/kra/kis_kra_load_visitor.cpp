@@ -86,6 +86,7 @@ KisKraLoadVisitor::KisKraLoadVisitor(KisImageWSP image,
         m_layerFilenames(layerFilenames)
 {
     m_external = false;
+    m_lazyLoading = false;
     m_image = image;
     m_store = store;
     m_name = name;
@@ -117,6 +118,11 @@ void KisKraLoadVisitor::setExternalUri(const QString &uri)
     m_uri = uri;
 }
 
+void KisKraLoadVisitor::setLazyLoading(bool value)
+{
+    m_lazyLoading = value;
+}
+
 bool KisKraLoadVisitor::visit(KisExternalLayer * layer)
 {
     bool result = false;
@@ -141,10 +147,14 @@ bool KisKraLoadVisitor::visit(KisExternalLayer * layer)
 bool KisKraLoadVisitor::visit(KisPaintLayer *layer)
 {
     dbgFile << "Visit: " << layer->name() << " colorSpace: " << layer->colorSpace()->id();
-    if (!loadPaintDevice(layer->paintDevice(), getLocation(layer))) {
+    /**
+     * The profile is loaded first, so that assigning the color space
+     * does not force decoding of the lazily loaded pixel data
+     */
+    if (!loadProfile(layer->paintDevice(), getLocation(layer, DOT_ICC))) {
         return false;
     }
-    if (!loadProfile(layer->paintDevice(), getLocation(layer, DOT_ICC))) {
+    if (!loadPaintDevice(layer->paintDevice(), getLocation(layer), m_lazyLoading)) {
         return false;
     }
     if (!loadMetaData(layer)) {
@@ -343,11 +353,19 @@ QStringList KisKraLoadVisitor::errorMessages() const
     return m_errorMessages;
 }
 
-bool KisKraLoadVisitor::loadPaintDevice(KisPaintDeviceSP device, const QString& location)
+bool KisKraLoadVisitor::loadPaintDevice(KisPaintDeviceSP device, const QString& location, bool lazy)
 {
     // Layer data
     if (m_store->open(location)) {
-        if (!device->read(m_store->device())) {
+        if (lazy) {
+            QByteArray data = m_store->read(m_store->size());
+            if (data.isEmpty()) {
+                m_errorMessages << i18n("Could not read pixel data: %1.", location);
+                m_store->close();
+                return false;
+            }
+            device->readLazily(data);
+        } else if (!device->read(m_store->device())) {
             m_errorMessages << i18n("Could not read pixel data: %1.", location);
             device->disconnect();
             m_store->close();
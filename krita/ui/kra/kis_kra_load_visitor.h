@@ -44,6 +44,13 @@ public:
 public:
     void setExternalUri(const QString &uri);
 
+    /**
+     * When enabled, the pixel data of the paint layers is only read
+     * from the store, but not decoded. The tiles are decoded when the
+     * layer is accessed for the first time, \see KisPaintDevice::readLazily()
+     */
+    void setLazyLoading(bool value);
+
     bool visit(KisNode*) {
         return true;
     }
@@ -62,7 +69,7 @@ public:
 
 private:
 
-    bool loadPaintDevice(KisPaintDeviceSP device, const QString& location);
+    bool loadPaintDevice(KisPaintDeviceSP device, const QString& location, bool lazy = false);
     bool loadProfile(KisPaintDeviceSP device,  const QString& location);
     bool loadFilterConfiguration(KisFilterConfiguration* kfc, const QString& location);
     bool loadMetaData(KisNode* node);
@@ -74,6 +81,7 @@ private:
     KisImageWSP m_image;
     KoStore *m_store;
     bool m_external;
+    bool m_lazyLoading;
     QString m_uri;
     QMap<KisNode *, QString> m_layerFilenames;
     QString m_name;
@@ -322,6 +322,9 @@ void KisKraLoader::loadBinaryData(KoStore * store, KisImageWSP image, const QStr
         visitor.setExternalUri(uri);
     }
 
+    KisConfig cfg;
+    visitor.setLazyLoading(cfg.loadKraLazily());
+
     image->rootLayer()->accept(visitor);
     if (!visitor.errorMessages().isEmpty()) {
         m_d->errorMessages.append(visitor.errorMessages());
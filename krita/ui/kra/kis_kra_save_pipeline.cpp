@@ -0,0 +1,180 @@
+/*
+ *  Copyright (c) 2015 Calligra developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_kra_save_pipeline.h"
+
+#include <QByteArray>
+#include <QFuture>
+#include <QList>
+#include <QtConcurrentRun>
+
+#include <KoStore.h>
+
+#include <kis_debug.h>
+#include <kis_paint_device.h>
+#include <kis_paint_device_writer.h>
+
+
+namespace {
+
+class KisByteArrayPaintDeviceWriter : public KisPaintDeviceWriter
+{
+public:
+    KisByteArrayPaintDeviceWriter(QByteArray *data)
+        : m_data(data)
+    {
+    }
+
+    bool write(const QByteArray &data) {
+        m_data->append(data);
+        return true;
+    }
+
+    bool write(const char* data, qint64 length) {
+        m_data->append(data, length);
+        return true;
+    }
+
+private:
+    QByteArray *m_data;
+};
+
+struct SerializedDevice {
+    SerializedDevice() : success(false) {}
+
+    bool success;
+    QByteArray data;
+};
+
+SerializedDevice serializeDevice(KisPaintDeviceSP device)
+{
+    SerializedDevice result;
+
+    KisByteArrayPaintDeviceWriter writer(&result.data);
+    result.success = device->write(writer);
+
+    return result;
+}
+
+}
+
+struct KisKraSavePipeline::Private
+{
+    struct Job {
+        KisPaintDeviceSP device;
+        QString location;
+        bool compressEntry;
+    };
+
+    Private(KoStore *_store, int _threadCount)
+        : store(_store),
+          threadCount(qMax(1, _threadCount))
+    {
+    }
+
+    void writeAll();
+    bool writeEntry(const Job &job, const QByteArray &data);
+
+    KoStore *store;
+    int threadCount;
+    QList<Job> jobs;
+    QStringList failedLocations;
+};
+
+void KisKraSavePipeline::Private::writeAll()
+{
+    /**
+     * The number of serialized layers waiting for the writer is
+     * limited, otherwise a fast compression of a huge document
+     * would keep all of it in memory.
+     */
+    const int maxJobsInFlight = threadCount;
+
+    QList<QFuture<SerializedDevice> > jobsInFlight;
+    int nextJob = 0;
+
+    for (int i = 0; i < jobs.size(); i++) {
+        while (nextJob < jobs.size() && nextJob - i < maxJobsInFlight) {
+            jobsInFlight.append(QtConcurrent::run(serializeDevice, jobs[nextJob].device));
+            nextJob++;
+        }
+
+        SerializedDevice serialized = jobsInFlight.takeFirst().result();
+
+        if (!serialized.success || !writeEntry(jobs[i], serialized.data)) {
+            warnFile << "Failed to write the pixel data into" << jobs[i].location;
+            failedLocations << jobs[i].location;
+        }
+    }
+}
+
+bool KisKraSavePipeline::Private::writeEntry(const Job &job, const QByteArray &data)
+{
+    bool result = false;
+
+    store->setCompressionEnabled(job.compressEntry);
+
+    if (store->open(job.location)) {
+        result = store->write(data) == data.size();
+        result &= store->close();
+    }
+
+    store->setCompressionEnabled(true);
+
+    return result;
+}
+
+KisKraSavePipeline::KisKraSavePipeline(KoStore *store, int threadCount)
+    : m_d(new Private(store, threadCount))
+{
+}
+
+KisKraSavePipeline::~KisKraSavePipeline()
+{
+}
+
+void KisKraSavePipeline::addDevice(KisPaintDeviceSP device, const QString &location, bool compressEntry)
+{
+    Private::Job job;
+    job.device = new KisPaintDevice(*device);
+    job.location = location;
+    job.compressEntry = compressEntry;
+
+    m_d->jobs.append(job);
+}
+
+bool KisKraSavePipeline::run()
+{
+    if (m_d->jobs.isEmpty()) return true;
+
+    /**
+     * The store is written by the calling thread, while the layers are
+     * serialized in the thread pool. Processing the events here would
+     * let the user close the document or change the image while the
+     * store and the saver are still in use.
+     */
+    m_d->writeAll();
+    m_d->jobs.clear();
+
+    return m_d->failedLocations.isEmpty();
+}
+
+QStringList KisKraSavePipeline::failedLocations() const
+{
+    return m_d->failedLocations;
+}
@@ -0,0 +1,77 @@
+/*
+ *  Copyright (c) 2015 Calligra developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __KIS_KRA_SAVE_PIPELINE_H
+#define __KIS_KRA_SAVE_PIPELINE_H
+
+#include <QScopedPointer>
+#include <QStringList>
+
+#include <kis_types.h>
+#include <kritaui_export.h>
+
+class KoStore;
+
+
+/**
+ * KisKraSavePipeline writes the pixel data of the layers into a
+ * KoStore.
+ *
+ * addDevice() only takes a copy-on-write snapshot of the device, so
+ * the device is not read again afterwards. run() serializes
+ * and compresses the snapshots on several threads, while the calling
+ * thread streams the results into the store in the same order the
+ * devices were added. Only a few compressed layers are kept in memory
+ * at a time. The save still blocks the caller until all the layers
+ * are written.
+ *
+ * The store must not be touched by anyone else while run() is in
+ * progress.
+ */
+class KRITAUI_EXPORT KisKraSavePipeline
+{
+public:
+    KisKraSavePipeline(KoStore *store, int threadCount);
+    ~KisKraSavePipeline();
+
+    /**
+     * Schedule saving of the pixel data of \p device into \p location.
+     * \p compressEntry defines whether the store should compress the
+     * entry (the tiles are compressed in any case).
+     */
+    void addDevice(KisPaintDeviceSP device, const QString &location, bool compressEntry);
+
+    /**
+     * Write all the scheduled devices into the store. The call blocks
+     * until all of them are written, no events are processed meanwhile.
+     *
+     * @return false if any of the devices could not be written
+     */
+    bool run();
+
+    /**
+     * @return the locations of the devices that could not be written
+     */
+    QStringList failedLocations() const;
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif /* __KIS_KRA_SAVE_PIPELINE_H */
@@ -20,6 +20,7 @@
 
 #include "kra/kis_kra_save_visitor.h"
 #include "kra/kis_kra_tags.h"
+#include "kra/kis_kra_save_pipeline.h"
 
 #include <QBuffer>
 #include <QByteArray>
@@ -64,6 +65,7 @@ KisKraSaveVisitor::KisKraSaveVisitor(KoStore *store, const QString & name, QMap<
     , m_name(name)
     , m_nodeFileNames(nodeFileNames)
     , m_writer(new KisStorePaintDeviceWriter(store))
+    , m_pipeline(0)
 {
 }
 
@@ -78,6 +80,11 @@ void KisKraSaveVisitor::setExternalUri(const QString &uri)
     m_uri = uri;
 }
 
+void KisKraSaveVisitor::setSavePipeline(KisKraSavePipeline *pipeline)
+{
+    m_pipeline = pipeline;
+}
+
 bool KisKraSaveVisitor::visit(KisExternalLayer * layer)
 {
     bool result = false;
@@ -261,9 +268,14 @@ bool KisKraSaveVisitor::savePaintDevice(KisPaintDeviceSP device,
 {
     // Layer data
     KisConfig cfg;
+
+    if (m_pipeline) {
+        m_pipeline->addDevice(device, location, cfg.compressKra());
+    }
+
     m_store->setCompressionEnabled(cfg.compressKra());
 
-    if (m_store->open(location)) {
+    if (!m_pipeline && m_store->open(location)) {
         if (!device->write(*m_writer)) {
             device->disconnect();
             m_store->close();
@@ -29,6 +29,7 @@
 
 
 class KisPaintDeviceWriter;
+class KisKraSavePipeline;
 class KoStore;
 
 class KisKraSaveVisitor : public KisNodeVisitor
@@ -41,6 +42,13 @@ public:
 public:
     void setExternalUri(const QString &uri);
 
+    /**
+     * When the pipeline is set, the pixel data of the layers is not
+     * written immediately, but scheduled in \p pipeline, which should
+     * be run after the visitor has finished.
+     */
+    void setSavePipeline(KisKraSavePipeline *pipeline);
+
     bool visit(KisNode*) {
         return true;
     }
@@ -85,6 +93,7 @@ private:
     QString m_name;
     QMap<const KisNode*, QString> m_nodeFileNames;
     KisPaintDeviceWriter *m_writer;
+    KisKraSavePipeline *m_pipeline;
     QStringList m_errorMessages;
 };
 
@@ -20,6 +20,7 @@
 
 #include "kis_kra_tags.h"
 #include "kis_kra_save_visitor.h"
+#include "kis_kra_save_pipeline.h"
 #include "kis_kra_savexml_visitor.h"
 
 #include <QDomDocument>
@@ -45,6 +46,7 @@
 #include <kis_painting_assistants_decoration.h>
 #include <kis_psd_layer_style_resource.h>
 #include "kis_png_converter.h"
+#include "kis_image_config.h"
 
 #include "KisDocument.h"
 #include <string>
@@ -114,8 +116,16 @@ bool KisKraSaver::saveBinaryData(KoStore* store, KisImageWSP image, const QStrin
 {
     QString location;
 
+    /**
+     * The visitor only takes snapshots of the layers' pixel data. It is
+     * compressed in parallel and written by the pipeline after all the
+     * other entries.
+     */
+    KisKraSavePipeline pipeline(store, KisImageConfig().maxNumberOfThreads());
+
     // Save the layers data
     KisKraSaveVisitor visitor(store, m_d->imageName, m_d->nodeFileNames);
+    visitor.setSavePipeline(&pipeline);
 
     if (external)
         visitor.setExternalUri(uri);
@@ -196,6 +206,14 @@ bool KisKraSaver::saveBinaryData(KoStore* store, KisImageWSP image, const QStrin
     }
 
     saveAssistants(store, uri,external);
+
+    if (!pipeline.run()) {
+        foreach (const QString &location, pipeline.failedLocations()) {
+            m_d->errorMessages << i18n("Failed to save the pixel data to %1.", location);
+        }
+        return false;
+    }
+
     return true;
 }
 
@@ -34,6 +34,7 @@
 #include "kis_image.h"
 #include "kis_config.h"
 #include "KisPart.h"
+#include "canvas/kis_display_conversion_cache.h"
 
 #ifdef HAVE_OPENEXR
 #include <half.h>
@@ -52,6 +53,7 @@ KisOpenGLImageTextures::ImageTexturesMap KisOpenGLImageTextures::imageTexturesMa
 
 KisOpenGLImageTextures::KisOpenGLImageTextures()
     : m_image(0)
+    , m_conversionCache(0)
     , m_monitorProfile(0)
     , m_tilesDestinationColorSpace(0)
     , m_internalColorManagementActive(true)
@@ -76,6 +78,7 @@ KisOpenGLImageTextures::KisOpenGLImageTextures(KisImageWSP image,
                                                KoColorConversionTransformation::Intent renderingIntent,
                                                KoColorConversionTransformation::ConversionFlags conversionFlags)
     : m_image(image)
+    , m_conversionCache(KisDisplayConversionCache::forImage(image))
     , m_monitorProfile(monitorProfile)
     , m_renderingIntent(renderingIntent)
     , m_conversionFlags(conversionFlags)
@@ -278,8 +281,12 @@ KisOpenGLUpdateInfoSP KisOpenGLImageTextures::updateCache(const QRect& rect)
                                              m_image->bounds()));
             // Don't update empty tiles
             if (tileInfo->valid()) {
-                tileInfo->retrieveData(m_image, channelFlags, m_onlyOneChannelSelected, m_selectedChannelIndex);
-                tileInfo->convertTo(dstCS, m_renderingIntent, m_conversionFlags);
+                if (m_conversionCache && channelFlags.isEmpty()) {
+                    tileInfo->retrieveConvertedData(m_conversionCache, m_image, dstCS, m_renderingIntent, m_conversionFlags);
+                } else {
+                    tileInfo->retrieveData(m_image, channelFlags, m_onlyOneChannelSelected, m_selectedChannelIndex);
+                    tileInfo->convertTo(dstCS, m_renderingIntent, m_conversionFlags);
+                }
 
                 info->tileList.append(tileInfo);
             }
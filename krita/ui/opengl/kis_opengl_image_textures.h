@@ -38,6 +38,7 @@ class QOpenGLFunctions;
 typedef KisSharedPtr<KisOpenGLImageTextures> KisOpenGLImageTexturesSP;
 
 class KoColorProfile;
+class KisDisplayConversionCache;
 
 /**
  * A set of OpenGL textures that contains the projection of a KisImage.
@@ -161,6 +162,7 @@ private:
 
 private:
     KisImageWSP m_image;
+    KisDisplayConversionCache *m_conversionCache;
     QRect m_storedImageBounds;
     const KoColorProfile *m_monitorProfile;
     KoColorConversionTransformation::Intent m_renderingIntent;
@@ -30,6 +30,7 @@
 #include "kis_image.h"
 #include "kis_paint_device.h"
 #include "kis_config.h"
+#include "canvas/kis_display_conversion_cache.h"
 #include <KoColorConversionTransformation.h>
 #include <KoChannelInfo.h>
 
@@ -181,6 +182,28 @@ public:
 
     }
 
+    /**
+     * Retrieves the data already converted into \p dstCS, reusing the
+     * tiles converted earlier. Used instead of retrieveData() and
+     * convertTo() when no channel flags are set.
+     */
+    void retrieveConvertedData(KisDisplayConversionCache *cache,
+                               KisImageWSP image,
+                               const KoColorSpace* dstCS,
+                               KoColorConversionTransformation::Intent renderingIntent,
+                               KoColorConversionTransformation::ConversionFlags conversionFlags)
+    {
+        m_patchColorSpace = dstCS;
+
+        m_patchPixelsLength = dstCS->pixelSize() * m_patchRect.width() * m_patchRect.height();
+        m_patchPixelsCache.ensureNotSmaller(m_patchPixelsLength);
+        m_patchPixelsCache.swap(m_patchPixels);
+
+        cache->readConverted(image->projection(), m_patchRect,
+                             dstCS, renderingIntent, conversionFlags,
+                             m_patchPixels.data());
+    }
+
     void convertTo(const KoColorSpace* dstCS,
                    KoColorConversionTransformation::Intent renderingIntent,
                    KoColorConversionTransformation::ConversionFlags conversionFlags)
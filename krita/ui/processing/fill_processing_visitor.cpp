@@ -22,6 +22,7 @@
 #include <kis_image.h>
 #include <kis_fill_painter.h>
 #include <kis_wrapped_rect.h>
+#include <kis_image_config.h>
 
 
 FillProcessingVisitor::FillProcessingVisitor(const QPoint &startPoint,
@@ -115,6 +116,7 @@ void FillProcessingVisitor::visitNodeWithPaintDevice(KisNode *node, KisUndoAdapt
         fillPainter.setSizemod(m_sizemod);
         fillPainter.setFeather(m_feather);
         fillPainter.setFillThreshold(m_fillThreshold);
+        fillPainter.setThreadCount(KisImageConfig().maxNumberOfThreads());
         fillPainter.setCareForSelection(true);
         fillPainter.setWidth(fillRect.width());
         fillPainter.setHeight(fillRect.height());
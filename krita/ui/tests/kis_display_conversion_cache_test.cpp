@@ -0,0 +1,129 @@
+/*
+ *  Copyright (c) 2015 Calligra developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_display_conversion_cache_test.h"
+
+#include <qtest_kde.h>
+
+#include <KoColor.h>
+#include <KoColorSpaceRegistry.h>
+
+#include "kis_image.h"
+#include "kis_paint_device.h"
+#include "canvas/kis_display_conversion_cache.h"
+
+
+QByteArray convertDirectly(KisPaintDeviceSP dev, const QRect &rc, const KoColorSpace *dstCs)
+{
+    const int numPixels = rc.width() * rc.height();
+
+    QByteArray src(dev->pixelSize() * numPixels, Qt::Uninitialized);
+    dev->readBytes((quint8*)src.data(), rc);
+
+    QByteArray dst(dstCs->pixelSize() * numPixels, Qt::Uninitialized);
+    dev->colorSpace()->convertPixelsTo((const quint8*)src.constData(), (quint8*)dst.data(), dstCs, numPixels,
+                                       KoColorConversionTransformation::InternalRenderingIntent,
+                                       KoColorConversionTransformation::InternalConversionFlags);
+
+    return dst;
+}
+
+QByteArray readFromCache(KisDisplayConversionCache *cache, KisPaintDeviceSP dev, const QRect &rc, const KoColorSpace *dstCs)
+{
+    QByteArray dst(dstCs->pixelSize() * rc.width() * rc.height(), Qt::Uninitialized);
+
+    cache->readConverted(dev, rc, dstCs,
+                         KoColorConversionTransformation::InternalRenderingIntent,
+                         KoColorConversionTransformation::InternalConversionFlags,
+                         (quint8*)dst.data());
+
+    return dst;
+}
+
+KisPaintDeviceSP createTestDevice()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
+
+    QImage qimage(QString(FILES_DATA_DIR) + QDir::separator() + "lena.png");
+
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    dev->convertFromQImage(qimage, 0, 0, 0);
+
+    return dev;
+}
+
+void KisDisplayConversionCacheTest::testReadConverted()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
+    const KoColorSpace *monitorCs = KoColorSpaceRegistry::instance()->rgb8();
+
+    KisImageSP image = new KisImage(0, 512, 512, cs, "conversion cache test");
+    KisDisplayConversionCache *cache = KisDisplayConversionCache::forImage(image);
+
+    KisPaintDeviceSP dev = createTestDevice();
+
+    // not aligned to the tiles
+    const QRect rc(10, 20, 300, 200);
+
+    QCOMPARE(readFromCache(cache, dev, rc, monitorCs), convertDirectly(dev, rc, monitorCs));
+
+    // only the tiles covered completely are cached
+    QCOMPARE(cache->numCachedTiles(), 3 * 2);
+
+    QCOMPARE(readFromCache(cache, dev, rc, monitorCs), convertDirectly(dev, rc, monitorCs));
+    QCOMPARE(cache->numCachedTiles(), 3 * 2);
+}
+
+void KisDisplayConversionCacheTest::testInvalidate()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
+    const KoColorSpace *monitorCs = KoColorSpaceRegistry::instance()->rgb8();
+
+    KisImageSP image = new KisImage(0, 512, 512, cs, "conversion cache test");
+    KisDisplayConversionCache *cache = KisDisplayConversionCache::forImage(image);
+
+    KisPaintDeviceSP dev = createTestDevice();
+
+    const QRect rc(0, 0, 256, 256);
+    readFromCache(cache, dev, rc, monitorCs);
+
+    const QRect dirtyRect(70, 30, 100, 50);
+    dev->fill(dirtyRect, KoColor(Qt::red, cs));
+    cache->invalidate(dirtyRect);
+
+    QCOMPARE(readFromCache(cache, dev, rc, monitorCs), convertDirectly(dev, rc, monitorCs));
+
+    cache->clear();
+    QCOMPARE(cache->numCachedTiles(), 0);
+
+    QCOMPARE(readFromCache(cache, dev, rc, monitorCs), convertDirectly(dev, rc, monitorCs));
+}
+
+void KisDisplayConversionCacheTest::testSharedBetweenCallers()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
+
+    KisImageSP image = new KisImage(0, 512, 512, cs, "conversion cache test");
+    KisImageSP image2 = new KisImage(0, 512, 512, cs, "conversion cache test 2");
+
+    KisDisplayConversionCache *cache = KisDisplayConversionCache::forImage(image);
+    QCOMPARE(KisDisplayConversionCache::forImage(image), cache);
+    QVERIFY(KisDisplayConversionCache::forImage(image2) != cache);
+}
+
+QTEST_KDEMAIN(KisDisplayConversionCacheTest, GUI)
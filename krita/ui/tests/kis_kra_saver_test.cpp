@@ -44,6 +44,7 @@
 #include "kis_selection.h"
 #include "kis_fill_painter.h"
 #include "kis_shape_selection.h"
+#include "kis_config.h"
 #include "util.h"
 #include "testutil.h"
 
@@ -245,4 +246,91 @@ void KisKraSaverTest::testRoundTripLayerStyles()
     QVERIFY(chk.testPassed());
 }
 
+void KisKraSaverTest::testRoundTripPixelData()
+{
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    QScopedPointer<KisDocument> doc(createEmptyDocument());
+    KisImageSP image = doc->image();
+
+    /**
+     * More layers than threads, so that the save pipeline has to
+     * reuse its slots and keep the order of the entries
+     */
+    const int numLayers = 12;
+
+    for (int i = 0; i < numLayers; i++) {
+        KisPaintLayerSP layer = new KisPaintLayer(image, QString("paint%1").arg(i), OPACITY_OPAQUE_U8, cs);
+        KoColor color(QColor(20 * i, 255 - 20 * i, 128), cs);
+        layer->paintDevice()->fill(QRect(30 * i, 20 * i, 100 + 7 * i, 90), color);
+        image->addNode(layer, image->root());
+    }
+
+    QVERIFY(doc->saveNativeFormat("roundtrip_pixel_data_test.kra"));
+
+    QScopedPointer<KisDocument> doc2(KisPart::instance()->createDocument());
+    doc2->loadNativeFormat("roundtrip_pixel_data_test.kra");
+
+    for (int i = 0; i < numLayers; i++) {
+        const QString name = QString("paint%1").arg(i);
+
+        KisNodeSP node1 = TestUtil::findNode(image->root(), name);
+        KisNodeSP node2 = TestUtil::findNode(doc2->image()->root(), name);
+        QVERIFY(node1);
+        QVERIFY(node2);
+
+        QPoint errpoint;
+        if (!TestUtil::comparePaintDevices(errpoint, node1->paintDevice(), node2->paintDevice())) {
+            QFAIL(QString("Pixel data of %1 differs at %2,%3").arg(name).arg(errpoint.x()).arg(errpoint.y()).toLatin1());
+        }
+    }
+}
+
+void KisKraSaverTest::testLazyLoading()
+{
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    QScopedPointer<KisDocument> doc(createEmptyDocument());
+    KisImageSP image = doc->image();
+
+    KisPaintLayerSP visibleLayer = new KisPaintLayer(image, "visible", OPACITY_OPAQUE_U8, cs);
+    visibleLayer->paintDevice()->fill(QRect(10, 10, 200, 100), KoColor(Qt::red, cs));
+    image->addNode(visibleLayer, image->root());
+
+    KisPaintLayerSP hiddenLayer = new KisPaintLayer(image, "hidden", OPACITY_OPAQUE_U8, cs);
+    hiddenLayer->paintDevice()->fill(QRect(50, 70, 100, 300), KoColor(Qt::blue, cs));
+    hiddenLayer->setVisible(false);
+    image->addNode(hiddenLayer, image->root());
+
+    QVERIFY(doc->saveNativeFormat("lazy_loading_test.kra"));
+
+    KisConfig cfg;
+    const bool savedLoadLazily = cfg.loadKraLazily();
+    cfg.setLoadKraLazily(true);
+
+    QScopedPointer<KisDocument> doc2(KisPart::instance()->createDocument());
+    doc2->loadNativeFormat("lazy_loading_test.kra");
+
+    cfg.setLoadKraLazily(savedLoadLazily);
+
+    KisNodeSP hiddenNode = TestUtil::findNode(doc2->image()->root(), "hidden");
+    QVERIFY(hiddenNode);
+
+    // nobody has touched the hidden layer yet
+    QVERIFY(hiddenNode->paintDevice()->hasPendingData());
+
+    QPoint errpoint;
+    if (!TestUtil::comparePaintDevices(errpoint, hiddenLayer->paintDevice(), hiddenNode->paintDevice())) {
+        QFAIL(QString("Pixel data of the hidden layer differs at %1,%2").arg(errpoint.x()).arg(errpoint.y()).toLatin1());
+    }
+    QVERIFY(!hiddenNode->paintDevice()->hasPendingData());
+
+    KisNodeSP visibleNode = TestUtil::findNode(doc2->image()->root(), "visible");
+    QVERIFY(visibleNode);
+
+    if (!TestUtil::comparePaintDevices(errpoint, visibleLayer->paintDevice(), visibleNode->paintDevice())) {
+        QFAIL(QString("Pixel data of the visible layer differs at %1,%2").arg(errpoint.x()).arg(errpoint.y()).toLatin1());
+    }
+}
+
 QTEST_KDEMAIN(KisKraSaverTest, GUI)
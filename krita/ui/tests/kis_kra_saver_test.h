@@ -37,6 +37,10 @@ private Q_SLOTS:
 
     void testRoundTripLayerStyles();
 
+    void testRoundTripPixelData();
+
+    void testLazyLoading();
+
 };
 
 #endif
@@ -80,6 +80,43 @@ void KoBasicHistogramProducer::clear()
     }
 }
 
+void KoBasicHistogramProducer::addBins(const KoHistogramProducer *other)
+{
+    mergeBins(other, 1);
+}
+
+void KoBasicHistogramProducer::removeBins(const KoHistogramProducer *other)
+{
+    mergeBins(other, -1);
+}
+
+KoHistogramProducer* KoBasicHistogramProducer::initEmptyCopy(KoBasicHistogramProducer *copy) const
+{
+    copy->setView(m_from, m_width);
+    copy->setSkipTransparent(m_skipTransparent);
+    copy->setSkipUnselected(m_skipUnselected);
+    return copy;
+}
+
+void KoBasicHistogramProducer::mergeBins(const KoHistogramProducer *other, int sign)
+{
+    const KoBasicHistogramProducer *rhs = dynamic_cast<const KoBasicHistogramProducer*>(other);
+    Q_ASSERT(rhs);
+    Q_ASSERT(rhs->m_channels == m_channels && rhs->m_nrOfBins == m_nrOfBins);
+
+    if (!rhs) return;
+
+    // the bins are stored in the internal order in both producers
+    m_count += sign * rhs->m_count;
+    for (int i = 0; i < m_channels; i++) {
+        for (int j = 0; j < m_nrOfBins; j++) {
+            m_bins[i][j] += sign * rhs->m_bins[i][j];
+        }
+        m_outLeft[i] += sign * rhs->m_outLeft[i];
+        m_outRight[i] += sign * rhs->m_outRight[i];
+    }
+}
+
 void KoBasicHistogramProducer::makeExternalToInternal()
 {
     // This function assumes that the pixel is has no 'gaps'. That is to say: if we start
@@ -107,6 +144,11 @@ KoBasicU8HistogramProducer::KoBasicU8HistogramProducer(const KoID& id, const KoC
 {
 }
 
+KoHistogramProducer* KoBasicU8HistogramProducer::createEmptyCopy() const
+{
+    return initEmptyCopy(new KoBasicU8HistogramProducer(m_id, m_colorSpace));
+}
+
 QString KoBasicU8HistogramProducer::positionToString(qreal pos) const
 {
     return QString("%1").arg(static_cast<quint8>(pos * UINT8_MAX));
@@ -155,6 +197,11 @@ KoBasicU16HistogramProducer::KoBasicU16HistogramProducer(const KoID& id, const K
 {
 }
 
+KoHistogramProducer* KoBasicU16HistogramProducer::createEmptyCopy() const
+{
+    return initEmptyCopy(new KoBasicU16HistogramProducer(m_id, m_colorSpace));
+}
+
 QString KoBasicU16HistogramProducer::positionToString(qreal pos) const
 {
     return QString("%1").arg(static_cast<quint8>(pos * UINT8_MAX));
@@ -223,6 +270,11 @@ KoBasicF32HistogramProducer::KoBasicF32HistogramProducer(const KoID& id, const K
 {
 }
 
+KoHistogramProducer* KoBasicF32HistogramProducer::createEmptyCopy() const
+{
+    return initEmptyCopy(new KoBasicF32HistogramProducer(m_id, m_colorSpace));
+}
+
 QString KoBasicF32HistogramProducer::positionToString(qreal pos) const
 {
     return QString("%1").arg(static_cast<float>(pos)); // XXX I doubt this is correct!
@@ -298,6 +350,11 @@ KoBasicF16HalfHistogramProducer::KoBasicF16HalfHistogramProducer(const KoID& id,
 {
 }
 
+KoHistogramProducer* KoBasicF16HalfHistogramProducer::createEmptyCopy() const
+{
+    return initEmptyCopy(new KoBasicF16HalfHistogramProducer(m_id, m_colorSpace));
+}
+
 QString KoBasicF16HalfHistogramProducer::positionToString(qreal pos) const
 {
     return QString("%1").arg(static_cast<float>(pos)); // XXX I doubt this is correct!
@@ -370,6 +427,11 @@ KoGenericRGBHistogramProducer::KoGenericRGBHistogramProducer()
     m_channelsList.append(new KoChannelInfo(i18n("B"), 2, 2, KoChannelInfo::COLOR, KoChannelInfo::UINT8, 1, QColor(0, 0, 255)));
 }
 
+KoHistogramProducer* KoGenericRGBHistogramProducer::createEmptyCopy() const
+{
+    return initEmptyCopy(new KoGenericRGBHistogramProducer());
+}
+
 QList<KoChannelInfo *> KoGenericRGBHistogramProducer::channels()
 {
     return m_channelsList;
@@ -447,6 +509,12 @@ KoGenericLabHistogramProducer::KoGenericLabHistogramProducer()
     }
     m_colorSpace = m_labCs;
 }
+
+KoHistogramProducer* KoGenericLabHistogramProducer::createEmptyCopy() const
+{
+    return initEmptyCopy(new KoGenericLabHistogramProducer());
+}
+
 KoGenericLabHistogramProducer::~KoGenericLabHistogramProducer()
 {
     delete m_channelsList[0];
@@ -75,7 +75,18 @@ public:
         return m_outRight.at(externalToInternal(channel));
     }
 
+    virtual void addBins(const KoHistogramProducer *other);
+    virtual void removeBins(const KoHistogramProducer *other);
+
 protected:
+    /**
+     * Copies the view and the settings of this producer to \p copy,
+     * used by the implementations of createEmptyCopy()
+     */
+    KoHistogramProducer* initEmptyCopy(KoBasicHistogramProducer *copy) const;
+
+    void mergeBins(const KoHistogramProducer *other, int sign);
+
     /**
      * The order in which channels() returns is not the same as the internal representation,
      * that of the pixel internally. This method converts external usage to internal usage.
@@ -105,6 +116,7 @@ class PIGMENTCMS_EXPORT KoBasicU8HistogramProducer : public KoBasicHistogramProd
 {
 public:
     KoBasicU8HistogramProducer(const KoID& id, const KoColorSpace *colorSpace);
+    virtual KoHistogramProducer* createEmptyCopy() const;
     virtual void addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *colorSpace);
     virtual QString positionToString(qreal pos) const;
     virtual qreal maximalZoom() const {
@@ -116,6 +128,7 @@ class PIGMENTCMS_EXPORT KoBasicU16HistogramProducer : public KoBasicHistogramPro
 {
 public:
     KoBasicU16HistogramProducer(const KoID& id, const KoColorSpace *colorSpace);
+    virtual KoHistogramProducer* createEmptyCopy() const;
     virtual void addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *colorSpace);
     virtual QString positionToString(qreal pos) const;
     virtual qreal maximalZoom() const;
@@ -125,6 +138,7 @@ class PIGMENTCMS_EXPORT KoBasicF32HistogramProducer : public KoBasicHistogramPro
 {
 public:
     KoBasicF32HistogramProducer(const KoID& id, const KoColorSpace *colorSpace);
+    virtual KoHistogramProducer* createEmptyCopy() const;
     virtual void addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *colorSpace);
     virtual QString positionToString(qreal pos) const;
     virtual qreal maximalZoom() const;
@@ -136,6 +150,7 @@ class PIGMENTCMS_EXPORT KoBasicF16HalfHistogramProducer : public KoBasicHistogra
 {
 public:
     KoBasicF16HalfHistogramProducer(const KoID& id, const KoColorSpace *colorSpace);
+    virtual KoHistogramProducer* createEmptyCopy() const;
     virtual void addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *colorSpace);
     virtual QString positionToString(qreal pos) const;
     virtual qreal maximalZoom() const;
@@ -185,6 +200,7 @@ class PIGMENTCMS_EXPORT KoGenericRGBHistogramProducer : public KoBasicHistogramP
 {
 public:
     KoGenericRGBHistogramProducer();
+    virtual KoHistogramProducer* createEmptyCopy() const;
     virtual void addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *colorSpace);
     virtual QString positionToString(qreal pos) const;
     virtual qreal maximalZoom() const;
@@ -220,6 +236,7 @@ class  PIGMENTCMS_EXPORT KoGenericLabHistogramProducer : public KoBasicHistogram
 {
 public:
     KoGenericLabHistogramProducer();
+    virtual KoHistogramProducer* createEmptyCopy() const;
     virtual ~KoGenericLabHistogramProducer();
     virtual void addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *colorSpace);
     virtual QString positionToString(qreal pos) const;
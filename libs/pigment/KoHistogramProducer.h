@@ -94,6 +94,36 @@ public:
     virtual qint32 getBinAt(qint32 channel, qint32 position) = 0;
     virtual qint32 outOfViewLeft(qint32 channel) = 0;
     virtual qint32 outOfViewRight(qint32 channel) = 0;
+
+    // Methods to compute the histogram in parts
+
+    /**
+     * Creates a producer of the same kind with the same view and
+     * settings, but with empty bins. The histograms of several parts
+     * of an image can be produced by such copies in parallel and then
+     * merged with addBins(). Returns 0 if the producer does not
+     * support that.
+     */
+    virtual KoHistogramProducer* createEmptyCopy() const {
+        return 0;
+    }
+
+    /**
+     * Adds the bins of \p other, which must have been created with
+     * createEmptyCopy(), to the bins of this producer
+     */
+    virtual void addBins(const KoHistogramProducer *other) {
+        Q_UNUSED(other);
+    }
+
+    /**
+     * Subtracts the bins of \p other, added earlier with addBins(),
+     * from the bins of this producer
+     */
+    virtual void removeBins(const KoHistogramProducer *other) {
+        Q_UNUSED(other);
+    }
+
 protected:
     bool m_skipTransparent;
     bool m_skipUnselected;
@@ -55,6 +55,14 @@ struct OptimizedOpsSelector
     static KoCompositeOp* createOverOp(const KoColorSpace *cs) {
         return new KoCompositeOpOver<Traits>(cs);
     }
+    static KoCompositeOp* createSeparableOp(const KoColorSpace *cs, const QString &id,
+                                            const QString &description, const QString &category) {
+        Q_UNUSED(cs);
+        Q_UNUSED(id);
+        Q_UNUSED(description);
+        Q_UNUSED(category);
+        return 0;
+    }
 };
 
 template<>
@@ -66,6 +74,10 @@ struct OptimizedOpsSelector<KoBgrU8Traits>
     static KoCompositeOp* createOverOp(const KoColorSpace *cs) {
         return KoOptimizedCompositeOpFactory::createOverOp32(cs);
     }
+    static KoCompositeOp* createSeparableOp(const KoColorSpace *cs, const QString &id,
+                                            const QString &description, const QString &category) {
+        return KoOptimizedCompositeOpFactory::createSeparableOp32(cs, id, description, category);
+    }
 };
 
 template<>
@@ -77,6 +89,10 @@ struct OptimizedOpsSelector<KoLabU8Traits>
     static KoCompositeOp* createOverOp(const KoColorSpace *cs) {
         return KoOptimizedCompositeOpFactory::createOverOp32(cs);
     }
+    static KoCompositeOp* createSeparableOp(const KoColorSpace *cs, const QString &id,
+                                            const QString &description, const QString &category) {
+        return KoOptimizedCompositeOpFactory::createSeparableOp32(cs, id, description, category);
+    }
 };
 
 template<>
@@ -88,6 +104,10 @@ struct OptimizedOpsSelector<KoRgbF32Traits>
     static KoCompositeOp* createOverOp(const KoColorSpace *cs) {
         return KoOptimizedCompositeOpFactory::createOverOp128(cs);
     }
+    static KoCompositeOp* createSeparableOp(const KoColorSpace *cs, const QString &id,
+                                            const QString &description, const QString &category) {
+        return KoOptimizedCompositeOpFactory::createSeparableOp128(cs, id, description, category);
+    }
 };
 
 template<class Traits>
@@ -99,7 +119,13 @@ struct AddGeneralOps<Traits, true>
 
      template<CompositeFunc func>
      static void add(KoColorSpace* cs, const QString& id, const QString& description, const QString& category) {
-         cs->addCompositeOp(new KoCompositeOpGenericSC<Traits, func>(cs, id, description, category));
+         KoCompositeOp *op = OptimizedOpsSelector<Traits>::createSeparableOp(cs, id, description, category);
+
+         if (!op) {
+             op = new KoCompositeOpGenericSC<Traits, func>(cs, id, description, category);
+         }
+
+         cs->addCompositeOp(op);
      }
 
      static void add(KoColorSpace* cs) {
@@ -46,3 +46,17 @@ KoCompositeOp* KoOptimizedCompositeOpFactory::createOverOp128(const KoColorSpace
 {
     return createOptimizedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver128> >(cs);
 }
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createSeparableOp32(const KoColorSpace *cs, const QString &id,
+                                                                 const QString &description, const QString &category)
+{
+    KoOptimizedSeparableOpParams param(cs, id, description, category);
+    return createOptimizedClass<KoOptimizedSeparableOpFactoryPerArch<KoOptimizedCompositeOpGenericSC32> >(param);
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createSeparableOp128(const KoColorSpace *cs, const QString &id,
+                                                                  const QString &description, const QString &category)
+{
+    KoOptimizedSeparableOpParams param(cs, id, description, category);
+    return createOptimizedClass<KoOptimizedSeparableOpFactoryPerArch<KoOptimizedCompositeOpGenericSC128> >(param);
+}
@@ -24,6 +24,7 @@
 
 class KoCompositeOp;
 class KoColorSpace;
+class QString;
 
 /**
  * The creation of the optimized composite ops is moved into a separate
@@ -43,6 +44,17 @@ public:
     static KoCompositeOp* createAlphaDarkenOp32(const KoColorSpace *cs);
     static KoCompositeOp* createOverOp32(const KoColorSpace *cs);
     static KoCompositeOp* createOverOp128(const KoColorSpace *cs);
+
+    /**
+     * Create an optimized version of a separable blending op (Multiply,
+     * Screen, Overlay, etc.) for 8-bit and float RGBA colorspaces
+     * respectively. Return null if there is no optimized version of
+     * the op with \p id.
+     */
+    static KoCompositeOp* createSeparableOp32(const KoColorSpace *cs, const QString &id,
+                                              const QString &description, const QString &category);
+    static KoCompositeOp* createSeparableOp128(const KoColorSpace *cs, const QString &id,
+                                               const QString &description, const QString &category);
 };
 
 #endif /* KOOPTIMIZEDCOMPOSITEOPFACTORY_H */
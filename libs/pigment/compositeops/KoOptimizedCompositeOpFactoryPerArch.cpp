@@ -23,6 +23,8 @@
 #include "KoOptimizedCompositeOpAlphaDarken32.h"
 #include "KoOptimizedCompositeOpOver32.h"
 #include "KoOptimizedCompositeOpOver128.h"
+#include "KoOptimizedCompositeOpGenericSC32.h"
+#include "KoOptimizedCompositeOpGenericSC128.h"
 
 #include <QString>
 #include "DebugPigment.h"
@@ -57,6 +59,54 @@ KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver128>::create<VC_I
     return new KoOptimizedCompositeOpOver128<VC_IMPL>(param);
 }
 
+template<Vc::Implementation _impl,
+         template<Vc::Implementation I, class F> class CompositeOp>
+KoCompositeOp* createSeparableOp(const KoOptimizedSeparableOpParams &param)
+{
+    const KoColorSpace *cs = param.cs;
+    const QString &id = param.id;
+
+    if (id == COMPOSITE_MULT) {
+        return new CompositeOp<_impl, KoStreamedBlendMultiply>(cs, id, param.description, param.category);
+    } else if (id == COMPOSITE_SCREEN) {
+        return new CompositeOp<_impl, KoStreamedBlendScreen>(cs, id, param.description, param.category);
+    } else if (id == COMPOSITE_OVERLAY) {
+        return new CompositeOp<_impl, KoStreamedBlendOverlay>(cs, id, param.description, param.category);
+    } else if (id == COMPOSITE_HARD_LIGHT) {
+        return new CompositeOp<_impl, KoStreamedBlendHardLight>(cs, id, param.description, param.category);
+    } else if (id == COMPOSITE_ADD || id == COMPOSITE_LINEAR_DODGE) {
+        return new CompositeOp<_impl, KoStreamedBlendAddition>(cs, id, param.description, param.category);
+    } else if (id == COMPOSITE_SUBTRACT) {
+        return new CompositeOp<_impl, KoStreamedBlendSubtract>(cs, id, param.description, param.category);
+    } else if (id == COMPOSITE_DIFF) {
+        return new CompositeOp<_impl, KoStreamedBlendDifference>(cs, id, param.description, param.category);
+    } else if (id == COMPOSITE_EXCLUSION) {
+        return new CompositeOp<_impl, KoStreamedBlendExclusion>(cs, id, param.description, param.category);
+    } else if (id == COMPOSITE_DARKEN) {
+        return new CompositeOp<_impl, KoStreamedBlendDarken>(cs, id, param.description, param.category);
+    } else if (id == COMPOSITE_LIGHTEN) {
+        return new CompositeOp<_impl, KoStreamedBlendLighten>(cs, id, param.description, param.category);
+    }
+
+    return 0;
+}
+
+template<>
+template<>
+KoOptimizedSeparableOpFactoryPerArch<KoOptimizedCompositeOpGenericSC32>::ReturnType
+KoOptimizedSeparableOpFactoryPerArch<KoOptimizedCompositeOpGenericSC32>::create<VC_IMPL>(ParamType param)
+{
+    return createSeparableOp<VC_IMPL, KoOptimizedCompositeOpGenericSC32>(param);
+}
+
+template<>
+template<>
+KoOptimizedSeparableOpFactoryPerArch<KoOptimizedCompositeOpGenericSC128>::ReturnType
+KoOptimizedSeparableOpFactoryPerArch<KoOptimizedCompositeOpGenericSC128>::create<VC_IMPL>(ParamType param)
+{
+    return createSeparableOp<VC_IMPL, KoOptimizedCompositeOpGenericSC128>(param);
+}
+
 #define __stringify(_s) #_s
 #define stringify(_s) __stringify(_s)
 
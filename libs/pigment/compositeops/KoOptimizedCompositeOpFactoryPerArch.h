@@ -23,6 +23,8 @@
 
 #include "KoVcMultiArchBuildSupport.h"
 
+#include <QString>
+
 
 class KoCompositeOp;
 class KoColorSpace;
@@ -47,6 +49,43 @@ struct KoOptimizedCompositeOpFactoryPerArch
     static ReturnType create(ParamType param);
 };
 
+template<Vc::Implementation _impl, class BlendFunction>
+class KoOptimizedCompositeOpGenericSC32;
+
+template<Vc::Implementation _impl, class BlendFunction>
+class KoOptimizedCompositeOpGenericSC128;
+
+struct KoOptimizedSeparableOpParams
+{
+    KoOptimizedSeparableOpParams(const KoColorSpace *_cs,
+                                 const QString &_id,
+                                 const QString &_description,
+                                 const QString &_category)
+        : cs(_cs), id(_id), description(_description), category(_category)
+    {
+    }
+
+    const KoColorSpace *cs;
+    QString id;
+    QString description;
+    QString category;
+};
+
+/**
+ * Creates an optimized version of a separable blending op with
+ * id \p param.id. Returns null if there is no optimized version
+ * of the requested op for the current architecture.
+ */
+template<template<Vc::Implementation I, class F> class CompositeOp>
+struct KoOptimizedSeparableOpFactoryPerArch
+{
+    typedef const KoOptimizedSeparableOpParams& ParamType;
+    typedef KoCompositeOp* ReturnType;
+
+    template<Vc::Implementation _impl>
+    static ReturnType create(ParamType param);
+};
+
 struct KoReportCurrentArch
 {
     typedef void* ParamType;
@@ -48,6 +48,26 @@ KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver128>::create<Vc::
     return new KoCompositeOpOver<KoRgbF32Traits>(param);
 }
 
+template<>
+template<>
+KoOptimizedSeparableOpFactoryPerArch<KoOptimizedCompositeOpGenericSC32>::ReturnType
+KoOptimizedSeparableOpFactoryPerArch<KoOptimizedCompositeOpGenericSC32>::create<Vc::ScalarImpl>(ParamType param)
+{
+    Q_UNUSED(param);
+    // the legacy KoCompositeOpGenericSC will be used instead
+    return 0;
+}
+
+template<>
+template<>
+KoOptimizedSeparableOpFactoryPerArch<KoOptimizedCompositeOpGenericSC128>::ReturnType
+KoOptimizedSeparableOpFactoryPerArch<KoOptimizedCompositeOpGenericSC128>::create<Vc::ScalarImpl>(ParamType param)
+{
+    Q_UNUSED(param);
+    // the legacy KoCompositeOpGenericSC will be used instead
+    return 0;
+}
+
 template<>
 KoReportCurrentArch::ReturnType
 KoReportCurrentArch::create<Vc::ScalarImpl>(ParamType)
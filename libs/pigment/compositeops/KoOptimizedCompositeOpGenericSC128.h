@@ -0,0 +1,228 @@
+/*
+ *  Copyright (c) 2015 Calligra developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KOOPTIMIZEDCOMPOSITEOPGENERICSC128_H_
+#define KOOPTIMIZEDCOMPOSITEOPGENERICSC128_H_
+
+#include "KoCompositeOpBase.h"
+#include "KoCompositeOpRegistry.h"
+#include "KoStreamedMath.h"
+#include "KoStreamedBlendFunctions.h"
+
+
+/**
+ * A vectorized equivalent of KoCompositeOpGenericSC for 16 byte
+ * colorspaces (4 float channels) with alpha channel placed at the
+ * last position of the pixel: C1_C2_C3_A.
+ *
+ * The result of the blending function is not clamped, which is
+ * exactly what the scalar version does for float channels.
+ */
+template<class BlendFunction, bool alphaLocked, bool allChannelsFlag>
+struct GenericSCCompositor128 {
+    struct OptionalParams {
+        OptionalParams(const KoCompositeOp::ParameterInfo& params)
+            : channelFlags(params.channelFlags)
+        {
+        }
+        const QBitArray &channelFlags;
+    };
+
+    struct Pixel {
+        float red;
+        float green;
+        float blue;
+        float alpha;
+    };
+
+    // \see docs in AlphaDarkenCompositor32
+    template<bool haveMask, bool src_aligned, Vc::Implementation _impl>
+    static ALWAYS_INLINE void compositeVector(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const OptionalParams &oparams)
+    {
+        Q_UNUSED(oparams);
+
+        const Pixel *sp = reinterpret_cast<const Pixel*>(src);
+        Pixel *dp = reinterpret_cast<Pixel*>(dst);
+
+        Vc::float_v src_alpha;
+        Vc::float_v dst_alpha;
+
+        Vc::float_v src_c1;
+        Vc::float_v src_c2;
+        Vc::float_v src_c3;
+
+        const Vc::uint_v indexes(Vc::int_v::IndexesFromZero());
+        Vc::InterleavedMemoryWrapper<Pixel, Vc::float_v> data(const_cast<Pixel*>(sp));
+        (src_c1, src_c2, src_c3, src_alpha) = data[indexes];
+
+        src_alpha *= Vc::float_v(opacity);
+
+        if (haveMask) {
+            const Vc::float_v uint8MaxRec1((float)1.0 / 255);
+            Vc::float_v mask_vec = KoStreamedMath<_impl>::fetch_mask_8(mask);
+            src_alpha *= mask_vec * uint8MaxRec1;
+        }
+
+        const Vc::float_v zeroValue(Vc::Zero);
+        const Vc::float_v oneValue(Vc::One);
+
+        // The source cannot change the colors in the destination,
+        // since its fully transparent
+        if ((src_alpha == zeroValue).isFull()) {
+            return;
+        }
+
+        Vc::float_v dst_c1;
+        Vc::float_v dst_c2;
+        Vc::float_v dst_c3;
+
+        Vc::InterleavedMemoryWrapper<Pixel, Vc::float_v> dataDest(dp);
+        (dst_c1, dst_c2, dst_c3, dst_alpha) = dataDest[indexes];
+
+        // \see the comments in GenericSCCompositor32
+        const Vc::float_v new_alpha = src_alpha + dst_alpha - src_alpha * dst_alpha;
+        const Vc::float_v dst_weight = (oneValue - src_alpha) * dst_alpha;
+        const Vc::float_v src_weight = (oneValue - dst_alpha) * src_alpha;
+        const Vc::float_v blend_weight = src_alpha * dst_alpha;
+
+        const Vc::float_m emptyPixels = new_alpha == zeroValue;
+        const Vc::float_v scale = oneValue / new_alpha;
+
+        Vc::float_v result_c1 = (dst_weight * dst_c1 + src_weight * src_c1 + blend_weight * BlendFunction::blend(src_c1, dst_c1)) * scale;
+        Vc::float_v result_c2 = (dst_weight * dst_c2 + src_weight * src_c2 + blend_weight * BlendFunction::blend(src_c2, dst_c2)) * scale;
+        Vc::float_v result_c3 = (dst_weight * dst_c3 + src_weight * src_c3 + blend_weight * BlendFunction::blend(src_c3, dst_c3)) * scale;
+
+        result_c1(emptyPixels) = dst_c1;
+        result_c2(emptyPixels) = dst_c2;
+        result_c3(emptyPixels) = dst_c3;
+
+        dataDest[indexes] = (result_c1, result_c2, result_c3, new_alpha);
+    }
+
+    template <bool haveMask, Vc::Implementation _impl>
+    static ALWAYS_INLINE void compositeOnePixelScalar(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const OptionalParams &oparams)
+    {
+        const qint32 alpha_pos = 3;
+
+        const float *s = reinterpret_cast<const float*>(src);
+        float *d = reinterpret_cast<float*>(dst);
+
+        float srcAlpha = s[alpha_pos] * opacity;
+
+        if (haveMask) {
+            const float uint8Rec1 = 1.0 / 255;
+            srcAlpha *= float(*mask) * uint8Rec1;
+        }
+
+        const float dstAlpha = d[alpha_pos];
+
+        if (!allChannelsFlag && dstAlpha == 0.0) {
+            KoStreamedMathFunctions::clearPixel<16>(dst);
+        }
+
+        const QBitArray &channelFlags = oparams.channelFlags;
+
+        if (alphaLocked) {
+            if (dstAlpha != 0.0) {
+                for (int i = 0; i < alpha_pos; i++) {
+                    if (allChannelsFlag || channelFlags.at(i)) {
+                        d[i] = d[i] + (BlendFunction::blend(s[i], d[i]) - d[i]) * srcAlpha;
+                    }
+                }
+            }
+        } else {
+            float newAlpha = srcAlpha + dstAlpha - srcAlpha * dstAlpha;
+
+            if (newAlpha != 0.0) {
+                const float dstWeight = (1.0f - srcAlpha) * dstAlpha;
+                const float srcWeight = (1.0f - dstAlpha) * srcAlpha;
+                const float blendWeight = srcAlpha * dstAlpha;
+
+                for (int i = 0; i < alpha_pos; i++) {
+                    if (allChannelsFlag || channelFlags.at(i)) {
+                        d[i] = (dstWeight * d[i] + srcWeight * s[i] + blendWeight * BlendFunction::blend(s[i], d[i])) / newAlpha;
+                    }
+                }
+            }
+
+            d[alpha_pos] = newAlpha;
+        }
+    }
+};
+
+/**
+ * An optimized version of KoCompositeOpGenericSC for the use in 16 byte
+ * colorspaces with alpha channel placed at the last position of
+ * the pixel: C1_C2_C3_A.
+ */
+template<Vc::Implementation _impl, class BlendFunction>
+class KoOptimizedCompositeOpGenericSC128 : public KoCompositeOp
+{
+public:
+    KoOptimizedCompositeOpGenericSC128(const KoColorSpace* cs, const QString& id, const QString& description, const QString& category)
+        : KoCompositeOp(cs, id, description, category) {}
+
+    using KoCompositeOp::composite;
+
+    virtual void composite(const KoCompositeOp::ParameterInfo& params) const
+    {
+        if(params.maskRowStart) {
+            composite<true>(params);
+        } else {
+            composite<false>(params);
+        }
+    }
+
+    template <bool haveMask>
+    inline void composite(const KoCompositeOp::ParameterInfo& params) const {
+        /**
+         * The vector version of genericComposite() can replicate
+         * only 4-byte source pixels, so a single-pixel source is
+         * composited with the scalar code
+         */
+        if (params.srcRowStride &&
+            (params.channelFlags.isEmpty() ||
+             params.channelFlags == QBitArray(4, true))) {
+
+            KoStreamedMath<_impl>::template genericComposite128<haveMask, false, GenericSCCompositor128<BlendFunction, false, true> >(params);
+        } else if (params.channelFlags.isEmpty()) {
+            KoStreamedMath<_impl>::template genericComposite128_novector<haveMask, false, GenericSCCompositor128<BlendFunction, false, true> >(params);
+        } else {
+            const bool allChannelsFlag =
+                params.channelFlags.at(0) &&
+                params.channelFlags.at(1) &&
+                params.channelFlags.at(2);
+
+            const bool alphaLocked =
+                !params.channelFlags.at(3);
+
+            if (allChannelsFlag && !alphaLocked) {
+                KoStreamedMath<_impl>::template genericComposite128_novector<haveMask, false, GenericSCCompositor128<BlendFunction, false, true> >(params);
+            } else if (allChannelsFlag && alphaLocked) {
+                KoStreamedMath<_impl>::template genericComposite128_novector<haveMask, false, GenericSCCompositor128<BlendFunction, true, true> >(params);
+            } else if (!allChannelsFlag && !alphaLocked) {
+                KoStreamedMath<_impl>::template genericComposite128_novector<haveMask, false, GenericSCCompositor128<BlendFunction, false, false> >(params);
+            } else /*if (!allChannelsFlag && alphaLocked) */{
+                KoStreamedMath<_impl>::template genericComposite128_novector<haveMask, false, GenericSCCompositor128<BlendFunction, true, false> >(params);
+            }
+        }
+    }
+};
+
+#endif // KOOPTIMIZEDCOMPOSITEOPGENERICSC128_H_
@@ -0,0 +1,239 @@
+/*
+ *  Copyright (c) 2015 Calligra developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KOOPTIMIZEDCOMPOSITEOPGENERICSC32_H_
+#define KOOPTIMIZEDCOMPOSITEOPGENERICSC32_H_
+
+#include "KoCompositeOpBase.h"
+#include "KoCompositeOpRegistry.h"
+#include "KoStreamedMath.h"
+#include "KoStreamedBlendFunctions.h"
+
+
+/**
+ * A vectorized equivalent of KoCompositeOpGenericSC for 4 byte
+ * colorspaces with alpha channel placed at the last byte of the
+ * pixel: C1_C2_C3_A.
+ *
+ * All the math is done in floating point with the channels
+ * normalized to [0.0, 1.0]. The result of the blending function is
+ * clamped to this range, like the integer scalar functions do.
+ */
+template<class BlendFunction, bool alphaLocked, bool allChannelsFlag>
+struct GenericSCCompositor32 {
+    struct OptionalParams {
+        OptionalParams(const KoCompositeOp::ParameterInfo& params)
+            : channelFlags(params.channelFlags)
+        {
+        }
+        const QBitArray &channelFlags;
+    };
+
+    static ALWAYS_INLINE Vc::float_v blendClamped(Vc::float_v::AsArg src, Vc::float_v::AsArg dst) {
+        const Vc::float_v zeroValue(Vc::Zero);
+        const Vc::float_v oneValue(Vc::One);
+        return Vc::max(zeroValue, Vc::min(oneValue, BlendFunction::blend(src, dst)));
+    }
+
+    static ALWAYS_INLINE float blendClamped(float src, float dst) {
+        return qBound(0.0f, BlendFunction::blend(src, dst), 1.0f);
+    }
+
+    // \see docs in AlphaDarkenCompositor32
+    template<bool haveMask, bool src_aligned, Vc::Implementation _impl>
+    static ALWAYS_INLINE void compositeVector(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const OptionalParams &oparams)
+    {
+        Q_UNUSED(oparams);
+
+        const Vc::float_v uint8Max((float)255.0);
+        const Vc::float_v uint8MaxRec1((float)1.0 / 255.0);
+        const Vc::float_v zeroValue(Vc::Zero);
+        const Vc::float_v oneValue(Vc::One);
+
+        Vc::float_v src_alpha = KoStreamedMath<_impl>::template fetch_alpha_32<src_aligned>(src);
+        src_alpha *= Vc::float_v(opacity) * uint8MaxRec1;
+
+        if (haveMask) {
+            Vc::float_v mask_vec = KoStreamedMath<_impl>::fetch_mask_8(mask);
+            src_alpha *= mask_vec * uint8MaxRec1;
+        }
+
+        // The source cannot change the colors in the destination,
+        // since its fully transparent
+        if ((src_alpha == zeroValue).isFull()) {
+            return;
+        }
+
+        Vc::float_v dst_alpha = KoStreamedMath<_impl>::template fetch_alpha_32<true>(dst);
+        dst_alpha *= uint8MaxRec1;
+
+        Vc::float_v src_c1;
+        Vc::float_v src_c2;
+        Vc::float_v src_c3;
+
+        Vc::float_v dst_c1;
+        Vc::float_v dst_c2;
+        Vc::float_v dst_c3;
+
+        KoStreamedMath<_impl>::template fetch_colors_32<src_aligned>(src, src_c1, src_c2, src_c3);
+        KoStreamedMath<_impl>::template fetch_colors_32<true>(dst, dst_c1, dst_c2, dst_c3);
+
+        src_c1 *= uint8MaxRec1;
+        src_c2 *= uint8MaxRec1;
+        src_c3 *= uint8MaxRec1;
+
+        dst_c1 *= uint8MaxRec1;
+        dst_c2 *= uint8MaxRec1;
+        dst_c3 *= uint8MaxRec1;
+
+        /**
+         * This is the vector form of Arithmetic::blend():
+         *
+         * dst = (1 - Sa) * Da * D + (1 - Da) * Sa * S + Da * Sa * f(S, D)
+         */
+        const Vc::float_v new_alpha = src_alpha + dst_alpha - src_alpha * dst_alpha;
+        const Vc::float_v dst_weight = (oneValue - src_alpha) * dst_alpha;
+        const Vc::float_v src_weight = (oneValue - dst_alpha) * src_alpha;
+        const Vc::float_v blend_weight = src_alpha * dst_alpha;
+
+        /**
+         * The value of new_alpha can have *some* zero values, which
+         * would result in NaN values while division. The scalar version
+         * keeps the color of such pixels untouched, so do we.
+         */
+        const Vc::float_m emptyPixels = new_alpha == zeroValue;
+        const Vc::float_v scale = uint8Max / new_alpha;
+
+        Vc::float_v result_c1 = (dst_weight * dst_c1 + src_weight * src_c1 + blend_weight * blendClamped(src_c1, dst_c1)) * scale;
+        Vc::float_v result_c2 = (dst_weight * dst_c2 + src_weight * src_c2 + blend_weight * blendClamped(src_c2, dst_c2)) * scale;
+        Vc::float_v result_c3 = (dst_weight * dst_c3 + src_weight * src_c3 + blend_weight * blendClamped(src_c3, dst_c3)) * scale;
+
+        result_c1(emptyPixels) = dst_c1 * uint8Max;
+        result_c2(emptyPixels) = dst_c2 * uint8Max;
+        result_c3(emptyPixels) = dst_c3 * uint8Max;
+
+        KoStreamedMath<_impl>::write_channels_32(dst, new_alpha * uint8Max, result_c1, result_c2, result_c3);
+    }
+
+    template <bool haveMask, Vc::Implementation _impl>
+    static ALWAYS_INLINE void compositeOnePixelScalar(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const OptionalParams &oparams)
+    {
+        const qint32 alpha_pos = 3;
+        const float uint8Rec1 = 1.0 / 255.0;
+        const float uint8Max = 255.0;
+
+        float srcAlpha = src[alpha_pos] * uint8Rec1 * opacity;
+
+        if (haveMask) {
+            srcAlpha *= float(*mask) * uint8Rec1;
+        }
+
+        float dstAlpha = dst[alpha_pos] * uint8Rec1;
+
+        if (!allChannelsFlag && dst[alpha_pos] == 0) {
+            KoStreamedMathFunctions::clearPixel<4>(dst);
+        }
+
+        const QBitArray &channelFlags = oparams.channelFlags;
+
+        if (alphaLocked) {
+            if (dstAlpha != 0.0) {
+                for (int i = 0; i < alpha_pos; i++) {
+                    if (allChannelsFlag || channelFlags.at(i)) {
+                        float s = src[i] * uint8Rec1;
+                        float d = dst[i] * uint8Rec1;
+                        float result = d + (blendClamped(s, d) - d) * srcAlpha;
+                        dst[i] = KoStreamedMath<_impl>::round_float_to_uint(result * uint8Max);
+                    }
+                }
+            }
+        } else {
+            float newAlpha = srcAlpha + dstAlpha - srcAlpha * dstAlpha;
+
+            if (newAlpha != 0.0) {
+                const float dstWeight = (1.0f - srcAlpha) * dstAlpha;
+                const float srcWeight = (1.0f - dstAlpha) * srcAlpha;
+                const float blendWeight = srcAlpha * dstAlpha;
+                const float scale = uint8Max / newAlpha;
+
+                for (int i = 0; i < alpha_pos; i++) {
+                    if (allChannelsFlag || channelFlags.at(i)) {
+                        float s = src[i] * uint8Rec1;
+                        float d = dst[i] * uint8Rec1;
+                        float result = (dstWeight * d + srcWeight * s + blendWeight * blendClamped(s, d)) * scale;
+                        dst[i] = KoStreamedMath<_impl>::round_float_to_uint(result);
+                    }
+                }
+            }
+
+            dst[alpha_pos] = KoStreamedMath<_impl>::round_float_to_uint(newAlpha * uint8Max);
+        }
+    }
+};
+
+/**
+ * An optimized version of KoCompositeOpGenericSC for the use in 4 byte
+ * colorspaces with alpha channel placed at the last byte of
+ * the pixel: C1_C2_C3_A.
+ */
+template<Vc::Implementation _impl, class BlendFunction>
+class KoOptimizedCompositeOpGenericSC32 : public KoCompositeOp
+{
+public:
+    KoOptimizedCompositeOpGenericSC32(const KoColorSpace* cs, const QString& id, const QString& description, const QString& category)
+        : KoCompositeOp(cs, id, description, category) {}
+
+    using KoCompositeOp::composite;
+
+    virtual void composite(const KoCompositeOp::ParameterInfo& params) const
+    {
+        if(params.maskRowStart) {
+            composite<true>(params);
+        } else {
+            composite<false>(params);
+        }
+    }
+
+    template <bool haveMask>
+    inline void composite(const KoCompositeOp::ParameterInfo& params) const {
+        if (params.channelFlags.isEmpty() ||
+            params.channelFlags == QBitArray(4, true)) {
+
+            KoStreamedMath<_impl>::template genericComposite32<haveMask, false, GenericSCCompositor32<BlendFunction, false, true> >(params);
+        } else {
+            const bool allChannelsFlag =
+                params.channelFlags.at(0) &&
+                params.channelFlags.at(1) &&
+                params.channelFlags.at(2);
+
+            const bool alphaLocked =
+                !params.channelFlags.at(3);
+
+            if (allChannelsFlag && alphaLocked) {
+                KoStreamedMath<_impl>::template genericComposite32_novector<haveMask, false, GenericSCCompositor32<BlendFunction, true, true> >(params);
+            } else if (!allChannelsFlag && !alphaLocked) {
+                KoStreamedMath<_impl>::template genericComposite32_novector<haveMask, false, GenericSCCompositor32<BlendFunction, false, false> >(params);
+            } else /*if (!allChannelsFlag && alphaLocked) */{
+                KoStreamedMath<_impl>::template genericComposite32_novector<haveMask, false, GenericSCCompositor32<BlendFunction, true, false> >(params);
+            }
+        }
+    }
+};
+
+#endif // KOOPTIMIZEDCOMPOSITEOPGENERICSC32_H_
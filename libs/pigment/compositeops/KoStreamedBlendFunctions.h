@@ -0,0 +1,160 @@
+/*
+ *  Copyright (c) 2015 Calligra developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __KOSTREAMED_BLEND_FUNCTIONS_H
+#define __KOSTREAMED_BLEND_FUNCTIONS_H
+
+#include <Vc/Vc>
+
+#include <QtGlobal>
+#include <KoAlwaysInline.h>
+
+/**
+ * Vectorized versions of the separable blending functions from
+ * KoCompositeOpFunctions.h. All the functions work on channel values
+ * normalized to the [0.0, 1.0] range. They do *not* clamp the
+ * result, the 8-bit compositor does it itself, while the floating
+ * point one keeps the out-of-range values just like the scalar
+ * functions do for float channels.
+ *
+ * Every function has a scalar overload that is used by the
+ * compositors for the unaligned heads and tails of the rows.
+ */
+
+struct KoStreamedBlendMultiply {
+    static ALWAYS_INLINE float blend(float src, float dst) {
+        return src * dst;
+    }
+
+    static ALWAYS_INLINE Vc::float_v blend(Vc::float_v::AsArg src, Vc::float_v::AsArg dst) {
+        return src * dst;
+    }
+};
+
+struct KoStreamedBlendScreen {
+    static ALWAYS_INLINE float blend(float src, float dst) {
+        return src + dst - src * dst;
+    }
+
+    static ALWAYS_INLINE Vc::float_v blend(Vc::float_v::AsArg src, Vc::float_v::AsArg dst) {
+        return src + dst - src * dst;
+    }
+};
+
+struct KoStreamedBlendHardLight {
+    static ALWAYS_INLINE float blend(float src, float dst) {
+        float src2 = src + src;
+
+        if (src > 0.5f) {
+            // screen(src*2.0 - 1.0, dst)
+            src2 -= 1.0f;
+            return src2 + dst - src2 * dst;
+        }
+
+        // multiply(src*2.0, dst)
+        return src2 * dst;
+    }
+
+    static ALWAYS_INLINE Vc::float_v blend(Vc::float_v::AsArg src, Vc::float_v::AsArg dst) {
+        const Vc::float_v oneValue(Vc::One);
+        const Vc::float_v halfValue(0.5f);
+
+        Vc::float_v src2 = src + src;
+        Vc::float_v result = src2 * dst;
+
+        src2 -= oneValue;
+        result(src > halfValue) = src2 + dst - src2 * dst;
+
+        return result;
+    }
+};
+
+struct KoStreamedBlendOverlay {
+    static ALWAYS_INLINE float blend(float src, float dst) {
+        return KoStreamedBlendHardLight::blend(dst, src);
+    }
+
+    static ALWAYS_INLINE Vc::float_v blend(Vc::float_v::AsArg src, Vc::float_v::AsArg dst) {
+        return KoStreamedBlendHardLight::blend(dst, src);
+    }
+};
+
+struct KoStreamedBlendAddition {
+    static ALWAYS_INLINE float blend(float src, float dst) {
+        return src + dst;
+    }
+
+    static ALWAYS_INLINE Vc::float_v blend(Vc::float_v::AsArg src, Vc::float_v::AsArg dst) {
+        return src + dst;
+    }
+};
+
+struct KoStreamedBlendSubtract {
+    static ALWAYS_INLINE float blend(float src, float dst) {
+        return dst - src;
+    }
+
+    static ALWAYS_INLINE Vc::float_v blend(Vc::float_v::AsArg src, Vc::float_v::AsArg dst) {
+        return dst - src;
+    }
+};
+
+struct KoStreamedBlendDifference {
+    static ALWAYS_INLINE float blend(float src, float dst) {
+        return qAbs(src - dst);
+    }
+
+    static ALWAYS_INLINE Vc::float_v blend(Vc::float_v::AsArg src, Vc::float_v::AsArg dst) {
+        return Vc::abs(src - dst);
+    }
+};
+
+struct KoStreamedBlendExclusion {
+    static ALWAYS_INLINE float blend(float src, float dst) {
+        float x = src * dst;
+        return dst + src - (x + x);
+    }
+
+    static ALWAYS_INLINE Vc::float_v blend(Vc::float_v::AsArg src, Vc::float_v::AsArg dst) {
+        Vc::float_v x = src * dst;
+        return dst + src - (x + x);
+    }
+};
+
+struct KoStreamedBlendDarken {
+    static ALWAYS_INLINE float blend(float src, float dst) {
+        return qMin(src, dst);
+    }
+
+    static ALWAYS_INLINE Vc::float_v blend(Vc::float_v::AsArg src, Vc::float_v::AsArg dst) {
+        return Vc::min(src, dst);
+    }
+};
+
+struct KoStreamedBlendLighten {
+    static ALWAYS_INLINE float blend(float src, float dst) {
+        return qMax(src, dst);
+    }
+
+    static ALWAYS_INLINE Vc::float_v blend(Vc::float_v::AsArg src, Vc::float_v::AsArg dst) {
+        return Vc::max(src, dst);
+    }
+};
+
+#endif /* __KOSTREAMED_BLEND_FUNCTIONS_H */
@@ -198,6 +198,8 @@ bool KoPattern::save()
 
 bool KoPattern::saveToDevice(QIODevice *dev) const
 {
+    ensureLoaded();
+
     QString fileExtension;
     int index = filename().lastIndexOf('.');
 
@@ -356,11 +358,13 @@ bool KoPattern::init(QByteArray& bytes)
 
 qint32 KoPattern::width() const
 {
+    ensureLoaded();
     return m_pattern.width();
 }
 
 qint32 KoPattern::height() const
 {
+    ensureLoaded();
     return m_pattern.height();
 }
 
@@ -384,6 +388,11 @@ QString KoPattern::defaultFileExtension() const
     return QString(".pat");
 }
 
+bool KoPattern::supportsLazyLoading() const
+{
+    return true;
+}
+
 KoPattern* KoPattern::clone() const
 {
     KoPattern* pat = new KoPattern(filename());
@@ -394,6 +403,7 @@ KoPattern* KoPattern::clone() const
 
 QImage KoPattern::pattern() const
 {
+    ensureLoaded();
     return m_pattern;
 }
 
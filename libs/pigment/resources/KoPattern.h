@@ -54,6 +54,8 @@ public:
 
     QString defaultFileExtension() const;
 
+    bool supportsLazyLoading() const;
+
     KoPattern& operator=(const KoPattern& pattern);
 
     KoPattern* clone() const;
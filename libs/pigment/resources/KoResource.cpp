@@ -23,17 +23,57 @@
 #include <QFileInfo>
 #include <QDebug>
 #include <QImage>
+#include <QMutex>
+#include <QMutexLocker>
 
 #include "KoHashGenerator.h"
 #include "KoHashGeneratorProvider.h"
 
 struct Q_DECL_HIDDEN KoResource::Private {
+    enum LoadingState {
+        Loaded = 0,
+        NeedsLoading,
+        Loading
+    };
+
+    Private()
+        : valid(false),
+          removable(false),
+          loadingState(Loaded),
+          loadingLock(QMutex::Recursive)
+    {
+    }
+
+    Private(const Private &rhs)
+        : name(rhs.name),
+          filename(rhs.filename),
+          valid(rhs.valid),
+          removable(rhs.removable),
+          md5(rhs.md5),
+          image(rhs.image),
+          loadingState(rhs.loadingState.load()),
+          loadingLock(QMutex::Recursive)
+    {
+    }
+
     QString name;
     QString filename;
     bool valid;
     bool removable;
     QByteArray md5;
     QImage image;
+
+    /**
+     * A lazy load rewrites the data of a resource that is already shown
+     * in the GUI. While a load may be in progress, the accessors take the
+     * loading lock, so they never see the data half rewritten.
+     */
+    QMutex* lockForAccess() {
+        return loadingState.loadAcquire() != Loaded ? &loadingLock : 0;
+    }
+
+    QAtomicInt loadingState;
+    QMutex loadingLock;
 };
 
 KoResource::KoResource(const QString& filename)
@@ -65,16 +105,19 @@ bool KoResource::saveToDevice(QIODevice *dev) const
 
 QImage KoResource::image() const
 {
+    QMutexLocker l(d->lockForAccess());
     return d->image;
 }
 
 void KoResource::setImage(const QImage &image)
 {
+    QMutexLocker l(d->lockForAccess());
     d->image = image;
 }
 
 QByteArray KoResource::md5() const
 {
+    QMutexLocker l(d->lockForAccess());
     if (d->md5.isEmpty()) {
         const_cast<KoResource*>(this)->setMD5(generateMD5());
     }
@@ -83,6 +126,7 @@ QByteArray KoResource::md5() const
 
 void KoResource::setMD5(const QByteArray &md5)
 {
+    QMutexLocker l(d->lockForAccess());
     d->md5 = md5;
 }
 
@@ -112,21 +156,25 @@ QString KoResource::shortFilename() const
 
 QString KoResource::name() const
 {
+    QMutexLocker l(d->lockForAccess());
     return d->name;
 }
 
 void KoResource::setName(const QString& name)
 {
+    QMutexLocker l(d->lockForAccess());
     d->name = name;
 }
 
 bool KoResource::valid() const
 {
+    QMutexLocker l(d->lockForAccess());
     return d->valid;
 }
 
 void KoResource::setValid(bool valid)
 {
+    QMutexLocker l(d->lockForAccess());
     d->valid = valid;
 }
 
@@ -140,3 +188,47 @@ QString KoResource::defaultFileExtension() const
     return QString();
 }
 
+bool KoResource::supportsLazyLoading() const
+{
+    return false;
+}
+
+bool KoResource::ensureLoaded() const
+{
+    if (d->loadingState.loadAcquire() == Private::Loaded) {
+        return d->valid;
+    }
+
+    QMutexLocker l(&d->loadingLock);
+
+    /**
+     * The lock is recursive, so the accessors called by load() itself
+     * come here in the Loading state and just pass through
+     */
+    if (d->loadingState.load() == Private::NeedsLoading) {
+        d->loadingState.store(Private::Loading);
+
+        // the name might have been made unique by the resource server
+        const QString indexedName = d->name;
+
+        KoResource *self = const_cast<KoResource*>(this);
+        if (!self->load() || !d->valid) {
+            qWarning() << "Failed to load the indexed resource" << d->filename;
+            d->valid = false;
+        }
+
+        if (!indexedName.isEmpty()) {
+            d->name = indexedName;
+        }
+
+        d->loadingState.storeRelease(Private::Loaded);
+    }
+
+    return d->valid;
+}
+
+void KoResource::setNeedsLoading()
+{
+    d->loadingState.storeRelease(Private::NeedsLoading);
+}
+
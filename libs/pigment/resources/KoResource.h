@@ -27,6 +27,7 @@
 
 class QDomDocument;
 class QDomElement;
+class KoResourceIndex;
 
 /**
  * The KoResource class provides a representation of resources.  This
@@ -97,6 +98,22 @@ public:
     /// @return the default file extension which should be used when saving the resource
     virtual QString defaultFileExtension() const;
 
+    /**
+     * @return true if the resource can be registered from the data stored
+     * in KoResourceIndex without decoding the file. Such a resource must
+     * call ensureLoaded() before accessing its own data.
+     */
+    virtual bool supportsLazyLoading() const;
+
+    /**
+     * Decodes the file of a resource restored from KoResourceIndex. Does
+     * nothing if the resource has already been loaded. The method is
+     * thread-safe.
+     *
+     * @return true if the resource is valid
+     */
+    bool ensureLoaded() const;
+
 protected:
 
     /// override generateMD5 and in your resource subclass
@@ -108,6 +125,10 @@ protected:
 protected:
     KoResource(const KoResource &rhs);
 
+private:
+    friend class KoResourceIndex;
+    void setNeedsLoading();
+
 private:
     struct Private;
     Private* const d;
@@ -0,0 +1,251 @@
+/*  This file is part of the KDE project
+    Copyright (c) 2015 Calligra developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "KoResourceIndex.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+
+#include "KoResource.h"
+
+// found by ADL from the QList streaming operators, so not in the anonymous namespace
+static QDataStream& operator<<(QDataStream &stream, const KoResourceIndex::Record &record)
+{
+    stream << record.name << record.md5 << record.thumbnail;
+    return stream;
+}
+
+static QDataStream& operator>>(QDataStream &stream, KoResourceIndex::Record &record)
+{
+    stream >> record.name >> record.md5 >> record.thumbnail;
+    return stream;
+}
+
+namespace {
+
+const quint32 indexMagic = 0x4b524958; // "KRIX"
+const quint32 indexVersion = 2;
+
+/**
+ * The thumbnails are shown by the resource choosers only, so there is
+ * no need to keep, say, a full size pattern in the index
+ */
+const int maxThumbnailSize = 256;
+
+struct Entry {
+    Entry() : lastModified(0), size(0) {}
+
+    qint64 lastModified;
+    qint64 size;
+    QList<KoResourceIndex::Record> records;
+};
+
+QDataStream& operator<<(QDataStream &stream, const Entry &entry)
+{
+    stream << entry.lastModified << entry.size << entry.records;
+    return stream;
+}
+
+QDataStream& operator>>(QDataStream &stream, Entry &entry)
+{
+    stream >> entry.lastModified >> entry.size >> entry.records;
+    return stream;
+}
+
+}
+
+struct Q_DECL_HIDDEN KoResourceIndex::Private
+{
+    Private() : modified(false) {}
+
+    QString indexFile;
+    QString environment;
+    QHash<QString, Entry> entries;
+    bool modified;
+    mutable QMutex mutex;
+};
+
+KoResourceIndex::KoResourceIndex(const QString &indexFile)
+    : d(new Private)
+{
+    d->indexFile = indexFile;
+}
+
+KoResourceIndex::~KoResourceIndex()
+{
+    delete d;
+}
+
+void KoResourceIndex::setEnvironment(const QString &environment)
+{
+    QMutexLocker l(&d->mutex);
+    d->environment = environment;
+}
+
+void KoResourceIndex::load()
+{
+    QMutexLocker l(&d->mutex);
+
+    d->entries.clear();
+    d->modified = false;
+
+    QFile file(d->indexFile);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_3);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    stream >> magic >> version;
+
+    if (magic != indexMagic || version != indexVersion) {
+        return;
+    }
+
+    QString environment;
+    stream >> environment >> d->entries;
+
+    if (stream.status() != QDataStream::Ok) {
+        qWarning() << "The resource index is corrupted:" << d->indexFile;
+        d->entries.clear();
+        return;
+    }
+
+    /**
+     * A file may have failed to load because of a missing plugin,
+     * e.g. a preset of a paintop that was not installed, so give
+     * it another chance when the plugins have changed
+     */
+    if (environment != d->environment) {
+        QHash<QString, Entry>::iterator it = d->entries.begin();
+        while (it != d->entries.end()) {
+            if (it->records.isEmpty()) {
+                it = d->entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        d->modified = true;
+    }
+}
+
+bool KoResourceIndex::save()
+{
+    QMutexLocker l(&d->mutex);
+
+    if (!d->modified) return true;
+
+    QHash<QString, Entry>::iterator it = d->entries.begin();
+    while (it != d->entries.end()) {
+        if (!QFileInfo(it.key()).exists()) {
+            it = d->entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    QDir().mkpath(QFileInfo(d->indexFile).absolutePath());
+
+    QSaveFile file(d->indexFile);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Cannot write the resource index:" << d->indexFile;
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_3);
+    stream << indexMagic << indexVersion << d->environment << d->entries;
+
+    if (stream.status() != QDataStream::Ok || !file.commit()) {
+        qWarning() << "Cannot write the resource index:" << d->indexFile;
+        return false;
+    }
+
+    d->modified = false;
+
+    return true;
+}
+
+bool KoResourceIndex::isUpToDate(const QString &filename) const
+{
+    QMutexLocker l(&d->mutex);
+
+    QHash<QString, Entry>::const_iterator it = d->entries.constFind(filename);
+    if (it == d->entries.constEnd()) return false;
+
+    const QFileInfo fileInfo(filename);
+
+    return fileInfo.lastModified().toMSecsSinceEpoch() == it->lastModified &&
+        fileInfo.size() == it->size;
+}
+
+QList<KoResourceIndex::Record> KoResourceIndex::records(const QString &filename) const
+{
+    QMutexLocker l(&d->mutex);
+    return d->entries.value(filename).records;
+}
+
+void KoResourceIndex::setRecords(const QString &filename, const QList<Record> &records)
+{
+    const QFileInfo fileInfo(filename);
+
+    Entry entry;
+    entry.lastModified = fileInfo.lastModified().toMSecsSinceEpoch();
+    entry.size = fileInfo.size();
+    entry.records = records;
+
+    QMutexLocker l(&d->mutex);
+    d->entries.insert(filename, entry);
+    d->modified = true;
+}
+
+KoResourceIndex::Record KoResourceIndex::createRecord(const KoResource *resource)
+{
+    Record record;
+    record.name = resource->name();
+    record.md5 = resource->md5();
+
+    const QImage image = resource->image();
+    if (image.width() > maxThumbnailSize || image.height() > maxThumbnailSize) {
+        record.thumbnail = image.scaled(maxThumbnailSize, maxThumbnailSize,
+                                        Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    } else {
+        record.thumbnail = image;
+    }
+
+    return record;
+}
+
+void KoResourceIndex::restore(KoResource *resource, const Record &record)
+{
+    resource->setName(record.name);
+    resource->setMD5(record.md5);
+    resource->setImage(record.thumbnail);
+    resource->setValid(true);
+    resource->setNeedsLoading();
+}
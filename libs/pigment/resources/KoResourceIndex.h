@@ -0,0 +1,114 @@
+/*  This file is part of the KDE project
+    Copyright (c) 2015 Calligra developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef KORESOURCEINDEX_H
+#define KORESOURCEINDEX_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QList>
+#include <QString>
+
+#include <pigment_export.h>
+
+class KoResource;
+
+/**
+ * KoResourceIndex is a persistent index of the metadata of the resource
+ * files: the name, the md5 and the thumbnail of every resource a file
+ * contains. The entries are keyed by the path of the file and are used
+ * only while the modification time and the size of the file stay the
+ * same.
+ *
+ * The resource server restores the resources that support lazy loading
+ * from the index without decoding their files, and skips the files that
+ * failed to load last time.
+ *
+ * All the methods are thread-safe.
+ */
+class PIGMENTCMS_EXPORT KoResourceIndex
+{
+public:
+    struct Record {
+        QString name;
+        QByteArray md5;
+        QImage thumbnail;
+    };
+
+    /**
+     * @param indexFile the file the index is read from and written to
+     */
+    explicit KoResourceIndex(const QString &indexFile);
+    ~KoResourceIndex();
+
+    /**
+     * Sets a description of the plugins the resources depend on. The
+     * entries of the files that failed to load are dropped by load(), if
+     * they were recorded with another environment. Call it before load().
+     */
+    void setEnvironment(const QString &environment);
+
+    /**
+     * Reads the index file. A missing or outdated file gives an empty index.
+     */
+    void load();
+
+    /**
+     * Writes the index file if the index has been changed. The entries
+     * of the files that do not exist anymore are dropped. The old file
+     * is replaced only after the new one has been written completely.
+     */
+    bool save();
+
+    /**
+     * @return true if the index has an entry for \p filename recorded
+     * with the current modification time and size of the file
+     */
+    bool isUpToDate(const QString &filename) const;
+
+    /**
+     * @return the records of \p filename. An empty list means the file
+     * has no valid resources.
+     */
+    QList<Record> records(const QString &filename) const;
+
+    /**
+     * Replaces the entry of \p filename, the modification time and the
+     * size are taken from the file
+     */
+    void setRecords(const QString &filename, const QList<Record> &records);
+
+    /**
+     * @return the record describing the loaded \p resource
+     */
+    static Record createRecord(const KoResource *resource);
+
+    /**
+     * Fills \p resource with the data of \p record without decoding the
+     * file. The resource decodes the file on the first access to its
+     * data, \see KoResource::ensureLoaded().
+     */
+    static void restore(KoResource *resource, const Record &record);
+
+private:
+    Q_DISABLE_COPY(KoResourceIndex)
+
+    struct Private;
+    Private * const d;
+};
+
+#endif // KORESOURCEINDEX_H
@@ -37,6 +37,7 @@
 #include <QTemporaryFile>
 #include <QDomDocument>
 #include "KoResource.h"
+#include "KoResourceIndex.h"
 #include "KoResourceServerPolicies.h"
 #include "KoResourceServerObserver.h"
 #include "KoResourceTagStore.h"
@@ -68,6 +69,20 @@ public:
 
     virtual int resourceCount() const = 0;
     virtual void loadResources(QStringList filenames) = 0;
+
+    /**
+     * Checks the files of the resources restored from the resource index
+     * by loadResources() and drops the outdated index entries. The files
+     * are decoded into separate resources, the registered ones are left
+     * untouched. Meant to be run in the background after the resources
+     * were loaded, returns early if cancelValidation() is called.
+     */
+    virtual void validateResources() = 0;
+
+    void cancelValidation() {
+        m_validationCancelled.ref();
+    }
+
     virtual QStringList blackListedFiles() const = 0;
     virtual QStringList queryResources(const QString &query) const = 0;
     QString type() const { return m_type; }
@@ -103,6 +118,7 @@ private:
 protected:
 
     QMutex m_loadLock;
+    QAtomicInt m_validationCancelled;
 
 };
 
@@ -140,6 +156,9 @@ public:
         m_blackListFileNames = readBlackListFile();
         m_tagStore = new KoResourceTagStore(this);
         m_tagStore->loadTags();
+
+        m_index = new KoResourceIndex(KStandardDirs::locateLocal("data", "krita/" + type + ".index"));
+        m_indexLoaded = false;
     }
 
     virtual ~KoResourceServer()
@@ -148,6 +167,8 @@ public:
             delete m_tagStore;
         }
 
+        delete m_index;
+
         foreach(ObserverType* observer, m_observers) {
             observer->unsetResourceServer();
         }
@@ -164,14 +185,34 @@ public:
         return m_resources.size();
     }
 
+    /**
+     * Sets a description of the plugins the resources depend on, e.g.
+     * the paintop ids for the presets. The files that failed to load
+     * with another set of plugins are tried again. Must be called
+     * before loadResources().
+     */
+    void setIndexEnvironment(const QString &environment) {
+        m_index->setEnvironment(environment);
+    }
+
     /**
      * Loads a set of resources and adds them to the resource server.
      * If a filename appears twice the resource will only be added once. Resources that can't
      * be loaded or and invalid aren't added to the server.
+     *
+     * The files unchanged since the last run are not decoded if the resource supports
+     * lazy loading, the resource is restored from the resource index instead. The files
+     * that failed to load last time are skipped.
+     *
      * @param filenames list of filenames to be loaded
      */
     void loadResources(QStringList filenames) {
 
+        if (!m_indexLoaded) {
+            m_index->load();
+            m_indexLoaded = true;
+        }
+
         QStringList uniqueFiles;
 
         while (!filenames.empty()) {
@@ -195,10 +236,26 @@ public:
             if (!uniqueFiles.contains(fname)) {
                 m_loadLock.lock();
                 uniqueFiles.append(fname);
-                QList<PointerType> resources = createResources(front);
+
+                QList<PointerType> resources;
+                const bool isIndexed = m_index->isUpToDate(front);
+                const bool isRestored = isIndexed && restoreResource(front, &resources);
+
+                if (isIndexed && !isRestored && m_index->records(front).isEmpty()) {
+                    kWarning() << "Skipping resource" << front << "that failed to load before";
+                    m_loadLock.unlock();
+                    continue;
+                }
+
+                if (!isRestored) {
+                    resources = createResources(front);
+                }
+
+                QList<KoResourceIndex::Record> records;
+
                 foreach(PointerType resource, resources) {
                     Q_CHECK_PTR(resource);
-                    if (resource->load() && resource->valid() && !resource->md5().isEmpty()) {
+                    if ((isRestored || resource->load()) && resource->valid() && !resource->md5().isEmpty()) {
                         QByteArray md5 = resource->md5();
                         m_resourcesByMd5[md5] = resource;
 
@@ -211,6 +268,14 @@ public:
                             resource->setName(resource->name() + "(" + resource->shortFilename() + ")");
                         }
                         m_resourcesByName[resource->name()] = resource;
+
+                        if (isRestored) {
+                            QMutexLocker l(&m_lazyLock);
+                            m_lazyFiles.append(resource->filename());
+                        } else {
+                            records.append(KoResourceIndex::createRecord(Policy::toResourcePointer(resource)));
+                        }
+
                         notifyResourceAdded(resource);
                     }
                     else {
@@ -218,6 +283,11 @@ public:
                         Policy::deleteResource(resource);
                     }
                 }
+
+                if (!isRestored) {
+                    m_index->setRecords(front, records);
+                }
+
                 m_loadLock.unlock();
             }
         }
@@ -228,9 +298,54 @@ public:
             observer->syncTaggedResourceView();
         }
 
+        m_index->save();
+
         kDebug(30009) << "done loading  resources for type " << type();
     }
 
+    void validateResources() {
+        QStringList lazyFiles;
+
+        {
+            QMutexLocker l(&m_lazyLock);
+            lazyFiles = m_lazyFiles;
+        }
+
+        foreach(const QString &filename, lazyFiles) {
+            if (m_validationCancelled.load()) break;
+
+            {
+                QMutexLocker l(&m_lazyLock);
+
+                // the resource might have been removed by the user in the meantime
+                if (!m_lazyFiles.removeOne(filename)) continue;
+            }
+
+            /**
+             * The registered resource is shown in the GUI already, so it is
+             * not touched here, it decodes itself on its first use. A
+             * separate copy of it is decoded to check the indexed record.
+             */
+            const QList<KoResourceIndex::Record> records = m_index->records(filename);
+            PointerType resource = createResource(filename);
+            const bool isValid = resource && resource->load() && resource->valid() &&
+                records.size() == 1 && resource->md5() == records.first().md5;
+
+            if (!isValid) {
+                kWarning() << "Indexed resource" << filename << "is not valid anymore";
+                m_index->setRecords(filename, QList<KoResourceIndex::Record>());
+            }
+
+            if (resource) {
+                Policy::deleteResource(resource);
+            }
+        }
+
+        m_index->save();
+
+        kDebug(30009) << "done validating resources for type " << type();
+    }
+
 
     /// Adds an already loaded resource to the server
     bool addResource(PointerType resource, bool save = true, bool infront = false) {
@@ -312,6 +427,7 @@ public:
         m_resourcesByFilename.remove(resource->shortFilename());
         m_resources.removeAt(m_resources.indexOf(resource));
         m_tagStore->removeResource(resource);
+        forgetLazyResource(resource);
         notifyRemovingResource(resource);
 
         Policy::deleteResource(resource);
@@ -330,6 +446,7 @@ public:
         m_resourcesByFilename.remove(resource->shortFilename());
         m_resources.removeAt(m_resources.indexOf(resource));
         m_tagStore->removeResource(resource);
+        forgetLazyResource(resource);
         notifyRemovingResource(resource);
 
         m_blackListFileNames.append(resource->filename());
@@ -582,6 +699,34 @@ public:
 
 protected:
 
+    /**
+     * Creates the resource of \p filename from the data stored in the
+     * resource index, if the resource supports lazy loading
+     */
+    bool restoreResource(const QString &filename, QList<PointerType> *resources)
+    {
+        const QList<KoResourceIndex::Record> records = m_index->records(filename);
+        if (records.size() != 1) return false;
+
+        PointerType resource = createResource(filename);
+        if (!resource) return false;
+
+        if (!resource->supportsLazyLoading()) {
+            Policy::deleteResource(resource);
+            return false;
+        }
+
+        KoResourceIndex::restore(Policy::toResourcePointer(resource), records.first());
+        resources->append(resource);
+        return true;
+    }
+
+    void forgetLazyResource(PointerType resource)
+    {
+        QMutexLocker l(&m_lazyLock);
+        m_lazyFiles.removeOne(resource->filename());
+    }
+
     void notifyResourceAdded(PointerType resource)
     {
         foreach(ObserverType* observer, m_observers) {
@@ -698,6 +843,12 @@ private:
     QStringList m_blackListFileNames;
     KoResourceTagStore* m_tagStore;
 
+    KoResourceIndex *m_index;
+    bool m_indexLoaded;
+
+    QMutex m_lazyLock;
+    QStringList m_lazyFiles; ///< the files of the resources restored from the index, not validated yet
+
 };
 
 template <class T, class Policy = PointerStoragePolicy<T> >
@@ -116,6 +116,7 @@ private:
 KoResourceLoaderThread::KoResourceLoaderThread(KoResourceServerBase * server)
     : QThread()
     , m_server(server)
+    , m_loaded(false)
 {
     m_fileNames = m_server->fileNames();
     QStringList fileNames = m_server->blackListedFiles();
@@ -127,20 +128,40 @@ KoResourceLoaderThread::KoResourceLoaderThread(KoResourceServerBase * server)
             }
         }
     }
-    connect(qApp, SIGNAL(aboutToQuit()), SLOT(barrier()));
+    connect(qApp, SIGNAL(aboutToQuit()), SLOT(cancelAndWait()));
 }
 
 KoResourceLoaderThread::~KoResourceLoaderThread()
 {
+    cancelAndWait();
 }
 
 void KoResourceLoaderThread::run()
 {
     m_server->loadResources(m_fileNames);
+
+    {
+        QMutexLocker l(&m_loadedMutex);
+        m_loaded = true;
+        m_loadedCondition.wakeAll();
+    }
+
+    m_server->validateResources();
 }
 
 void KoResourceLoaderThread::barrier()
 {
+    QMutexLocker l(&m_loadedMutex);
+
+    while (!m_loaded && isRunning()) {
+        m_loadedCondition.wait(&m_loadedMutex);
+    }
+}
+
+void KoResourceLoaderThread::cancelAndWait()
+{
+    m_server->cancelValidation();
+
     if(isRunning()) {
         wait();
     }
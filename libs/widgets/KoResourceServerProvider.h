@@ -24,7 +24,9 @@
 
 #include <kowidgets_export.h>
 
+#include <QMutex>
 #include <QThread>
+#include <QWaitCondition>
 
 #include <kdebug.h>
 
@@ -35,6 +37,11 @@
 
 /**
  * KoResourceLoaderThread allows threaded loading of the resources of a resource server
+ *
+ * After the resources are loaded, the thread continues with decoding of
+ * the resources restored from the resource index, \see
+ * KoResourceServerBase::validateResources(). The server is usable at
+ * that moment already, so barrier() does not wait for the validation.
  */
 class KOWIDGETS_EXPORT KoResourceLoaderThread : public QThread {
 
@@ -54,6 +61,12 @@ public Q_SLOTS:
      */
     void barrier();
 
+private Q_SLOTS:
+    /**
+     * Stops the validation of the resources and waits for the thread
+     */
+    void cancelAndWait();
+
 protected:
     /**
      * Overridden from QThread
@@ -64,6 +77,10 @@ private:
 
     KoResourceServerBase * m_server;
     QStringList m_fileNames;
+
+    QMutex m_loadedMutex;
+    QWaitCondition m_loadedCondition;
+    bool m_loaded;
 };
 
 
@@ -0,0 +1,187 @@
+/*
+ *  Copyright (c) 2015 Calligra developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "KoResourceIndexTest.h"
+
+#include <QTest>
+#include <QFile>
+#include <QImage>
+
+#include "KoPattern.h"
+#include "KoResourceIndex.h"
+
+namespace {
+
+QString createPatternFile(const QString &name, int size)
+{
+    QImage image(size, size, QImage::Format_ARGB32);
+    image.fill(Qt::red);
+    for (int i = 0; i < size; i++) {
+        image.setPixel(i, i, qRgb(0, 0, 255));
+    }
+
+    const QString filename = QString(FILES_OUTPUT_DIR) + '/' + name + ".png";
+    QFile::remove(filename);
+    image.save(filename, "PNG");
+
+    return filename;
+}
+
+}
+
+void KoResourceIndexTest::testReadWrite()
+{
+    const QString patternFile = createPatternFile("index_read_write", 32);
+    const QString indexFile = QString(FILES_OUTPUT_DIR) + "/read_write.index";
+    QFile::remove(indexFile);
+
+    KoPattern pattern(patternFile);
+    QVERIFY(pattern.load());
+    pattern.setName("Test Pattern");
+
+    {
+        KoResourceIndex index(indexFile);
+        index.load();
+        QVERIFY(!index.isUpToDate(patternFile));
+
+        index.setRecords(patternFile, QList<KoResourceIndex::Record>() << KoResourceIndex::createRecord(&pattern));
+        QVERIFY(index.isUpToDate(patternFile));
+        QVERIFY(index.save());
+    }
+
+    KoResourceIndex index(indexFile);
+    index.load();
+    QVERIFY(index.isUpToDate(patternFile));
+
+    QList<KoResourceIndex::Record> records = index.records(patternFile);
+    QCOMPARE(records.size(), 1);
+    QCOMPARE(records.first().name, QString("Test Pattern"));
+    QCOMPARE(records.first().md5, pattern.md5());
+    QCOMPARE(records.first().thumbnail.size(), QSize(32, 32));
+}
+
+void KoResourceIndexTest::testLazyLoading()
+{
+    const QString patternFile = createPatternFile("index_lazy_loading", 512);
+
+    KoPattern pattern(patternFile);
+    QVERIFY(pattern.load());
+    pattern.setName("Lazy Pattern");
+
+    const KoResourceIndex::Record record = KoResourceIndex::createRecord(&pattern);
+    QCOMPARE(record.thumbnail.size(), QSize(256, 256));
+
+    KoPattern lazyPattern(patternFile);
+    KoResourceIndex::restore(&lazyPattern, record);
+
+    QVERIFY(lazyPattern.valid());
+    QCOMPARE(lazyPattern.name(), QString("Lazy Pattern"));
+    QCOMPARE(lazyPattern.md5(), pattern.md5());
+    QCOMPARE(lazyPattern.image().size(), QSize(256, 256));
+
+    // the first access to the data decodes the file
+    QCOMPARE(lazyPattern.pattern(), pattern.pattern());
+    QCOMPARE(lazyPattern.image().size(), QSize(512, 512));
+
+    // and keeps the name given by the server
+    QCOMPARE(lazyPattern.name(), QString("Lazy Pattern"));
+    QVERIFY(lazyPattern.ensureLoaded());
+}
+
+void KoResourceIndexTest::testOutdatedEntry()
+{
+    const QString patternFile = createPatternFile("index_outdated", 16);
+    const QString brokenFile = QString(FILES_OUTPUT_DIR) + "/index_broken.png";
+    const QString indexFile = QString(FILES_OUTPUT_DIR) + "/outdated.index";
+    QFile::remove(indexFile);
+
+    {
+        QFile file(brokenFile);
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        file.write("not a png file");
+    }
+
+    KoPattern pattern(patternFile);
+    QVERIFY(pattern.load());
+
+    KoResourceIndex index(indexFile);
+    index.setRecords(patternFile, QList<KoResourceIndex::Record>() << KoResourceIndex::createRecord(&pattern));
+    index.setRecords(brokenFile, QList<KoResourceIndex::Record>());
+
+    QVERIFY(index.isUpToDate(brokenFile));
+    QVERIFY(index.records(brokenFile).isEmpty());
+
+    // a changed file must be decoded again
+    createPatternFile("index_outdated", 24);
+    QVERIFY(!index.isUpToDate(patternFile));
+
+    // the entries of removed files are not saved
+    QFile::remove(brokenFile);
+    QVERIFY(index.save());
+
+    KoResourceIndex loadedIndex(indexFile);
+    loadedIndex.load();
+    QVERIFY(loadedIndex.records(brokenFile).isEmpty());
+    QVERIFY(!loadedIndex.isUpToDate(brokenFile));
+    QCOMPARE(loadedIndex.records(patternFile).size(), 1);
+}
+
+void KoResourceIndexTest::testEnvironmentChange()
+{
+    const QString patternFile = createPatternFile("index_environment", 16);
+    const QString brokenFile = QString(FILES_OUTPUT_DIR) + "/index_environment_broken.png";
+    const QString indexFile = QString(FILES_OUTPUT_DIR) + "/environment.index";
+    QFile::remove(indexFile);
+
+    {
+        QFile file(brokenFile);
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        file.write("not a png file");
+    }
+
+    KoPattern pattern(patternFile);
+    QVERIFY(pattern.load());
+
+    {
+        KoResourceIndex index(indexFile);
+        index.setEnvironment("paintop1");
+        index.load();
+        index.setRecords(patternFile, QList<KoResourceIndex::Record>() << KoResourceIndex::createRecord(&pattern));
+        index.setRecords(brokenFile, QList<KoResourceIndex::Record>());
+        QVERIFY(index.save());
+    }
+
+    {
+        // the same plugins, the broken file is still skipped
+        KoResourceIndex index(indexFile);
+        index.setEnvironment("paintop1");
+        index.load();
+        QVERIFY(index.isUpToDate(brokenFile));
+        QVERIFY(index.isUpToDate(patternFile));
+    }
+
+    // a new plugin might be able to load the broken file
+    KoResourceIndex index(indexFile);
+    index.setEnvironment("paintop1,paintop2");
+    index.load();
+    QVERIFY(!index.isUpToDate(brokenFile));
+    QVERIFY(index.isUpToDate(patternFile));
+    QCOMPARE(index.records(patternFile).size(), 1);
+}
+
+QTEST_MAIN(KoResourceIndexTest)
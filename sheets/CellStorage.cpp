@@ -23,6 +23,8 @@
 #include "CellStorage_p.h"
 
 // Qt
+#include <QAtomicInteger>
+#include <QHash>
 #ifdef CALLIGRA_SHEETS_MT
 #include <QReadWriteLock>
 #include <QReadLocker>
@@ -66,6 +68,14 @@ using namespace Calligra::Sheets;
 
 typedef RectStorage<QString> NamedAreaStorage;
 
+// the last revision handed out to any of the storages
+static QAtomicInteger<qint64> s_revision;
+
+static qint64 nextRevision()
+{
+    return s_revision.fetchAndAddOrdered(1) + 1;
+}
+
 class Q_DECL_HIDDEN CellStorage::Private
 {
 public:
@@ -87,6 +97,7 @@ public:
             , richTextStorage(new RichTextStorage())
             , rowRepeatStorage(new RowRepeatStorage())
             , undoData(0)
+            , structureRevision(nextRevision())
 #ifdef CALLIGRA_SHEETS_MT
             , bigUglyLock(QReadWriteLock::Recursive)
 #endif
@@ -110,6 +121,7 @@ public:
             , richTextStorage(new RichTextStorage(*other.richTextStorage))
             , rowRepeatStorage(new RowRepeatStorage(*other.rowRepeatStorage))
             , undoData(0)
+            , structureRevision(nextRevision())
 #ifdef CALLIGRA_SHEETS_MT
             , bigUglyLock(QReadWriteLock::Recursive)
 #endif
@@ -134,6 +146,8 @@ public:
     }
 
     void createCommand(KUndo2Command *parent) const;
+    void valueChanged(int column, int row);
+    void structureChanged();
 
     Sheet*                  sheet;
     BindingStorage*         bindingStorage;
@@ -153,11 +167,36 @@ public:
     RowRepeatStorage*       rowRepeatStorage;
     CellStorageUndoData*    undoData;
 
+    // the revisions of the values, see CellStorage::columnRevision()
+    QHash<int, qint64>      columnRevisions;
+    QHash<int, qint64>      rowRevisions;
+    qint64                  structureRevision;
+
 #ifdef CALLIGRA_SHEETS_MT
     QReadWriteLock bigUglyLock;
 #endif
 };
 
+void CellStorage::Private::valueChanged(int column, int row)
+{
+    // There is no need to track the lines one by one while loading and
+    // the tracking must not grow without bounds either.
+    if (sheet->map()->isLoading() || rowRevisions.count() >= 0x10000) {
+        structureChanged();
+        return;
+    }
+    const qint64 revision = nextRevision();
+    columnRevisions[column] = revision;
+    rowRevisions[row] = revision;
+}
+
+void CellStorage::Private::structureChanged()
+{
+    columnRevisions.clear();
+    rowRevisions.clear();
+    structureRevision = nextRevision();
+}
+
 void CellStorage::Private::createCommand(KUndo2Command *parent) const
 {
     if (!undoData->bindings.isEmpty()) {
@@ -278,6 +317,8 @@ void CellStorage::take(int col, int row)
     oldUserInput = d->userInputStorage->take(col, row);
     oldValue = d->valueStorage->take(col, row);
     oldRichText = d->richTextStorage->take(col, row);
+    if (!oldValue.isEmpty())
+        d->valueChanged(col, row);
 
     if (!d->sheet->map()->isLoading()) {
         // Trigger a recalculation of the consuming cells.
@@ -668,6 +709,14 @@ Value CellStorage::value(int column, int row) const
     return d->valueStorage->lookup(column, row);
 }
 
+bool CellStorage::numericValue(int column, int row, Number* number, Value::Format* format) const
+{
+#ifdef CALLIGRA_SHEETS_MT
+    QReadLocker rl(&d->bigUglyLock);
+#endif
+    return d->valueStorage->lookupNumber(column, row, number, format);
+}
+
 Value CellStorage::valueRegion(const Region& region) const
 {
 #ifdef CALLIGRA_SHEETS_MT
@@ -693,6 +742,7 @@ void CellStorage::setValue(int column, int row, const Value& value)
 
     // value changed?
     if (value != old) {
+        d->valueChanged(column, row);
         if (!d->sheet->map()->isLoading()) {
             // Always trigger a repainting and a binding update.
             CellDamage::Changes changes = CellDamage::Appearance | CellDamage::Binding;
@@ -714,6 +764,22 @@ void CellStorage::setValue(int column, int row, const Value& value)
     }
 }
 
+qint64 CellStorage::columnRevision(int column) const
+{
+#ifdef CALLIGRA_SHEETS_MT
+    QReadLocker rl(&d->bigUglyLock);
+#endif
+    return qMax(d->structureRevision, d->columnRevisions.value(column));
+}
+
+qint64 CellStorage::rowRevision(int row) const
+{
+#ifdef CALLIGRA_SHEETS_MT
+    QReadLocker rl(&d->bigUglyLock);
+#endif
+    return qMax(d->structureRevision, d->rowRevisions.value(row));
+}
+
 bool CellStorage::doesMergeCells(int column, int row) const
 {
 #ifdef CALLIGRA_SHEETS_MT
@@ -968,6 +1034,7 @@ void CellStorage::insertColumns(int position, int number)
     QVector< QPair<QPoint, QSharedPointer<QTextDocument> > > richTexts = d->richTextStorage->insertColumns(position, number);
     QList< QPair<QRectF, Validity> > validities = d->validityStorage->insertColumns(position, number);
     QVector< QPair<QPoint, Value> > values = d->valueStorage->insertColumns(position, number);
+    d->structureChanged();
     // recording undo?
     if (d->undoData) {
         d->undoData->bindings   << bindings;
@@ -1027,6 +1094,7 @@ void CellStorage::removeColumns(int position, int number)
     QVector< QPair<QPoint, QString> > userInputs = d->userInputStorage->removeColumns(position, number);
     QList< QPair<QRectF, Validity> > validities = d->validityStorage->removeColumns(position, number);
     QVector< QPair<QPoint, Value> > values = d->valueStorage->removeColumns(position, number);
+    d->structureChanged();
     QVector< QPair<QPoint, QSharedPointer<QTextDocument> > > richTexts = d->richTextStorage->removeColumns(position, number);
     // recording undo?
     if (d->undoData) {
@@ -1086,6 +1154,7 @@ void CellStorage::insertRows(int position, int number)
     QVector< QPair<QPoint, QString> > userInputs = d->userInputStorage->insertRows(position, number);
     QList< QPair<QRectF, Validity> > validities = d->validityStorage->insertRows(position, number);
     QVector< QPair<QPoint, Value> > values = d->valueStorage->insertRows(position, number);
+    d->structureChanged();
     QVector< QPair<QPoint, QSharedPointer<QTextDocument> > > richTexts = d->richTextStorage->insertRows(position, number);
     // recording undo?
     if (d->undoData) {
@@ -1148,6 +1217,7 @@ void CellStorage::removeRows(int position, int number)
     QVector< QPair<QPoint, QString> > userInputs = d->userInputStorage->removeRows(position, number);
     QList< QPair<QRectF, Validity> > validities = d->validityStorage->removeRows(position, number);
     QVector< QPair<QPoint, Value> > values = d->valueStorage->removeRows(position, number);
+    d->structureChanged();
     QVector< QPair<QPoint, QSharedPointer<QTextDocument> > > richTexts = d->richTextStorage->removeRows(position, number);
     // recording undo?
     if (d->undoData) {
@@ -1210,6 +1280,7 @@ void CellStorage::removeShiftLeft(const QRect& rect)
     QVector< QPair<QPoint, QString> > userInputs = d->userInputStorage->removeShiftLeft(rect);
     QList< QPair<QRectF, Validity> > validities = d->validityStorage->removeShiftLeft(rect);
     QVector< QPair<QPoint, Value> > values = d->valueStorage->removeShiftLeft(rect);
+    d->structureChanged();
     QVector< QPair<QPoint, QSharedPointer<QTextDocument> > > richTexts = d->richTextStorage->removeShiftLeft(rect);
     // recording undo?
     if (d->undoData) {
@@ -1271,6 +1342,7 @@ void CellStorage::insertShiftRight(const QRect& rect)
     QVector< QPair<QPoint, QString> > userInputs = d->userInputStorage->insertShiftRight(rect);
     QList< QPair<QRectF, Validity> > validities = d->validityStorage->insertShiftRight(rect);
     QVector< QPair<QPoint, Value> > values = d->valueStorage->insertShiftRight(rect);
+    d->structureChanged();
     QVector< QPair<QPoint, QSharedPointer<QTextDocument> > > richTexts = d->richTextStorage->insertShiftRight(rect);
     // recording undo?
     if (d->undoData) {
@@ -1333,6 +1405,7 @@ void CellStorage::removeShiftUp(const QRect& rect)
     QVector< QPair<QPoint, QString> > userInputs = d->userInputStorage->removeShiftUp(rect);
     QList< QPair<QRectF, Validity> > validities = d->validityStorage->removeShiftUp(rect);
     QVector< QPair<QPoint, Value> > values = d->valueStorage->removeShiftUp(rect);
+    d->structureChanged();
     QVector< QPair<QPoint, QSharedPointer<QTextDocument> > > richTexts = d->richTextStorage->removeShiftUp(rect);
     // recording undo?
     if (d->undoData) {
@@ -1394,6 +1467,7 @@ void CellStorage::insertShiftDown(const QRect& rect)
     QVector< QPair<QPoint, QString> > userInputs = d->userInputStorage->insertShiftDown(rect);
     QList< QPair<QRectF, Validity> > validities = d->validityStorage->insertShiftDown(rect);
     QVector< QPair<QPoint, Value> > values = d->valueStorage->insertShiftDown(rect);
+    d->structureChanged();
     QVector< QPair<QPoint, QSharedPointer<QTextDocument> > > richTexts = d->richTextStorage->insertShiftDown(rect);
     // recording undo?
     if (d->undoData) {
@@ -27,6 +27,7 @@
 #include "Cell.h"
 #include "calligra_sheets_limits.h"
 #include "PointStorage.h"
+#include "Value.h"
 
 #include "database/Database.h"
 
@@ -193,12 +194,34 @@ public:
      */
     Value value(int column, int row) const;
 
+    /**
+     * Reads the number at \p column , \p row without building a Value.
+     * An empty value reads as zero.
+     * \return \c false , if the value is neither a number nor empty
+     */
+    bool numericValue(int column, int row, Number* number, Value::Format* format) const;
+
     /**
      * Creates a value array containing the values in \p region.
      */
     Value valueRegion(const Region& region) const;
     void setValue(int column, int row, const Value& value);
 
+    /**
+     * \return the revision of the values in \p column .
+     * The revision changes whenever a value in the column changes or
+     * the cells are moved around. The revisions of all the storages are
+     * unique, so a cache of the column's values can tell whether it is
+     * still valid by comparing the revisions.
+     */
+    qint64 columnRevision(int column) const;
+
+    /**
+     * \return the revision of the values in \p row .
+     * \see columnRevision()
+     */
+    qint64 rowRevision(int row) const;
+
     QSharedPointer<QTextDocument> richText(int column, int row) const;
     void setRichText(int column, int row, QSharedPointer<QTextDocument> text);
 
@@ -0,0 +1,318 @@
+/* This file is part of the KDE project
+   Copyright (c) 2015 Calligra developers
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+// Local
+#include "DependencyIndex.h"
+
+#include "Cell.h"
+#include "RTree.h"
+
+#include <QHash>
+#include <QSet>
+
+using namespace Calligra::Sheets;
+
+namespace
+{
+
+// the size of the largest reference stored as range pattern
+const int maximumPatternArea = 64;
+
+// Each query checks all the patterns, so their number is limited.
+// References filled down or across share their pattern, so there are
+// only a few of them in usual documents.
+const int maximumPatternCount = 256;
+
+typedef QPair<int, int> Span;
+
+// A reference relative to its consuming cell.
+struct PatternKey {
+    PatternKey(const Sheet* _sheet, const QRect& _offset)
+        : sheet(_sheet), offset(_offset) {}
+
+    bool operator==(const PatternKey& other) const {
+        return sheet == other.sheet && offset == other.offset;
+    }
+
+    // the sheet of the consuming cells
+    const Sheet* sheet;
+    // the range translated by the position of the consuming cell
+    QRect offset;
+};
+
+uint qHash(const PatternKey& key)
+{
+    return ::qHash(key.sheet) ^ ::qHash(key.offset.left()) ^ (::qHash(key.offset.top()) << 8) ^
+           (::qHash(key.offset.width()) << 16) ^ (::qHash(key.offset.height()) << 24);
+}
+
+// A reference stored in the R-Tree.
+struct TreeEntry {
+    TreeEntry(const QRect& _range, const Cell& _cell) : range(_range), cell(_cell) {}
+
+    bool operator==(const TreeEntry& other) const {
+        return range == other.range && cell == other.cell;
+    }
+
+    QRect range;
+    Cell cell;
+};
+
+uint qHash(const TreeEntry& entry)
+{
+    return qHash(entry.cell) ^ ::qHash(entry.range.width()) ^ (::qHash(entry.range.height()) << 16);
+}
+
+bool isColumnRange(const QRect& range)
+{
+    return range.top() == 1 && range.bottom() >= KS_rowMax;
+}
+
+bool isRowRange(const QRect& range)
+{
+    return range.left() == 1 && range.right() >= KS_colMax;
+}
+
+} // namespace
+
+class Q_DECL_HIDDEN DependencyIndex::Private
+{
+public:
+    Private() : count(0) {}
+
+    /**
+     * Collects the compressed references intersecting \p rect or, if
+     * \p covering is set, the ones covering \p rect completely.
+     * Any of the output parameters may be null.
+     */
+    void collect(const QRect& rect, bool covering, QList<Cell>* cells,
+                 QList< QPair<QRect, Cell> >* pairs, QList<QRect>* ranges) const;
+
+    // the consumers of complete columns by their column span
+    QHash<Span, QSet<Cell> > columnConsumers;
+    // the consumers of complete rows by their row span
+    QHash<Span, QSet<Cell> > rowConsumers;
+    // the consumers of small ranges by their relative position
+    QHash<PatternKey, QSet<Cell> > patternConsumers;
+    // the consumers of all other ranges
+    RTree<Cell> tree;
+    // the references in the tree, looking them up in the tree is slow,
+    // if many cells consume the same range
+    QSet<TreeEntry> treeEntries;
+    int count;
+};
+
+void DependencyIndex::Private::collect(const QRect& rect, bool covering, QList<Cell>* cells,
+                                       QList< QPair<QRect, Cell> >* pairs, QList<QRect>* ranges) const
+{
+    for (int i = 0; i < 2; ++i) {
+        const bool columns = (i == 0);
+        const QHash<Span, QSet<Cell> >& consumers = columns ? columnConsumers : rowConsumers;
+        QHash<Span, QSet<Cell> >::ConstIterator end(consumers.constEnd());
+        for (QHash<Span, QSet<Cell> >::ConstIterator it(consumers.constBegin()); it != end; ++it) {
+            const Span span = it.key();
+            const QRect range = columns ? QRect(QPoint(span.first, 1), QPoint(span.second, KS_rowMax))
+                                        : QRect(QPoint(1, span.first), QPoint(KS_colMax, span.second));
+            if (covering ? !range.contains(rect) : !range.intersects(rect))
+                continue;
+            if (cells)
+                *cells += it.value().toList();
+            if (pairs) {
+                foreach (const Cell& cell, it.value())
+                    pairs->append(qMakePair(range, cell));
+            }
+            if (ranges)
+                ranges->append(range);
+        }
+    }
+
+    QHash<PatternKey, QSet<Cell> >::ConstIterator end(patternConsumers.constEnd());
+    for (QHash<PatternKey, QSet<Cell> >::ConstIterator it(patternConsumers.constBegin()); it != end; ++it) {
+        const QRect offset = it.key().offset;
+        // the positions of the consuming cells, whose ranges match
+        QRect positions;
+        if (covering) {
+            positions = QRect(QPoint(rect.right() - offset.right(), rect.bottom() - offset.bottom()),
+                              QPoint(rect.left() - offset.left(), rect.top() - offset.top()));
+        } else {
+            positions = QRect(QPoint(rect.left() - offset.right(), rect.top() - offset.bottom()),
+                              QPoint(rect.right() - offset.left(), rect.bottom() - offset.top()));
+        }
+        positions &= QRect(1, 1, KS_colMax, KS_rowMax);
+        if (positions.isEmpty())
+            continue;
+
+        const QSet<Cell>& consumers = it.value();
+        QList<Cell> matches;
+        if (qint64(positions.width()) * positions.height() > consumers.count()) {
+            foreach (const Cell& cell, consumers) {
+                if (positions.contains(cell.cellPosition()))
+                    matches.append(cell);
+            }
+        } else {
+            for (int row = positions.top(); row <= positions.bottom(); ++row) {
+                for (int col = positions.left(); col <= positions.right(); ++col) {
+                    const Cell cell(it.key().sheet, col, row);
+                    if (consumers.contains(cell))
+                        matches.append(cell);
+                }
+            }
+        }
+        if (cells)
+            *cells += matches;
+        foreach (const Cell& cell, matches) {
+            const QRect range = offset.translated(cell.cellPosition());
+            if (pairs)
+                pairs->append(qMakePair(range, cell));
+            if (ranges)
+                ranges->append(range);
+        }
+    }
+}
+
+DependencyIndex::DependencyIndex()
+        : d(new Private)
+{
+}
+
+DependencyIndex::~DependencyIndex()
+{
+    delete d;
+}
+
+void DependencyIndex::insert(const QRect& range, const Cell& cell)
+{
+    if (isColumnRange(range)) {
+        QSet<Cell>& consumers = d->columnConsumers[Span(range.left(), range.right())];
+        if (!consumers.contains(cell)) {
+            consumers.insert(cell);
+            ++d->count;
+        }
+        return;
+    }
+    if (isRowRange(range)) {
+        QSet<Cell>& consumers = d->rowConsumers[Span(range.top(), range.bottom())];
+        if (!consumers.contains(cell)) {
+            consumers.insert(cell);
+            ++d->count;
+        }
+        return;
+    }
+    const PatternKey key(cell.sheet(), range.translated(-cell.cellPosition()));
+    if (qint64(range.width()) * range.height() <= maximumPatternArea &&
+            (d->patternConsumers.contains(key) || d->patternConsumers.count() < maximumPatternCount)) {
+        QSet<Cell>& consumers = d->patternConsumers[key];
+        if (!consumers.contains(cell)) {
+            consumers.insert(cell);
+            ++d->count;
+        }
+        return;
+    }
+    const TreeEntry entry(range, cell);
+    if (!d->treeEntries.contains(entry)) {
+        d->treeEntries.insert(entry);
+        d->tree.insert(range, cell);
+        ++d->count;
+    }
+}
+
+void DependencyIndex::remove(const QRect& range, const Cell& cell)
+{
+    QHash<Span, QSet<Cell> >::Iterator it;
+    if (isColumnRange(range)) {
+        it = d->columnConsumers.find(Span(range.left(), range.right()));
+        if (it != d->columnConsumers.end() && it.value().remove(cell)) {
+            --d->count;
+            if (it.value().isEmpty())
+                d->columnConsumers.erase(it);
+        }
+        return;
+    }
+    if (isRowRange(range)) {
+        it = d->rowConsumers.find(Span(range.top(), range.bottom()));
+        if (it != d->rowConsumers.end() && it.value().remove(cell)) {
+            --d->count;
+            if (it.value().isEmpty())
+                d->rowConsumers.erase(it);
+        }
+        return;
+    }
+    // The pattern may have been full on insertion, so check the tree too.
+    const PatternKey key(cell.sheet(), range.translated(-cell.cellPosition()));
+    QHash<PatternKey, QSet<Cell> >::Iterator pit = d->patternConsumers.find(key);
+    if (pit != d->patternConsumers.end() && pit.value().remove(cell)) {
+        --d->count;
+        if (pit.value().isEmpty())
+            d->patternConsumers.erase(pit);
+        return;
+    }
+    if (d->treeEntries.remove(TreeEntry(range, cell))) {
+        d->tree.remove(range, cell);
+        --d->count;
+    }
+}
+
+QList<Cell> DependencyIndex::contains(const QPoint& point) const
+{
+    QList<Cell> cells;
+    d->collect(QRect(point, point), false, &cells, 0, 0);
+    cells += d->tree.contains(point);
+    return cells;
+}
+
+QList<Cell> DependencyIndex::contains(const QRect& rect) const
+{
+    QList<Cell> cells;
+    d->collect(rect, true, &cells, 0, 0);
+    cells += d->tree.contains(rect);
+    return cells;
+}
+
+QList<Cell> DependencyIndex::intersects(const QRect& rect) const
+{
+    QList<Cell> cells;
+    d->collect(rect, false, &cells, 0, 0);
+    cells += d->tree.intersects(rect);
+    return cells;
+}
+
+QList< QPair<QRect, Cell> > DependencyIndex::intersectingPairs(const QRect& rect) const
+{
+    QList< QPair<QRect, Cell> > pairs;
+    d->collect(rect, false, 0, &pairs, 0);
+    const QList< QPair<QRectF, Cell> > treePairs = d->tree.intersectingPairs(rect).values();
+    for (int i = 0; i < treePairs.count(); ++i)
+        pairs.append(qMakePair(treePairs[i].first.toRect(), treePairs[i].second));
+    return pairs;
+}
+
+QList<QRect> DependencyIndex::intersectingRanges(const QRect& rect) const
+{
+    QList<QRect> ranges;
+    d->collect(rect, false, 0, 0, &ranges);
+    const QList< QPair<QRectF, Cell> > treePairs = d->tree.intersectingPairs(rect).values();
+    for (int i = 0; i < treePairs.count(); ++i)
+        ranges.append(treePairs[i].first.toRect());
+    return ranges;
+}
+
+int DependencyIndex::count() const
+{
+    return d->count;
+}
@@ -0,0 +1,114 @@
+/* This file is part of the KDE project
+   Copyright (c) 2015 Calligra developers
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#ifndef CALLIGRA_SHEETS_DEPENDENCY_INDEX
+#define CALLIGRA_SHEETS_DEPENDENCY_INDEX
+
+#include <QList>
+#include <QPair>
+#include <QPoint>
+#include <QRect>
+
+#include "calligra_sheets_export.h"
+
+namespace Calligra
+{
+namespace Sheets
+{
+class Cell;
+
+/**
+ * \class DependencyIndex
+ * \brief Stores the consuming cells of a sheet by the ranges they refer to.
+ * \ingroup Value
+ *
+ * A single R-Tree degrades, if many cells refer to the same large range,
+ * e.g. SUM(A:A) in each row, or if a formula is filled down a column,
+ * because of the many overlapping rectangles. The index keeps those
+ * references compressed:
+ * \li references to complete columns are grouped by their column span,
+ * \li references to complete rows are grouped by their row span,
+ * \li small references are grouped by their position relative to the
+ * consuming cell, so a formula filled down a column is stored as one
+ * range pattern with the set of its consuming cells,
+ * \li all other references are stored in an R-Tree.
+ *
+ * A range is stored once per consuming cell, inserting it again has no
+ * effect.
+ */
+class CALLIGRA_SHEETS_ODF_EXPORT DependencyIndex
+{
+public:
+    DependencyIndex();
+    ~DependencyIndex();
+
+    /**
+     * Adds \p cell as consumer of the values in \p range .
+     */
+    void insert(const QRect& range, const Cell& cell);
+
+    /**
+     * Removes \p cell as consumer of the values in \p range .
+     */
+    void remove(const QRect& range, const Cell& cell);
+
+    /**
+     * \return the cells consuming the value at \p point
+     */
+    QList<Cell> contains(const QPoint& point) const;
+
+    /**
+     * \return the cells consuming all the values in \p rect
+     */
+    QList<Cell> contains(const QRect& rect) const;
+
+    /**
+     * \return the cells consuming any of the values in \p rect
+     */
+    QList<Cell> intersects(const QRect& rect) const;
+
+    /**
+     * \return the consumed ranges intersecting \p rect paired with their
+     * consuming cells
+     */
+    QList< QPair<QRect, Cell> > intersectingPairs(const QRect& rect) const;
+
+    /**
+     * \return the consumed ranges intersecting \p rect . Unlike
+     * intersectingPairs(), a range consumed by many cells is listed once
+     * at most, if it is stored compressed.
+     */
+    QList<QRect> intersectingRanges(const QRect& rect) const;
+
+    /**
+     * \return the number of stored references
+     */
+    int count() const;
+
+private:
+    Q_DISABLE_COPY(DependencyIndex)
+
+    class Private;
+    Private * const d;
+};
+
+} // namespace Sheets
+} // namespace Calligra
+
+#endif // CALLIGRA_SHEETS_DEPENDENCY_INDEX
@@ -25,12 +25,12 @@
 
 #include "Cell.h"
 #include "CellStorage.h"
+#include "DependencyIndex.h"
 #include "Formula.h"
 #include "FormulaStorage.h"
 #include "Map.h"
 #include "NamedAreaManager.h"
 #include "Region.h"
-#include "RTree.h"
 #include "Sheet.h"
 #include "Value.h"
 #include "DocBase.h"
@@ -61,10 +61,10 @@ void DependencyManager::Private::dump() const
     }
 
     foreach(Sheet* sheet, consumers.keys()) {
-        const QList< QPair<QRectF, Cell> > pairs = consumers[sheet]->intersectingPairs(QRect(1, 1, KS_colMax, KS_rowMax)).values();
+        const QList< QPair<QRect, Cell> > pairs = consumers[sheet]->intersectingPairs(QRect(1, 1, KS_colMax, KS_rowMax));
         QHash<QString, QString> table;
         for (int i = 0; i < pairs.count(); ++i) {
-            Region tmpRange(pairs[i].first.toRect(), sheet);
+            Region tmpRange(pairs[i].first, sheet);
             table.insertMulti(tmpRange.name(), pairs[i].second.name());
         }
         foreach(const QString &uniqueKey, table.uniqueKeys()) {
@@ -213,6 +213,7 @@ void DependencyManager::updateAllDependencies(const Map* map, KoUpdater *updater
         }
     }
     cellCurrent = 0;
+    d->clearRangeDepths();
     foreach(const Sheet* sheet, map->sheetList()) {
         for (int c = 0; c < sheet->formulaStorage()->count(); ++c, ++cellCurrent) {
             cell = Cell(sheet, sheet->formulaStorage()->col(c), sheet->formulaStorage()->row(c));
@@ -226,6 +227,7 @@ void DependencyManager::updateAllDependencies(const Map* map, KoUpdater *updater
                 updater->setProgress(50 + int(qreal(cellCurrent) / qreal(cellsCount) * 50.));
         }
     }
+    d->clearRangeDepths();
 
     if (updater)
         updater->setProgress(100);
@@ -244,17 +246,17 @@ Calligra::Sheets::Region DependencyManager::consumingRegion(const Cell& cell) co
 Calligra::Sheets::Region DependencyManager::reduceToProvidingRegion(const Region& region) const
 {
     Region providingRegion;
-    QList< QPair<QRectF, Cell> > pairs;
+    QList<QRect> ranges;
     Region::ConstIterator end(region.constEnd());
     for (Region::ConstIterator it(region.constBegin()); it != end; ++it) {
         Sheet* const sheet = (*it)->sheet();
-        QHash<Sheet*, RTree<Cell>*>::ConstIterator cit = d->consumers.constFind(sheet);
+        QHash<Sheet*, DependencyIndex*>::ConstIterator cit = d->consumers.constFind(sheet);
         if (cit == d->consumers.constEnd())
             continue;
 
-        pairs = cit.value()->intersectingPairs((*it)->rect()).values();
-        for (int i = 0; i < pairs.count(); ++i)
-            providingRegion.add(pairs[i].first.toRect() & (*it)->rect(), sheet);
+        ranges = cit.value()->intersectingRanges((*it)->rect());
+        for (int i = 0; i < ranges.count(); ++i)
+            providingRegion.add(ranges[i] & (*it)->rect(), sheet);
     }
     return providingRegion;
 }
@@ -268,7 +270,7 @@ void DependencyManager::regionMoved(const Region& movedRegion, const Cell& desti
         Sheet* const sheet = (*it)->sheet();
         locationOffset.setSheet((sheet == destination.sheet()) ? 0 : destination.sheet());
 
-        QHash<Sheet*, RTree<Cell>*>::ConstIterator cit = d->consumers.constFind(sheet);
+        QHash<Sheet*, DependencyIndex*>::ConstIterator cit = d->consumers.constFind(sheet);
         if (cit == d->consumers.constEnd())
             continue;
 
@@ -330,7 +332,7 @@ void DependencyManager::Private::reset()
 
 Calligra::Sheets::Region DependencyManager::Private::consumingRegion(const Cell& cell) const
 {
-    QHash<Sheet*, RTree<Cell>*>::ConstIterator cit = consumers.constFind(cell.sheet());
+    QHash<Sheet*, DependencyIndex*>::ConstIterator cit = consumers.constFind(cell.sheet());
     if (cit == consumers.constEnd()) {
         //kDebug(36002) << "No consumer tree found for the cell's sheet.";
         return Region();
@@ -374,7 +376,7 @@ void DependencyManager::Private::removeDependencies(const Cell& cell)
     Region region = pit.value();
     Region::ConstIterator end(region.constEnd());
     for (Region::ConstIterator it(region.constBegin()); it != end; ++it) {
-        QHash<Sheet*, RTree<Cell>*>::ConstIterator cit = consumers.constFind((*it)->sheet());
+        QHash<Sheet*, DependencyIndex*>::ConstIterator cit = consumers.constFind((*it)->sheet());
         if (cit != consumers.constEnd()) {
             cit.value()->remove((*it)->rect(), cell);
         }
@@ -403,7 +405,7 @@ void DependencyManager::Private::removeDepths(const Cell& cell)
     QMap<Cell, int>::Iterator dit = depths.find(cell);
     if (dit == depths.end())
         return;
-    QHash<Sheet*, RTree<Cell>*>::ConstIterator cit = consumers.constFind(cell.sheet());
+    QHash<Sheet*, DependencyIndex*>::ConstIterator cit = consumers.constFind(cell.sheet());
     if (cit == consumers.constEnd())
         return;
     depths.erase(dit);
@@ -430,6 +432,7 @@ void DependencyManager::Private::generateDependencies(const Cell& cell, const Fo
 void DependencyManager::Private::generateDepths(const Region& region)
 {
     QSet<Cell> computedDepths;
+    clearRangeDepths();
 
     Region::ConstIterator end(region.constEnd());
     for (Region::ConstIterator it(region.constBegin()); it != end; ++it) {
@@ -449,6 +452,7 @@ void DependencyManager::Private::generateDepths(const Region& region)
             }
         }
     }
+    clearRangeDepths();
 }
 
 void DependencyManager::Private::generateDepths(Cell cell, QSet<Cell>& computedDepths)
@@ -476,7 +480,7 @@ void DependencyManager::Private::generateDepths(Cell cell, QSet<Cell>& computedD
 
     // Recursion. We need the whole dependency tree of the changed region.
     // An infinite loop is prevented by the check above.
-    QHash<Sheet*, RTree<Cell>*>::ConstIterator cit = consumers.constFind(cell.sheet());
+    QHash<Sheet*, DependencyIndex*>::ConstIterator cit = consumers.constFind(cell.sheet());
     if (cit == consumers.constEnd()) {
         processedCells.remove(cell);
         return;
@@ -511,40 +515,61 @@ int DependencyManager::Private::computeDepth(Cell cell) const
 
     Region::ConstIterator end(region.constEnd());
     for (Region::ConstIterator it(region.constBegin()); it != end; ++it) {
-        const QRect range = (*it)->rect();
-        Sheet* sheet = (*it)->sheet();
-        const int right = range.right();
-        const int bottom = range.bottom();
-        for (int col = range.left(); col <= right; ++col) {
-            for (int row = range.top(); row <= bottom; ++row) {
-                Cell referencedCell = Cell(sheet, col, row);
-                if (!providers.contains(referencedCell)) {
-                    // no further references
-                    // depth is one at least
-                    depth = qMax(depth, 1);
-                    continue;
-                }
+        depth = qMax(computeDepth((*it)->sheet(), (*it)->rect()), depth);
+    }
 
-                QMap<Cell, int>::ConstIterator it = depths.constFind(referencedCell);
-                if (it != depths.constEnd()) {
-                    // the referenced cell depth was already computed
-                    depth = qMax(it.value() + 1, depth);
-                    continue;
-                }
+    //clear the computing reference depth flag
+    processedCells.remove(cell);
 
-                // compute the depth of the referenced cell, add one and
-                // take it as new depth, if it's greater than the current one
-                depth = qMax(computeDepth(referencedCell) + 1, depth);
-            }
+    return depth;
+}
+
+int DependencyManager::Private::computeDepth(Sheet* sheet, const QRect& range) const
+{
+    const SheetRange key(sheet, range);
+    QHash<SheetRange, int>::ConstIterator rit = rangeDepths.constFind(key);
+    if (rit != rangeDepths.constEnd())
+        return rit.value();
+
+    int depth = 0;
+    qint64 formulaCount = 0;
+
+    // The providers are ordered by rows, so all the cells in the rows of
+    // the range are visited, but not the empty ones.
+    QMap<Cell, Region>::ConstIterator it = providers.lowerBound(Cell(sheet, range.left(), range.top()));
+    const QMap<Cell, Region>::ConstIterator end = providers.upperBound(Cell(sheet, range.right(), range.bottom()));
+    for (; it != end; ++it) {
+        const Cell referencedCell = it.key();
+        if (referencedCell.column() < range.left() || referencedCell.column() > range.right())
+            continue;
+        ++formulaCount;
+
+        QMap<Cell, int>::ConstIterator dit = depths.constFind(referencedCell);
+        if (dit != depths.constEnd()) {
+            // the referenced cell depth was already computed
+            depth = qMax(dit.value() + 1, depth);
+            continue;
         }
+
+        // compute the depth of the referenced cell, add one and
+        // take it as new depth, if it's greater than the current one
+        depth = qMax(computeDepth(referencedCell) + 1, depth);
     }
 
-    //clear the computing reference depth flag
-    processedCells.remove(cell);
+    // cells without further references
+    // depth is one at least
+    if (formulaCount < qint64(range.width()) * range.height())
+        depth = qMax(depth, 1);
 
+    rangeDepths.insert(key, depth);
     return depth;
 }
 
+void DependencyManager::Private::clearRangeDepths()
+{
+    rangeDepths.clear();
+}
+
 void DependencyManager::Private::computeDependencies(const Cell& cell, const Formula& formula)
 {
     // Broken formula -> meaningless dependencies
@@ -602,9 +627,9 @@ void DependencyManager::Private::computeDependencies(const Cell& cell, const For
                     Sheet* sheet = region.firstSheet();
 
                     // create consumer tree, if not existing yet
-                    QHash<Sheet*, RTree<Cell>*>::iterator it = consumers.find(sheet);
+                    QHash<Sheet*, DependencyIndex*>::iterator it = consumers.find(sheet);
                     if (it == consumers.end()) {
-                        it = consumers.insert(sheet, new RTree<Cell>());
+                        it = consumers.insert(sheet, new DependencyIndex());
                     }
                     // add cell as consumer of the range
                     it.value()->insert(region.firstRange(), cell);
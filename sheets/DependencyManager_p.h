@@ -28,8 +28,8 @@
 #include <QList>
 
 #include "Cell.h"
+#include "DependencyIndex.h"
 #include "Region.h"
-#include "RTree.h"
 
 namespace Calligra
 {
@@ -39,6 +39,26 @@ class Formula;
 class Map;
 class Sheet;
 
+/**
+ * A range in a sheet, used as key for the reference depths of ranges.
+ */
+struct SheetRange {
+    SheetRange(const Sheet* _sheet, const QRect& _rect) : sheet(_sheet), rect(_rect) {}
+
+    bool operator==(const SheetRange& other) const {
+        return sheet == other.sheet && rect == other.rect;
+    }
+
+    const Sheet* sheet;
+    QRect rect;
+};
+
+inline uint qHash(const SheetRange& range)
+{
+    return ::qHash(range.sheet) ^ ::qHash(range.rect.left()) ^ (::qHash(range.rect.top()) << 8) ^
+           (::qHash(range.rect.width()) << 16) ^ (::qHash(range.rect.height()) << 24);
+}
+
 class Q_DECL_HIDDEN DependencyManager::Private
 {
 public:
@@ -74,6 +94,22 @@ public:
      */
     int computeDepth(Cell cell) const;
 
+    /**
+     * Computes the reference depth of \p range , i.e. the maximum depth
+     * of the cells in it plus one.
+     * Only the cells containing a formula are visited. The depths of the
+     * ranges are cached until clearRangeDepths() is called, so a range
+     * referenced by many cells, e.g. a complete column, is visited once.
+     */
+    int computeDepth(Sheet* sheet, const QRect& range) const;
+
+    /**
+     * Clears the cached reference depths of the ranges.
+     * Has to be called after each depth computation pass, because the
+     * cached depths get invalid as soon as any formula changes.
+     */
+    void clearRangeDepths();
+
     /**
      * Used in the recalculation events for changed regions.
      * Determines the reference depth for each position in \p region .
@@ -140,7 +176,7 @@ public:
     // use QMap rather then QHash cause it's faster for our use-case
     QMap<Cell, Region> providers;
     // stores consuming cell locations ordered by their providing regions
-    QHash<Sheet*, RTree<Cell>*> consumers;
+    QHash<Sheet*, DependencyIndex*> consumers;
     // stores consuming cell locations ordered by their providing named area
     // (in addition to the general storage of the consuming cell locations)
     QHash<QString, QList<Cell> > namedAreaConsumers;
@@ -161,6 +197,8 @@ public:
      */
     // use QMap rather then QHash cause it's faster for our use-case
     QMap<Cell, int> depths;
+    // the reference depths of the ranges computed in the current pass
+    mutable QHash<SheetRange, int> rangeDepths;
 };
 
 } // namespace Sheets
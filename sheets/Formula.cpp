@@ -39,9 +39,13 @@
 
 #include <limits.h>
 
+#include <QAtomicInt>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QStack>
 #include <QString>
 #include <QTextStream>
+#include <QVarLengthArray>
 
 #include <klocale.h>
 
@@ -75,7 +79,6 @@ TODO - optimizations:
 - handle initial formula marker = (and +)
 - reuse constant already in the pool
 - reuse references already in the pool
-- expression optimization (e.g. 1+2+A1 becomes 3+A1)
 */
 
 namespace Calligra
@@ -99,6 +102,9 @@ public:
     Opcode(unsigned t, unsigned i): type(t), index(i) {}
 };
 
+// serializes the lazy compilation of the formulas in evalRecursive()
+static QMutex s_compileMutex;
+
 // used when evaluation formulas
 struct stackEntry {
     void reset() {
@@ -112,18 +118,41 @@ struct stackEntry {
     int row1, col1, row2, col2;
 };
 
+// a cell or range reference resolved when compiling the formula
+struct Reference {
+    Reference() : sheet(0) {}
+    Calligra::Sheets::Sheet *sheet;
+    QRect rect;
+    Calligra::Sheets::Region region;
+};
+
+// used when evaluating the formulas consisting of arithmetics only
+struct NumericEntry {
+    Number number;
+    Value::Format format;
+};
+
 class Q_DECL_HIDDEN Formula::Private : public QSharedData
 {
 public:
     Cell cell;
     Sheet *sheet;
-    mutable bool dirty;
+    // cleared by compile() only after the program below is complete, so
+    // that the threads that see it cleared can run the program unlocked
+    mutable QAtomicInt dirty;
     mutable bool valid;
     QString expression;
     mutable QVector<Opcode> codes;
     mutable QVector<Value> constants;
+    // indexed like the constants, the sheet is null for the unresolved ones
+    mutable QVector<Reference> references;
+    // true if the codes consist of numbers, cell references and arithmetics
+    mutable bool numeric;
 
     Value valueOrElement(FuncExtra &fe, const stackEntry& entry) const;
+    const Reference* reference(int index) const;
+    void optimize() const;
+    bool evalNumeric(Value& result) const;
 };
 
 class TokenStack : public QVector<Token>
@@ -582,7 +611,7 @@ Sheet* Formula::sheet() const
 void Formula::setExpression(const QString& expr)
 {
     d->expression = expr;
-    d->dirty = true;
+    d->dirty.storeRelease(1);
     d->valid = false;
 }
 
@@ -598,7 +627,7 @@ QString Formula::expression() const
 
 bool Formula::isValid() const
 {
-    if (d->dirty) {
+    if (d->dirty.loadAcquire()) {
         KLocale* locale = !d->cell.isNull() ? d->cell.locale() : 0;
         if ((!locale) && d->sheet)
             locale = d->sheet->map()->calculationSettings()->locale();
@@ -617,10 +646,12 @@ bool Formula::isValid() const
 void Formula::clear()
 {
     d->expression.clear();
-    d->dirty = true;
+    d->dirty.storeRelease(1);
     d->valid = false;
     d->constants.clear();
     d->codes.clear();
+    d->references.clear();
+    d->numeric = false;
 }
 
 // Returns list of token for the expression.
@@ -1075,13 +1106,17 @@ Tokens Formula::scan(const QString &expr, const KLocale* locale) const
 void Formula::compile(const Tokens& tokens) const
 {
     // initialize variables
-    d->dirty = false;
     d->valid = false;
     d->codes.clear();
     d->constants.clear();
+    d->references.clear();
+    d->numeric = false;
 
     // sanity check
-    if (tokens.count() == 0) return;
+    if (tokens.count() == 0) {
+        d->dirty.storeRelease(0);
+        return;
+    }
 
     TokenStack syntaxStack;
     QStack<int> argStack;
@@ -1464,7 +1499,12 @@ void Formula::compile(const Tokens& tokens) const
     if (!d->valid) {
         d->constants.clear();
         d->codes.clear();
+        d->dirty.storeRelease(0);
+        return;
     }
+
+    d->optimize();
+    d->dirty.storeRelease(0);
 }
 
 bool Formula::isNamedArea(const QString& expr) const
@@ -1501,6 +1541,215 @@ Value Formula::Private::valueOrElement(FuncExtra &fe, const stackEntry& entry) c
     return v;
 }
 
+const Reference* Formula::Private::reference(int index) const
+{
+    if (index >= references.count() || !references.at(index).sheet)
+        return 0;
+    return &references.at(index);
+}
+
+// The format of the result of an arithmetic operation, see ValueCalc::format().
+static Value::Format numericFormat(Value::Format af, Value::Format bf)
+{
+    const bool aIsDate = (af == Value::fmt_Date) || (af == Value::fmt_DateTime);
+    const bool bIsDate = (bf == Value::fmt_Date) || (bf == Value::fmt_DateTime);
+
+    // operation on two dates should produce a number
+    if (aIsDate && bIsDate)
+        return Value::fmt_Number;
+
+    if ((af == Value::fmt_None) || (af == Value::fmt_Boolean))
+        return bf;
+    return af;
+}
+
+// Applies the arithmetic opcode to the unboxed operands, the same way
+// ValueCalc does for the boxed ones. The result is stored in a.
+// Returns false on division by zero.
+static bool numericOperation(unsigned type, NumericEntry& a, const NumericEntry& b)
+{
+    switch (type) {
+    case Opcode::Add: a.number = a.number + b.number; break;
+    case Opcode::Sub: a.number = a.number - b.number; break;
+    case Opcode::Mul: a.number = a.number * b.number; break;
+    case Opcode::Div:
+        if (b.number == 0.0)
+            return false;
+        a.number = a.number / b.number;
+        break;
+    default:
+        Q_ASSERT(false);
+        return false;
+    }
+    a.format = numericFormat(a.format, b.format);
+    return true;
+}
+
+static bool isPlainNumber(const Value& value)
+{
+    return (value.type() == Value::Integer) || (value.type() == Value::Float);
+}
+
+// Loads a number, an integer or an empty value, anything else needs the full
+// evaluation.
+static bool loadNumeric(const Value& value, NumericEntry& entry)
+{
+    if (!isPlainNumber(value) && !value.isEmpty())
+        return false;
+    entry.number = value.asFloat();
+    entry.format = value.format();
+    return true;
+}
+
+static bool isNumericOperation(unsigned type)
+{
+    return (type == Opcode::Add) || (type == Opcode::Sub) ||
+           (type == Opcode::Mul) || (type == Opcode::Div);
+}
+
+// The optimizing stage of the compilation:
+// - arithmetics on constants are folded, e.g. 1+2+A1 becomes 3+A1,
+// - the cell and range references into the own sheet are resolved, so that
+//   the evaluation does not parse the reference strings again,
+// - formulas consisting of numbers, cell references and arithmetics only
+//   are marked to be evaluated on plain numbers, see evalNumeric().
+void Formula::Private::optimize() const
+{
+    // constant folding
+    QVector<Opcode> folded;
+    folded.reserve(codes.count());
+    for (int pc = 0; pc < codes.count(); ++pc) {
+        const Opcode& opcode = codes.at(pc);
+        const int count = folded.count();
+        NumericEntry a, b;
+
+        if (isNumericOperation(opcode.type) && count >= 2 &&
+                folded[count - 2].type == Opcode::Load && isPlainNumber(constants.at(folded[count - 2].index)) &&
+                folded[count - 1].type == Opcode::Load && isPlainNumber(constants.at(folded[count - 1].index)) &&
+                loadNumeric(constants.at(folded[count - 2].index), a) &&
+                loadNumeric(constants.at(folded[count - 1].index), b) &&
+                numericOperation(opcode.type, a, b)) {
+            Value value(a.number);
+            value.setFormat(a.format);
+            constants.append(value);
+            folded.resize(count - 2);
+            folded.append(Opcode(Opcode::Load, constants.count() - 1));
+        } else if (opcode.type == Opcode::Neg && count >= 1 &&
+                   folded[count - 1].type == Opcode::Load && isPlainNumber(constants.at(folded[count - 1].index)) &&
+                   loadNumeric(constants.at(folded[count - 1].index), a)) {
+            // same as ValueCalc::mul(a, -1)
+            Value value(a.number * -1);
+            value.setFormat(a.format);
+            constants.append(value);
+            folded.last() = Opcode(Opcode::Load, constants.count() - 1);
+        } else {
+            folded.append(opcode);
+        }
+    }
+    codes = folded;
+
+    // reference resolution
+    if (sheet) {
+        const Map* const map = sheet->map();
+        for (int pc = 0; pc < codes.count(); ++pc) {
+            const Opcode& opcode = codes.at(pc);
+            if (opcode.type != Opcode::Cell && opcode.type != Opcode::Range)
+                continue;
+            const QString text = constants.at(opcode.index).asString();
+            // the named areas may be redefined at any time
+            if (map->namedAreaManager()->contains(text))
+                continue;
+            const Region region(text, map, sheet);
+            // the references into the other sheets are looked up by name,
+            // as those sheets may be removed or replaced
+            if (!region.isValid() || region.firstSheet() != sheet)
+                continue;
+            if (opcode.type == Opcode::Cell && !region.isSingular())
+                continue;
+            if (references.count() < constants.count())
+                references.resize(constants.count());
+            Reference& reference = references[opcode.index];
+            reference.sheet = sheet;
+            reference.rect = region.firstRange();
+            reference.region = region;
+        }
+    }
+
+    // the numeric evaluation
+    numeric = !codes.isEmpty() && (isNumericOperation(codes.last().type) || codes.last().type == Opcode::Neg);
+    for (int pc = 0; numeric && pc < codes.count(); ++pc) {
+        const Opcode& opcode = codes.at(pc);
+        switch (opcode.type) {
+        case Opcode::Load:
+            numeric = isPlainNumber(constants.at(opcode.index));
+            break;
+        case Opcode::Cell:
+            numeric = reference(opcode.index) != 0;
+            break;
+        case Opcode::Add:
+        case Opcode::Sub:
+        case Opcode::Mul:
+        case Opcode::Div:
+        case Opcode::Neg:
+            break;
+        default:
+            numeric = false;
+            break;
+        }
+    }
+}
+
+// Evaluates the formulas marked as numeric by optimize() without the Value
+// allocations. Returns false, if an operand is not a number, i.e. the full
+// evaluation is needed.
+bool Formula::Private::evalNumeric(Value& result) const
+{
+    QVarLengthArray<NumericEntry, 16> stack;
+
+    for (int pc = 0; pc < codes.count(); ++pc) {
+        const Opcode& opcode = codes.at(pc);
+        switch (opcode.type) {
+        case Opcode::Load: {
+            NumericEntry entry;
+            loadNumeric(constants.at(opcode.index), entry);
+            stack.append(entry);
+            break;
+        }
+        case Opcode::Cell: {
+            const Reference& reference = references.at(opcode.index);
+            NumericEntry entry;
+            // reads the typed storage directly, no Value is built
+            if (!reference.sheet->cellStorage()->numericValue(reference.rect.left(), reference.rect.top(),
+                                                              &entry.number, &entry.format))
+                return false;
+            stack.append(entry);
+            break;
+        }
+        case Opcode::Neg:
+            // same as ValueCalc::mul(a, -1)
+            stack.last().number = stack.last().number * -1;
+            break;
+        default: {
+            if (stack.count() < 2)
+                return false;
+            const NumericEntry b = stack.last();
+            stack.removeLast();
+            if (!numericOperation(opcode.type, stack.last(), b)) {
+                result = Value::errorDIV0();
+                return true;
+            }
+            break;
+        }
+        }
+    }
+
+    if (stack.count() != 1)
+        return false;
+    result = Value(stack.last().number);
+    result.setFormat(stack.last().format);
+    return true;
+}
+
 // On OO.org Calc and MS Excel operations done with +, -, * and / do fail if one of the values is
 // non-numeric. This differs from formulas like SUM which just ignores non numeric values.
 Value numericOrError(const ValueConverter* converter, const Value &v)
@@ -1537,6 +1786,30 @@ Value Formula::evalRecursive(CellIndirection cellIndirections, QHash<Cell, Value
     QString c;
     QVector<Value> args;
 
+    if (d->dirty.loadAcquire()) {
+        // The formulas may be evaluated concurrently, see RecalcManager.
+        // Only the ones that have not been evaluated before, e.g. those
+        // referred to by MULTIPLE.OPERATIONS, are compiled here.
+        // compile() clears the flag last, so the other threads wait
+        // here until the program is complete.
+        QMutexLocker locker(&s_compileMutex);
+        if (d->dirty.loadAcquire()) {
+            Tokens tokens = scan(d->expression);
+            d->valid = tokens.valid();
+            if (tokens.valid())
+                compile(tokens);
+        }
+    }
+
+    if (!d->valid)
+        return Value::errorPARSE();
+
+    if (d->numeric && cellIndirections.isEmpty()) {
+        Value result;
+        if (d->evalNumeric(result))
+            return result;
+    }
+
     const Map* map = d->sheet ? d->sheet->map() : new Map(0 /*document*/);
     const ValueConverter* converter = map->converter();
     ValueCalc* calc = map->calc();
@@ -1549,19 +1822,9 @@ Value Formula::evalRecursive(CellIndirection cellIndirections, QHash<Cell, Value
         fe.myrow = d->cell.row();
     }
 
-    if (d->dirty) {
-        Tokens tokens = scan(d->expression);
-        d->valid = tokens.valid();
-        if (tokens.valid())
-            compile(tokens);
-    }
-
-    if (!d->valid)
-        return Value::errorPARSE();
-
     for (int pc = 0; pc < d->codes.count(); pc++) {
         Value ret;   // for the function caller
-        Opcode& opcode = d->codes[pc];
+        const Opcode& opcode = d->codes.at(pc);
         index = opcode.index;
         switch (opcode.type) {
             // no operation
@@ -1571,7 +1834,7 @@ Value Formula::evalRecursive(CellIndirection cellIndirections, QHash<Cell, Value
             // load a constant, push to stack
         case Opcode::Load:
             entry.reset();
-            entry.val = d->constants[index];
+            entry.val = d->constants.at(index);
             stack.push(entry);
             break;
 
@@ -1649,8 +1912,8 @@ Value Formula::evalRecursive(CellIndirection cellIndirections, QHash<Cell, Value
         case Opcode::Intersect: {
             val1 = stack.pop().val;
             val2 = stack.pop().val;
-            Region r1(d->constants[index].asString(), map, d->sheet);
-            Region r2(d->constants[index+1].asString(), map, d->sheet);
+            Region r1(d->constants.at(index).asString(), map, d->sheet);
+            Region r2(d->constants.at(index+1).asString(), map, d->sheet);
             if(!r1.isValid() || !r2.isValid()) {
                 val1 = Value::errorNULL();
             } else {
@@ -1761,11 +2024,12 @@ Value Formula::evalRecursive(CellIndirection cellIndirections, QHash<Cell, Value
 
         // cell in a sheet
         case Opcode::Cell: {
-            c = d->constants[index].asString();
+            c = d->constants.at(index).asString();
             val1 = Value::empty();
             entry.reset();
 
-            const Region region(c, map, d->sheet);
+            const Reference* reference = d->reference(index);
+            const Region region = reference ? reference->region : Region(c, map, d->sheet);
             if (!region.isValid()) {
                 val1 = Value::errorREF();
             } else if (region.isSingular()) {
@@ -1790,7 +2054,7 @@ Value Formula::evalRecursive(CellIndirection cellIndirections, QHash<Cell, Value
                 entry.col1 = entry.col2 = position.x();
                 entry.row1 = entry.row2 = position.y();
                 entry.reg = region;
-                entry.regIsNamedOrLabeled = map->namedAreaManager()->contains(c);
+                entry.regIsNamedOrLabeled = !reference && map->namedAreaManager()->contains(c);
             } else {
                 kWarning() << "Unhandled non singular region in Opcode::Cell with rects=" << region.rects();
             }
@@ -1801,11 +2065,12 @@ Value Formula::evalRecursive(CellIndirection cellIndirections, QHash<Cell, Value
 
         // selected range in a sheet
         case Opcode::Range: {
-            c = d->constants[index].asString();
+            c = d->constants.at(index).asString();
             val1 = Value::empty();
             entry.reset();
 
-            const Region region(c, map, d->sheet);
+            const Reference* reference = d->reference(index);
+            const Region region = reference ? reference->region : Region(c, map, d->sheet);
             if (region.isValid()) {
                 val1 = region.firstSheet()->cellStorage()->valueRegion(region);
                 // store the reference, so we can use it within functions
@@ -1814,7 +2079,7 @@ Value Formula::evalRecursive(CellIndirection cellIndirections, QHash<Cell, Value
                 entry.col2 = region.firstRange().right();
                 entry.row2 = region.firstRange().bottom();
                 entry.reg = region;
-                entry.regIsNamedOrLabeled = map->namedAreaManager()->contains(c);
+                entry.regIsNamedOrLabeled = !reference && map->namedAreaManager()->contains(c);
             }
 
             entry.val = val1; // any array is valid here
@@ -1824,7 +2089,7 @@ Value Formula::evalRecursive(CellIndirection cellIndirections, QHash<Cell, Value
 
         // reference
         case Opcode::Ref:
-            val1 = d->constants[index];
+            val1 = d->constants.at(index);
             entry.reset();
             entry.val = val1;
             stack.push(entry);
@@ -1872,8 +2137,8 @@ Value Formula::evalRecursive(CellIndirection cellIndirections, QHash<Cell, Value
 #ifdef CALLIGRA_SHEETS_INLINE_ARRAYS
             // creating an array
         case Opcode::Array: {
-            const int cols = d->constants[index].asInteger();
-            const int rows = d->constants[index+1].asInteger();
+            const int cols = d->constants.at(index).asInteger();
+            const int rows = d->constants.at(index+1).asInteger();
             // check if enough array elements are available
             if (stack.count() < cols * rows)
                 return Value::errorVALUE();
@@ -1921,7 +2186,7 @@ QString Formula::dump() const
 {
     QString result;
 
-    if (d->dirty) {
+    if (d->dirty.loadAcquire()) {
         Tokens tokens = scan(d->expression);
         compile(tokens);
     }
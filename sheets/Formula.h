@@ -374,6 +374,9 @@ public:
      * occurrences of a references to certain cells with references to
      * different cells. If this mapping is non-empty this does mean
      * that intermediate results can't be cached.
+     *
+     * Different formulas may be evaluated concurrently, as long as no
+     * cell values are modified meanwhile.
      */
     Value eval(CellIndirection cellIndirections = CellIndirection()) const;
 
@@ -20,10 +20,13 @@
 #ifndef CALLIGRA_SHEETS_POINT_STORAGE
 #define CALLIGRA_SHEETS_POINT_STORAGE
 
+#include <QPair>
 #include <QRect>
 #include <QString>
 #include <QVector>
 
+#include <algorithm>
+
 #include "Region.h"
 #include "calligra_sheets_limits.h"
 
@@ -34,6 +37,19 @@ namespace Calligra
 namespace Sheets
 {
 
+/**
+ * \return the elements of \p data at \p indices
+ * \see PointStorage::subStorage()
+ */
+template<typename Vector>
+Vector selectElements(const Vector& data, const QVector<int>& indices)
+{
+    Vector result;
+    for (int i = 0; i < indices.count(); ++i)
+        result.append(data.value(indices[i]));
+    return result;
+}
+
 /**
  * \ingroup Storage
  * A custom pointwise storage.
@@ -61,8 +77,12 @@ namespace Sheets
  * \note For data assigned to rectangular regions use RectStorage.
  * \note It's QVector based. To boost performance a lot, declare the stored
  *       data type as movable.
+ * \note The container of the data can be replaced by \p Vector . It has to
+ *       provide QVector's append(), insert(), replace(), remove(), value(),
+ *       mid(), count(), clear() and operator==(). To copy its elements
+ *       faster than by value, overload selectElements() for it.
  */
-template<typename T>
+template<typename T, typename Vector = QVector<T> >
 class PointStorage
 {
     friend class PointStorageBenchmark;
@@ -145,11 +165,11 @@ public:
             // column exists
             else {
                 const int index = m_rows.value(row - 1) + (cit - cstart);
-                const T oldData = m_data[ index ];
+                const T oldData = m_data.value(index);
 #ifdef KSPREAD_POINT_STORAGE_HASH
-                m_data[ index ] = *m_usedData.insert(data);
+                m_data.replace(index, *m_usedData.insert(data));
 #else
-                m_data[ index ] = data;
+                m_data.replace(index, data);
 #endif
                 return oldData;
             }
@@ -164,18 +184,30 @@ public:
      * \return the data at the given coordinate
      */
     T lookup(int col, int row, const T& defaultVal = T()) const {
+        const int index = indexOf(col, row);
+        if (index == -1)
+            return defaultVal;
+        return m_data.value(index);
+    }
+
+    /**
+     * Looks up the index of the data at \p col , \p row .
+     * \return the index of the data or -1, if no data was found
+     * \see data()
+     */
+    int indexOf(int col, int row) const {
         Q_ASSERT(1 <= col && col <= KS_colMax);
         Q_ASSERT(1 <= row && row <= KS_rowMax);
         // is the row not present?
         if (row > m_rows.count())
-            return defaultVal;
+            return -1;
         const QVector<int>::const_iterator cstart(m_cols.begin() + m_rows.value(row - 1));
         const QVector<int>::const_iterator cend((row < m_rows.count()) ? (m_cols.begin() + m_rows.value(row)) : m_cols.end());
         const QVector<int>::const_iterator cit = qBinaryFind(cstart, cend, col);
         // is the col not present?
         if (cit == cend)
-            return defaultVal;
-        return m_data.value(m_rows.value(row - 1) + (cit - cstart));
+            return -1;
+        return m_rows.value(row - 1) + (cit - cstart);
     }
 
     /**
@@ -197,7 +229,7 @@ public:
             return defaultVal;
         const int index = rowStart + (cit - cols.constBegin());
         // save the old data
-        const T oldData = m_data[ index ];
+        const T oldData = m_data.value(index);
         // remove the actual data
         m_data.remove(index);
         // remove the column index
@@ -317,7 +349,7 @@ public:
             const int rowStart = m_rows.value(row - 1);
             const int rowLength = (row < m_rows.count()) ? m_rows.value(row) - rowStart : -1;
             const QVector<int> cols = m_cols.mid(rowStart, rowLength);
-            const QVector<T> data = m_data.mid(rowStart, rowLength);
+            const Vector data = m_data.mid(rowStart, rowLength);
             for (int col = 0; col < cols.count(); ++col)
                 oldData.append(qMakePair(QPoint(cols.value(col), row), data.value(col)));
             dataCount += data.count();
@@ -408,7 +440,7 @@ public:
             const int rowStart = m_rows.value(row - 1);
             const int rowLength = (row < m_rows.count()) ? m_rows.value(row) - rowStart : -1;
             const QVector<int> cols = m_cols.mid(rowStart, rowLength);
-            const QVector<T> data = m_data.mid(rowStart, rowLength);
+            const Vector data = m_data.mid(rowStart, rowLength);
             // first, iterate over the destination row
             for (int col = cols.count() - 1; col >= 0; --col) {
                 const int column = cols.value(col); // real column value (1...KS_colMax)
@@ -432,7 +464,7 @@ public:
                     // column exists
                     else {
                         // copy
-                        m_data[rowStart + col] = m_data.value(cit2 - m_cols.constBegin());
+                        m_data.replace(rowStart + col, m_data.value(cit2 - m_cols.constBegin()));
                         // remove
                         m_cols.remove(cit2 - m_cols.constBegin());
                         m_data.remove(cit2 - m_cols.constBegin());
@@ -447,7 +479,7 @@ public:
             const int rowStart2 = (srcRow - 1 < m_rows.count()) ? m_rows.value(srcRow - 1) : m_data.count();
             const int rowLength2 = (srcRow < m_rows.count()) ? m_rows.value(srcRow) - rowStart2 : -1;
             const QVector<int> cols2 = m_cols.mid(rowStart2, rowLength2);
-            const QVector<T> data2 = m_data.mid(rowStart2, rowLength2);
+            const Vector data2 = m_data.mid(rowStart2, rowLength2);
             int offset = 0;
             for (int col = cols2.count() - 1; col >= 0; --col) {
                 const int column = cols2.value(col); // real column value (1...KS_colMax)
@@ -461,7 +493,7 @@ public:
                     if (dstcit != cols.end()) { // destination column exists
                         // replace the existing destination value
                         const int dstCol = (dstcit - cols.constBegin());
-                        m_data[rowStart + dstCol] = m_data.value(rowStart2 + col);
+                        m_data.replace(rowStart + dstCol, m_data.value(rowStart2 + col));
                         // remove it from its old position
                         m_data.remove(rowStart2 + col + 1);
                         m_cols.remove(rowStart2 + col + 1);
@@ -506,7 +538,7 @@ public:
             const int rowStart = m_rows.value(row - 1);
             const int rowLength = (row < m_rows.count()) ? m_rows.value(row) - rowStart : -1;
             const QVector<int> cols = m_cols.mid(rowStart, rowLength);
-            const QVector<T> data = m_data.mid(rowStart, rowLength);
+            const Vector data = m_data.mid(rowStart, rowLength);
             for (int col = cols.count() - 1; col >= 0; --col) {
                 if (cols.value(col) >= rect.left() && cols.value(col) <= rect.right()) {
                     if (row + rect.height() > KS_rowMax) {
@@ -537,7 +569,7 @@ public:
                         // column exists
                         else {
                             const int index = m_rows.value(row2 - 1) + (cit2 - cstart2);
-                            m_data[ index ] = data.value(col);
+                            m_data.replace(index, data.value(col));
                         }
                     }
 
@@ -746,7 +778,7 @@ public:
             const int rowStart = m_rows.value(row);
             const int rowLength = (row + 1 < m_rows.count()) ? m_rows.value(row + 1) - rowStart : -1;
             const QVector<int> cols = m_cols.mid(rowStart, rowLength);
-            const QVector<T> data = m_data.mid(rowStart, rowLength);
+            const Vector data = m_data.mid(rowStart, rowLength);
             int lastCol = 0;
             for (int col = 0; col < cols.count(); ++col) {
                 int counter = cols.value(col) - lastCol;
@@ -826,37 +858,60 @@ public:
      * and all positions are adjusted.
      * \return a subset of the storage stripped down to the values in \p region
      */
-    PointStorage<T> subStorage(const Region& region, bool keepOffset = true) const {
+    PointStorage<T, Vector> subStorage(const Region& region, bool keepOffset = true) const {
         // Determine the offset.
         const QPoint offset = keepOffset ? QPoint(0, 0) : region.boundingRect().topLeft() - QPoint(1, 1);
-        // this generates an array of values
-        PointStorage<T> subStorage;
+        // the positions (row, column) of the values and their indices
+        QVector<QPair<QPair<int, int>, int> > entries;
+        int rectCount = 0;
         Region::ConstIterator end(region.constEnd());
-        for (Region::ConstIterator it(region.constBegin()); it != end; ++it) {
+        for (Region::ConstIterator it(region.constBegin()); it != end; ++it, ++rectCount) {
             const QRect rect = (*it)->rect();
             for (int row = rect.top(); row <= rect.bottom() && row <= m_rows.count(); ++row) {
                 const QVector<int>::const_iterator cstart(m_cols.begin() + m_rows.value(row - 1));
                 const QVector<int>::const_iterator cend((row < m_rows.count()) ? (m_cols.begin() + m_rows.value(row)) : m_cols.end());
                 for (QVector<int>::const_iterator cit = cstart; cit != cend; ++cit) {
-                    if (*cit >= rect.left() && *cit <= rect.right()) {
-                        if (keepOffset)
-                            subStorage.insert(*cit, row, m_data.value(cit - m_cols.begin()));
-                        else
-                            subStorage.insert(*cit - offset.x(), row - offset.y(), m_data.value(cit - m_cols.begin()));
-                    }
+                    if (*cit >= rect.left() && *cit <= rect.right())
+                        entries.append(qMakePair(qMakePair(row - offset.y(), *cit - offset.x()), int(cit - m_cols.begin())));
                 }
             }
         }
+        // the rects may overlap and are not ordered
+        if (rectCount > 1) {
+            std::sort(entries.begin(), entries.end());
+            entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+        }
+        // build the storage row by row and copy the data at once
+        PointStorage<T, Vector> subStorage;
+        QVector<int> indices;
+        indices.reserve(entries.count());
+        subStorage.m_cols.reserve(entries.count());
+        for (int i = 0; i < entries.count(); ++i) {
+            const int row = entries[i].first.first;
+            if (row > subStorage.m_rows.count())
+                subStorage.m_rows.insert(subStorage.m_rows.count(), row - subStorage.m_rows.count(), subStorage.m_cols.count());
+            subStorage.m_cols.append(entries[i].first.second);
+            indices.append(entries[i].second);
+        }
+        subStorage.m_data = selectElements(m_data, indices);
         return subStorage;
     }
 
     /**
      * Equality operator.
      */
-    bool operator==(const PointStorage<T>& o) const {
+    bool operator==(const PointStorage<T, Vector>& o) const {
         return (m_rows == o.m_rows && m_cols == o.m_cols && m_data == o.m_data);
     }
 
+protected:
+    /**
+     * \return the non-default data in the order of data()
+     */
+    const Vector& dataVector() const {
+        return m_data;
+    }
+
 private:
     void squeezeRows() {
         int row = m_rows.count() - 1;
@@ -867,7 +922,7 @@ private:
 private:
     QVector<int> m_cols;    // stores the column indices (beginning with one)
     QVector<int> m_rows;    // stores the row offsets in m_data
-    QVector<T>   m_data;    // stores the actual non-default data
+    Vector       m_data;    // stores the actual non-default data
 
 #ifdef KSPREAD_POINT_STORAGE_HASH
     QSet<T> m_usedData;
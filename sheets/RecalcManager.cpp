@@ -38,9 +38,25 @@
 
 #include <QHash>
 #include <QMap>
+#include <QThread>
+#include <QtConcurrentMap>
 
 using namespace Calligra::Sheets;
 
+namespace
+{
+/**
+ * The minimum number of formulas of one depth level that are worth
+ * evaluating in the thread pool.
+ */
+const int minimumParallelCellsCount = 64;
+
+Value evaluateFormula(const Cell& cell)
+{
+    return cell.formula().eval();
+}
+}
+
 class Q_DECL_HIDDEN RecalcManager::Private
 {
 public:
@@ -66,6 +82,12 @@ public:
      */
     void cellsToCalculate(const Region& region, QSet<Cell>& cells) const;
 
+    /**
+     * Stores the evaluation \p result of the formula in \p cell .
+     * Must be called in the thread owning the map.
+     */
+    void setResult(const Cell& cell, const Value& result) const;
+
     /*
      * Stores cells ordered by its reference depth.
      * Depth means the maximum depth of all cells this cell depends on plus one,
@@ -159,6 +181,26 @@ void RecalcManager::Private::cellsToCalculate(const Region& region, QSet<Cell>&
     }
 }
 
+void RecalcManager::Private::setResult(const Cell& cell, const Value& result) const
+{
+    const Sheet* sheet = cell.sheet();
+
+    if (result.isArray() && (result.columns() > 1 || result.rows() > 1)) {
+        const QRect rect = cell.lockedCells();
+        // unlock
+        sheet->cellStorage()->unlockCells(rect.left(), rect.top());
+        for (int row = rect.top(); row <= rect.bottom(); ++row) {
+            for (int col = rect.left(); col <= rect.right(); ++col) {
+                Cell(sheet, col, row).setValue(result.element(col - rect.left(), row - rect.top()));
+            }
+        }
+        // relock
+        sheet->cellStorage()->lockCells(rect);
+    } else {
+        Cell(cell).setValue(result);
+    }
+}
+
 RecalcManager::RecalcManager(Map *const map)
         : QObject(map)
         , d(new Private)
@@ -236,36 +278,44 @@ void RecalcManager::recalc(KoUpdater *updater)
     if (updater)
         updater->setProgress(0);
 
-    const QList<Cell> cells = d->cells.values();
-    const int cellsCount = cells.count();
-    for (int c = 0; c < cellsCount; ++c) {
-        // only recalculate, if no circular dependency occurred
-        if (cells.value(c).value() == Value::errorCIRCLE())
-            continue;
-        // Check for valid formula; parses the expression, if not done already.
-        if (!cells.value(c).formula().isValid())
-            continue;
-
-        const Sheet* sheet = cells.value(c).sheet();
-
-        // evaluate the formula and set the result
-        Value result = cells.value(c).formula().eval();
-        if (result.isArray() && (result.columns() > 1 || result.rows() > 1)) {
-            const QRect rect = cells.value(c).lockedCells();
-            // unlock
-            sheet->cellStorage()->unlockCells(rect.left(), rect.top());
-            for (int row = rect.top(); row <= rect.bottom(); ++row) {
-                for (int col = rect.left(); col <= rect.right(); ++col) {
-                    Cell(sheet, col, row).setValue(result.element(col - rect.left(), row - rect.top()));
-                }
-            }
-            // relock
-            sheet->cellStorage()->lockCells(rect);
+    const bool parallel = QThread::idealThreadCount() > 1;
+    const int cellsCount = d->cells.count();
+    int processedCount = 0;
+
+    const QList<int> depths = d->cells.uniqueKeys();
+    foreach (int depth, depths) {
+        const QList<Cell> levelCells = d->cells.values(depth);
+
+        // The formulas are parsed and compiled here, so that the
+        // evaluation does not modify them.
+        QList<Cell> cells;
+        for (int c = 0; c < levelCells.count(); ++c) {
+            // only recalculate, if no circular dependency occurred
+            if (levelCells[c].value() == Value::errorCIRCLE())
+                continue;
+            // Check for valid formula; parses the expression, if not done already.
+            if (!levelCells[c].formula().isValid())
+                continue;
+            cells.append(levelCells[c]);
+        }
+
+        // The cells of one depth do not depend on each other and all
+        // the cells they depend on have been calculated already.
+        QList<Value> results;
+        if (parallel && cells.count() >= minimumParallelCellsCount) {
+            results = QtConcurrent::blockingMapped<QList<Value> >(cells, evaluateFormula);
         } else {
-            Cell(cells.value(c)).setValue(result);
+            for (int c = 0; c < cells.count(); ++c)
+                results.append(evaluateFormula(cells[c]));
         }
+
+        for (int c = 0; c < cells.count(); ++c) {
+            d->setResult(cells[c], results[c]);
+        }
+
+        processedCount += levelCells.count();
         if (updater)
-            updater->setProgress(int(qreal(c) / qreal(cellsCount) * 100.));
+            updater->setProgress(int(qreal(processedCount) / qreal(cellsCount) * 100.));
     }
 
     if (updater)
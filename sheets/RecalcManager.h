@@ -51,6 +51,12 @@ class Sheet;
  *
  * Cell value changes are blocked while doing this, i.e. they do not
  * trigger a new recalculation event.
+ *
+ * The cells of one depth do not refer to each other, so their formulas
+ * are evaluated concurrently. The results are written into the cell
+ * storages by the calling thread once the whole depth level has been
+ * evaluated, before the next level starts. The formulas still read the
+ * storages concurrently, so the caches that the reads fill are locked.
  */
 class CALLIGRA_SHEETS_ODF_EXPORT RecalcManager : public QObject
 {
@@ -117,9 +123,8 @@ public Q_SLOTS:
 protected:
     /**
      * Iterates over the map of cell with their reference depths
-     * and calls recalcCell().
-     *
-     * \see recalcCell()
+     * and evaluates the formulas of every depth level, in parallel
+     * if the level is big enough.
      */
     void recalc(KoUpdater *updater = 0);
 
@@ -26,10 +26,8 @@
 #include <QTimer>
 #include <QRunnable>
 #include <QTime>
-#ifdef CALLIGRA_SHEETS_MT
 #include <QMutex>
 #include <QMutexLocker>
-#endif
 
 #include "calligra_sheets_export.h"
 
@@ -181,9 +179,9 @@ private:
     QMap<int, QPair<QRectF, T> > m_possibleGarbage;
     QList<T> m_storedData;
     mutable QCache<QPoint, T> m_cache;
-#ifdef CALLIGRA_SHEETS_MT
+    // guards the cache and the lazy loading, the formulas are evaluated
+    // concurrently, see RecalcManager
     mutable QMutex m_mutex;
-#endif
     mutable QRegion m_cachedArea;
 
     RectStorageLoader<T>* m_loader;
@@ -232,12 +230,9 @@ RectStorage<T>::~RectStorage()
 template<typename T>
 T RectStorage<T>::contains(const QPoint& point) const
 {
-    ensureLoaded();
-#ifdef CALLIGRA_SHEETS_MT
-    QMutexLocker ml(&m_mutex);
-#endif
     if (!usedArea().contains(point))
         return T();
+    QMutexLocker ml(&m_mutex);
     // first, lookup point in the cache
     if (m_cache.contains(point)) {
         return *m_cache.object(point);
@@ -531,9 +526,7 @@ void RectStorage<T>::invalidateCache(const QRect& invRect)
 {
     if (m_loader && !m_loader->isFinished())
         return;
-#ifdef CALLIGRA_SHEETS_MT
     QMutexLocker ml(&m_mutex);
-#endif
     const QVector<QRect> rects = m_cachedArea.intersected(invRect).rects();
     m_cachedArea = m_cachedArea.subtracted(invRect);
     foreach(const QRect& rect, rects) {
@@ -547,6 +540,7 @@ void RectStorage<T>::invalidateCache(const QRect& invRect)
 template<typename T>
 void RectStorage<T>::ensureLoaded() const
 {
+    QMutexLocker ml(&m_mutex);
     if (m_loader) {
         m_loader->waitForFinished();
         delete m_loader;
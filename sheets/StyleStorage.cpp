@@ -25,10 +25,8 @@
 #include <QRegion>
 #include <QTimer>
 #include <QRunnable>
-#ifdef CALLIGRA_SHEETS_MT
 #include <QMutex>
 #include <QMutexLocker>
-#endif
 
 #include "Global.h"
 #include "Map.h"
@@ -46,9 +44,7 @@ class Q_DECL_HIDDEN StyleStorage::Private
 {
 public:
     Private()
-#ifdef CALLIGRA_SHEETS_MT
         : cacheMutex(QMutex::Recursive)
-#endif
     {}
     Map* map;
     RTree<SharedSubStyle> tree;
@@ -60,9 +56,9 @@ public:
     QCache<QPoint, Style> cache;
     QRegion cachedArea;
     StyleStorageLoaderJob* loader;
-#ifdef CALLIGRA_SHEETS_MT
+    // guards the cache and the lazy loading, the formulas are evaluated
+    // concurrently, see RecalcManager
     QMutex cacheMutex;
-#endif
 
     void ensureLoaded();
 };
@@ -108,9 +104,7 @@ void StyleStorageLoaderJob::run()
     d->usedColumns.clear();
     d->usedRows.clear();
     {
-#ifdef CALLIGRA_SHEETS_MT
-        QMutexLocker(&d->cacheMutex);
-#endif
+        QMutexLocker ml(&d->cacheMutex);
         d->cachedArea = QRegion();
         d->cache.clear();
     }
@@ -168,6 +162,7 @@ void StyleStorageLoaderJob::run()
 
 void StyleStorage::Private::ensureLoaded()
 {
+    QMutexLocker ml(&cacheMutex);
     if (loader) {
         loader->waitForFinished();
         delete loader;
@@ -215,9 +210,7 @@ Style StyleStorage::contains(const QPoint& point) const
         return *styleManager()->defaultStyle();
 
     {
-#ifdef CALLIGRA_SHEETS_MT
         QMutexLocker ml(&d->cacheMutex);
-#endif
         // first, lookup point in the cache
         if (d->cache.contains(point)) {
     //         kDebug(36006) <<"StyleStorage: Using cached style for" << cellName;
@@ -228,32 +221,16 @@ Style StyleStorage::contains(const QPoint& point) const
     // not found, lookup in the tree
     QList<SharedSubStyle> subStyles = d->tree.contains(point);
 
-    if (subStyles.isEmpty()) {
-        Style *style = styleManager()->defaultStyle();
-        // let's try caching empty styles too, the lookup is rather expensive still
-        {
-#ifdef CALLIGRA_SHEETS_MT
-            QMutexLocker ml(&d->cacheMutex);
-#endif
-            // insert style into the cache
-            d->cache.insert(point, style);
-            d->cachedArea += QRect(point, point);
-        }
+    // let's try caching empty styles too, the lookup is rather expensive still
+    const Style style = subStyles.isEmpty() ? *styleManager()->defaultStyle() : composeStyle(subStyles);
 
-        return *style;
-    }
-    Style* style = new Style();
-    (*style) = composeStyle(subStyles);
-
-    {
-#ifdef CALLIGRA_SHEETS_MT
-        QMutexLocker ml(&d->cacheMutex);
-#endif
-        // insert style into the cache
-        d->cache.insert(point, style);
+    QMutexLocker ml(&d->cacheMutex);
+    // insert style into the cache, unless another thread was faster
+    if (!d->cache.contains(point)) {
+        d->cache.insert(point, new Style(style));
         d->cachedArea += QRect(point, point);
     }
-    return *style;
+    return style;
 }
 
 Style StyleStorage::contains(const QRect& rect) const
@@ -673,9 +650,7 @@ void StyleStorage::invalidateCache()
     if (d->loader && !d->loader->isFinished())
         return;
 
-#ifdef CALLIGRA_SHEETS_MT
     QMutexLocker ml(&d->cacheMutex);
-#endif
     d->cache.clear();
     d->cachedArea = QRegion();
 }
@@ -838,9 +813,7 @@ void StyleStorage::invalidateCache(const QRect& rect)
     if (d->loader && !d->loader->isFinished())
         return;
 
-#ifdef CALLIGRA_SHEETS_MT
     QMutexLocker ml(&d->cacheMutex);
-#endif
 //     kDebug(36006) <<"StyleStorage: Invalidating" << rect;
     const QRegion region = d->cachedArea.intersected(rect);
     d->cachedArea = d->cachedArea.subtracted(rect);
@@ -597,6 +597,13 @@ unsigned Value::count() const
     return d->pa->storage().count();
 }
 
+const ValueStorage* Value::storage() const
+{
+    if (d->type != Array) return 0;
+    if (!d->pa) return 0;
+    return &d->pa->storage();
+}
+
 // reference to empty value
 const Value& Value::empty()
 {
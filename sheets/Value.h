@@ -373,6 +373,13 @@ public:
      */
     unsigned count() const;
 
+    /**
+     * If this value is an array, return the storage of its elements.
+     * Returns 0 if isArray() returns false.
+     * Usable to iterate over the typed element data, \see ValueVector.
+     */
+    const ValueStorage* storage() const;
+
     /**
      * Returns error message associated with this value.
      *
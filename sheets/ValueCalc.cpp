@@ -23,6 +23,7 @@
 #include "Cell.h"
 #include "Number.h"
 #include "ValueConverter.h"
+#include "ValueStorage.h"
 #include "CalculationSettings.h"
 
 #include <QRegExp>
@@ -191,6 +192,116 @@ void awDevSqA(ValueCalc *c, Value &res, Value val,
 }
 
 
+// Aggregations over the typed element data of arrays, see ValueVector.
+// They return false, if the range has no typed data or contains nested
+// arrays. Then, the caller has to walk the range with the functions above.
+
+// Adds the numbers in range to res like arrayWalk() with awSum or awSumA.
+// The numbers are summed up in storage order as Number, so that the result
+// does not differ from the one of the array walk.
+static bool sumTyped(ValueCalc *c, const Value &range, bool full, Value &res)
+{
+    const ValueStorage *storage = range.storage();
+    if (!storage)
+        return false;
+    if (res.isError())
+        return true;
+
+    const ValueVector &values = storage->values();
+    const quint8 *types = values.types();
+    const ValueVector::Payload *payloads = values.payloads();
+    const Number *numbers = values.numbers();
+    const int count = values.count();
+
+    Number sum = res.asFloat();
+    bool added = false;
+    Value error;
+    for (int i = 0; i < count; ++i) {
+        switch (ValueVector::kind(types[i])) {
+        case ValueVector::Boolean:
+            if (!full)
+                break;
+            // fall through
+        case ValueVector::Integer:
+            sum += static_cast<Number>(payloads[i].integer);
+            added = true;
+            break;
+        case ValueVector::Float:
+            sum += Number(payloads[i].number);
+            added = true;
+            break;
+        case ValueVector::WideFloat:
+            sum += numbers[payloads[i].index];
+            added = true;
+            break;
+        case ValueVector::String:
+        case ValueVector::Other: {
+            const Value value = values.value(i);
+            if (value.isArray())
+                return false;
+            if (value.isEmpty() || (!full && value.isString()))
+                break;
+            if (value.isError()) {
+                // awSum keeps the last error, add() the first one
+                if (!full || !error.isError())
+                    error = value;
+                break;
+            }
+            sum += c->conv()->toFloat(value);
+            added = true;
+            break;
+        }
+        }
+    }
+    if (error.isError())
+        res = error;
+    else if (added)
+        res = Value(sum);
+    return true;
+}
+
+// Counts the numbers in range like arrayWalk() with awCount or awCountA.
+static bool countTyped(const Value &range, bool full, int &res)
+{
+    const ValueStorage *storage = range.storage();
+    if (!storage)
+        return false;
+
+    const ValueVector &values = storage->values();
+    const quint8 *types = values.types();
+    const int count = values.count();
+
+    // the kinds counted without looking at the values, one bit per kind
+    const unsigned int numberKinds = (1 << ValueVector::Integer) | (1 << ValueVector::Float) |
+                                     (1 << ValueVector::WideFloat);
+    const unsigned int countedKinds = full ? numberKinds | (1 << ValueVector::Boolean) |
+                                      (1 << ValueVector::String) : numberKinds;
+
+    // no branches, so that the loop gets vectorized
+    int counted = 0;
+    int others = 0;
+    for (int i = 0; i < count; ++i) {
+        const unsigned int kind = ValueVector::kind(types[i]);
+        counted += (countedKinds >> kind) & 1;
+        others += (kind == unsigned(ValueVector::Other));
+    }
+
+    for (int i = 0; others > 0 && i < count; ++i) {
+        if (ValueVector::kind(types[i]) != ValueVector::Other)
+            continue;
+        --others;
+        const Value value = values.value(i);
+        if (value.isArray())
+            return false;
+        if (value.isEmpty())
+            continue;
+        if (full || (!value.isBoolean() && !value.isString() && !value.isError()))
+            ++counted;
+    }
+    res += counted;
+    return true;
+}
+
 // ***********************
 // ****** ValueCalc ******
 // ***********************
@@ -1926,14 +2037,18 @@ void ValueCalc::registerAwFunc(const QString &name, arrayWalkFunc func)
 Value ValueCalc::sum(const Value &range, bool full)
 {
     Value res(0);
-    arrayWalk(range, res, full ? awSumA : awSum, Value(0));
+    if (!sumTyped(this, range, full, res))
+        arrayWalk(range, res, full ? awSumA : awSum, Value(0));
     return res;
 }
 
 Value ValueCalc::sum(QVector<Value> range, bool full)
 {
     Value res(0);
-    arrayWalk(range, res, full ? awSumA : awSum, Value(0));
+    for (int i = 0; i < range.count(); ++i) {
+        if (!sumTyped(this, range[i], full, res))
+            arrayWalk(range[i], res, full ? awSumA : awSum, Value(0));
+    }
     return res;
 }
 
@@ -2192,6 +2307,9 @@ Value ValueCalc::averageIfs(const Cell &avgRangeStart, QList<Value> range, QList
 
 int ValueCalc::count(const Value &range, bool full)
 {
+    int cnt = 0;
+    if (countTyped(range, full, cnt))
+        return cnt;
     Value res(0);
     arrayWalk(range, res, full ? awCountA : awCount, Value(0));
     return converter->asInteger(res).asInteger();
@@ -2199,9 +2317,10 @@ int ValueCalc::count(const Value &range, bool full)
 
 int ValueCalc::count(QVector<Value> range, bool full)
 {
-    Value res(0);
-    arrayWalk(range, res, full ? awCountA : awCount, Value(0));
-    return converter->asInteger(res).asInteger();
+    int cnt = 0;
+    for (int i = 0; i < range.count(); ++i)
+        cnt += count(range[i], full);
+    return cnt;
 }
 
 int ValueCalc::countIf(const Value &range, const Condition &cond)
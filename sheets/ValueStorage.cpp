@@ -0,0 +1,303 @@
+/* This file is part of the KDE project
+   Copyright (c) 2015 Calligra developers
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+// Local
+#include "ValueStorage.h"
+
+using namespace Calligra::Sheets;
+
+namespace
+{
+
+template<typename T>
+int takeSlot(QVector<T>& items, QVector<int>& freeSlots, const T& data)
+{
+    if (freeSlots.isEmpty()) {
+        items.append(data);
+        return items.count() - 1;
+    }
+    const int index = freeSlots.takeLast();
+    items[index] = data;
+    return index;
+}
+
+bool isInline(ValueVector::Kind kind)
+{
+    return kind == ValueVector::Boolean || kind == ValueVector::Integer || kind == ValueVector::Float;
+}
+
+} // namespace
+
+void ValueVector::clear()
+{
+    m_types.clear();
+    m_payloads.clear();
+    m_numbers.clear();
+    m_freeNumbers.clear();
+    m_strings.clear();
+    m_stringRefs.clear();
+    m_stringIds.clear();
+    m_freeStrings.clear();
+    m_values.clear();
+    m_freeValues.clear();
+}
+
+void ValueVector::append(const Value& value)
+{
+    Payload payload;
+    m_types.append(encode(value, &payload));
+    m_payloads.append(payload);
+}
+
+void ValueVector::insert(int index, const Value& value)
+{
+    Payload payload;
+    m_types.insert(index, encode(value, &payload));
+    m_payloads.insert(index, payload);
+}
+
+void ValueVector::replace(int index, const Value& value)
+{
+    // encode first, the value may be the one replaced
+    Payload payload;
+    const quint8 type = encode(value, &payload);
+    release(m_types[index], m_payloads[index]);
+    m_types[index] = type;
+    m_payloads[index] = payload;
+}
+
+void ValueVector::remove(int index)
+{
+    release(m_types[index], m_payloads[index]);
+    m_types.remove(index);
+    m_payloads.remove(index);
+}
+
+Value ValueVector::value(int index) const
+{
+    if (index < 0 || index >= m_types.count())
+        return Value();
+    const quint8 type = m_types[index];
+    const Payload& payload = m_payloads[index];
+    Value result;
+    switch (kind(type)) {
+    case Boolean:
+        result = Value(payload.integer != 0);
+        break;
+    case Integer:
+        result = Value(payload.integer);
+        break;
+    case Float:
+        result = Value(payload.number);
+        break;
+    case WideFloat:
+        result = Value(m_numbers[payload.index]);
+        break;
+    case String:
+        result = Value(m_strings[payload.index]);
+        break;
+    case Other:
+        return m_values[payload.index];
+    }
+    result.setFormat(format(type));
+    return result;
+}
+
+Number ValueVector::toFloat(int index) const
+{
+    const Payload& payload = m_payloads[index];
+    switch (kind(m_types[index])) {
+    case Boolean:
+    case Integer:
+        return static_cast<Number>(payload.integer);
+    case Float:
+        return Number(payload.number);
+    case WideFloat:
+        return m_numbers[payload.index];
+    default:
+        Q_ASSERT(false);
+        return 0.0;
+    }
+}
+
+ValueVector ValueVector::mid(int position, int length) const
+{
+    const int start = qMax(0, position);
+    const int end = (length < 0 || position + length > m_types.count()) ? m_types.count() : position + length;
+    ValueVector vector = sharingStrings();
+    vector.m_types.reserve(end - start);
+    vector.m_payloads.reserve(end - start);
+    for (int i = start; i < end; ++i)
+        vector.appendFrom(*this, i);
+    return vector;
+}
+
+ValueVector ValueVector::select(const QVector<int>& indices) const
+{
+    ValueVector vector = sharingStrings();
+    vector.m_types.reserve(indices.count());
+    vector.m_payloads.reserve(indices.count());
+    for (int i = 0; i < indices.count(); ++i)
+        vector.appendFrom(*this, indices[i]);
+    return vector;
+}
+
+bool ValueVector::operator==(const ValueVector& other) const
+{
+    if (m_types.count() != other.m_types.count())
+        return false;
+    for (int i = 0; i < m_types.count(); ++i) {
+        if (m_types[i] == other.m_types[i] && isInline(kind(m_types[i])) &&
+                m_payloads[i].integer == other.m_payloads[i].integer)
+            continue;
+        if (!(value(i) == other.value(i)))
+            return false;
+    }
+    return true;
+}
+
+ValueVector ValueVector::sharingStrings() const
+{
+    ValueVector vector;
+    vector.m_strings = m_strings;
+    vector.m_stringIds = m_stringIds;
+    vector.m_freeStrings = m_freeStrings;
+    return vector;
+}
+
+void ValueVector::appendFrom(const ValueVector& other, int index)
+{
+    const quint8 type = other.m_types[index];
+    Payload payload = other.m_payloads[index];
+    switch (kind(type)) {
+    case WideFloat:
+        payload.index = takeSlot(m_numbers, m_freeNumbers, other.m_numbers[payload.index]);
+        break;
+    case String:
+        // the dictionary is shared, see sharingStrings()
+        if (!m_stringRefs.isEmpty())
+            ++m_stringRefs[payload.index];
+        break;
+    case Other:
+        payload.index = takeSlot(m_values, m_freeValues, other.m_values[payload.index]);
+        break;
+    default:
+        break;
+    }
+    m_types.append(type);
+    m_payloads.append(payload);
+}
+
+void ValueVector::countStringRefs()
+{
+    if (m_stringRefs.count() == m_strings.count())
+        return;
+    m_stringRefs.fill(0, m_strings.count());
+    for (int i = 0; i < m_types.count(); ++i) {
+        if (kind(m_types[i]) == String)
+            ++m_stringRefs[m_payloads[i].index];
+    }
+    // the free slots are null already
+    for (int index = 0; index < m_strings.count(); ++index) {
+        if (m_stringRefs[index] == 0 && !m_strings[index].isNull()) {
+            m_stringIds.remove(m_strings[index]);
+            m_strings[index] = QString();
+            m_freeStrings.append(index);
+        }
+    }
+}
+
+quint8 ValueVector::encode(const Value& value, Payload* payload)
+{
+    // the payload is compared bitwise, so do not leave bits uninitialized
+    payload->integer = 0;
+    Kind kind = Other;
+    switch (value.type()) {
+    case Value::Boolean:
+        kind = Boolean;
+        payload->integer = value.asBoolean() ? 1 : 0;
+        break;
+    case Value::Integer:
+        kind = Integer;
+        payload->integer = value.asInteger();
+        break;
+    case Value::Float: {
+        const Number number = value.asFloat();
+        const double approximation = double(numToDouble(number));
+        if (Number(approximation) == number) {
+            kind = Float;
+            payload->number = approximation;
+        } else {
+            kind = WideFloat;
+            payload->index = takeSlot(m_numbers, m_freeNumbers, number);
+        }
+        break;
+    }
+    case Value::String: {
+        const QString string = value.asString();
+        // the dictionary does not distinguish null and empty strings
+        if (string.isNull()) {
+            payload->index = takeSlot(m_values, m_freeValues, value);
+            break;
+        }
+        countStringRefs();
+        const QHash<QString, int>::ConstIterator it = m_stringIds.constFind(string);
+        if (it != m_stringIds.constEnd()) {
+            payload->index = it.value();
+            ++m_stringRefs[it.value()];
+        } else {
+            payload->index = takeSlot(m_strings, m_freeStrings, string);
+            if (payload->index < m_stringRefs.count())
+                m_stringRefs[payload->index] = 1;
+            else
+                m_stringRefs.append(1);
+            m_stringIds.insert(string, payload->index);
+        }
+        kind = String;
+        break;
+    }
+    default:
+        payload->index = takeSlot(m_values, m_freeValues, value);
+        break;
+    }
+    return quint8(kind) | quint8(value.format() << 4);
+}
+
+void ValueVector::release(quint8 type, const Payload& payload)
+{
+    switch (kind(type)) {
+    case WideFloat:
+        m_freeNumbers.append(payload.index);
+        break;
+    case String:
+        countStringRefs();
+        if (--m_stringRefs[payload.index] == 0) {
+            m_stringIds.remove(m_strings[payload.index]);
+            m_strings[payload.index] = QString();
+            m_freeStrings.append(payload.index);
+        }
+        break;
+    case Other:
+        m_values[payload.index] = Value();
+        m_freeValues.append(payload.index);
+        break;
+    default:
+        break;
+    }
+}
@@ -20,37 +20,229 @@
 #ifndef KSPREAD_VALUE_STORAGE
 #define KSPREAD_VALUE_STORAGE
 
+#include <QHash>
+#include <QString>
+#include <QVector>
+
 #include "PointStorage.h"
+#include "Value.h"
 
 namespace Calligra
 {
 namespace Sheets
 {
 
+/**
+ * \class ValueVector
+ * \ingroup Storage
+ * \ingroup Value
+ * Stores the values of a ValueStorage by their type.
+ *
+ * Each value occupies a type byte (its kind and its format) and an eight
+ * byte payload in two contiguous arrays, instead of a pointer to a
+ * separately allocated Value::Private:
+ * \li booleans and integers are stored in the payload,
+ * \li floats, that are representable as double without loss, are stored
+ * in the payload as double, the other ones in an array of Numbers,
+ * \li strings are stored once in a dictionary, the payload is their index,
+ * \li all other values (empty, complex, arrays, errors) are kept as Value.
+ *
+ * The calculation iterates over the typed arrays directly, \see types() and
+ * payloads(), or reads single elements by kindAt(), toFloat() and string()
+ * without building a Value. The slots of the Numbers, the strings and the
+ * Values are reused after their removal.
+ *
+ * The vectors returned by mid() and select() share the string dictionary
+ * with this one, so copying a string does not look it up again. The
+ * references to the shared strings are counted, once the copy is modified.
+ *
+ * The elements keep the order of the PointStorage, i.e. row by row, so the
+ * arrays are not split into columns.
+ */
+class CALLIGRA_SHEETS_ODF_EXPORT ValueVector
+{
+public:
+    enum Kind {
+        Boolean,    ///< payload.integer is 0 or 1
+        Integer,    ///< payload.integer
+        Float,      ///< payload.number
+        WideFloat,  ///< payload.index refers to the Numbers
+        String,     ///< payload.index refers to the string dictionary
+        Other       ///< payload.index refers to the Values
+    };
+
+    union Payload {
+        double number;
+        qint64 integer;
+        int index;
+    };
+
+    ValueVector() {}
+
+    int count() const {
+        return m_types.count();
+    }
+    void clear();
+    void append(const Value& value);
+    void insert(int index, const Value& value);
+    void replace(int index, const Value& value);
+    void remove(int index);
+
+    /**
+     * \return the value at \p index or an empty value, if \p index is
+     * out of range
+     */
+    Value value(int index) const;
+
+    Kind kindAt(int index) const {
+        return kind(m_types[index]);
+    }
+    /**
+     * \return the number at \p index , which has to be a Boolean, an
+     * Integer, a Float or a WideFloat
+     */
+    Number toFloat(int index) const;
+    /**
+     * \return the string at \p index , which has to be a String
+     */
+    const QString& string(int index) const {
+        return m_strings[m_payloads[index].index];
+    }
+
+    ValueVector mid(int position, int length = -1) const;
+
+    /**
+     * \return the elements at \p indices
+     */
+    ValueVector select(const QVector<int>& indices) const;
+
+    bool operator==(const ValueVector& other) const;
+
+    /**
+     * \return the type bytes, whose lower half is the Kind and whose upper
+     * half is the Value::Format
+     */
+    const quint8* types() const {
+        return m_types.constData();
+    }
+    const Payload* payloads() const {
+        return m_payloads.constData();
+    }
+    /**
+     * \return the floats not representable as double, the payload of
+     * a WideFloat is the index in this array
+     */
+    const Number* numbers() const {
+        return m_numbers.constData();
+    }
+    static Kind kind(quint8 type) {
+        return Kind(type & 0x0f);
+    }
+    static Value::Format format(quint8 type) {
+        return Value::Format(type >> 4);
+    }
+
+private:
+    quint8 encode(const Value& value, Payload* payload);
+    void release(quint8 type, const Payload& payload);
+    // an empty vector sharing the string dictionary of this one
+    ValueVector sharingStrings() const;
+    void appendFrom(const ValueVector& other, int index);
+    // counts the references to the strings of a shared dictionary and
+    // releases the strings this vector does not refer to
+    void countStringRefs();
+
+    QVector<quint8> m_types;
+    QVector<Payload> m_payloads;
+    // the floats not representable as double
+    QVector<Number> m_numbers;
+    QVector<int> m_freeNumbers;
+    // the string dictionary
+    QVector<QString> m_strings;
+    // empty while the dictionary is shared and not modified
+    QVector<int> m_stringRefs;
+    QHash<QString, int> m_stringIds;
+    QVector<int> m_freeStrings;
+    // the values of all other types
+    QVector<Value> m_values;
+    QVector<int> m_freeValues;
+};
+
+/**
+ * Copies the \p indices of \p data without decoding the values,
+ * \see PointStorage::subStorage().
+ */
+inline ValueVector selectElements(const ValueVector& data, const QVector<int>& indices)
+{
+    return data.select(indices);
+}
+
 /**
  * \class ValueStorage
  * \ingroup Storage
  * \ingroup Value
  * Stores cell values.
  */
-class ValueStorage : public PointStorage<Value>
+class ValueStorage : public PointStorage<Value, ValueVector>
 {
 public:
     ValueStorage()
-            : PointStorage<Value>() {
+            : PointStorage<Value, ValueVector>() {
     }
 
-    ValueStorage(const PointStorage<Value>& o)  //krazy:exclude=explicit
-            : PointStorage<Value>(o) {
+    ValueStorage(const PointStorage<Value, ValueVector>& o)  //krazy:exclude=explicit
+            : PointStorage<Value, ValueVector>(o) {
     }
 
-    ValueStorage& operator=(const PointStorage<Value>& o) {
-        PointStorage<Value>::operator=(o);
+    ValueStorage& operator=(const PointStorage<Value, ValueVector>& o) {
+        PointStorage<Value, ValueVector>::operator=(o);
         return *this;
     }
+
+    /**
+     * \return the values in the order of data()
+     */
+    const ValueVector& values() const {
+        return dataVector();
+    }
+
+    /**
+     * Reads the number at \p col , \p row without building a Value.
+     * An empty value reads as zero.
+     * \return \c false , if the value is neither a number nor empty
+     */
+    bool lookupNumber(int col, int row, Number* number, Value::Format* format) const {
+        const int index = indexOf(col, row);
+        if (index == -1) {
+            *number = 0.0;
+            *format = Value::fmt_None;
+            return true;
+        }
+        const ValueVector& values = dataVector();
+        switch (values.kindAt(index)) {
+        case ValueVector::Integer:
+        case ValueVector::Float:
+        case ValueVector::WideFloat:
+            *number = values.toFloat(index);
+            *format = ValueVector::format(values.types()[index]);
+            return true;
+        case ValueVector::Other: {
+            const Value value = values.value(index);
+            if (!value.isEmpty())
+                return false;
+            *number = 0.0;
+            *format = value.format();
+            return true;
+        }
+        default:
+            return false;
+        }
+    }
 };
 
 } // namespace Sheets
 } // namespace Calligra
 
+Q_DECLARE_TYPEINFO(Calligra::Sheets::ValueVector::Payload, Q_PRIMITIVE_TYPE);
+
 #endif // KSPREAD_VALUE_STORAGE
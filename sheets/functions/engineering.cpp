@@ -32,6 +32,8 @@
 
 // used by the CONVERT function
 #include <QMap>
+#include <QMutex>
+#include <QMutexLocker>
 
 // these are needed for complex functions, while we handle them in the old way
 #include <math.h>
@@ -1122,6 +1124,11 @@ Value func_convert(valVector args, ValueCalc *calc, FuncExtra *)
 
     double result = value;
 
+    // the unit maps are filled on the first use, and the formulas
+    // may be evaluated concurrently
+    static QMutex unitMapsMutex;
+    QMutexLocker locker(&unitMapsMutex);
+
     if (!kspread_convert_mass(fromUnit, toUnit, value, result))
         if (!kspread_convert_distance(fromUnit, toUnit, value, result))
             if (!kspread_convert_pressure(fromUnit, toUnit, value, result))
@@ -34,9 +34,20 @@
 #include "FunctionModuleRegistry.h"
 #include "ValueCalc.h"
 #include "ValueConverter.h"
+#include "ValueStorage.h"
 
 #include <klocale.h>
 
+#include <QCache>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSharedPointer>
+
+#include <float.h> // DBL_EPSILON
+
+#include <algorithm>
+
 using namespace Calligra::Sheets;
 
 // prototypes (sorted alphabetically)
@@ -96,6 +107,7 @@ ReferenceModule::ReferenceModule(QObject* parent, const QVariantList&)
     f = new Function("HLOOKUP",  func_hlookup);
     f->setParamCount(3, 4);
     f->setAcceptArray();
+    f->setNeedsExtra(true);
     add(f);
     f = new Function("INDEX",   func_index);
     f->setParamCount(3);
@@ -142,6 +154,7 @@ ReferenceModule::ReferenceModule(QObject* parent, const QVariantList&)
     f = new Function("VLOOKUP",  func_vlookup);
     f->setParamCount(3, 4);
     f->setAcceptArray();
+    f->setNeedsExtra(true);
     add(f);
 }
 
@@ -151,6 +164,305 @@ QString ReferenceModule::descriptionFileName() const
 }
 
 
+//
+// Lookup index
+//
+// VLOOKUP, HLOOKUP and MATCH search the first column or row of a range.
+// Many lookups in the same range are common, so the searched line is
+// indexed once and the index is kept until a value in the line changes,
+// which is detected by the revisions of the cell storage.
+//
+
+namespace
+{
+
+// shorter lines are searched faster than an index is looked up
+const int minimumIndexedLength = 16;
+
+// the maximum number of indexed values
+const int maximumIndexCost = 1 << 20;
+
+// A row or column of a range in a sheet, the one a lookup function searches.
+struct LookupLine {
+    LookupLine() : sheet(0), isColumn(true), revision(0) {}
+
+    bool isValid() const {
+        return sheet;
+    }
+    int length() const {
+        return isColumn ? rect.height() : rect.width();
+    }
+    Value element(int position) const {
+        return isColumn ? data.element(0, position) : data.element(position, 0);
+    }
+
+    Sheet* sheet;
+    QRect rect;
+    bool isColumn;
+    qint64 revision;
+    // the value of the range passed to the function
+    Value data;
+};
+
+struct LookupIndexKey {
+    LookupIndexKey(Sheet* _sheet, const QRect& _rect, bool _caseSensitive)
+        : sheet(_sheet), rect(_rect), caseSensitive(_caseSensitive) {}
+
+    bool operator==(const LookupIndexKey& other) const {
+        return sheet == other.sheet && rect == other.rect && caseSensitive == other.caseSensitive;
+    }
+
+    Sheet* sheet;
+    QRect rect;
+    bool caseSensitive;
+};
+
+uint qHash(const LookupIndexKey& key)
+{
+    return ::qHash(key.sheet) ^ ::qHash(key.rect.left()) ^ (::qHash(key.rect.top()) << 8) ^
+           (::qHash(key.rect.width()) << 16) ^ (::qHash(key.rect.height()) << 24) ^ uint(key.caseSensitive);
+}
+
+/**
+ * The values of a lookup line indexed for the exact and the approximate
+ * matches. Only the strings and the numbers are indexed, the empty and
+ * the boolean values never match those. If the line contains values of
+ * other types, the index is not usable and the line has to be searched.
+ */
+struct LookupIndex {
+    LookupIndex() : revision(0), usable(true) {}
+
+    void addString(const QString& value, int position, bool caseSensitive) {
+        const QString string = caseSensitive ? value : value.toLower();
+        if (!strings.contains(string))
+            strings.insert(string, position);
+        if (!string.isEmpty())
+            sortedStrings.append(qMakePair(string, position));
+    }
+
+    qint64 revision;
+    bool usable;
+    // the first position of each string, lower-cased for the case-insensitive index
+    QHash<QString, int> strings;
+    // the non-empty strings with their positions, sorted
+    QVector<QPair<QString, int> > sortedStrings;
+    // the numbers with their positions, sorted
+    QVector<QPair<Number, int> > sortedNumbers;
+};
+
+// orders the indexed numbers before a key, if they are lower than the key
+// within the tolerance of Value::compare()
+struct NumberLowerThan {
+    bool operator()(const QPair<Number, int>& entry, Number key) const {
+        return Value::compare(key, entry.first) > 0;
+    }
+};
+
+class LookupIndexCache
+{
+public:
+    LookupIndexCache() : m_indexes(maximumIndexCost) {}
+
+    /**
+     * \return the position of the first value in \p line equal to \p key,
+     * compared as ValueCalc::naturalEqual() does, -1 if there is no such
+     * value or -2 if the line has to be searched.
+     */
+    int exactMatch(const LookupLine& line, const Value& key, bool caseSensitive, ValueCalc* calc);
+
+    /**
+     * \return the position of the first value in \p line, that is the
+     * largest of the strings or of the numbers lower than \p key, compared
+     * as ValueCalc::naturalLower() does, -1 if there is no such value or
+     * -2 if the line has to be searched.
+     */
+    int approximateMatch(const LookupLine& line, const Value& key);
+
+private:
+    typedef QSharedPointer<const LookupIndex> LookupIndexPointer;
+
+    /**
+     * \return the index of \p line . The index is never modified once it
+     * is built, so it is searched without holding the mutex.
+     */
+    LookupIndexPointer index(const LookupLine& line, bool caseSensitive);
+
+    // guards the cache only, the formulas are evaluated concurrently
+    QMutex m_mutex;
+    QCache<LookupIndexKey, LookupIndexPointer> m_indexes;
+};
+
+Q_GLOBAL_STATIC(LookupIndexCache, s_lookupIndexCache)
+
+LookupIndexCache::LookupIndexPointer LookupIndexCache::index(const LookupLine& line, bool caseSensitive)
+{
+    const LookupIndexKey key(line.sheet, line.rect, caseSensitive);
+    {
+        QMutexLocker locker(&m_mutex);
+        const LookupIndexPointer* cached = m_indexes.object(key);
+        if (cached && (*cached)->revision == line.revision)
+            return *cached;
+    }
+
+    LookupIndex* index = new LookupIndex();
+    index->revision = line.revision;
+    const int length = line.length();
+    // the values are read from the typed storage, without building Values
+    const ValueStorage* storage = line.data.storage();
+    if (!storage)
+        index->usable = false;
+    for (int position = 0; position < length && index->usable; ++position) {
+        const int i = line.isColumn ? storage->indexOf(1, position + 1) : storage->indexOf(position + 1, 1);
+        if (i == -1)
+            continue;
+        const ValueVector& values = storage->values();
+        switch (values.kindAt(i)) {
+        case ValueVector::Boolean:
+            break;
+        case ValueVector::Integer:
+        case ValueVector::Float:
+        case ValueVector::WideFloat:
+            index->sortedNumbers.append(qMakePair(values.toFloat(i), position));
+            break;
+        case ValueVector::String:
+            index->addString(values.string(i), position, caseSensitive);
+            break;
+        case ValueVector::Other: {
+            const Value value = values.value(i);
+            if (value.isEmpty())
+                break;
+            if (value.isString()) {
+                index->addString(value.asString(), position, caseSensitive);
+                break;
+            }
+            // the comparisons of the other types are not transitive
+            index->usable = false;
+            break;
+        }
+        }
+    }
+    std::sort(index->sortedStrings.begin(), index->sortedStrings.end());
+    std::sort(index->sortedNumbers.begin(), index->sortedNumbers.end());
+    const LookupIndexPointer result(index);
+
+    QMutexLocker locker(&m_mutex);
+    // another thread may have indexed the same line meanwhile
+    const LookupIndexPointer* cached = m_indexes.object(key);
+    if (cached && (*cached)->revision == line.revision)
+        return *cached;
+    m_indexes.insert(key, new LookupIndexPointer(result), length);
+    return result;
+}
+
+int LookupIndexCache::exactMatch(const LookupLine& line, const Value& key, bool caseSensitive, ValueCalc* calc)
+{
+    const bool isString = key.isString() && !key.asString().isEmpty();
+    const bool isNumber = key.isInteger() || key.isFloat();
+    if (!isString && !isNumber)
+        return -2;
+
+    const LookupIndexPointer index = this->index(line, caseSensitive);
+    if (!index->usable)
+        return -2;
+
+    if (isString)
+        return index->strings.value(caseSensitive ? key.asString() : key.asString().toLower(), -1);
+
+    // The numbers are equal within a tolerance, so check the neighbours.
+    const Number number = key.asFloat();
+    QVector<QPair<Number, int> >::const_iterator it =
+        std::lower_bound(index->sortedNumbers.constBegin(), index->sortedNumbers.constEnd(),
+                         qMakePair(number - 4 * DBL_EPSILON, -1));
+    int result = -1;
+    for (; it != index->sortedNumbers.constEnd() && it->first <= number + 4 * DBL_EPSILON; ++it) {
+        if ((result == -1 || it->second < result) && calc->naturalEqual(key, line.element(it->second), caseSensitive))
+            result = it->second;
+    }
+    return result;
+}
+
+int LookupIndexCache::approximateMatch(const LookupLine& line, const Value& key)
+{
+    const bool isString = key.isString() && !key.asString().isEmpty();
+    const bool isNumber = key.isInteger() || key.isFloat();
+    if (!isString && !isNumber)
+        return -2;
+
+    const LookupIndexPointer index = this->index(line, true);
+    if (!index->usable)
+        return -2;
+
+    if (isNumber) {
+        // Only the numbers are lower than a number. The largest of them
+        // is the last one lower than the key, the ones equal to it within
+        // the tolerance precede it.
+        const QVector<QPair<Number, int> >& numbers = index->sortedNumbers;
+        const QVector<QPair<Number, int> >::const_iterator end =
+            std::lower_bound(numbers.constBegin(), numbers.constEnd(), key.asFloat(), NumberLowerThan());
+        if (end == numbers.constBegin())
+            return -1;
+        QVector<QPair<Number, int> >::const_iterator it =
+            std::lower_bound(numbers.constBegin(), end, (end - 1)->first, NumberLowerThan());
+        int result = it->second;
+        for (; it != end; ++it)
+            result = qMin(result, it->second);
+        return result;
+    }
+
+    // the largest string lower than the key
+    const QVector<QPair<QString, int> >& strings = index->sortedStrings;
+    QVector<QPair<QString, int> >::const_iterator it =
+        std::lower_bound(strings.constBegin(), strings.constEnd(), qMakePair(key.asString(), -1));
+    if (it == strings.constBegin()) {
+        // the numbers and the empty strings are lower than the key too,
+        // but their order is not the natural one
+        if (!index->sortedNumbers.isEmpty() || index->strings.contains(QString()))
+            return -2;
+        return -1;
+    }
+    const QString& largest = (it - 1)->first;
+    // and its first position
+    it = std::lower_bound(strings.constBegin(), it, qMakePair(largest, -1));
+    return it->second;
+}
+
+/**
+ * \return the first column (or row) of the range passed as argument
+ * \p arg , if the range is in a sheet and is worth indexing.
+ */
+LookupLine lookupLine(const Value& data, FuncExtra* e, int arg, bool isColumn)
+{
+    LookupLine line;
+    if (!e || arg >= e->regions.count() || e->ranges[arg].col1 == -1)
+        return line;
+    const Region& region = e->regions[arg];
+    if (!region.isValid() || !region.isContiguous())
+        return line;
+    // the value is not the one of the range, e.g. a cell indirection
+    const QRect rect = region.firstRange();
+    if (rect.width() != int(data.columns()) || rect.height() != int(data.rows()))
+        return line;
+    if ((isColumn ? rect.height() : rect.width()) < minimumIndexedLength)
+        return line;
+
+    line.sheet = region.firstSheet() ? region.firstSheet() : e->sheet;
+    if (!line.sheet)
+        return line;
+    line.isColumn = isColumn;
+    line.data = data;
+    if (isColumn) {
+        line.rect = QRect(rect.left(), rect.top(), 1, rect.height());
+        line.revision = line.sheet->cellStorage()->columnRevision(rect.left());
+    } else {
+        line.rect = QRect(rect.left(), rect.top(), rect.width(), 1);
+        line.revision = line.sheet->cellStorage()->rowRevision(rect.top());
+    }
+    return line;
+}
+
+} // namespace
+
+
 //
 // Function: ADDRESS
 //
@@ -355,7 +667,7 @@ Value func_columns(valVector, ValueCalc *, FuncExtra *e)
 //
 // Function: HLOOKUP
 //
-Value func_hlookup(valVector args, ValueCalc *calc, FuncExtra *)
+Value func_hlookup(valVector args, ValueCalc *calc, FuncExtra *e)
 {
     const Value key = args[0];
     const Value data = args[1];
@@ -366,9 +678,24 @@ Value func_hlookup(valVector args, ValueCalc *calc, FuncExtra *)
         return Value::errorVALUE();
     const bool rangeLookup = (args.count() > 3) ? calc->conv()->asBoolean(args[3]).asBoolean() : true;
 
+    // use the index of the first row, if possible
+    const LookupLine line = lookupLine(data, e, 1, false);
+    if (line.isValid()) {
+        int col = s_lookupIndexCache->exactMatch(line, key, true, calc);
+        if (col == -1 && rangeLookup)
+            col = s_lookupIndexCache->approximateMatch(line, key);
+        if (col >= 0)
+            return data.element(col, row - 1);
+        if (col == -1)
+            return Value::errorNA();
+    }
+
     // now traverse the array and perform comparison
     Value r;
     Value v = Value::errorNA();
+    // no number is naturally lower than the empty value, so the first
+    // number lower than a numeric key is taken explicitly
+    const bool isNumber = key.isInteger() || key.isFloat();
     for (int col = 0; col < cols; ++col) {
         // search in the first row
         const Value le = data.element(col, 0);
@@ -376,7 +703,7 @@ Value func_hlookup(valVector args, ValueCalc *calc, FuncExtra *)
             return data.element(col, row - 1);
         }
         // optionally look for the next largest value that is less than key
-        if (rangeLookup && calc->naturalLower(le, key) && calc->naturalLower(r, le)) {
+        if (rangeLookup && calc->naturalLower(le, key) && (calc->naturalLower(r, le) || (r.isEmpty() && isNumber))) {
             r = le;
             v = data.element(col, row - 1);
         }
@@ -487,6 +814,15 @@ Value func_match(valVector args, ValueCalc *calc, FuncExtra* e)
     int n = qMax(searchArray.rows(), searchArray.columns());
 
     if (matchType == 0) {
+        // use the index, if possible
+        const LookupLine line = lookupLine(searchArray, e, 1, dr == 1);
+        if (line.isValid()) {
+            const int position = s_lookupIndexCache->exactMatch(line, searchValue, false, calc);
+            if (position >= 0)
+                return Value(position + 1);
+            if (position == -1)
+                return Value::errorNA();
+        }
         // linear search
         for (int r = 0, c = 0; r < n && c < n; r += dr, c += dc) {
             if (calc->naturalEqual(searchValue, searchArray.element(c, r), false)) {
@@ -650,7 +986,7 @@ Value func_sheets(valVector /*args*/, ValueCalc *, FuncExtra *e)
 //
 // Function: VLOOKUP
 //
-Value func_vlookup(valVector args, ValueCalc *calc, FuncExtra *)
+Value func_vlookup(valVector args, ValueCalc *calc, FuncExtra *e)
 {
     const Value key = args[0];
     const Value data = args[1];
@@ -661,9 +997,24 @@ Value func_vlookup(valVector args, ValueCalc *calc, FuncExtra *)
         return Value::errorVALUE();
     const bool rangeLookup = (args.count() > 3) ? calc->conv()->asBoolean(args[3]).asBoolean() : true;
 
+    // use the index of the first column, if possible
+    const LookupLine line = lookupLine(data, e, 1, true);
+    if (line.isValid()) {
+        int row = s_lookupIndexCache->exactMatch(line, key, true, calc);
+        if (row == -1 && rangeLookup)
+            row = s_lookupIndexCache->approximateMatch(line, key);
+        if (row >= 0)
+            return data.element(col - 1, row);
+        if (row == -1)
+            return Value::errorNA();
+    }
+
     // now traverse the array and perform comparison
     Value r;
     Value v = Value::errorNA();
+    // no number is naturally lower than the empty value, so the first
+    // number lower than a numeric key is taken explicitly
+    const bool isNumber = key.isInteger() || key.isFloat();
     for (int row = 0; row < rows; ++row) {
         // search in the first column
         const Value le = data.element(0, row);
@@ -671,7 +1022,7 @@ Value func_vlookup(valVector args, ValueCalc *calc, FuncExtra *)
             return data.element(col - 1, row);
         }
         // optionally look for the next largest value that is less than key
-        if (rangeLookup && calc->naturalLower(le, key) && calc->naturalLower(r, le)) {
+        if (rangeLookup && calc->naturalLower(le, key) && (calc->naturalLower(r, le) || (r.isEmpty() && isNumber))) {
             r = le;
             v = data.element(col - 1, row);
         }
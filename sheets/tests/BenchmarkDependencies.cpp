@@ -0,0 +1,162 @@
+/* This file is part of the KDE project
+   Copyright (c) 2015 Calligra developers
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#include "BenchmarkDependencies.h"
+
+#include "Cell.h"
+#include "DependencyIndex.h"
+#include "Map.h"
+#include "RTree.h"
+#include "Sheet.h"
+
+#include <QTest>
+
+using namespace Calligra::Sheets;
+
+// the number of the formulas, each of them consuming one range
+static const int formulaCount = 1000000;
+
+// the number of the lookups in one benchmark iteration
+static const int lookupCount = 1000;
+
+// the range consumed by the formula in the given row
+static QRect consumedRange(int pattern, int row)
+{
+    switch (pattern) {
+    case 0: // =A1, =A2, ...
+        return QRect(1, row, 1, 1);
+    case 1: // =SUM(A1:C1), =SUM(A2:C2), ...
+        return QRect(1, row, 3, 1);
+    case 2: // =SUM(A:A)
+        return QRect(1, 1, 1, KS_rowMax);
+    default: // =SUM($A$1:$A$100)
+        return QRect(1, 1, 1, 100);
+    }
+}
+
+static void addData()
+{
+    QTest::addColumn<int>("pattern");
+    QTest::addColumn<bool>("rtree");
+
+    const char* names[] = { "relative cell", "relative range", "complete column", "absolute range" };
+    for (int pattern = 0; pattern < 4; ++pattern) {
+        QTest::newRow(QByteArray(names[pattern]).append(" (index)").constData()) << pattern << false;
+        QTest::newRow(QByteArray(names[pattern]).append(" (R-Tree)").constData()) << pattern << true;
+    }
+}
+
+void DependencyBenchmark::initTestCase()
+{
+    m_map = new Map(0 /* no Doc */);
+    m_sheet = m_map->addNewSheet();
+    m_sheet->setSheetName("Sheet1");
+}
+
+void DependencyBenchmark::cleanupTestCase()
+{
+    delete m_map;
+}
+
+void DependencyBenchmark::testInsertionPerformance_data()
+{
+    addData();
+}
+
+void DependencyBenchmark::testInsertionPerformance()
+{
+    QFETCH(int, pattern);
+    QFETCH(bool, rtree);
+
+    QBENCHMARK_ONCE {
+        if (rtree) {
+            RTree<Cell> tree;
+            for (int row = 1; row <= formulaCount; ++row)
+                tree.insert(consumedRange(pattern, row), Cell(m_sheet, 4, row));
+        } else {
+            DependencyIndex index;
+            for (int row = 1; row <= formulaCount; ++row)
+                index.insert(consumedRange(pattern, row), Cell(m_sheet, 4, row));
+        }
+    }
+}
+
+void DependencyBenchmark::testLookupPerformance_data()
+{
+    addData();
+}
+
+void DependencyBenchmark::testLookupPerformance()
+{
+    QFETCH(int, pattern);
+    QFETCH(bool, rtree);
+
+    RTree<Cell> tree;
+    DependencyIndex index;
+    for (int row = 1; row <= formulaCount; ++row) {
+        if (rtree)
+            tree.insert(consumedRange(pattern, row), Cell(m_sheet, 4, row));
+        else
+            index.insert(consumedRange(pattern, row), Cell(m_sheet, 4, row));
+    }
+
+    // the consumers of single cells, as the recalculation looks them up
+    int counter = 0;
+    QBENCHMARK {
+        for (int i = 0; i < lookupCount; ++i) {
+            const QPoint point(1 + i % 3, 1 + (i * 997) % formulaCount);
+            counter += rtree ? tree.contains(point).count() : index.contains(point).count();
+        }
+    }
+    QVERIFY(counter > 0);
+}
+
+void DependencyBenchmark::testRemovalPerformance_data()
+{
+    addData();
+}
+
+void DependencyBenchmark::testRemovalPerformance()
+{
+    QFETCH(int, pattern);
+    QFETCH(bool, rtree);
+
+    // removing from the R-Tree does not scale, so only a part is removed
+    const int removalCount = 1000;
+
+    RTree<Cell> tree;
+    DependencyIndex index;
+    for (int row = 1; row <= formulaCount; ++row) {
+        if (rtree)
+            tree.insert(consumedRange(pattern, row), Cell(m_sheet, 4, row));
+        else
+            index.insert(consumedRange(pattern, row), Cell(m_sheet, 4, row));
+    }
+
+    QBENCHMARK_ONCE {
+        for (int row = 1; row <= removalCount; ++row) {
+            if (rtree)
+                tree.remove(consumedRange(pattern, row), Cell(m_sheet, 4, row));
+            else
+                index.remove(consumedRange(pattern, row), Cell(m_sheet, 4, row));
+        }
+    }
+}
+
+QTEST_MAIN(DependencyBenchmark)
@@ -0,0 +1,121 @@
+/* This file is part of the KDE project
+   Copyright (c) 2015 Calligra developers
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#include "BenchmarkFormula.h"
+
+#include "CellStorage.h"
+#include "Formula.h"
+#include "FunctionModuleRegistry.h"
+#include "Map.h"
+#include "Sheet.h"
+#include "Value.h"
+
+#include <QTest>
+
+using namespace Calligra::Sheets;
+
+// the number of the formulas evaluated in one benchmark iteration
+static const int formulaCount = 10000;
+
+void FormulaBenchmark::initTestCase()
+{
+    FunctionModuleRegistry::instance()->loadFunctionModules();
+
+    m_map = new Map(0 /* no Doc */);
+    m_sheet = m_map->addNewSheet();
+    m_sheet->setSheetName("Sheet1");
+
+    CellStorage* storage = m_sheet->cellStorage();
+    for (int row = 1; row <= formulaCount; ++row) {
+        storage->setValue(1, row, Value(row));          // A
+        storage->setValue(2, row, Value(row * 0.5));    // B
+        storage->setValue(3, row, Value(QString::number(row))); // C
+    }
+}
+
+void FormulaBenchmark::cleanupTestCase()
+{
+    delete m_map;
+}
+
+void FormulaBenchmark::testCompilePerformance_data()
+{
+    QTest::addColumn<QString>("expression");
+
+    QTest::newRow("constants") << "=1+2*3-4/5";
+    QTest::newRow("cell references") << "=A%1*2+B%1/3-1";
+    QTest::newRow("function") << "=SUM(A1:A%1)+ABS(B%1)";
+}
+
+void FormulaBenchmark::testCompilePerformance()
+{
+    QFETCH(QString, expression);
+
+    QList<Formula> formulas;
+    for (int row = 1; row <= formulaCount; ++row) {
+        Formula formula(m_sheet, Cell(m_sheet, 5, row));
+        formulas.append(formula);
+    }
+
+    QBENCHMARK {
+        for (int row = 1; row <= formulaCount; ++row) {
+            formulas[row - 1].setExpression(QString(expression).replace("%1", QString::number(row)));
+            formulas[row - 1].isValid();
+        }
+    }
+}
+
+void FormulaBenchmark::testEvaluationPerformance_data()
+{
+    QTest::addColumn<QString>("expression");
+
+    // the arithmetics on numbers are evaluated without the Value allocations
+    QTest::newRow("constants") << "=1+2*3-4/5";
+    QTest::newRow("folded constants and cell reference") << "=(1+2)*(3+4)+A%1";
+    QTest::newRow("cell references") << "=A%1*2+B%1/3-1";
+    QTest::newRow("long arithmetics") << "=A%1+B%1-A%1*B%1+A%1/2-B%1*3+A%1-B%1+1";
+    // these need the full evaluation
+    QTest::newRow("string cell reference") << "=C%1*2+B%1/3-1";
+    QTest::newRow("comparison") << "=A%1*2>B%1";
+    QTest::newRow("function") << "=ABS(A%1)+ABS(B%1)";
+    QTest::newRow("range function") << "=SUM(A%1:B%1)";
+}
+
+void FormulaBenchmark::testEvaluationPerformance()
+{
+    QFETCH(QString, expression);
+
+    QList<Formula> formulas;
+    for (int row = 1; row <= formulaCount; ++row) {
+        Formula formula(m_sheet, Cell(m_sheet, 5, row));
+        formula.setExpression(QString(expression).replace("%1", QString::number(row)));
+        QVERIFY(formula.isValid());
+        formulas.append(formula);
+    }
+
+    Value result;
+    QBENCHMARK {
+        for (int i = 0; i < formulas.count(); ++i) {
+            result = formulas[i].eval();
+        }
+    }
+    QVERIFY(!result.isError());
+}
+
+QTEST_MAIN(FormulaBenchmark)
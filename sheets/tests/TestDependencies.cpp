@@ -22,10 +22,12 @@
 #include <QTest>
 
 #include "CellStorage.h"
+#include "DependencyIndex.h"
 #include "DependencyManager.h"
 #include "DependencyManager_p.h"
 #include "Formula.h"
 #include "Map.h"
+#include "RecalcManager.h"
 #include "Region.h"
 #include "Sheet.h"
 #include "Value.h"
@@ -108,6 +110,71 @@ void TestDependencies::testDepths()
     QCOMPARE(depths[a4], 2);
 }
 
+void TestDependencies::testParallelRecalc()
+{
+    // enough cells per depth level to be evaluated in the thread pool
+    const int rowCount = 300;
+
+    for (int row = 1; row <= rowCount; ++row) {
+        Cell(m_sheet, 5, row).setUserInput(QString::number(row));
+        Cell(m_sheet, 6, row).setUserInput(QString("=E%1*2").arg(row));
+        Cell(m_sheet, 7, row).setUserInput(QString("=F%1+E%1+SUM(E1:E3)").arg(row));
+    }
+
+    QApplication::processEvents(); // handle Damages
+
+    m_map->recalcManager()->recalcSheet(m_sheet);
+
+    for (int row = 1; row <= rowCount; ++row) {
+        QCOMPARE(m_storage->value(6, row).asInteger(), qint64(2 * row));
+        QCOMPARE(m_storage->value(7, row).asInteger(), qint64(3 * row + 6));
+    }
+}
+
+void TestDependencies::testCompressedRanges()
+{
+    Sheet* sheet = m_map->addNewSheet();
+    const int rowCount = 100;
+
+    for (int row = 1; row <= rowCount; ++row) {
+        Cell(sheet, 1, row).setUserInput(QString::number(row));
+        Cell(sheet, 2, row).setUserInput(QString("=A%1*2").arg(row));   // range pattern
+        Cell(sheet, 3, row).setUserInput("=SUM(A:A)");                   // complete column
+    }
+    Cell(sheet, 5, 200).setUserInput("=SUM(1:1)");                       // complete row
+
+    QApplication::processEvents(); // handle Damages
+
+    m_map->recalcManager()->recalcSheet(sheet);
+
+    QCOMPARE(sheet->cellStorage()->value(2, 5).asInteger(), qint64(10));
+    QCOMPARE(sheet->cellStorage()->value(3, 7).asInteger(), qint64(5050));
+    QCOMPARE(sheet->cellStorage()->value(5, 200).asInteger(), qint64(5053));
+
+    DependencyManager* manager = m_map->dependencyManager();
+    DependencyIndex* index = manager->d->consumers.value(sheet);
+    QVERIFY(index);
+    QCOMPARE(index->count(), 2 * rowCount + 1);
+    QCOMPARE(index->contains(QPoint(1, 5)).count(), rowCount + 1);
+    QVERIFY(index->contains(QPoint(1, 5)).contains(Cell(sheet, 2, 5)));
+    QCOMPARE(index->contains(QPoint(2, 1)).count(), 1);
+    QCOMPARE(index->contains(QPoint(2, 1)).first(), Cell(sheet, 5, 200));
+    QCOMPARE(index->contains(QPoint(2, 2)).count(), 0);
+    QCOMPARE(index->intersects(QRect(1, 5, 1, 2)).count(), rowCount + 2);
+
+    const QMap<Cell, int> depths = manager->depths();
+    QCOMPARE(depths[Cell(sheet, 2, 5)], 1);
+    QCOMPARE(depths[Cell(sheet, 3, 5)], 1);
+    QCOMPARE(depths[Cell(sheet, 5, 200)], 2);
+
+    Cell(sheet, 2, 5).setUserInput("");
+    QApplication::processEvents(); // handle Damages
+
+    QCOMPARE(index->count(), 2 * rowCount);
+    QCOMPARE(index->contains(QPoint(1, 5)).count(), rowCount);
+    QVERIFY(!index->contains(QPoint(1, 5)).contains(Cell(sheet, 2, 5)));
+}
+
 void TestDependencies::cleanupTestCase()
 {
     delete m_map;
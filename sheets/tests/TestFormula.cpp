@@ -22,6 +22,10 @@
 
 #include "TestKspreadCommon.h"
 
+#include "CellStorage.h"
+#include "Map.h"
+#include "Sheet.h"
+
 using namespace Calligra::Sheets;
 
 static char encodeTokenType(const Token& token)
@@ -105,6 +109,28 @@ Value TestFormula::evaluate(const QString& formula, Value& ex)
     return result;
 }
 
+// the full evaluation is enforced by a cell indirection
+#define CHECK_EVAL_CELLS(x,y) { \
+    Value z(y); \
+    const Value numeric = evaluateCells(sheet, x, z, CellIndirection()); \
+    const Value full = evaluateCells(sheet, x, z, indirection); \
+    QCOMPARE(numeric, z); \
+    QCOMPARE(full, z); \
+    QCOMPARE(int(numeric.format()), int(full.format())); }
+
+static Value evaluateCells(Sheet* sheet, const QString& formula, Value& ex,
+                           const CellIndirection& cellIndirections)
+{
+    Formula f(sheet);
+    f.setExpression('=' + formula);
+    Value result = f.eval(cellIndirections);
+
+    if (result.isFloat() && ex.isInteger())
+        ex = Value(ex.asFloat());
+
+    return result;
+}
+
 void TestFormula::initTestCase()
 {
     FunctionModuleRegistry::instance()->loadFunctionModules();
@@ -349,6 +375,40 @@ void TestFormula::testFunction()
     CHECK_EVAL("SUM(SUM(-2;-2;-2);SUM(-2;-2;-2;-2);SUM(-2;-2;-2;-2;-2))", Value(-24));
 }
 
+void TestFormula::testNumericEvaluation()
+{
+    Map map(0 /* no Doc */);
+    Sheet* sheet = map.addNewSheet();
+    CellStorage* storage = sheet->cellStorage();
+
+    Value percent(0.25);
+    percent.setFormat(Value::fmt_Percent);
+
+    storage->setValue(1, 1, Value(3));        // A1
+    storage->setValue(1, 2, Value(0.5));      // A2
+    storage->setValue(1, 3, percent);         // A3
+    storage->setValue(1, 4, Value("text"));   // A4
+    storage->setValue(1, 6, Value(0));        // A6
+    storage->setValue(1, 7, Value(true));     // A7
+
+    CellIndirection indirection;
+    indirection.insert(Cell(sheet, 100, 100), Cell(sheet, 100, 100));
+
+    // arithmetics on numbers and cell references are evaluated on plain
+    // numbers, which has to give the same results as the full evaluation
+    CHECK_EVAL_CELLS("A1*2+A2", Value(6.5));
+    CHECK_EVAL_CELLS("1+2+A1", Value(6));
+    CHECK_EVAL_CELLS("-A1-(2*3)", Value(-9));
+    CHECK_EVAL_CELLS("A1/A6", Value::errorDIV0());
+    CHECK_EVAL_CELLS("A3*A1", Value(0.75));
+    CHECK_EVAL_CELLS("A5+1", Value(1));
+    CHECK_EVAL_CELLS("-A5", Value(0));
+    CHECK_EVAL_CELLS("A1+A4", Value::errorVALUE());
+    CHECK_EVAL_CELLS("A1+A7", Value(4));
+    CHECK_EVAL_CELLS("A1*50%", Value(1.5));
+    CHECK_EVAL_CELLS("SUM(A1:A2)*(4-2)", Value(7));
+}
+
 void TestFormula::testInlineArrays()
 {
 #ifdef CALLIGRA_SHEETS_INLINE_ARRAYS
@@ -44,6 +44,7 @@ private Q_SLOTS:
     void testComparison();
     void testString();
     void testFunction();
+    void testNumericEvaluation();
     void testInlineArrays();
 
 private:
@@ -191,6 +191,19 @@ void TestInformationFunctions::initTestCase()
      storage->setValue(26,22, Value(    2 ) );
      storage->setValue(26,23, Value(    1 ) );
 
+     // J101:L124, long enough to be indexed by the lookup functions
+     for (int i = 0; i < 24; ++i) {
+         storage->setValue(10, 101 + i, Value(QString("k%1").arg(2 * i, 2, 10, QChar('0'))));
+         storage->setValue(11, 101 + i, Value(10 * i));
+         storage->setValue(12, 101 + i, Value(QString("v%1").arg(i)));
+     }
+
+     // A130:X131, the same for the horizontal lookup
+     for (int i = 0; i < 24; ++i) {
+         storage->setValue(1 + i, 130, Value(QString("k%1").arg(2 * i, 2, 10, QChar('0'))));
+         storage->setValue(1 + i, 131, Value(QString("v%1").arg(i)));
+     }
+
     // Add the second sheet
     m_map->addNewSheet();
     sheet = m_map->sheet(1);
@@ -611,6 +624,45 @@ void TestInformationFunctions::testMATCH()
     CHECK_EVAL("MATCH(13;C11:D13;-1)", Value::errorNA()); // not sure if this is the best error
 }
 
+void TestInformationFunctions::testLookupIndex()
+{
+    // exact matches
+    CHECK_EVAL("VLOOKUP(\"k10\";J101:L124;3;0)", Value("v5"));
+    CHECK_EVAL("VLOOKUP(\"K10\";J101:L124;3;0)", Value::errorNA()); // case sensitive
+    CHECK_EVAL("VLOOKUP(\"k11\";J101:L124;3;0)", Value::errorNA());
+    CHECK_EVAL("VLOOKUP(50;K101:L124;2;0)", Value("v5"));
+    CHECK_EVAL("VLOOKUP(55;K101:L124;2;0)", Value::errorNA());
+    CHECK_EVAL("HLOOKUP(\"k46\";A130:X131;2;0)", Value("v23"));
+    CHECK_EVAL("MATCH(\"K10\";J101:J124;0)", Value(6)); // case insensitive
+    CHECK_EVAL("MATCH(230;K101:K124;0)", Value(24));
+    CHECK_EVAL("MATCH(\"k11\";J101:J124;0)", Value::errorNA());
+
+    // approximate matches
+    CHECK_EVAL("VLOOKUP(\"k11\";J101:L124;3)", Value("v5"));
+    CHECK_EVAL("VLOOKUP(\"k99\";J101:L124;3)", Value("v23"));
+    CHECK_EVAL("VLOOKUP(\"a\";J101:L124;3)", Value::errorNA());
+    CHECK_EVAL("HLOOKUP(\"k11\";A130:X131;2)", Value("v5"));
+    CHECK_EVAL("VLOOKUP(55;K101:L124;2)", Value("v5"));
+    CHECK_EVAL("VLOOKUP(1000;K101:L124;2)", Value("v23"));
+    CHECK_EVAL("VLOOKUP(-1;K101:L124;2)", Value::errorNA());
+    // too short to be indexed
+    CHECK_EVAL("VLOOKUP(55;K101:L110;2)", Value("v5"));
+    CHECK_EVAL("VLOOKUP(-1;K101:L110;2)", Value::errorNA());
+
+    // the index follows the changes of the range
+    CellStorage* storage = m_map->sheet(0)->cellStorage();
+    storage->setValue(10, 106, Value("x"));
+    CHECK_EVAL("VLOOKUP(\"k10\";J101:L124;3;0)", Value::errorNA());
+    CHECK_EVAL("VLOOKUP(\"x\";J101:L124;3;0)", Value("v5"));
+    storage->insertRows(103, 1);
+    CHECK_EVAL("VLOOKUP(\"x\";J101:L125;3;0)", Value("v5"));
+    CHECK_EVAL("MATCH(\"x\";J101:J125;0)", Value(7));
+    storage->removeRows(103, 1);
+    storage->setValue(10, 106, Value("k10"));
+    CHECK_EVAL("VLOOKUP(\"k10\";J101:L124;3;0)", Value("v5"));
+    CHECK_EVAL("VLOOKUP(\"x\";J101:L124;3;0)", Value::errorNA());
+}
+
 //
 // cleanup test
 //
@@ -65,6 +65,7 @@ private Q_SLOTS:
     void testISTEXT();
     void testISREF();
     void testMATCH();
+    void testLookupIndex();
     void testN();
     void testNA();
     void testROW();
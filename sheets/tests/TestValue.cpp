@@ -22,6 +22,11 @@
 #include "TestKspreadCommon.h"
 
 #include "CalculationSettings.h"
+#include "Region.h"
+#include "ValueCalc.h"
+#include "ValueConverter.h"
+#include "ValueParser.h"
+#include "ValueStorage.h"
 
 
 void TestValue::testEmpty()
@@ -289,6 +294,105 @@ void TestValue::testArray()
     delete v2;
 }
 
+void TestValue::testTypedStorage()
+{
+    ValueStorage storage;
+    Value date(14.5);
+    date.setFormat(Value::fmt_Date);
+    const Value wide(Number(1.0) / Number(3.0));
+    Value array(Value::Array);
+    array.setElement(0, 0, Value(1));
+
+    storage.insert(1, 1, Value(true));
+    storage.insert(2, 1, Value(42));
+    storage.insert(3, 1, date);
+    storage.insert(4, 1, wide);
+    storage.insert(5, 1, Value("Hello"));
+    storage.insert(6, 1, Value::errorDIV0());
+    storage.insert(7, 1, array);
+    storage.insert(1, 2, Value("Hello"));
+    QCOMPARE(storage.count(), 8);
+
+    // the values come back with their type and format
+    QCOMPARE(storage.lookup(1, 1), Value(true));
+    QCOMPARE(storage.lookup(2, 1), Value(42));
+    QCOMPARE(storage.lookup(3, 1), date);
+    QCOMPARE(storage.lookup(3, 1).format(), Value::fmt_Date);
+    QCOMPARE(storage.lookup(4, 1).asFloat(), wide.asFloat());
+    QCOMPARE(storage.lookup(5, 1), Value("Hello"));
+    QCOMPARE(storage.lookup(6, 1), Value::errorDIV0());
+    QCOMPARE(storage.lookup(7, 1), array);
+    QCOMPARE(storage.lookup(1, 2), Value("Hello"));
+    QCOMPARE(storage.lookup(8, 1), Value());
+
+    // the shared string stays, if one of its cells changes
+    storage.insert(5, 1, Value(1.5));
+    QCOMPARE(storage.lookup(5, 1), Value(1.5));
+    QCOMPARE(storage.lookup(1, 2), Value("Hello"));
+    storage.take(1, 2);
+    storage.insert(1, 3, Value("World"));
+    QCOMPARE(storage.lookup(1, 3), Value("World"));
+
+    // shifting the rows keeps the values
+    storage.insertRows(1, 1);
+    QCOMPARE(storage.lookup(3, 2), date);
+    QCOMPARE(storage.lookup(4, 2).asFloat(), wide.asFloat());
+    QCOMPARE(storage.lookup(1, 4), Value("World"));
+    storage.removeRows(1, 1);
+
+    // the numbers are read without building values
+    Number number;
+    Value::Format format;
+    QVERIFY(storage.lookupNumber(3, 1, &number, &format));
+    QCOMPARE(number, Number(14.5));
+    QCOMPARE(format, Value::fmt_Date);
+    QVERIFY(storage.lookupNumber(4, 1, &number, &format));
+    QCOMPARE(number, wide.asFloat());
+    QVERIFY(storage.lookupNumber(8, 1, &number, &format));
+    QCOMPARE(number, Number(0.0));
+    QVERIFY(!storage.lookupNumber(1, 1, &number, &format));
+    QVERIFY(!storage.lookupNumber(1, 3, &number, &format));
+
+    // a sub storage shares the strings, changing it keeps the source
+    ValueStorage sub = storage.subStorage(Region(QRect(1, 1, 5, 3)), false);
+    QCOMPARE(sub.lookup(1, 3), Value("World"));
+    sub.insert(2, 3, Value("World"));
+    sub.take(1, 3);
+    sub.insert(1, 1, Value("Hello"));
+    QCOMPARE(sub.lookup(2, 3), Value("World"));
+    QCOMPARE(sub.lookup(1, 1), Value("Hello"));
+    QCOMPARE(sub.lookup(3, 1), date);
+    QCOMPARE(storage.lookup(1, 3), Value("World"));
+    QCOMPARE(storage.lookup(1, 1), Value(true));
+    QCOMPARE(storage.lookup(2, 3), Value());
+
+    // the aggregations over the typed data agree with the array walk
+    CalculationSettings settings;
+    ValueParser parser(&settings);
+    ValueConverter converter(&parser);
+    ValueCalc calc(&converter);
+
+    Value numbers(storage.subStorage(Region(QRect(1, 1, 5, 3))), QSize(5, 3));
+    QCOMPARE(calc.count(numbers, false), 4);
+    QCOMPARE(calc.count(numbers, true), 6);
+    QCOMPARE(calc.sum(numbers, false).asFloat(), Number(42.0) + Number(14.5) + wide.asFloat() + Number(1.5));
+    QCOMPARE(calc.sum(numbers, false).format(), Value::fmt_Number);
+    QCOMPARE(calc.sum(numbers, true).asFloat(), Number(1.0) + Number(42.0) + Number(14.5) + wide.asFloat() + Number(1.5));
+
+    Value errors(storage.subStorage(Region(QRect(1, 1, 6, 1))), QSize(6, 1));
+    QCOMPARE(calc.sum(errors, false), Value::errorDIV0());
+    QCOMPARE(calc.count(errors, true), 6);
+
+    // nested arrays are walked recursively
+    Region region(QRect(2, 1, 1, 1));
+    region.add(QRect(7, 1, 1, 1));
+    Value nested(storage.subStorage(region), QSize(7, 1));
+    QCOMPARE(calc.sum(nested, false).asFloat(), Number(43.0));
+    QCOMPARE(calc.count(nested, false), 2);
+
+    QCOMPARE(calc.sum(Value(Value::Array), false), Value(0));
+}
+
 void TestValue::testCopy()
 {
     Value* v1;
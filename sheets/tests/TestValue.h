@@ -40,6 +40,7 @@ private Q_SLOTS:
     void testTime();
     void testError();
     void testArray();
+    void testTypedStorage();
     void testCopy();
     void testAssignment();
 };